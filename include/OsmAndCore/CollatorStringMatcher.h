@@ -27,6 +27,10 @@ namespace OsmAnd
         
         bool matches(const QString& name) const;
 
+        // Part and mode as prepared for matching (e.g. trailing '.' turns equality check into prefix check)
+        QString getPart() const;
+        StringMatcherMode getMode() const;
+
         static bool cmatches(const QString& _base, const QString& _part, StringMatcherMode _mode);
         static bool ccontains(const QString& _base, const QString& _part);
         static bool cstartsWith(const QString& _searchInParam, const QString& _theStart,
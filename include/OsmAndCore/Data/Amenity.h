@@ -8,6 +8,7 @@
 #include <QSet>
 #include <QHash>
 #include <QList>
+#include <QStringList>
 #include <QVariant>
 #include <OsmAndCore/restore_internal_warnings.h>
 
@@ -57,6 +58,8 @@ namespace OsmAnd
         QList<ObfPoiCategoryId> categories;
         QString nativeName;
         QHash<QString, QString> localizedNames;
+        // Values of other name tags, like "alt_name", that are matched by search by name as well
+        QStringList additionalNames;
         ObfObjectId id;
         QHash<int, QVariant> values;
 
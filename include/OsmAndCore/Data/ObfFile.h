@@ -13,6 +13,7 @@
 namespace OsmAnd
 {
     class ObfInfo;
+    class ObfReader;
     class ObfReader_P;
     class CachedOsmandIndexes_P;
 
@@ -35,6 +36,12 @@ namespace OsmAnd
 
         const QString getRegionName() const;
 
+        // Name indexes of POI and address sections are kept in memory once searched, as long as all of them fit
+        // into this budget (in bytes) shared by all files. By default it's 0, so name indexes are read from files.
+        static size_t getNameIndexesMemoryBudget();
+        static void setNameIndexesMemoryBudget(const size_t budget);
+
+    friend class OsmAnd::ObfReader;
     friend class OsmAnd::ObfReader_P;
     friend class OsmAnd::CachedOsmandIndexes_P;
     };
@@ -37,7 +37,7 @@ namespace OsmAnd
         PrivateImplementation<ObfReader_P> _p;
     protected:
     public:
-        ObfReader(const std::shared_ptr<const ObfFile>& obfFile);
+        ObfReader(const std::shared_ptr<const ObfFile>& obfFile, const bool useSharedMemoryMapping = false);
         ObfReader(const std::shared_ptr<QIODevice>& input);
         virtual ~ObfReader();
 
@@ -46,6 +46,7 @@ namespace OsmAnd
         bool isOpened() const;
         bool open();
         bool close();
+        bool rewind();
 
         std::shared_ptr<const ObfInfo> obtainInfo() const;
 
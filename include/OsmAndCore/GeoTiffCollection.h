@@ -7,11 +7,14 @@
 #include <OsmAndCore/ignore_warnings_on_external_includes.h>
 #include <QString>
 #include <QFileInfo>
+#include <QList>
 #include <QMutexLocker>
 #include <OsmAndCore/restore_internal_warnings.h>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/PointsAndAreas.h>
+#include <OsmAndCore/IQueryController.h>
 #include <OsmAndCore/IGeoTiffCollection.h>
 
 namespace OsmAnd
@@ -23,6 +26,50 @@ namespace OsmAnd
     public:
         typedef int SourceOriginId;
 
+        enum {
+            // Maximal number of idle opened GeoTIFF files kept for reuse
+            DefaultMaxCachedDatasets = 64,
+        };
+
+        // Product of tiles that is put in local cache, requested same way as its consumer does
+        struct OSMAND_CORE_API CachedProduct
+        {
+            CachedProduct();
+
+            RasterType rasterType;
+            uint32_t tileSize;
+            uint32_t overlap;
+            // Used for hillshade and slope rasters
+            ProcessingParameters procParameters;
+        };
+
+        struct OSMAND_CORE_API PregenerationRequest
+        {
+            PregenerationRequest();
+
+            AreaI area31;
+            ZoomLevel minZoom;
+            ZoomLevel maxZoom;
+            // Tiles closest to this point are generated first
+            PointI priorityPoint31;
+            QList<CachedProduct> products;
+        };
+
+        struct OSMAND_CORE_API PregenerationProgress
+        {
+            PregenerationProgress();
+
+            // Tiles of all zoom levels within area
+            int totalTilesCount;
+            int processedTilesCount;
+            // Products of processed tiles by outcome
+            int cachedProductsCount;
+            int generatedProductsCount;
+            int emptyProductsCount;
+            int failedProductsCount;
+        };
+        typedef std::function<void(const PregenerationProgress& progress)> PregenerationProgressCallback;
+
     private:
     protected:
         PrivateImplementation<GeoTiffCollection_P> _p;
@@ -43,6 +90,27 @@ namespace OsmAnd
         bool removeFileTilesFromCache(const RasterType cache, const QString& filePath);
         bool removeOlderTilesFromCache(const RasterType cache, int64_t time);
 
+        // Opened GeoTIFF files are kept for reuse, since opening them requires parsing of headers and
+        // loses GDAL block cache. Limit of 0 disables reuse.
+        void setMaxCachedDatasets(const int maxCachedDatasets);
+        int getMaxCachedDatasets() const;
+        // Size of GDAL raster block cache, shared by all opened datasets
+        static void setBlockCacheSize(const int64_t size);
+        static int64_t getBlockCacheSize();
+
+        // Tiles of low zoom levels are read from overviews rather than from full-resolution data. For files
+        // that lack internal overviews, they can be built once into local cache. Returns number of such files.
+        int buildOverviews(const std::shared_ptr<const IQueryController>& queryController = nullptr);
+
+        // Fills local cache with products of tiles within area. Tiles that are already in cache are skipped, so
+        // interrupted pre-generation is resumed by repeating the same request. Tiles are generated in parallel,
+        // including calling thread, which is blocked until all tiles are processed or query is aborted.
+        bool pregenerateTiles(
+            const PregenerationRequest& request,
+            PregenerationProgress* const pOutProgress = nullptr,
+            const PregenerationProgressCallback progressCallback = nullptr,
+            const std::shared_ptr<const IQueryController>& queryController = nullptr) const;
+
         virtual ZoomLevel getMinZoom() const Q_DECL_OVERRIDE;
         virtual ZoomLevel getMaxZoom(const uint32_t tileSize) const Q_DECL_OVERRIDE;
 
@@ -61,6 +129,15 @@ namespace OsmAnd
             const uint32_t tileSize,
             const QList<PointI>& points31,
             QList<float>& outHeights) const Q_DECL_OVERRIDE;
+
+        virtual void registerHeightsConsumer(
+            const uint32_t tileSize,
+            const uint32_t overlap,
+            const bool processed) const Q_DECL_OVERRIDE;
+        virtual void unregisterHeightsConsumer(
+            const uint32_t tileSize,
+            const uint32_t overlap,
+            const bool processed) const Q_DECL_OVERRIDE;
     };
 }
 
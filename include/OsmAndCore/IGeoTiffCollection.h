@@ -28,11 +28,15 @@ namespace OsmAnd
             Hillshade,
             Slope
         };        
-        struct ProcessingParameters
+        struct OSMAND_CORE_API ProcessingParameters
         {
+            ProcessingParameters();
+
             RasterType rasterType;
             QString resultColorsFilename;
             QString intermediateColorsFilename;
+            // Compute terrain rasters in-process rather than via GDAL DEM processing, if color files allow that
+            bool useNativeProcessing;
         };
     private:
     protected:
@@ -59,6 +63,18 @@ namespace OsmAnd
             const uint32_t tileSize,
             const QList<PointI>& points31,
             QList<float>& outHeights) const = 0;
+
+        // Consumers that request tiles of same size and overlap (e.g. hillshade and slope layers) register
+        // themselves, so that heights read for one of them are kept until the others have taken them too.
+        // Processed consumers are ones that pass processing parameters.
+        virtual void registerHeightsConsumer(
+            const uint32_t tileSize,
+            const uint32_t overlap,
+            const bool processed) const;
+        virtual void unregisterHeightsConsumer(
+            const uint32_t tileSize,
+            const uint32_t overlap,
+            const bool processed) const;
     };
 }
 
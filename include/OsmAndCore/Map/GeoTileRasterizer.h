@@ -44,7 +44,8 @@ namespace OsmAnd
             const QHash<BandIndex, std::shared_ptr<const GeoBandSettings>>& bandSettings,
             const uint32_t tileSize = 256,
             const float densityFactor = 1.0f,
-            const QString& projSearchPath = QString());
+            const QString& projSearchPath = QString(),
+            const bool useNativeProcessing = true);
         
         virtual ~GeoTileRasterizer();
         
@@ -58,6 +59,9 @@ namespace OsmAnd
         const uint32_t tileSize;
         const float densityFactor;
         const QString projSearchPath;
+        // Bands are colorized directly from decoded GeoTIFF, and GDAL warp and color-relief chain is used only
+        // as fallback. Otherwise, GDAL chain is used for all bands.
+        const bool useNativeProcessing;
 
         virtual QHash<BandIndex, sk_sp<const SkImage>> rasterize(
             std::shared_ptr<Metric>* const pOutMetric = nullptr,
@@ -24,6 +24,7 @@
 namespace OsmAnd
 {
     class MapStyleEvaluator;
+    class MapStyleEvaluationResultsCache;
     class MapStyleValueDefinition;
     class MapStyleBuiltinValueDefinitions;
     struct MapStyleConstantValue;
@@ -93,11 +94,18 @@ namespace OsmAnd
         const QSet<QString> disabledAttributes;
 
         QHash< OsmAnd::IMapStyle::ValueDefinitionId, MapStyleConstantValue > getSettings() const;
+        // Incremented each time settings are set, so that anything derived from settings may be reused until then
+        unsigned int getSettingsRevision() const;
         void setSettings(const QHash< OsmAnd::IMapStyle::ValueDefinitionId, MapStyleConstantValue >& newSettings);
         void setSettings(const QHash< QString, QString >& newSettings);
 
         void applyTo(MapStyleEvaluator& evaluator) const;
 
+#if !defined(SWIG)
+        // Shared cache of style evaluation results for given zoom, reset when settings change
+        std::shared_ptr<MapStyleEvaluationResultsCache> getStyleEvaluationResultsCache(const ZoomLevel zoom) const;
+#endif // !defined(SWIG)
+
         bool obtainShader(const QString& name, sk_sp<const SkImage>& outShader) const;
         bool obtainMapIcon(const QString& name, sk_sp<const SkImage>& outIcon) const;
         bool obtainTextShield(const QString& name, sk_sp<const SkImage>& outTextShield) const;
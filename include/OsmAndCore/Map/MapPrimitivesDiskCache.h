@@ -0,0 +1,52 @@
+#ifndef _OSMAND_CORE_MAP_PRIMITIVES_DISK_CACHE_H_
+#define _OSMAND_CORE_MAP_PRIMITIVES_DISK_CACHE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+#include <QByteArray>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+
+namespace OsmAnd
+{
+    // Persistent storage of serialized primitivised tiles, shared across sessions. Each entry is identified by
+    // tile, zoom and key that fingerprints everything tile content depends on. When total size of stored data
+    // exceeds limit, least recently used entries are evicted.
+    class MapPrimitivesDiskCache_P;
+    class OSMAND_CORE_API MapPrimitivesDiskCache
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapPrimitivesDiskCache);
+    public:
+        enum {
+            DefaultMaxSize = 256 * 1024 * 1024,
+        };
+
+    private:
+        PrivateImplementation<MapPrimitivesDiskCache_P> _p;
+    protected:
+    public:
+        MapPrimitivesDiskCache(const QString& filename, const uint64_t maxSize = DefaultMaxSize);
+        virtual ~MapPrimitivesDiskCache();
+
+        const QString filename;
+        const uint64_t maxSize;
+
+        bool isOpened() const;
+        bool open();
+        bool close();
+
+        uint64_t getSize() const;
+        int getHits() const;
+        int getMisses() const;
+
+        bool obtainData(const TileId tileId, const ZoomLevel zoom, const uint64_t key, QByteArray& outData);
+        bool storeData(const TileId tileId, const ZoomLevel zoom, const uint64_t key, const QByteArray& data);
+        bool removeAllData();
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_PRIMITIVES_DISK_CACHE_H_)
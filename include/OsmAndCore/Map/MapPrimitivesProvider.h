@@ -15,6 +15,7 @@
 #include <OsmAndCore/Map/MapPrimitiviser.h>
 #include <OsmAndCore/Map/IMapObjectsProvider.h>
 #include <OsmAndCore/Map/MapPrimitivesProvider_Metrics.h>
+#include <OsmAndCore/Map/MapPrimitivesDiskCache.h>
 
 namespace OsmAnd
 {
@@ -70,6 +71,10 @@ namespace OsmAnd
         virtual ZoomLevel getMinZoom() const;
         virtual ZoomLevel getMaxZoom() const;
 
+        // Optional persistent cache of primitivised tiles, none by default
+        std::shared_ptr<MapPrimitivesDiskCache> getDiskCache() const;
+        void setDiskCache(const std::shared_ptr<MapPrimitivesDiskCache>& diskCache);
+
         virtual bool obtainTiledPrimitives(
             const Request& request,
             std::shared_ptr<Data>& outTiledPrimitives,
@@ -23,6 +23,8 @@ namespace OsmAnd
     class MapObject;
     class MapPresentationEnvironment;
 
+    class MapPrimitivesSerializer;
+
     class MapPrimitiviser_P;
     class OSMAND_CORE_API MapPrimitiviser
     {
@@ -86,6 +88,7 @@ namespace OsmAnd
 
         friend class OsmAnd::MapPrimitiviser;
         friend class OsmAnd::MapPrimitiviser_P;
+        friend class OsmAnd::MapPrimitivesSerializer;
         };
         
         class OSMAND_CORE_API Primitive Q_DECL_FINAL
@@ -118,6 +121,7 @@ namespace OsmAnd
 
         friend class OsmAnd::MapPrimitiviser;
         friend class OsmAnd::MapPrimitiviser_P;
+        friend class OsmAnd::MapPrimitivesSerializer;
         };
 
         class Symbol;
@@ -142,6 +146,7 @@ namespace OsmAnd
         
         friend class OsmAnd::MapPrimitiviser;
         friend class OsmAnd::MapPrimitiviser_P;
+        friend class OsmAnd::MapPrimitivesSerializer;
         };
 
         class OSMAND_CORE_API GridSymbolsGroup Q_DECL_FINAL
@@ -162,6 +167,7 @@ namespace OsmAnd
         
         friend class OsmAnd::MapPrimitiviser;
         friend class OsmAnd::MapPrimitiviser_P;
+        friend class OsmAnd::MapPrimitivesSerializer;
         };
 
         class OSMAND_CORE_API Symbol
@@ -193,6 +199,7 @@ namespace OsmAnd
 
         friend class OsmAnd::MapPrimitiviser;
         friend class OsmAnd::MapPrimitiviser_P;
+        friend class OsmAnd::MapPrimitivesSerializer;
         };
 
         class OSMAND_CORE_API TextSymbol : public Symbol
@@ -237,6 +244,7 @@ namespace OsmAnd
             
         friend class OsmAnd::MapPrimitiviser;
         friend class OsmAnd::MapPrimitiviser_P;
+        friend class OsmAnd::MapPrimitivesSerializer;
         };
 
         class OSMAND_CORE_API IconSymbol : public Symbol
@@ -262,6 +270,7 @@ namespace OsmAnd
 
         friend class OsmAnd::MapPrimitiviser;
         friend class OsmAnd::MapPrimitiviser_P;
+        friend class OsmAnd::MapPrimitivesSerializer;
         };
 
         class OSMAND_CORE_API Cache
@@ -319,6 +328,7 @@ namespace OsmAnd
 
         friend class OsmAnd::MapPrimitiviser;
         friend class OsmAnd::MapPrimitiviser_P;
+        friend class OsmAnd::MapPrimitivesSerializer;
         };
     private:
         PrivateImplementation<MapPrimitiviser_P> _p;
@@ -13,6 +13,7 @@ namespace OsmAnd
 {
     class MapObject;
     class MapStyleEvaluationResult;
+    class MapStyleEvaluationResultsCache;
 
     class MapStyleEvaluator_P;
     class OSMAND_CORE_API MapStyleEvaluator Q_DECL_FINAL
@@ -36,6 +37,13 @@ namespace OsmAnd
         void setFloatValue(const IMapStyle::ValueDefinitionId valueDefId, const float value);
         void setStringValue(const IMapStyle::ValueDefinitionId valueDefId, const QString& value);
 
+#if !defined(SWIG)
+        // Ruleset evaluations are looked up in and stored to given cache, which may be shared by evaluators
+        // of different threads. Only used with compiled styles
+        std::shared_ptr<MapStyleEvaluationResultsCache> getResultsCache() const;
+        void setResultsCache(const std::shared_ptr<MapStyleEvaluationResultsCache>& resultsCache);
+#endif // !defined(SWIG)
+
         bool evaluate(
             const std::shared_ptr<const MapObject>& mapObject,
             const MapStyleRulesetType rulesetType,
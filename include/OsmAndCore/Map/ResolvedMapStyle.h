@@ -20,6 +20,8 @@
 
 namespace OsmAnd
 {
+    class MapStyleProgram;
+
     class ResolvedMapStyle_P;
     class OSMAND_CORE_API ResolvedMapStyle : public IMapStyle
     {
@@ -214,6 +216,13 @@ namespace OsmAnd
 
         virtual QString getStringById(const SWIG_CLARIFY(IMapStyle, StringId) id) const Q_DECL_OVERRIDE;
 
+#if !defined(SWIG)
+        // All rulesets and attributes lowered into flat program, built once when style is resolved
+        std::shared_ptr<const MapStyleProgram> getProgram() const;
+#endif // !defined(SWIG)
+        // Hash of style content, that is same for same style in any session
+        uint64_t getFingerprint() const;
+
         static std::shared_ptr<const ResolvedMapStyle> resolveMapStylesChain(
             const QList< std::shared_ptr<const UnresolvedMapStyle> >& unresolvedMapStylesChain);
     };
@@ -28,6 +28,11 @@ namespace OsmAnd
         PrivateImplementation<SqliteHeightmapTileProvider_P> _p;
     protected:
     public:
+        enum {
+            // Size of in-memory cache of decoded tiles, in bytes
+            DefaultCacheSize = 64 * 1024 * 1024,
+        };
+
         SqliteHeightmapTileProvider(
             const std::shared_ptr<const ITileSqliteDatabasesCollection>& sourcesCollection,
             uint32_t outputTileSize
@@ -51,6 +56,11 @@ namespace OsmAnd
         virtual ZoomLevel getMaxZoom() const Q_DECL_OVERRIDE;
         virtual uint32_t getTileSize() const Q_DECL_OVERRIDE;
 
+        size_t getCacheSize() const;
+        void setCacheSize(const size_t cacheSize);
+        // Should be called when sources have changed
+        void clearCache();
+
         virtual bool supportsNaturalObtainData() const Q_DECL_OVERRIDE;
         virtual bool obtainData(
             const IMapDataProvider::Request& request,
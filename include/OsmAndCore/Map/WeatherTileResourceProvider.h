@@ -57,6 +57,36 @@ namespace OsmAnd
             virtual std::shared_ptr<ValueRequest> clone() const;
         };
 
+        // Values of all bands at many points and forecast times
+        struct OSMAND_CORE_API ValuesRequest
+        {
+            ValuesRequest();
+            ValuesRequest(const ValuesRequest& that);
+            virtual ~ValuesRequest();
+
+            QString clientId;
+            QList<int64_t> dateTimes;
+            QList<PointI> points31;
+            bool localData;
+
+            std::shared_ptr<const IQueryController> queryController;
+
+            static void copy(ValuesRequest& dst, const ValuesRequest& src);
+            virtual std::shared_ptr<ValuesRequest> clone() const;
+        };
+
+        struct OSMAND_CORE_API ValuesSample
+        {
+            ValuesSample();
+            ~ValuesSample();
+
+            int64_t dateTime;
+            PointI point31;
+            bool available;
+            // In the same form as values obtained by ValueRequest
+            QList<double> values;
+        };
+
         struct OSMAND_CORE_API TileRequest
         {
             TileRequest();
@@ -98,6 +128,45 @@ namespace OsmAnd
             virtual std::shared_ptr<DownloadGeoTileRequest> clone() const;
         };
 
+        // Tiles of current view, that are speculatively prepared for forecast times adjacent to current one
+        struct OSMAND_CORE_API PrefetchRequest
+        {
+            PrefetchRequest();
+            PrefetchRequest(const PrefetchRequest& that);
+            virtual ~PrefetchRequest();
+
+            int64_t dateTime;
+            int64_t timeStep;
+            int stepsForward;
+            int stepsBackward;
+            // Tiles are prepared in given order, so the most important ones should go first
+            QList<TileId> tileIds;
+            ZoomLevel zoom;
+            QList<BandIndex> rasterBands;
+            QList<BandIndex> contourBands;
+            bool localData;
+
+            static void copy(PrefetchRequest& dst, const PrefetchRequest& src);
+            virtual std::shared_ptr<PrefetchRequest> clone() const;
+        };
+
+        struct OSMAND_CORE_API PrefetchStatistics
+        {
+            PrefetchStatistics();
+            ~PrefetchStatistics();
+
+            uint64_t scheduledTiles;
+            uint64_t preparedTiles;
+            uint64_t cancelledTiles;
+            uint64_t failedTiles;
+            // Tiles that were being prepared by tile requests at the time, so prefetch skipped them
+            uint64_t skippedTiles;
+            // Prepared tiles that were requested afterwards
+            uint64_t hits;
+
+            double getHitRate() const;
+        };
+
         class OSMAND_CORE_API Data
         {
             Q_DISABLE_COPY_AND_MOVE(Data);
@@ -127,6 +196,13 @@ namespace OsmAnd
             const QList<double>& values,
             const std::shared_ptr<Metric>& metric);
 
+        // Samples are ordered by date-time first, then by point, as in request
+        OSMAND_CALLABLE(ObtainValuesAsyncCallback,
+            void,
+            bool succeeded,
+            const QList<ValuesSample>& samples,
+            const std::shared_ptr<Metric>& metric);
+
         OSMAND_CALLABLE(ObtainTileDataAsyncCallback,
             void,
             bool requestSucceeded,
@@ -163,6 +239,16 @@ namespace OsmAnd
             const ObtainValueAsyncCallback callback,
             const bool collectMetric = false);
 
+        virtual void obtainValues(
+            const ValuesRequest& request,
+            const ObtainValuesAsyncCallback callback,
+            const bool collectMetric = false);
+
+        virtual void obtainValuesAsync(
+            const ValuesRequest& request,
+            const ObtainValuesAsyncCallback callback,
+            const bool collectMetric = false);
+
         virtual void obtainData(
             const TileRequest& request,
             const ObtainTileDataAsyncCallback callback,
@@ -183,6 +269,12 @@ namespace OsmAnd
             const DownloadGeoTilesAsyncCallback callback,
             const bool collectMetric = false);
 
+        // Previously scheduled prefetch is cancelled, as well as it is by change of zoom or bands of tile requests
+        virtual void prefetch(const PrefetchRequest& request);
+        void cancelPrefetch();
+        PrefetchStatistics getPrefetchStatistics() const;
+        void resetPrefetchStatistics();
+
         void setBandSettings(const QHash<BandIndex, std::shared_ptr<const GeoBandSettings>>& bandSettings);
 
         int getCurrentRequestVersion() const;
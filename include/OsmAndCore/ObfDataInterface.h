@@ -7,6 +7,7 @@
 
 #include <OsmAndCore/QtExtensions.h>
 #include <QList>
+#include <QVector>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/CommonTypes.h>
@@ -19,24 +20,66 @@
 #include <OsmAndCore/CollatorStringMatcher.h>
 #include <OsmAndCore/Ref.h>
 
+class QThreadPool;
+
 namespace OsmAnd
 {
     class ObfReader;
     class ObfFile;
     class ObfMapObject;
+    class ObfAddressSectionInfo;
     class IQueryController;
 
     class OSMAND_CORE_API ObfDataInterface
     {
         Q_DISABLE_COPY_AND_MOVE(ObfDataInterface);
+    public:
+        typedef std::function<std::shared_ptr<const ObfReader> (const std::shared_ptr<const ObfFile>& obfFile)>
+            ObtainReaderFunction;
+
     private:
+        bool _parallelReadingEnabled;
+        QThreadPool* _parallelReadingThreadPool;
+        // Source of additional readers of same file (e.g. pool of readers), otherwise they are opened as needed
+        const ObtainReaderFunction _obtainAdditionalReader;
+
+        typedef std::function<void ()> ParallelTask;
+        bool shouldReadInParallel() const;
+        void runInParallel(const QVector<ParallelTask>& tasks) const;
+
+        // Task gets reader exclusively, that is either given one or additional reader of the same file
+        typedef std::pair<
+            std::shared_ptr<const ObfReader>,
+            std::function<void (const std::shared_ptr<const ObfReader>& obfReader)> > ReaderTask;
+        void runOnReadersInParallel(const QVector<ReaderTask>& tasks) const;
+        static QThreadPool* getDefaultParallelReadingThreadPool();
+
+        bool loadBinaryMapObjectsInParallel(
+            QList< std::shared_ptr<const OsmAnd::BinaryMapObject> >* resultOut,
+            MapSurfaceType* outSurfaceType,
+            const ZoomLevel zoom,
+            const AreaI* const bbox31,
+            const ObfMapSectionReader::FilterByIdFunction filterById,
+            ObfMapSectionReader::DataBlocksCache* cache,
+            QList< std::shared_ptr<const ObfMapSectionReader::DataBlock> >* outReferencedCacheEntries,
+            const std::shared_ptr<const IQueryController>& queryController,
+            bool coastlineOnly);
     protected:
     public:
-        ObfDataInterface(const QList< std::shared_ptr<const ObfReader> >& obfReaders);
+        ObfDataInterface(
+            const QList< std::shared_ptr<const ObfReader> >& obfReaders,
+            const ObtainReaderFunction obtainAdditionalReader = nullptr);
         virtual ~ObfDataInterface();
 
         const QList< std::shared_ptr<const ObfReader> > obfReaders;
 
+        // When enabled, independent OBF readers are read concurrently on given (or shared) pool of workers.
+        // Callbacks (filters, visitors) are never called concurrently, results are merged in order of readers.
+        // Address sections, street groups and streets are additionally fanned out to readers opened for same file,
+        // so their visitors are called as soon as objects are read.
+        bool isParallelReadingEnabled() const;
+        void setParallelReadingEnabled(const bool enabled, QThreadPool* const threadPool = nullptr);
+
         bool loadObfFiles(
             QList< std::shared_ptr<const ObfFile> >* outFiles = nullptr,
             const std::shared_ptr<const IQueryController>& queryController = nullptr);
@@ -123,6 +166,9 @@ namespace OsmAnd
             std::shared_ptr<const OsmAnd::Amenity>* const outAmenity,
             const std::shared_ptr<const IQueryController>& queryController = nullptr);
 
+        // Filter is checked right before section is read, sections nearest to xy31 are read first
+        typedef std::function<bool (const std::shared_ptr<const ObfAddressSectionInfo>& addressSection)>
+            AddressSectionFilterFunction;
         bool scanAddressesByName(
             const QString& query,
             const StringMatcherMode matcherMode,
@@ -132,7 +178,9 @@ namespace OsmAnd
             const bool includeStreets = true,
             const bool strictMatch = false,
             const ObfAddressSectionReader::VisitorFunction visitor = nullptr,
-            const std::shared_ptr<const IQueryController>& queryController = nullptr);
+            const std::shared_ptr<const IQueryController>& queryController = nullptr,
+            const PointI* const xy31 = nullptr,
+            const AddressSectionFilterFunction sectionFilter = nullptr);
 
         bool loadStreetGroups(
             QList< std::shared_ptr<const StreetGroup> >* resultOut = nullptr,
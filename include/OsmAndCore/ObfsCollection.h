@@ -26,6 +26,22 @@ namespace OsmAnd
     public:
         typedef int SourceOriginId;
 
+        struct ReadersPoolStatistics
+        {
+            ReadersPoolStatistics()
+                : hits(0)
+                , misses(0)
+                , invalidations(0)
+                , idleReaders(0)
+            {
+            }
+
+            unsigned int hits;
+            unsigned int misses;
+            unsigned int invalidations;
+            unsigned int idleReaders;
+        };
+
     private:
     protected:
         PrivateImplementation<ObfsCollection_P> _p;
@@ -44,6 +60,15 @@ namespace OsmAnd
         void setIndexCacheFile(const QString& filePath);
         bool remove(const SourceOriginId entryId);
 
+        int getMaxIdleReadersPerFile() const;
+        void setMaxIdleReadersPerFile(const int maxIdleReadersPerFile);
+        ReadersPoolStatistics getReadersPoolStatistics() const;
+        void resetReadersPoolStatistics();
+        void clearReadersPool();
+
+        bool getUseSharedMemoryMapping() const;
+        void setUseSharedMemoryMapping(const bool useSharedMemoryMapping);
+
         virtual QList< std::shared_ptr<const ObfFile> > getObfFiles() const;
         virtual std::shared_ptr<OsmAnd::ObfDataInterface> obtainDataInterface(
             const std::shared_ptr<const ObfFile> obfFile) const;
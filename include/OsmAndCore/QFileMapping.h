@@ -0,0 +1,49 @@
+#ifndef _OSMAND_CORE_Q_FILE_MAPPING_H_
+#define _OSMAND_CORE_Q_FILE_MAPPING_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+#include <QFile>
+
+#include <OsmAndCore.h>
+
+namespace OsmAnd
+{
+    /**
+    Read-only memory mapping of an entire file. Mapping is established once and can be shared
+    between any number of readers and threads, since mapped memory is never modified.
+    */
+    class OSMAND_CORE_API QFileMapping
+    {
+        Q_DISABLE_COPY_AND_MOVE(QFileMapping);
+    public:
+        enum class AccessPattern
+        {
+            Normal,
+            Random,
+            Sequential,
+            WillNeed,
+        };
+
+    private:
+        QFile _file;
+        uchar* _mappedMemory;
+        qint64 _size;
+    protected:
+    public:
+        QFileMapping(const QString& filePath);
+        virtual ~QFileMapping();
+
+        bool isMapped() const;
+        const uint8_t* data() const;
+        qint64 size() const;
+        QString fileName() const;
+
+        bool advise(const AccessPattern accessPattern) const;
+        bool advise(const qint64 offset, const qint64 length, const AccessPattern accessPattern) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_Q_FILE_MAPPING_H_)
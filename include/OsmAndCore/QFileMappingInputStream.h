@@ -0,0 +1,59 @@
+#ifndef _OSMAND_CORE_Q_FILE_MAPPING_INPUT_STREAM_H_
+#define _OSMAND_CORE_Q_FILE_MAPPING_INPUT_STREAM_H_
+
+#include <memory>
+
+#include <OsmAndCore/QtExtensions.h>
+
+#include "ignore_warnings_on_external_includes.h"
+#include <google/protobuf/io/zero_copy_stream.h>
+#include "restore_internal_warnings.h"
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/QFileMapping.h>
+
+namespace OsmAnd
+{
+    namespace gpb = google::protobuf;
+
+    /**
+    Implementation of input stream for Google Protobuf that hands out slices of shared whole-file memory mapping
+    */
+    class OSMAND_CORE_API QFileMappingInputStream : public gpb::io::ZeroCopyInputStream
+    {
+    public:
+        enum {
+            DefaultSliceSize = 64 * 1024 * 1024, // 64Mb
+        };
+
+    private:
+        GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(QFileMappingInputStream);
+
+        //! Pointer to mapping
+        const std::shared_ptr<const QFileMapping> _mapping;
+
+        //! Mapping size
+        const qint64 _size;
+
+        //! Slice size
+        const qint64 _sliceSize;
+
+        //! Current position
+        qint64 _currentPosition;
+    protected:
+    public:
+        QFileMappingInputStream(
+            const std::shared_ptr<const QFileMapping>& mapping,
+            const size_t sliceSize = DefaultSliceSize);
+        virtual ~QFileMappingInputStream();
+
+        const std::shared_ptr<const QFileMapping> mapping;
+
+        virtual bool Next(const void** data, int* size);
+        virtual void BackUp(int count);
+        virtual bool Skip(int count);
+        virtual gpb::int64 ByteCount() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_Q_FILE_MAPPING_INPUT_STREAM_H_)
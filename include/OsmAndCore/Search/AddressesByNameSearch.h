@@ -43,6 +43,15 @@ namespace OsmAnd
             StringMatcherMode matcherMode;
             bool strictMatch;
             QList< std::shared_ptr<const ResourcesManager::LocalResource> > localResources;
+
+            // Address sections nearest to this point are read first
+            Nullable<PointI> xy31;
+            // When positive along with xy31, only results that get into this number of nearest ones so far are
+            // reported, and address sections that can't contain nearer results are not read at all
+            int nearestResultsLimit;
+            // OBF files, address sections, cities and streets are read concurrently, results are reported
+            // as soon as they are found
+            bool parallelReading;
         };
 
         struct OSMAND_CORE_API ResultEntry : public IResultEntry
@@ -0,0 +1,62 @@
+#ifndef _OSMAND_CORE_NAME_SEARCH_SESSION_H_
+#define _OSMAND_CORE_NAME_SEARCH_SESSION_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/Search/ISearch.h>
+#include <OsmAndCore/Search/AmenitiesByNameSearch.h>
+#include <OsmAndCore/Search/AddressesByNameSearch.h>
+
+namespace OsmAnd
+{
+    class IQueryController;
+
+    // Type-ahead search by name, where criteria stay the same and only name changes. Results of last name are
+    // kept, so that name extended by typing is answered by narrowing them instead of searching OBFs again.
+    // Any other change of name causes full search. Search that is superseded by newer one is aborted.
+    class NameSearchSession_P;
+    class OSMAND_CORE_API NameSearchSession Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(NameSearchSession);
+    public:
+        enum {
+            DefaultMaxKeptResults = 10000,
+        };
+
+    private:
+        PrivateImplementation<NameSearchSession_P> _p;
+    protected:
+    public:
+        // Name of criteria is ignored
+        NameSearchSession(
+            const std::shared_ptr<const AmenitiesByNameSearch>& search,
+            const AmenitiesByNameSearch::Criteria& criteria,
+            const int maxKeptResults = DefaultMaxKeptResults);
+        NameSearchSession(
+            const std::shared_ptr<const AddressesByNameSearch>& search,
+            const AddressesByNameSearch::Criteria& criteria,
+            const int maxKeptResults = DefaultMaxKeptResults);
+        virtual ~NameSearchSession();
+
+        const std::shared_ptr<const ISearch> search;
+        // Results are not kept if there are more of them, so that next name is searched in full
+        const int maxKeptResults;
+
+        // Callback receives criteria with given name. Returns false if search was aborted, either by query
+        // controller or by newer search of this session. May be called from different threads.
+        bool performSearch(
+            const QString& name,
+            const ISearch::NewResultEntryCallback newResultEntryCallback,
+            const std::shared_ptr<const IQueryController>& queryController = nullptr);
+        void reset();
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_NAME_SEARCH_SESSION_H_)
@@ -8,6 +8,7 @@
 #include <QString>
 #include <QHash>
 #include <QList>
+#include <QVector>
 #include <OsmAndCore/restore_internal_warnings.h>
 
 #include <OsmAndCore.h>
@@ -77,6 +78,12 @@ namespace OsmAnd
                 const NewResultEntryCallback newResultEntryCallback,
                 const std::shared_ptr<const IQueryController>& queryController = nullptr) const;
         std::shared_ptr<const ResultEntry> performSearch(const Criteria &criteria) const;
+
+        // Results are in order of points, ones that were not processed due to abort are nullptr. Points are
+        // processed grouped by tiles, so that nearby points reuse same loaded streets and buildings.
+        QVector<std::shared_ptr<const ResultEntry>> reverseGeocode(
+                const QVector<LatLon>& points,
+                const std::shared_ptr<const IQueryController>& queryController = nullptr) const;
     };
 }
 
@@ -9,9 +9,13 @@
 #include <QHash>
 #include <QList>
 #include <QVector>
+#include <QSet>
+#include <QCache>
+#include <QMutex>
 #include <OsmAndCore/restore_internal_warnings.h>
 
 #include "OsmAndCore.h"
+#include "CommonTypes.h"
 #include "PrivateImplementation.h"
 #include "IRoadLocator.h"
 #include "LatLon.h"
@@ -21,6 +25,8 @@
 
 namespace OsmAnd
 {
+    class ObfAddressSectionInfo;
+
     class ReverseGeocoder_P Q_DECL_FINAL
     {
         Q_DISABLE_COPY_AND_MOVE(ReverseGeocoder_P)
@@ -28,10 +34,54 @@ namespace OsmAnd
         using ResultEntry = ReverseGeocoder::ResultEntry;
         using Criteria = ReverseGeocoder::Criteria;
 
+    public:
+        // Street of address section, by its offset in OBF file
+        struct AddressKey
+        {
+            std::shared_ptr<const ObfAddressSectionInfo> section;
+            uint32_t offset;
+
+            inline bool operator==(const AddressKey& that) const
+            {
+                return section == that.section && offset == that.offset;
+            }
+        };
+
+        // Streets of same name key, found by name search around tile of batch
+        struct TileStreetsKey
+        {
+            QString nameKey;
+            uint64_t tileId;
+
+            inline bool operator==(const TileStreetsKey& that) const
+            {
+                return tileId == that.tileId && nameKey == that.nameKey;
+            }
+        };
+
     private:
         const std::shared_ptr<const IRoadLocator> roadLocator;
         const std::shared_ptr<const AddressesByNameSearch> addressByNameSearch;
 
+        // Streets found by name search for whole tile, so that nearby points don't repeat same name search.
+        // Since these are exactly streets of name search, streets of any street group are found as before.
+        mutable QMutex _tilesStreetsMutex;
+        mutable QCache< TileStreetsKey, QVector< std::shared_ptr<const Street> > > _tilesStreets;
+        mutable QMutex _streetsBuildingsMutex;
+        mutable QCache< AddressKey, QList< std::shared_ptr<const Building> > > _streetsBuildings;
+        QVector<std::shared_ptr<const Street>> obtainStreets(
+                const QStringList& streetNamesUsed,
+                const bool addCommonWords,
+                const PointI& position31,
+                const double radius) const;
+        QVector<std::shared_ptr<const Street>> findStreetsByName(
+                const QStringList& streetNamesUsed,
+                const bool addCommonWords,
+                const AreaI& bbox31) const;
+        QList<std::shared_ptr<const Building>> obtainStreetBuildings(
+                const std::shared_ptr<const Street>& street,
+                const PointI& position31) const;
+
         static bool DISTANCE_COMPARATOR(
                 const std::shared_ptr<const ResultEntry> &a,
                 const std::shared_ptr<const ResultEntry> &b);
@@ -46,6 +96,8 @@ namespace OsmAnd
                 const std::shared_ptr<const ResultEntry> street) const;
         QVector<std::shared_ptr<const ResultEntry>> reverseGeocodeToRoads(
                 const LatLon searchPoint) const;
+        std::shared_ptr<const ResultEntry> reverseGeocode(
+                const LatLon searchPoint) const;
     protected:
         ImplementationInterface<ReverseGeocoder> owner;
     public:
@@ -58,9 +110,22 @@ namespace OsmAnd
                 const ISearch::Criteria& criteria,
                 const ISearch::NewResultEntryCallback newResultEntryCallback,
                 const std::shared_ptr<const IQueryController>& queryController = nullptr) const;
+        QVector<std::shared_ptr<const ResultEntry>> reverseGeocode(
+                const QVector<LatLon>& points,
+                const std::shared_ptr<const IQueryController>& queryController = nullptr) const;
 
         friend class OsmAnd::ReverseGeocoder;
     };
+
+    inline uint qHash(const ReverseGeocoder_P::AddressKey& key, uint seed = 0)
+    {
+        return ::qHash(key.section.get(), seed) ^ ::qHash(key.offset, seed);
+    }
+
+    inline uint qHash(const ReverseGeocoder_P::TileStreetsKey& key, uint seed = 0)
+    {
+        return ::qHash(key.nameKey, seed) ^ ::qHash(key.tileId, seed);
+    }
 }
 
 #endif // _OSMAND_CORE_REVERSE_GEOCODER_P_H_
@@ -88,6 +88,30 @@ namespace OsmAnd
             int64_t getTileSize(bool* outOk = nullptr) const;
             void setTileSize(int64_t tileSize);
         };
+
+        // Tile to be stored as part of a batch. Specification is used only if it's not 0.
+        struct OSMAND_CORE_API TileEntry Q_DECL_FINAL
+        {
+            TileEntry();
+            TileEntry(
+                const TileId tileId,
+                const ZoomLevel zoom,
+                const QByteArray& data,
+                const int64_t time = 0,
+                const int64_t specification = 0);
+            ~TileEntry();
+
+            TileId tileId;
+            ZoomLevel zoom;
+            int64_t specification;
+            QByteArray data;
+            int64_t time;
+        };
+
+        enum {
+            // Number of tiles stored within single transaction by storeTilesData()
+            TilesPerTransaction = 256,
+        };
     private:
         PrivateImplementation<TileSqliteDatabase_P> _p;
     protected:
@@ -143,6 +167,7 @@ namespace OsmAnd
         bool storeTileData(TileId tileId, ZoomLevel zoom, const QByteArray& data, int64_t time = 0);
         bool storeTileData(TileId tileId, ZoomLevel zoom, int64_t specification,
             const QByteArray& data, int64_t time = 0);
+        bool storeTilesData(const QList<TileEntry>& tiles);
         bool updateTileDataFrom(const QString& dbFilePath, const QString* specName = nullptr);
         bool removeTileData(TileId tileId, ZoomLevel zoom, int64_t specification = 0);
         bool removeTilesData(QList<TileId>& tileIds, ZoomLevel zoom, int64_t specification = 0);
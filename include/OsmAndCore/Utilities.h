@@ -295,6 +295,15 @@ namespace OsmAnd
             return qSqrt(squareDistance31(a, b));
         }
 
+        // Distance to nearest point of area, that is zero for points inside it
+        inline static double squareDistance31(const PointI& point, const AreaI& area)
+        {
+            const PointI nearestPoint(
+                qBound(area.left(), point.x, area.right()),
+                qBound(area.top(), point.y, area.bottom()));
+            return squareDistance31(point, nearestPoint);
+        }
+
         inline static double distance(const double xLonA, const double yLatA, const double xLonB, const double yLatB)
         {
             double R = 6372.8; // for haversine use R = 6372.8 km instead of 6371 km
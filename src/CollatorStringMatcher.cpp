@@ -8,7 +8,7 @@ OsmAnd::CollatorStringMatcher::CollatorStringMatcher(const QString& part, const
     QString part_ = CollatorStringMatcher_P::simplifyStringAndAlignChars(part);
     StringMatcherMode mode_ = mode;
     if (part_.length() > 0 && part_.at(part_.length() - 1) == L'.') {
-        part_ = part_.mid(0, part.length() - 1);
+        part_ = part_.mid(0, part_.length() - 1);
         if (mode == StringMatcherMode::CHECK_EQUALS_FROM_SPACE) {
             mode_ = StringMatcherMode::CHECK_STARTS_FROM_SPACE;
         } else if (mode == StringMatcherMode::CHECK_EQUALS) {
@@ -17,6 +17,7 @@ OsmAnd::CollatorStringMatcher::CollatorStringMatcher(const QString& part, const
     }
     _part = part_;
     _mode = mode_;
+    _p->initialize(_part, _mode);
 }
 
 OsmAnd::CollatorStringMatcher::~CollatorStringMatcher()
@@ -25,7 +26,17 @@ OsmAnd::CollatorStringMatcher::~CollatorStringMatcher()
 
 bool OsmAnd::CollatorStringMatcher::matches(const QString& name) const
 {
-    return _p->CollatorStringMatcher_P::matches(name, _part, _mode);
+    return _p->matches(name);
+}
+
+QString OsmAnd::CollatorStringMatcher::getPart() const
+{
+    return _part;
+}
+
+OsmAnd::StringMatcherMode OsmAnd::CollatorStringMatcher::getMode() const
+{
+    return _mode;
 }
 
 bool OsmAnd::CollatorStringMatcher::cmatches(const QString& _base, const QString& _part, StringMatcherMode _mode)
@@ -1,8 +1,13 @@
 #include "CollatorStringMatcher_P.h"
 #include "CollatorStringMatcher.h"
 
+#include <cstring>
+
 #include <ICU.h>
 #include <QLocale>
+#include <QThreadStorage>
+
+#include "ICU_private.h"
 
 OsmAnd::CollatorStringMatcher_P::CollatorStringMatcher_P(CollatorStringMatcher* owner_)
     : owner(owner_)
@@ -13,6 +18,24 @@ OsmAnd::CollatorStringMatcher_P::~CollatorStringMatcher_P()
 {
 }
 
+void OsmAnd::CollatorStringMatcher_P::initialize(const QString& part, const StringMatcherMode mode)
+{
+    makeKey(part, _partKey);
+    _mode = mode;
+}
+
+bool OsmAnd::CollatorStringMatcher_P::matches(const QString& name) const
+{
+    // Key of name is rebuilt for each name, so its buffers are kept per thread
+    static QThreadStorage<Key*> nameKeys;
+    if (!nameKeys.hasLocalData())
+        nameKeys.setLocalData(new Key());
+    const auto pNameKey = nameKeys.localData();
+
+    makeKey(name, *pNameKey);
+    return matches(*pNameKey, _partKey, _mode);
+}
+
 bool OsmAnd::CollatorStringMatcher_P::matches(const QString& _base, const QString& _part, StringMatcherMode _mode) const
 {
     return OsmAnd::ICU::cmatches(_base, _part, _mode);
@@ -47,3 +70,150 @@ QString OsmAnd::CollatorStringMatcher_P::alignChars(const QString& fullText)
     }
     return res;
 }
+
+void OsmAnd::CollatorStringMatcher_P::makeKey(const QString& input, Key& outKey)
+{
+    // Same as in ICU::cstartsWith, 'ß' is aligned to 'ss', so that each 's' is a character of its own
+    if (input.contains(QChar(0x00DF)))
+    {
+        makeKey(alignChars(input), outKey);
+        return;
+    }
+
+    outKey.weights.resize(0);
+    outKey.flags.resize(0);
+
+    const auto length = input.length();
+    const auto pChars = input.constData();
+    const auto readCodePoint =
+        [pChars, length]
+        (const int index, int& outCharLength) -> uint32_t
+        {
+            if (pChars[index].isHighSurrogate() && index + 1 < length && pChars[index + 1].isLowSurrogate())
+            {
+                outCharLength = 2;
+                return QChar::surrogateToUcs4(pChars[index], pChars[index + 1]);
+            }
+            outCharLength = 1;
+            return pChars[index].unicode();
+        };
+
+    // Same as in ICU::cstartsWith, anything but letters and digits separates words
+    int charLength = 0;
+    auto codePoint = length > 0 ? readCodePoint(0, charLength) : 0;
+    auto isSpace = !QChar::isLetterOrNumber(codePoint);
+    auto previousIsSpace = false;
+    for (int index = 0; index < length; )
+    {
+        const auto nextIndex = index + charLength;
+        int nextCharLength = 0;
+        const auto nextCodePoint = nextIndex < length ? readCodePoint(nextIndex, nextCharLength) : 0;
+        const auto nextIsSpace = nextIndex >= length || !QChar::isLetterOrNumber(nextCodePoint);
+
+        const auto weights = ICU::getPrimaryCollationWeights(codePoint);
+        const auto weightsCount = weights.size();
+        for (int weightIndex = 0; weightIndex < weightsCount; weightIndex++)
+        {
+            uint8_t flags = 0;
+            if (weightIndex == 0)
+            {
+                flags |= Key::CharacterStart;
+                if (index > 0 && previousIsSpace && !isSpace)
+                    flags |= Key::WordStart;
+            }
+            if (weightIndex == weightsCount - 1)
+            {
+                flags |= Key::CharacterEnd;
+                if (nextIsSpace)
+                    flags |= Key::WordEnd;
+            }
+            outKey.weights.push_back(weights[weightIndex]);
+            outKey.flags.push_back(flags);
+        }
+
+        previousIsSpace = isSpace;
+        index = nextIndex;
+        codePoint = nextCodePoint;
+        charLength = nextCharLength;
+        isSpace = nextIsSpace;
+    }
+}
+
+bool OsmAnd::CollatorStringMatcher_P::matches(const Key& base, const Key& part, const StringMatcherMode mode)
+{
+    switch (mode)
+    {
+        case StringMatcherMode::CHECK_CONTAINS:
+            return contains(base, part);
+        case StringMatcherMode::CHECK_EQUALS_FROM_SPACE:
+            return startsWith(base, part, true, true, true);
+        case StringMatcherMode::CHECK_STARTS_FROM_SPACE:
+            return startsWith(base, part, true, true, false);
+        case StringMatcherMode::CHECK_STARTS_FROM_SPACE_NOT_BEGINNING:
+            return startsWith(base, part, false, true, false);
+        case StringMatcherMode::CHECK_ONLY_STARTS_WITH:
+            return startsWith(base, part, true, false, false);
+        case StringMatcherMode::CHECK_EQUALS:
+            return startsWith(base, part, false, false, true);
+        default:
+            return false;
+    }
+}
+
+bool OsmAnd::CollatorStringMatcher_P::contains(const Key& base, const Key& part)
+{
+    if (part.weights.isEmpty())
+        return true;
+
+    const auto lastPosition = base.weights.size() - part.weights.size();
+    for (int position = 0; position <= lastPosition; position++)
+    {
+        if ((base.flags[position] & Key::CharacterStart) && matchesAt(base, position, part, false))
+            return true;
+    }
+    return false;
+}
+
+bool OsmAnd::CollatorStringMatcher_P::startsWith(
+    const Key& base,
+    const Key& part,
+    bool checkBeginning,
+    bool checkSpaces,
+    bool equals)
+{
+    if (!checkBeginning && !checkSpaces && equals)
+        return base.weights == part.weights;
+    if (part.weights.isEmpty())
+        return true;
+
+    if (checkBeginning && matchesAt(base, 0, part, equals))
+        return true;
+    if (checkSpaces)
+    {
+        const auto lastPosition = base.weights.size() - part.weights.size();
+        for (int position = 1; position <= lastPosition; position++)
+        {
+            if ((base.flags[position] & Key::WordStart) && matchesAt(base, position, part, equals))
+                return true;
+        }
+    }
+    return false;
+}
+
+bool OsmAnd::CollatorStringMatcher_P::matchesAt(
+    const Key& base,
+    const int position,
+    const Key& part,
+    const bool equals)
+{
+    const auto size = part.weights.size();
+    if (position + size > base.weights.size())
+        return false;
+    if (std::memcmp(base.weights.constData() + position, part.weights.constData(), size * sizeof(uint32_t)) != 0)
+        return false;
+
+    // Match should end together with word if equality is checked. Otherwise it may end within weights of
+    // character that expands to several ones (like 'æ'), same as prefix typed by user does.
+    const auto endFlags = base.flags[position + size - 1];
+    return !equals || (endFlags & Key::WordEnd);
+}
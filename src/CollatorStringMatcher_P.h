@@ -5,6 +5,7 @@
 #include <OsmAndCore.h>
 
 #include <QString>
+#include <QVector>
 #include "OsmAndCore.h"
 #include <CollatorStringMatcher.h>
 
@@ -14,21 +15,51 @@ namespace OsmAnd
     
     class OSMAND_CORE_API CollatorStringMatcher_P Q_DECL_FINAL
     {
+    public:
+        // Primary collation weights of string, so that strings are compared by plain comparison of weights instead
+        // of collator. Each weight is flagged with boundaries of character and word it belongs to.
+        struct Key
+        {
+            enum Flag : uint8_t
+            {
+                CharacterStart = 1 << 0,
+                CharacterEnd = 1 << 1,
+                WordStart = 1 << 2,
+                WordEnd = 1 << 3,
+            };
+
+            QVector<uint32_t> weights;
+            QVector<uint8_t> flags;
+        };
+
     private:
         static QString simplifyStringAndAlignChars(const QString& fullText);
         static QString alignChars(const QString& fullText);
+
+        Key _partKey;
+        StringMatcherMode _mode;
+
+        static bool matchesAt(const Key& base, const int position, const Key& part, const bool equals);
     protected:
         CollatorStringMatcher_P(CollatorStringMatcher* const owner);
-        
+
+        void initialize(const QString& part, const StringMatcherMode mode);
     public:
         virtual ~CollatorStringMatcher_P();
         
         ImplementationInterface<CollatorStringMatcher> owner;
         
+        bool matches(const QString& name) const;
         bool matches(const QString& _base, const QString& _part, StringMatcherMode _mode) const;
         bool contains(const QString& _base, const QString& _part) const;
         bool startsWith(const QString& _searchInParam, const QString& _theStart,
                          bool checkBeginning, bool checkSpaces, bool equals) const;
+
+        // Key is rebuilt in place, so that its buffers are reused
+        static void makeKey(const QString& input, Key& outKey);
+        static bool matches(const Key& base, const Key& part, const StringMatcherMode mode);
+        static bool contains(const Key& base, const Key& part);
+        static bool startsWith(const Key& base, const Key& part, bool checkBeginning, bool checkSpaces, bool equals);
     
         friend class OsmAnd::CollatorStringMatcher;
     };
@@ -0,0 +1,327 @@
+#include "ContourGenerator.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "ignore_warnings_on_external_includes.h"
+#include <QAtomicInt>
+#include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include "restore_internal_warnings.h"
+
+#include "QRunnableFunctor.h"
+
+OsmAnd::ContourGenerator::ContourGenerator()
+{
+}
+
+OsmAnd::ContourGenerator::~ContourGenerator()
+{
+}
+
+OsmAnd::ContourGenerator::Grid::Grid()
+    : pValues(nullptr)
+    , width(0)
+    , height(0)
+    , hasNoData(false)
+    , noData(0.0f)
+{
+}
+
+QVector<double> OsmAnd::ContourGenerator::getIntervalLevels(
+    const Grid& grid,
+    const double interval,
+    const double base /*= 0.0*/)
+{
+    QVector<double> levels;
+    if (!grid.pValues || interval <= 0.0)
+        return levels;
+
+    auto minValue = std::numeric_limits<float>::max();
+    auto maxValue = std::numeric_limits<float>::lowest();
+    const auto pEnd = grid.pValues + grid.width * grid.height;
+    for (auto pValue = grid.pValues; pValue != pEnd; pValue++)
+    {
+        const auto value = *pValue;
+        if (std::isnan(value) || (grid.hasNoData && value == grid.noData))
+            continue;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+    if (minValue > maxValue)
+        return levels;
+
+    const auto first = std::ceil((minValue - base) / interval);
+    const auto last = std::floor((maxValue - base) / interval);
+    for (auto k = first; k <= last && levels.size() < 10000; k += 1.0)
+        levels.push_back(base + k * interval);
+
+    return levels;
+}
+
+QList<OsmAnd::ContourGenerator::Contour> OsmAnd::ContourGenerator::generate(
+    const Grid& grid,
+    const QVector<double>& levels)
+{
+    QList<Contour> contours;
+    if (!grid.pValues || grid.width < 2 || grid.height < 2)
+        return contours;
+
+    // For each cell edge, two slots for segments that end on it. It's reused for all levels.
+    std::vector<int32_t> edgesSegments(grid.width * grid.height * 4, -1);
+    for (const auto level : levels)
+        generateForLevel(grid, level, edgesSegments, contours);
+
+    return contours;
+}
+
+QVector< QList<OsmAnd::ContourGenerator::Contour> > OsmAnd::ContourGenerator::generate(
+    const QVector<Grid>& grids,
+    const QVector< QVector<double> >& levels)
+{
+    QVector< QList<Contour> > contours(grids.size());
+    if (grids.isEmpty())
+        return contours;
+
+    struct State
+    {
+        QAtomicInt nextGridIndex;
+        QAtomicInt pendingGridsCount;
+        QMutex mutex;
+        QWaitCondition allGridsDone;
+    };
+    const auto state = std::make_shared<State>();
+    state->pendingGridsCount.storeRelease(grids.size());
+
+    const auto pContours = contours.data();
+    const auto processGrids =
+        [state, grids, levels, pContours]
+        ()
+        {
+            for (;;)
+            {
+                const auto gridIndex = state->nextGridIndex.fetchAndAddOrdered(1);
+                if (gridIndex >= grids.size())
+                    break;
+
+                pContours[gridIndex] = generate(grids[gridIndex], levels.value(gridIndex));
+
+                if (state->pendingGridsCount.fetchAndAddOrdered(-1) == 1)
+                {
+                    QMutexLocker scopedLocker(&state->mutex);
+                    state->allGridsDone.wakeAll();
+                }
+            }
+        };
+
+    static QThreadPool threadPool;
+    const auto helpersCount = qMin(grids.size() - 1, threadPool.maxThreadCount());
+    for (auto helperIndex = 0; helperIndex < helpersCount; helperIndex++)
+    {
+        const auto runnable = new QRunnableFunctor(
+            [processGrids]
+            (const QRunnableFunctor* const runnable)
+            {
+                Q_UNUSED(runnable);
+                processGrids();
+            });
+        runnable->setAutoDelete(true);
+        threadPool.start(runnable);
+    }
+
+    // Calling thread processes grids as well, so that progress is made even if pool is saturated
+    processGrids();
+
+    QMutexLocker scopedLocker(&state->mutex);
+    while (state->pendingGridsCount.loadAcquire() > 0)
+        state->allGridsDone.wait(&state->mutex);
+
+    return contours;
+}
+
+void OsmAnd::ContourGenerator::generateForLevel(
+    const Grid& grid,
+    const double level_,
+    std::vector<int32_t>& edgesSegments,
+    QList<Contour>& outContours)
+{
+    const auto level = static_cast<float>(level_);
+    const auto width = grid.width;
+    const auto height = grid.height;
+    const auto pValues = grid.pValues;
+
+    // Edge (x, y) -> (x + 1, y) has key 2 * (y * width + x), edge (x, y) -> (x, y + 1) has next key
+    const auto horizontalEdge =
+        [width]
+        (const uint32_t x, const uint32_t y) -> uint32_t
+        {
+            return 2 * (y * width + x);
+        };
+    const auto verticalEdge =
+        [width]
+        (const uint32_t x, const uint32_t y) -> uint32_t
+        {
+            return 2 * (y * width + x) + 1;
+        };
+
+    std::vector< std::array<uint32_t, 2> > segments;
+    const auto addSegment =
+        [&segments, &edgesSegments]
+        (const uint32_t edge0, const uint32_t edge1)
+        {
+            const auto segmentIndex = static_cast<int32_t>(segments.size());
+            segments.push_back({ { edge0, edge1 } });
+            for (const auto edge : { edge0, edge1 })
+            {
+                const auto slot = edgesSegments[2 * edge] < 0 ? 2 * edge : 2 * edge + 1;
+                edgesSegments[slot] = segmentIndex;
+            }
+        };
+
+    for (uint32_t y = 0; y + 1 < height; y++)
+    {
+        const auto pTop = pValues + y * width;
+        const auto pBottom = pTop + width;
+        for (uint32_t x = 0; x + 1 < width; x++)
+        {
+            const auto tl = pTop[x];
+            const auto tr = pTop[x + 1];
+            const auto br = pBottom[x + 1];
+            const auto bl = pBottom[x];
+            if (std::isnan(tl) || std::isnan(tr) || std::isnan(br) || std::isnan(bl))
+                continue;
+            if (grid.hasNoData &&
+                (tl == grid.noData || tr == grid.noData || br == grid.noData || bl == grid.noData))
+            {
+                continue;
+            }
+
+            const auto cellCase =
+                ((tl >= level) ? 8 : 0) | ((tr >= level) ? 4 : 0) | ((br >= level) ? 2 : 0) | ((bl >= level) ? 1 : 0);
+            if (cellCase == 0 || cellCase == 15)
+                continue;
+
+            const auto top = horizontalEdge(x, y);
+            const auto right = verticalEdge(x + 1, y);
+            const auto bottom = horizontalEdge(x, y + 1);
+            const auto left = verticalEdge(x, y);
+            switch (cellCase)
+            {
+                case 1:
+                case 14:
+                    addSegment(left, bottom);
+                    break;
+                case 2:
+                case 13:
+                    addSegment(bottom, right);
+                    break;
+                case 3:
+                case 12:
+                    addSegment(left, right);
+                    break;
+                case 4:
+                case 11:
+                    addSegment(top, right);
+                    break;
+                case 6:
+                case 9:
+                    addSegment(top, bottom);
+                    break;
+                case 7:
+                case 8:
+                    addSegment(left, top);
+                    break;
+                case 5:
+                case 10:
+                {
+                    // Saddle is resolved by value at cell center
+                    const auto centerAbove = (tl + tr + br + bl) * 0.25f >= level;
+                    if (centerAbove == (cellCase == 5))
+                    {
+                        addSegment(left, top);
+                        addSegment(bottom, right);
+                    }
+                    else
+                    {
+                        addSegment(top, right);
+                        addSegment(left, bottom);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    const auto edgePoint =
+        [pValues, width, level]
+        (const uint32_t edge) -> PointD
+        {
+            const auto index = edge / 2;
+            const auto x = index % width;
+            const auto y = index / width;
+            const auto isVertical = (edge & 1) != 0;
+            const auto a = pValues[index];
+            const auto b = pValues[isVertical ? index + width : index + 1];
+            const auto t = static_cast<double>(level - a) / static_cast<double>(b - a);
+            return isVertical
+                ? PointD(x + 0.5, y + t + 0.5)
+                : PointD(x + t + 0.5, y + 0.5);
+        };
+
+    // Join segments that share edges into polylines
+    std::vector<bool> usedSegments(segments.size(), false);
+    std::vector<uint32_t> forwardEdges;
+    std::vector<uint32_t> backwardEdges;
+    const auto walk =
+        [&segments, &edgesSegments, &usedSegments]
+        (int32_t segmentIndex, uint32_t edge, std::vector<uint32_t>& outEdges)
+        {
+            outEdges.clear();
+            for (;;)
+            {
+                const auto pSlots = &edgesSegments[2 * edge];
+                const auto nextSegmentIndex = pSlots[0] == segmentIndex ? pSlots[1] : pSlots[0];
+                if (nextSegmentIndex < 0 || usedSegments[nextSegmentIndex])
+                    break;
+                usedSegments[nextSegmentIndex] = true;
+
+                const auto& nextSegment = segments[nextSegmentIndex];
+                edge = nextSegment[0] == edge ? nextSegment[1] : nextSegment[0];
+                outEdges.push_back(edge);
+                segmentIndex = nextSegmentIndex;
+            }
+        };
+    for (int32_t segmentIndex = 0; segmentIndex < static_cast<int32_t>(segments.size()); segmentIndex++)
+    {
+        if (usedSegments[segmentIndex])
+            continue;
+        usedSegments[segmentIndex] = true;
+
+        const auto& segment = segments[segmentIndex];
+        walk(segmentIndex, segment[1], forwardEdges);
+        walk(segmentIndex, segment[0], backwardEdges);
+
+        Contour contour;
+        contour.level = level_;
+        contour.points.reserve(static_cast<int>(backwardEdges.size() + forwardEdges.size() + 2));
+        for (auto itEdge = backwardEdges.crbegin(); itEdge != backwardEdges.crend(); ++itEdge)
+            contour.points.push_back(edgePoint(*itEdge));
+        contour.points.push_back(edgePoint(segment[0]));
+        contour.points.push_back(edgePoint(segment[1]));
+        for (const auto edge : forwardEdges)
+            contour.points.push_back(edgePoint(edge));
+        outContours.push_back(contour);
+    }
+
+    // Restore scratch for next level
+    for (const auto& segment : segments)
+    {
+        for (const auto edge : segment)
+        {
+            edgesSegments[2 * edge] = -1;
+            edgesSegments[2 * edge + 1] = -1;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef _OSMAND_CORE_CONTOUR_GENERATOR_H_
+#define _OSMAND_CORE_CONTOUR_GENERATOR_H_
+
+#include "stdlib_common.h"
+#include <vector>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QList>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include <OsmAndCore/PointsAndAreas.h>
+
+namespace OsmAnd
+{
+    // Marching squares contour lines generator, that works directly on grid of values. Cell segments are joined
+    // into polylines, that are closed if contour doesn't leave the grid. Like in GDAL, values are sampled at
+    // pixel centers, so point (col + 0.5, row + 0.5) corresponds to value at [row][col].
+    class ContourGenerator Q_DECL_FINAL
+    {
+    public:
+        struct Grid
+        {
+            Grid();
+
+            const float* pValues;
+            uint32_t width;
+            uint32_t height;
+            bool hasNoData;
+            float noData;
+        };
+
+        struct Contour
+        {
+            double level;
+            // Points in pixel coordinates
+            QVector<PointD> points;
+        };
+
+    private:
+        ContourGenerator();
+        ~ContourGenerator();
+
+        static void generateForLevel(
+            const Grid& grid,
+            const double level,
+            std::vector<int32_t>& edgesSegments,
+            QList<Contour>& outContours);
+    public:
+        // Levels of form (base + k * interval), that are within range of grid values
+        static QVector<double> getIntervalLevels(const Grid& grid, const double interval, const double base = 0.0);
+
+        static QList<Contour> generate(const Grid& grid, const QVector<double>& levels);
+        // Grids are processed in parallel, including calling thread
+        static QVector< QList<Contour> > generate(const QVector<Grid>& grids, const QVector< QVector<double> >& levels);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_CONTOUR_GENERATOR_H_)
@@ -31,6 +31,24 @@ OsmAnd::ObfAddressSectionReader_P::~ObfAddressSectionReader_P()
 {
 }
 
+OsmAnd::ObfAddressSectionReader_P::NameIndex::NameIndex()
+{
+}
+
+OsmAnd::ObfAddressSectionReader_P::NameIndex::~NameIndex()
+{
+}
+
+size_t OsmAnd::ObfAddressSectionReader_P::NameIndex::getMemorySize() const
+{
+    auto memorySize = ObfNameIndex::getMemorySize();
+    memorySize += static_cast<size_t>(atoms.size()) * (sizeof(uint32_t) + sizeof(QVector<NameIndexDataAtom>));
+    for (const auto& blockAtoms : constOf(atoms))
+        memorySize += blockAtoms.capacity() * sizeof(NameIndexDataAtom);
+
+    return memorySize;
+}
+
 void OsmAnd::ObfAddressSectionReader_P::read(
     const ObfReader_P& reader,
     const std::shared_ptr<ObfAddressSectionInfo>& section)
@@ -893,17 +911,44 @@ void OsmAnd::ObfAddressSectionReader_P::readAddressesByName(
             case OBF::OsmAndAddressIndex::kNameIndexFieldNumber:
             {
                 const auto length = ObfReaderUtilities::readBigEndianInt(cis);
+                const auto offset = cis->CurrentPosition();
                 const auto oldLimit = cis->PushLimit(length);
 
-                scanNameIndex(
-                    reader,
-                    query,
-                    indexReferences,
-                    bbox31,
-                    streetGroupTypesFilter,
-                    includeStreets,
-                    strictMatch,
-                    queryController);
+                // Resident index is read once, then stream is returned to start of name index
+                const auto nameIndex = std::static_pointer_cast<const NameIndex>(reader.obtainNameIndex(
+                    section->offset,
+                    length,
+                    [&reader, cis, offset]
+                    () -> std::shared_ptr<const ObfNameIndex>
+                    {
+                        const auto nameIndex = readNameIndex(reader);
+                        cis->Seek(offset);
+                        return nameIndex;
+                    }));
+                if (nameIndex)
+                {
+                    lookupNameIndex(
+                        nameIndex,
+                        query,
+                        indexReferences,
+                        bbox31,
+                        streetGroupTypesFilter,
+                        includeStreets,
+                        strictMatch);
+                    cis->Skip(cis->BytesUntilLimit());
+                }
+                else
+                {
+                    scanNameIndex(
+                        reader,
+                        query,
+                        indexReferences,
+                        bbox31,
+                        streetGroupTypesFilter,
+                        includeStreets,
+                        strictMatch,
+                        queryController);
+                }
 
                 ObfReaderUtilities::ensureAllDataWasRead(cis);
                 cis->PopLimit(oldLimit);
@@ -1109,17 +1154,13 @@ void OsmAnd::ObfAddressSectionReader_P::scanNameIndex(
                     cis->ReadVarint32(&length);
                     const auto oldLimit = cis->PushLimit(length);
 
-                    readNameIndexData(
-                        reader,
-                        offset,
-                        outAddressReferences,
-                        bbox31,
-                        streetGroupTypesFilter,
-                        includeStreets,
-                        queryController);
+                    QVector<NameIndexDataAtom> atoms;
+                    readNameIndexData(reader, offset, atoms);
                     ObfReaderUtilities::ensureAllDataWasRead(cis);
 
                     cis->PopLimit(oldLimit);
+
+                    acceptNameIndexDataAtoms(atoms, outAddressReferences, bbox31, streetGroupTypesFilter, includeStreets);
                 }
                 cis->Skip(cis->BytesUntilLimit());
                 return;
@@ -1134,11 +1175,7 @@ void OsmAnd::ObfAddressSectionReader_P::scanNameIndex(
 void OsmAnd::ObfAddressSectionReader_P::readNameIndexData(
     const ObfReader_P& reader,
     const uint32_t baseOffset,
-    QVector<AddressReference>& outAddressReferences,
-    const AreaI* const bbox31,
-    const ObfAddressStreetGroupTypesMask streetGroupTypesFilter,
-    const bool includeStreets,
-    const std::shared_ptr<const IQueryController>& queryController)
+    QVector<NameIndexDataAtom>& outAtoms)
 {
     const auto cis = reader.getCodedInputStream().get();
 
@@ -1158,14 +1195,7 @@ void OsmAnd::ObfAddressSectionReader_P::readNameIndexData(
                 cis->ReadVarint32(&length);
                 const auto oldLimit = cis->PushLimit(length);
 
-                readNameIndexDataAtom(
-                    reader,
-                    baseOffset,
-                    outAddressReferences, 
-                    bbox31,
-                    streetGroupTypesFilter,
-                    includeStreets,
-                    queryController);
+                readNameIndexDataAtom(reader, baseOffset, outAtoms);
                 ObfReaderUtilities::ensureAllDataWasRead(cis);
 
                 cis->PopLimit(oldLimit);
@@ -1181,17 +1211,13 @@ void OsmAnd::ObfAddressSectionReader_P::readNameIndexData(
 void OsmAnd::ObfAddressSectionReader_P::readNameIndexDataAtom(
     const ObfReader_P& reader,
     const uint32_t baseOffset,
-    QVector<AddressReference>& outAddressReferences,
-    const AreaI* const bbox31,
-    const ObfAddressStreetGroupTypesMask streetGroupTypesFilter,
-    const bool includeStreets,
-    const std::shared_ptr<const IQueryController>& queryController)
+    QVector<NameIndexDataAtom>& outAtoms)
 {
     const auto cis = reader.getCodedInputStream().get();
 
-    AddressReference addressReference;
-    bool add = true;
-    
+    NameIndexDataAtom atom;
+    auto& addressReference = atom.addressReference;
+
     for (;;)
     {
         const auto tag = cis->ReadTag();
@@ -1199,14 +1225,14 @@ void OsmAnd::ObfAddressSectionReader_P::readNameIndexDataAtom(
         {
             case 0:
             {
-                if (!add || !ObfReaderUtilities::reachedDataEnd(cis))
+                if (!ObfReaderUtilities::reachedDataEnd(cis))
                     return;
 
                 if (addressReference.containerIndexOffset != 0)
                     addressReference.containerIndexOffset = baseOffset - addressReference.containerIndexOffset;
                 if (addressReference.dataIndexOffset != 0)
                     addressReference.dataIndexOffset = baseOffset - addressReference.dataIndexOffset;
-                outAddressReferences.push_back(addressReference);
+                outAtoms.push_back(atom);
 
                 return;
             }
@@ -1219,24 +1245,8 @@ void OsmAnd::ObfAddressSectionReader_P::readNameIndexDataAtom(
                 break;
             }
             case OBF::AddressNameIndexDataAtom::kTypeFieldNumber:
-            {
                 cis->ReadVarint32(reinterpret_cast<gpb::uint32*>(&addressReference.addressType));
-
-                auto shouldSkip = false;
-                if (addressReference.addressType == AddressNameIndexDataAtomType::Street)
-                    shouldSkip = shouldSkip || !includeStreets;
-                else
-                {
-                    shouldSkip = shouldSkip ||
-                        !streetGroupTypesFilter.isSet(static_cast<ObfAddressStreetGroupType>(addressReference.addressType));
-                }
-                if (shouldSkip)
-                {
-                    cis->Skip(cis->BytesUntilLimit());
-                    return;
-                }
                 break;
-            }
             case OBF::AddressNameIndexDataAtom::kShiftToIndexFieldNumber:
                 cis->ReadVarint32(reinterpret_cast<gpb::uint32*>(&addressReference.dataIndexOffset));
                 break;
@@ -1247,9 +1257,9 @@ void OsmAnd::ObfAddressSectionReader_P::readNameIndexDataAtom(
             {
                 gpb::uint32 xy16;
                 cis->ReadVarint32(reinterpret_cast<gpb::uint32*>(&xy16));
-                int x = (xy16 >> 16) << 15;
-                int y = (xy16 & ((1 << 16) - 1)) << 15;
-                add = !bbox31 || bbox31->contains(x, y);
+                atom.hasPosition = true;
+                atom.position31.x = (xy16 >> 16) << 15;
+                atom.position31.y = (xy16 & ((1 << 16) - 1)) << 15;
                 break;
             }
             default:
@@ -1259,6 +1269,113 @@ void OsmAnd::ObfAddressSectionReader_P::readNameIndexDataAtom(
     }
 }
 
+void OsmAnd::ObfAddressSectionReader_P::acceptNameIndexDataAtoms(
+    const QVector<NameIndexDataAtom>& atoms,
+    QVector<AddressReference>& outAddressReferences,
+    const AreaI* const bbox31,
+    const ObfAddressStreetGroupTypesMask streetGroupTypesFilter,
+    const bool includeStreets)
+{
+    for (const auto& atom : constOf(atoms))
+    {
+        const auto& addressReference = atom.addressReference;
+        if (addressReference.addressType == AddressNameIndexDataAtomType::Street)
+        {
+            if (!includeStreets)
+                continue;
+        }
+        else if (!streetGroupTypesFilter.isSet(static_cast<ObfAddressStreetGroupType>(addressReference.addressType)))
+            continue;
+
+        if (atom.hasPosition && bbox31 && !bbox31->contains(atom.position31))
+            continue;
+
+        outAddressReferences.push_back(addressReference);
+    }
+}
+
+std::shared_ptr<const OsmAnd::ObfNameIndex> OsmAnd::ObfAddressSectionReader_P::readNameIndex(
+    const ObfReader_P& reader)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    const std::shared_ptr<NameIndex> nameIndex(new NameIndex());
+    uint32_t baseOffset = 0;
+
+    for (;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch (gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+            case 0:
+                if (!ObfReaderUtilities::reachedDataEnd(cis))
+                    return nullptr;
+
+                return nameIndex;
+            case OBF::OsmAndAddressNameIndexData::kTableFieldNumber:
+            {
+                const auto length = ObfReaderUtilities::readBigEndianInt(cis);
+                baseOffset = cis->CurrentPosition();
+                const auto oldLimit = cis->PushLimit(length);
+
+                nameIndex->readTable(cis);
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+
+                cis->PopLimit(oldLimit);
+                break;
+            }
+            case OBF::OsmAndAddressNameIndexData::kAtomFieldNumber:
+            {
+                const auto intermediateOffsets = nameIndex->getValues();
+                for (const auto intermediateOffset : intermediateOffsets)
+                {
+                    const auto offset = baseOffset + intermediateOffset;
+                    cis->Seek(offset);
+
+                    gpb::uint32 length;
+                    cis->ReadVarint32(&length);
+                    const auto oldLimit = cis->PushLimit(length);
+
+                    auto& atoms = nameIndex->atoms[intermediateOffset];
+                    readNameIndexData(reader, offset, atoms);
+                    atoms.squeeze();
+                    ObfReaderUtilities::ensureAllDataWasRead(cis);
+
+                    cis->PopLimit(oldLimit);
+                }
+                cis->Skip(cis->BytesUntilLimit());
+                return nameIndex;
+            }
+            default:
+                ObfReaderUtilities::skipUnknownField(cis, tag);
+                break;
+        }
+    }
+}
+
+void OsmAnd::ObfAddressSectionReader_P::lookupNameIndex(
+    const std::shared_ptr<const NameIndex>& nameIndex,
+    const QString& query,
+    QVector<AddressReference>& outAddressReferences,
+    const AreaI* const bbox31,
+    const ObfAddressStreetGroupTypesMask streetGroupTypesFilter,
+    const bool includeStreets,
+    const bool strictMatch)
+{
+    QVector<uint32_t> intermediateOffsets;
+    nameIndex->scan(query, intermediateOffsets, strictMatch);
+
+    std::sort(intermediateOffsets);
+    for (const auto& intermediateOffset : constOf(intermediateOffsets))
+    {
+        const auto citAtoms = nameIndex->atoms.constFind(intermediateOffset);
+        if (citAtoms == nameIndex->atoms.cend())
+            continue;
+
+        acceptNameIndexDataAtoms(*citAtoms, outAddressReferences, bbox31, streetGroupTypesFilter, includeStreets);
+    }
+}
+
 void OsmAnd::ObfAddressSectionReader_P::loadStreetGroups(
     const ObfReader_P& reader,
     const std::shared_ptr<const ObfAddressSectionInfo>& section,
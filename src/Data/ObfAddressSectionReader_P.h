@@ -5,12 +5,17 @@
 #include <functional>
 
 #include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QHash>
+#include <QVector>
+#include "restore_internal_warnings.h"
 
 #include "OsmAndCore.h"
 #include "CommonTypes.h"
 #include "DataCommonTypes.h"
 #include "ObfAddressSectionReader.h"
 #include "ObfAddressSectionInfo.h"
+#include "ObfNameIndex.h"
 #include <OsmAndCore/CollatorStringMatcher.h>
 
 namespace OsmAnd
@@ -56,6 +61,30 @@ namespace OsmAnd
             return o1.dataIndexOffset < o2.dataIndexOffset;
         }
 
+        struct NameIndexDataAtom
+        {
+            NameIndexDataAtom()
+                : hasPosition(false)
+            {
+            }
+
+            AddressReference addressReference;
+            bool hasPosition;
+            PointI position31;
+        };
+
+        // Name index with atoms of its data blocks, by offset of block relative to the table
+        class NameIndex Q_DECL_FINAL : public ObfNameIndex
+        {
+        public:
+            NameIndex();
+            virtual ~NameIndex();
+
+            QHash< uint32_t, QVector<NameIndexDataAtom> > atoms;
+
+            virtual size_t getMemorySize() const Q_DECL_OVERRIDE;
+        };
+
     private:
         ObfAddressSectionReader_P();
         ~ObfAddressSectionReader_P();
@@ -150,19 +179,26 @@ namespace OsmAnd
         static void readNameIndexData(
             const ObfReader_P& reader,
             const uint32_t baseOffset,
-            QVector<AddressReference>& outAddressReferences,
-            const AreaI* const bbox31,
-            const ObfAddressStreetGroupTypesMask streetGroupTypesFilter,
-            const bool includeStreets,
-            const std::shared_ptr<const IQueryController>& queryController);
+            QVector<NameIndexDataAtom>& outAtoms);
         static void readNameIndexDataAtom(
             const ObfReader_P& reader,
             const uint32_t baseOffset,
+            QVector<NameIndexDataAtom>& outAtoms);
+        static void acceptNameIndexDataAtoms(
+            const QVector<NameIndexDataAtom>& atoms,
+            QVector<AddressReference>& outAddressReferences,
+            const AreaI* const bbox31,
+            const ObfAddressStreetGroupTypesMask streetGroupTypesFilter,
+            const bool includeStreets);
+        static std::shared_ptr<const ObfNameIndex> readNameIndex(const ObfReader_P& reader);
+        static void lookupNameIndex(
+            const std::shared_ptr<const NameIndex>& nameIndex,
+            const QString& query,
             QVector<AddressReference>& outAddressReferences,
             const AreaI* const bbox31,
             const ObfAddressStreetGroupTypesMask streetGroupTypesFilter,
             const bool includeStreets,
-            const std::shared_ptr<const IQueryController>& queryController);
+            const bool strictMatch);
     public:
         static void loadStreetGroups(
             const ObfReader_P& reader,
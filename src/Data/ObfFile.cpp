@@ -49,3 +49,13 @@ const QString OsmAnd::ObfFile::getRegionName() const
 
     return ls;
 }
+
+size_t OsmAnd::ObfFile::getNameIndexesMemoryBudget()
+{
+    return ObfFile_P::getNameIndexesMemoryBudget();
+}
+
+void OsmAnd::ObfFile::setNameIndexesMemoryBudget(const size_t budget)
+{
+    ObfFile_P::setNameIndexesMemoryBudget(budget);
+}
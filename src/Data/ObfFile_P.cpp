@@ -1,16 +1,119 @@
 #include "ObfFile_P.h"
+#include "ObfFile.h"
+
+#include "QFileMapping.h"
+#include "ObfNameIndex.h"
+
+namespace OsmAnd
+{
+    // Name indexes of all files share same budget, which is 0 (no resident indexes) by default
+    static QMutex nameIndexesBudgetMutex;
+    static size_t nameIndexesMemoryBudget = 0;
+    static size_t nameIndexesMemorySize = 0;
+}
 
 OsmAnd::ObfFile_P::ObfFile_P(ObfFile* owner_, const std::shared_ptr<const ObfInfo>& obfInfo_)
     : owner(owner_)
     , _obfInfo(obfInfo_)
+    , _nameIndexesMemorySize(0)
 {
 }
 
 OsmAnd::ObfFile_P::ObfFile_P(ObfFile* owner_)
     : owner(owner_)
+    , _nameIndexesMemorySize(0)
 {
 }
 
 OsmAnd::ObfFile_P::~ObfFile_P()
 {
+    QMutexLocker scopedLocker(&nameIndexesBudgetMutex);
+
+    nameIndexesMemorySize -= _nameIndexesMemorySize;
+}
+
+std::shared_ptr<const OsmAnd::QFileMapping> OsmAnd::ObfFile_P::obtainMemoryMapping() const
+{
+    QMutexLocker scopedLocker(&_memoryMappingMutex);
+
+    // Whole file is mapped only once and shared between all readers of this file
+    if (!_memoryMapping)
+    {
+        const std::shared_ptr<QFileMapping> memoryMapping(new QFileMapping(owner->filePath));
+        if (!memoryMapping->isMapped())
+            return nullptr;
+
+        // Tree nodes are visited in random order, so don't waste I/O on read-ahead by default
+        memoryMapping->advise(QFileMapping::AccessPattern::Random);
+
+        _memoryMapping = memoryMapping;
+    }
+
+    return _memoryMapping;
+}
+
+OsmAnd::ObfFile_P::NameIndexEntry::NameIndexEntry(const size_t memorySize_)
+    : memorySize(memorySize_)
+{
+}
+
+std::shared_ptr<const OsmAnd::ObfNameIndex> OsmAnd::ObfFile_P::obtainNameIndex(
+    const uint32_t sectionOffset,
+    const size_t estimatedMemorySize,
+    const std::function<std::shared_ptr<const ObfNameIndex> ()> buildNameIndex) const
+{
+    std::shared_ptr<NameIndexEntry> entry;
+    {
+        QMutexLocker scopedLocker(&_nameIndexesMutex);
+
+        auto& entryRef = _nameIndexes[sectionOffset];
+        if (!entryRef)
+            entryRef.reset(new NameIndexEntry(estimatedMemorySize));
+        entry = entryRef;
+    }
+
+    // Index is built only once, so concurrent searches in this section wait for it
+    QMutexLocker scopedEntryLocker(&entry->buildMutex);
+
+    if (entry->nameIndex)
+        return entry->nameIndex;
+
+    // Index that doesn't fit into what is left of budget isn't built, but may be once budget is enlarged or freed
+    {
+        QMutexLocker scopedBudgetLocker(&nameIndexesBudgetMutex);
+
+        if (nameIndexesMemorySize + entry->memorySize > nameIndexesMemoryBudget)
+            return nullptr;
+    }
+
+    const auto nameIndex = buildNameIndex();
+    if (!nameIndex)
+        return nullptr;
+    entry->memorySize = nameIndex->getMemorySize();
+
+    {
+        QMutexLocker scopedBudgetLocker(&nameIndexesBudgetMutex);
+
+        if (nameIndexesMemorySize + entry->memorySize > nameIndexesMemoryBudget)
+            return nullptr;
+        nameIndexesMemorySize += entry->memorySize;
+        _nameIndexesMemorySize += entry->memorySize;
+    }
+    entry->nameIndex = nameIndex;
+
+    return nameIndex;
+}
+
+size_t OsmAnd::ObfFile_P::getNameIndexesMemoryBudget()
+{
+    QMutexLocker scopedLocker(&nameIndexesBudgetMutex);
+
+    return nameIndexesMemoryBudget;
+}
+
+void OsmAnd::ObfFile_P::setNameIndexesMemoryBudget(const size_t budget)
+{
+    QMutexLocker scopedLocker(&nameIndexesBudgetMutex);
+
+    nameIndexesMemoryBudget = budget;
 }
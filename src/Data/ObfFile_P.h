@@ -2,18 +2,23 @@
 #define _OSMAND_CORE_OBF_FILE_P_H_
 
 #include "stdlib_common.h"
+#include <functional>
 
 #include "QtExtensions.h"
 #include <QMutex>
 #include <QWaitCondition>
+#include <QHash>
 
 #include "OsmAndCore.h"
 #include "PrivateImplementation.h"
 
 namespace OsmAnd
 {
+    class ObfReader;
     class ObfReader_P;
     class ObfInfo;
+    class QFileMapping;
+    class ObfNameIndex;
 
     class ObfFile;
     class ObfFile_P Q_DECL_FINAL
@@ -28,10 +33,36 @@ namespace OsmAnd
 
         mutable QMutex _obfInfoMutex;
         mutable std::shared_ptr<const ObfInfo> _obfInfo;
+
+        mutable QMutex _memoryMappingMutex;
+        mutable std::shared_ptr<const QFileMapping> _memoryMapping;
+        std::shared_ptr<const QFileMapping> obtainMemoryMapping() const;
+
+        // Name indexes by offset of section. Each one is built under its own lock, so that searches in other
+        // sections of this file don't wait for it. Memory size is estimated until index was built once.
+        struct NameIndexEntry
+        {
+            NameIndexEntry(const size_t memorySize);
+
+            QMutex buildMutex;
+            std::shared_ptr<const ObfNameIndex> nameIndex;
+            size_t memorySize;
+        };
+        mutable QMutex _nameIndexesMutex;
+        mutable QHash< uint32_t, std::shared_ptr<NameIndexEntry> > _nameIndexes;
+        mutable size_t _nameIndexesMemorySize;
+        std::shared_ptr<const ObfNameIndex> obtainNameIndex(
+            const uint32_t sectionOffset,
+            const size_t estimatedMemorySize,
+            const std::function<std::shared_ptr<const ObfNameIndex> ()> buildNameIndex) const;
+
+        static size_t getNameIndexesMemoryBudget();
+        static void setNameIndexesMemoryBudget(const size_t budget);
     public:
         virtual ~ObfFile_P();
 
     friend class OsmAnd::ObfFile;
+    friend class OsmAnd::ObfReader;
     friend class OsmAnd::ObfReader_P;
     };
 }
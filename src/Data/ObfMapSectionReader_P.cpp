@@ -1181,6 +1181,7 @@ void OsmAnd::ObfMapSectionReader_P::loadMapObjects(
 
                     gpb::uint32 length;
                     cis->ReadVarint32(&length);
+                    reader.adviseDataBlock(cis->TotalBytesRead(), length);
                     const auto oldLimit = cis->PushLimit(length);
 
                     readMapObjectsBlock(
@@ -1259,6 +1260,7 @@ void OsmAnd::ObfMapSectionReader_P::loadMapObjects(
                 cis->Seek(treeNode->dataOffset);
                 gpb::uint32 length;
                 cis->ReadVarint32(&length);
+                reader.adviseDataBlock(cis->TotalBytesRead(), length);
                 const auto oldLimit = cis->PushLimit(length);
 
                 readMapObjectsBlock(reader,
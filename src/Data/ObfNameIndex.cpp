@@ -0,0 +1,177 @@
+#include "ObfNameIndex.h"
+
+#include <algorithm>
+
+#include "ignore_warnings_on_external_includes.h"
+#include "OBF.pb.h"
+#include <google/protobuf/wire_format_lite.h>
+#include "restore_internal_warnings.h"
+
+#include "Common.h"
+#include "ObfReaderUtilities.h"
+
+OsmAnd::ObfNameIndex::ObfNameIndex()
+{
+}
+
+OsmAnd::ObfNameIndex::~ObfNameIndex()
+{
+}
+
+void OsmAnd::ObfNameIndex::readTable(gpb::io::CodedInputStream* cis)
+{
+    readTable(cis, QString());
+}
+
+void OsmAnd::ObfNameIndex::readTable(gpb::io::CodedInputStream* cis, const QString& keysPrefix)
+{
+    auto entryIndex = -1;
+
+    for (;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch (gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+            case 0:
+                if (!ObfReaderUtilities::reachedDataEnd(cis))
+                    return;
+
+                return;
+            case OBF::IndexedStringTable::kKeyFieldNumber:
+            {
+                Entry entry;
+                ObfReaderUtilities::readQString(cis, entry.key);
+                if (!keysPrefix.isEmpty())
+                    entry.key.prepend(keysPrefix);
+                CollatorStringMatcher_P::makeKey(entry.key, entry.collationKey);
+                entry.hasValue = false;
+                entry.value = 0;
+                entry.subtreeEnd = entries.size() + 1;
+
+                entryIndex = entries.size();
+                entries.push_back(qMove(entry));
+                break;
+            }
+            case OBF::IndexedStringTable::kValFieldNumber:
+            {
+                const auto value = ObfReaderUtilities::readBigEndianInt(cis);
+                if (entryIndex < 0)
+                    break;
+
+                // Another value of same key is kept as separate entry without subtable
+                if (entries[entryIndex].hasValue)
+                {
+                    auto entry = entries[entryIndex];
+                    entry.subtreeEnd = entries.size() + 1;
+                    entryIndex = entries.size();
+                    entries.push_back(qMove(entry));
+                }
+                auto& entry = entries[entryIndex];
+                entry.hasValue = true;
+                entry.value = value;
+                break;
+            }
+            case OBF::IndexedStringTable::kSubtablesFieldNumber:
+            {
+                const auto length = ObfReaderUtilities::readLength(cis);
+                const auto oldLimit = cis->PushLimit(length);
+
+                if (entryIndex >= 0 && entries[entryIndex].subtreeEnd == entries.size())
+                {
+                    const auto keysPrefix = entries[entryIndex].key;
+                    readTable(cis, keysPrefix);
+                    entries[entryIndex].subtreeEnd = entries.size();
+                }
+                else
+                    cis->Skip(cis->BytesUntilLimit());
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(oldLimit);
+                break;
+            }
+            default:
+                ObfReaderUtilities::skipUnknownField(cis, tag);
+                break;
+        }
+    }
+}
+
+QVector<uint32_t> OsmAnd::ObfNameIndex::getValues() const
+{
+    QVector<uint32_t> values;
+    values.reserve(entries.size());
+    for (const auto& entry : constOf(entries))
+    {
+        if (entry.hasValue)
+            values.push_back(entry.value);
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+
+    return values;
+}
+
+int OsmAnd::ObfNameIndex::scan(
+    const QString& query,
+    QVector<uint32_t>& outValues,
+    const bool strictMatch /*= false*/) const
+{
+    CollatorStringMatcher_P::Key queryKey;
+    if (!strictMatch)
+        CollatorStringMatcher_P::makeKey(query, queryKey);
+
+    return scan(query, queryKey, outValues, strictMatch, 0, entries.size(), 0);
+}
+
+int OsmAnd::ObfNameIndex::scan(
+    const QString& query,
+    const CollatorStringMatcher_P::Key& queryKey,
+    QVector<uint32_t>& outValues,
+    const bool strictMatch,
+    const int begin,
+    const int end,
+    const int matchedCharactersCount_) const
+{
+    auto matchedCharactersCount = matchedCharactersCount_;
+
+    // Keys that don't match are skipped along with their subtables
+    for (auto entryIndex = begin; entryIndex < end; entryIndex = entries[entryIndex].subtreeEnd)
+    {
+        const auto& entry = entries[entryIndex];
+        const auto keyMatchedCharactersCount = ObfReaderUtilities::matchIndexedStringTableKey(
+            entry.key, entry.collationKey, query, queryKey, strictMatch);
+        if (keyMatchedCharactersCount < 0)
+            continue;
+
+        if (keyMatchedCharactersCount > matchedCharactersCount)
+        {
+            matchedCharactersCount = keyMatchedCharactersCount;
+            outValues.clear();
+        }
+        else if (keyMatchedCharactersCount < matchedCharactersCount)
+            continue;
+
+        if (entry.hasValue)
+            outValues.push_back(entry.value);
+        if (entry.subtreeEnd > entryIndex + 1)
+        {
+            matchedCharactersCount = scan(
+                query, queryKey, outValues, strictMatch, entryIndex + 1, entry.subtreeEnd, matchedCharactersCount);
+        }
+    }
+
+    return matchedCharactersCount;
+}
+
+size_t OsmAnd::ObfNameIndex::getMemorySize() const
+{
+    auto memorySize = static_cast<size_t>(entries.capacity()) * sizeof(Entry);
+    for (const auto& entry : constOf(entries))
+    {
+        memorySize += entry.key.capacity() * sizeof(QChar);
+        memorySize += entry.collationKey.weights.capacity() * sizeof(uint32_t);
+        memorySize += entry.collationKey.flags.capacity() * sizeof(uint8_t);
+    }
+
+    return memorySize;
+}
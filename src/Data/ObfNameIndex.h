@@ -0,0 +1,68 @@
+#ifndef _OSMAND_CORE_OBF_NAME_INDEX_H_
+#define _OSMAND_CORE_OBF_NAME_INDEX_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QString>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "ignore_warnings_on_external_includes.h"
+#include <google/protobuf/io/coded_stream.h>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CollatorStringMatcher_P.h"
+
+namespace OsmAnd
+{
+    namespace gpb = google::protobuf;
+
+    // Resident copy of IndexedStringTable of OBF section name index, with collation keys of all keys made once.
+    // Entries are kept in order of the table, so lookups give exactly same values as scanning it in file.
+    // Data atoms, that values point to, are kept by section-specific subclasses.
+    class ObfNameIndex
+    {
+        Q_DISABLE_COPY_AND_MOVE(ObfNameIndex);
+    public:
+        struct Entry
+        {
+            // Key with prefixes of all parent keys
+            QString key;
+            CollatorStringMatcher_P::Key collationKey;
+            bool hasValue;
+            uint32_t value;
+            // Index that follows last entry of subtable of this key
+            int subtreeEnd;
+        };
+
+    private:
+        int scan(
+            const QString& query,
+            const CollatorStringMatcher_P::Key& queryKey,
+            QVector<uint32_t>& outValues,
+            const bool strictMatch,
+            const int begin,
+            const int end,
+            const int matchedCharactersCount) const;
+        void readTable(gpb::io::CodedInputStream* cis, const QString& keysPrefix);
+    protected:
+        ObfNameIndex();
+    public:
+        virtual ~ObfNameIndex();
+
+        QVector<Entry> entries;
+
+        void readTable(gpb::io::CodedInputStream* cis);
+        // Sorted distinct values of all entries
+        QVector<uint32_t> getValues() const;
+        // Same as ObfReaderUtilities::scanIndexedStringTable()
+        int scan(const QString& query, QVector<uint32_t>& outValues, const bool strictMatch = false) const;
+
+        virtual size_t getMemorySize() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_OBF_NAME_INDEX_H_)
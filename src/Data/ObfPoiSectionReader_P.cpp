@@ -35,6 +35,24 @@ OsmAnd::ObfPoiSectionReader_P::~ObfPoiSectionReader_P()
 {
 }
 
+OsmAnd::ObfPoiSectionReader_P::NameIndex::NameIndex()
+{
+}
+
+OsmAnd::ObfPoiSectionReader_P::NameIndex::~NameIndex()
+{
+}
+
+size_t OsmAnd::ObfPoiSectionReader_P::NameIndex::getMemorySize() const
+{
+    auto memorySize = ObfNameIndex::getMemorySize();
+    memorySize += static_cast<size_t>(atoms.size()) * (sizeof(uint32_t) + sizeof(QVector<NameIndexDataAtom>));
+    for (const auto& blockAtoms : constOf(atoms))
+        memorySize += blockAtoms.capacity() * sizeof(NameIndexDataAtom);
+
+    return memorySize;
+}
+
 void OsmAnd::ObfPoiSectionReader_P::read(
     const ObfReader_P& reader,
     const std::shared_ptr<ObfPoiSectionInfo>& section)
@@ -892,7 +910,7 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenity(
                 if (!ObfReaderUtilities::reachedDataEnd(cis))
                     return;
 
-                QList<QString> additionalNames;
+                QStringList additionalNames;
 
                 auto itStringOrDataValue = mutableIteratorOf(stringOrDataValues);
                 while (itStringOrDataValue.hasNext())
@@ -959,6 +977,7 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenity(
 
                 amenity->nativeName = qMove(nativeName);
                 amenity->localizedNames = qMove(localizedNames);
+                amenity->additionalNames = qMove(additionalNames);
                 if (precisionXY > 0)
                 {
                     int xBase = position31.x >> BASE_POI_SHIFT;
@@ -1172,13 +1191,38 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenitiesByName(
                 const auto offset = cis->CurrentPosition();
                 const auto oldLimit = cis->PushLimit(length);
 
-                scanNameIndex(
-                    reader,
-                    query,
-                    dataBoxesOffsetsSet,
-                    xy31,
-                    bbox31,
-                    tileFilter);
+                // Resident index is read once, then stream is returned to start of name index
+                const auto nameIndex = std::static_pointer_cast<const NameIndex>(reader.obtainNameIndex(
+                    section->offset,
+                    length,
+                    [&reader, cis, offset]
+                    () -> std::shared_ptr<const ObfNameIndex>
+                    {
+                        const auto nameIndex = readNameIndex(reader);
+                        cis->Seek(offset);
+                        return nameIndex;
+                    }));
+                if (nameIndex)
+                {
+                    lookupNameIndex(
+                        nameIndex,
+                        query,
+                        dataBoxesOffsetsSet,
+                        xy31,
+                        bbox31,
+                        tileFilter);
+                    cis->Skip(cis->BytesUntilLimit());
+                }
+                else
+                {
+                    scanNameIndex(
+                        reader,
+                        query,
+                        dataBoxesOffsetsSet,
+                        xy31,
+                        bbox31,
+                        tileFilter);
+                }
 
                 ObfReaderUtilities::ensureAllDataWasRead(cis);
                 cis->PopLimit(oldLimit);
@@ -1306,15 +1350,13 @@ void OsmAnd::ObfPoiSectionReader_P::scanNameIndex(
                     cis->ReadVarint32(&length);
                     const auto oldLimit = cis->PushLimit(length);
 
-                    readNameIndexData(
-                        reader,
-                        outDataOffsets,
-                        xy31,
-                        bbox31, 
-                        tileFilter);
+                    QVector<NameIndexDataAtom> atoms;
+                    readNameIndexData(reader, atoms);
                     ObfReaderUtilities::ensureAllDataWasRead(cis);
 
                     cis->PopLimit(oldLimit);
+
+                    acceptNameIndexDataAtoms(atoms, outDataOffsets, xy31, bbox31, tileFilter);
                 }
                 cis->Skip(cis->BytesUntilLimit());
                 return;
@@ -1328,10 +1370,7 @@ void OsmAnd::ObfPoiSectionReader_P::scanNameIndex(
 
 void OsmAnd::ObfPoiSectionReader_P::readNameIndexData(
     const ObfReader_P& reader,
-    QMap<uint32_t, uint32_t>& outDataOffsets,
-    const PointI* const xy31,
-    const AreaI* const bbox31,
-    const TileAcceptorFunction tileFilter)
+    QVector<NameIndexDataAtom>& outAtoms)
 {
     const auto cis = reader.getCodedInputStream().get();
 
@@ -1351,12 +1390,7 @@ void OsmAnd::ObfPoiSectionReader_P::readNameIndexData(
                 cis->ReadVarint32(&length);
                 const auto oldLimit = cis->PushLimit(length);
 
-                readNameIndexDataAtom(
-                    reader,
-                    outDataOffsets,
-                    xy31,
-                    bbox31,
-                    tileFilter);
+                readNameIndexDataAtom(reader, outAtoms);
                 ObfReaderUtilities::ensureAllDataWasRead(cis);
 
                 cis->PopLimit(oldLimit);
@@ -1371,10 +1405,7 @@ void OsmAnd::ObfPoiSectionReader_P::readNameIndexData(
 
 void OsmAnd::ObfPoiSectionReader_P::readNameIndexDataAtom(
     const ObfReader_P& reader,
-    QMap<uint32_t, uint32_t>& outDataOffsets,
-    const PointI* const xy31,
-    const AreaI* const bbox31,
-    const TileAcceptorFunction tileFilter)
+    QVector<NameIndexDataAtom>& outAtoms)
 {
     const auto cis = reader.getCodedInputStream().get();
     auto tileId = TileId::zero();
@@ -1401,29 +1432,101 @@ void OsmAnd::ObfPoiSectionReader_P::readNameIndexDataAtom(
                 break;
             case OBF::OsmAndPoiNameIndexDataAtom::kShiftToFieldNumber:
             {
-                const auto dataOffset = ObfReaderUtilities::readBigEndianInt(cis);
+                NameIndexDataAtom atom;
+                atom.tileId = tileId;
+                atom.zoom = zoom;
+                atom.dataOffset = ObfReaderUtilities::readBigEndianInt(cis);
+                outAtoms.push_back(atom);
+                break;
+            }
+            default:
+                ObfReaderUtilities::skipUnknownField(cis, tag);
+                break;
+        }
+    }
+}
 
-                bool accept = true;
+void OsmAnd::ObfPoiSectionReader_P::acceptNameIndexDataAtoms(
+    const QVector<NameIndexDataAtom>& atoms,
+    QMap<uint32_t, uint32_t>& outDataOffsets,
+    const PointI* const xy31,
+    const AreaI* const bbox31,
+    const TileAcceptorFunction tileFilter)
+{
+    for (const auto& atom : constOf(atoms))
+    {
+        bool accept = true;
 
-                if (accept && tileFilter)
-                    accept = tileFilter(tileId, zoom);
+        if (accept && tileFilter)
+            accept = tileFilter(atom.tileId, atom.zoom);
 
-                PointI position31;
-                uint32_t d = 0;
-                if (accept && bbox31)
-                {
-                    position31.x = tileId.x << (31 - zoom);
-                    position31.y = tileId.y << (31 - zoom);
-                    accept = bbox31->contains(position31);
-                }
+        PointI position31;
+        uint32_t d = 0;
+        if (accept && bbox31)
+        {
+            position31.x = atom.tileId.x << (31 - atom.zoom);
+            position31.y = atom.tileId.y << (31 - atom.zoom);
+            accept = bbox31->contains(position31);
+        }
+
+        if (accept)
+        {
+            if (xy31)
+                d = qAbs(xy31->x - position31.x) + qAbs(xy31->y - position31.y);
+            outDataOffsets.insert(atom.dataOffset, d);
+        }
+    }
+}
+
+std::shared_ptr<const OsmAnd::ObfNameIndex> OsmAnd::ObfPoiSectionReader_P::readNameIndex(const ObfReader_P& reader)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    const std::shared_ptr<NameIndex> nameIndex(new NameIndex());
+    uint32_t baseOffset = 0;
+
+    for (;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch (gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+            case 0:
+                if (!ObfReaderUtilities::reachedDataEnd(cis))
+                    return nullptr;
+
+                return nameIndex;
+            case OBF::OsmAndPoiNameIndex::kTableFieldNumber:
+            {
+                const auto length = ObfReaderUtilities::readBigEndianInt(cis);
+                baseOffset = cis->CurrentPosition();
+                const auto oldLimit = cis->PushLimit(length);
+
+                nameIndex->readTable(cis);
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
 
-                if (accept)
+                cis->PopLimit(oldLimit);
+                break;
+            }
+            case OBF::OsmAndPoiNameIndex::kDataFieldNumber:
+            {
+                const auto intermediateOffsets = nameIndex->getValues();
+                for (const auto intermediateOffset : intermediateOffsets)
                 {
-                    if (xy31)
-                        d = qAbs(xy31->x - position31.x) + qAbs(xy31->y - position31.y);
-                    outDataOffsets.insert(dataOffset, d);
+                    cis->Seek(baseOffset + intermediateOffset);
+
+                    gpb::uint32 length;
+                    cis->ReadVarint32(&length);
+                    const auto oldLimit = cis->PushLimit(length);
+
+                    auto& atoms = nameIndex->atoms[intermediateOffset];
+                    readNameIndexData(reader, atoms);
+                    atoms.squeeze();
+                    ObfReaderUtilities::ensureAllDataWasRead(cis);
+
+                    cis->PopLimit(oldLimit);
                 }
-                break;
+                cis->Skip(cis->BytesUntilLimit());
+                return nameIndex;
             }
             default:
                 ObfReaderUtilities::skipUnknownField(cis, tag);
@@ -1432,6 +1535,26 @@ void OsmAnd::ObfPoiSectionReader_P::readNameIndexDataAtom(
     }
 }
 
+void OsmAnd::ObfPoiSectionReader_P::lookupNameIndex(
+    const std::shared_ptr<const NameIndex>& nameIndex,
+    const QString& query,
+    QMap<uint32_t, uint32_t>& outDataOffsets,
+    const PointI* const xy31,
+    const AreaI* const bbox31,
+    const TileAcceptorFunction tileFilter)
+{
+    QVector<uint32_t> intermediateOffsets;
+    nameIndex->scan(query, intermediateOffsets);
+
+    std::sort(intermediateOffsets);
+    for (const auto& intermediateOffset : constOf(intermediateOffsets))
+    {
+        const auto citAtoms = nameIndex->atoms.constFind(intermediateOffset);
+        if (citAtoms != nameIndex->atoms.cend())
+            acceptNameIndexDataAtoms(*citAtoms, outDataOffsets, xy31, bbox31, tileFilter);
+    }
+}
+
 void OsmAnd::ObfPoiSectionReader_P::loadCategories(
     const ObfReader_P& reader,
     const std::shared_ptr<const ObfPoiSectionInfo>& section,
@@ -7,6 +7,8 @@
 #include "QtExtensions.h"
 #include "ignore_warnings_on_external_includes.h"
 #include <QMap>
+#include <QHash>
+#include <QVector>
 #include "restore_internal_warnings.h"
 
 #include "OsmAndCore.h"
@@ -14,6 +16,7 @@
 #include "DataCommonTypes.h"
 #include "ObfPoiSectionReader.h"
 #include "ObfPoiSectionInfo.h"
+#include "ObfNameIndex.h"
 
 namespace OsmAnd
 {
@@ -28,6 +31,25 @@ namespace OsmAnd
     public:
         typedef ObfPoiSectionReader::VisitorFunction VisitorFunction;
 
+        struct NameIndexDataAtom
+        {
+            TileId tileId;
+            ZoomLevel zoom;
+            uint32_t dataOffset;
+        };
+
+        // Name index with atoms of its data blocks, by offset of block relative to the table
+        class NameIndex Q_DECL_FINAL : public ObfNameIndex
+        {
+        public:
+            NameIndex();
+            virtual ~NameIndex();
+
+            QHash< uint32_t, QVector<NameIndexDataAtom> > atoms;
+
+            virtual size_t getMemorySize() const Q_DECL_OVERRIDE;
+        };
+
     private:
         ObfPoiSectionReader_P();
         ~ObfPoiSectionReader_P();
@@ -109,12 +131,20 @@ namespace OsmAnd
             const TileAcceptorFunction tileFilter);
         static void readNameIndexData(
             const ObfReader_P& reader,
+            QVector<NameIndexDataAtom>& outAtoms);
+        static void readNameIndexDataAtom(
+            const ObfReader_P& reader,
+            QVector<NameIndexDataAtom>& outAtoms);
+        static void acceptNameIndexDataAtoms(
+            const QVector<NameIndexDataAtom>& atoms,
             QMap<uint32_t, uint32_t>& outDataOffsets,
             const PointI* const xy31,
             const AreaI* const bbox31,
             const TileAcceptorFunction tileFilter);
-        static void readNameIndexDataAtom(
-            const ObfReader_P& reader,
+        static std::shared_ptr<const ObfNameIndex> readNameIndex(const ObfReader_P& reader);
+        static void lookupNameIndex(
+            const std::shared_ptr<const NameIndex>& nameIndex,
+            const QString& query,
             QMap<uint32_t, uint32_t>& outDataOffsets,
             const PointI* const xy31,
             const AreaI* const bbox31,
@@ -4,9 +4,13 @@
 #include <QFile>
 
 #include "ObfFile.h"
+#include "ObfFile_P.h"
 
-OsmAnd::ObfReader::ObfReader(const std::shared_ptr<const ObfFile>& obfFile_)
-    : _p(new ObfReader_P(this, std::shared_ptr<QIODevice>(new QFile(obfFile_->filePath))))
+OsmAnd::ObfReader::ObfReader(const std::shared_ptr<const ObfFile>& obfFile_, const bool useSharedMemoryMapping /*= false*/)
+    : _p(new ObfReader_P(
+        this,
+        std::shared_ptr<QIODevice>(new QFile(obfFile_->filePath)),
+        useSharedMemoryMapping ? obfFile_->_p->obtainMemoryMapping() : nullptr))
     , obfFile(obfFile_)
 {
     open();
@@ -38,6 +42,11 @@ bool OsmAnd::ObfReader::close()
     return _p->close();
 }
 
+bool OsmAnd::ObfReader::rewind()
+{
+    return _p->rewind();
+}
+
 std::shared_ptr<const OsmAnd::ObfInfo> OsmAnd::ObfReader::obtainInfo() const
 {
     return _p->obtainInfo();
@@ -13,7 +13,6 @@
 
 #include "ObfSectionInfo.h"
 #include "Logging.h"
-#include "CollatorStringMatcher.h"
 
 bool OsmAnd::ObfReaderUtilities::readQString(gpb::io::CodedInputStream* cis, QString& output)
 {
@@ -90,9 +89,28 @@ int OsmAnd::ObfReaderUtilities::scanIndexedStringTable(
     QVector<uint32_t>& outValues,
     const bool strictMatch /*= false*/,
     const QString& keysPrefix /*= QString::null*/,
-    const int matchedCharactersCount_ /*= 0*/)
+    const int matchedCharactersCount /*= 0*/)
+{
+    // Collation key of query is made once for whole table
+    CollatorStringMatcher_P::Key queryKey;
+    if (!strictMatch)
+        CollatorStringMatcher_P::makeKey(query, queryKey);
+
+    return scanIndexedStringTable(
+        cis, query, queryKey, outValues, strictMatch, keysPrefix, matchedCharactersCount);
+}
+
+int OsmAnd::ObfReaderUtilities::scanIndexedStringTable(
+    gpb::io::CodedInputStream* cis,
+    const QString& query,
+    const CollatorStringMatcher_P::Key& queryKey,
+    QVector<uint32_t>& outValues,
+    const bool strictMatch,
+    const QString& keysPrefix,
+    const int matchedCharactersCount_)
 {
     QString key;
+    CollatorStringMatcher_P::Key keyKey;
     auto matchedCharactersCount = matchedCharactersCount_;
 
     for (;;)
@@ -111,46 +129,22 @@ int OsmAnd::ObfReaderUtilities::scanIndexedStringTable(
                 if (!keysPrefix.isEmpty())
                     key.prepend(keysPrefix);
 
-                bool matchesForward = false;
-                bool matchesBackward = false;
-                if (strictMatch)
-                    matchesForward = key.startsWith(query, Qt::CaseInsensitive);
-                else
-                    matchesForward = CollatorStringMatcher::cmatches(key, query, StringMatcherMode::CHECK_ONLY_STARTS_WITH);
+                // Same key serves both directions
+                if (!strictMatch)
+                    CollatorStringMatcher_P::makeKey(key, keyKey);
+                const auto keyMatchedCharactersCount =
+                    matchIndexedStringTableKey(key, keyKey, query, queryKey, strictMatch);
 
-                if (!matchesForward)
+                if (keyMatchedCharactersCount < 0)
                 {
-                    if (strictMatch)
-                        matchesBackward = query.startsWith(key, Qt::CaseInsensitive);
-                    else
-                        matchesBackward = CollatorStringMatcher::cmatches(query, key, StringMatcherMode::CHECK_ONLY_STARTS_WITH);
-                }
-
-                if (matchesForward)
-                {
-                    if (query.length() > matchedCharactersCount)
-                    {
-                        matchedCharactersCount = query.length();
-                        outValues.clear();
-                    }
-                    else if (query.length() < matchedCharactersCount)
-                    {
-                        key = QString::null;
-                    }
+                    key = QString::null;
                 }
-                else if (matchesBackward)
+                else if (keyMatchedCharactersCount > matchedCharactersCount)
                 {
-                    if (key.length() > matchedCharactersCount)
-                    {
-                        matchedCharactersCount = key.length();
-                        outValues.clear();
-                    }
-                    else if (key.length() < matchedCharactersCount)
-                    {
-                        key = QString::null;
-                    }
+                    matchedCharactersCount = keyMatchedCharactersCount;
+                    outValues.clear();
                 }
-                else
+                else if (keyMatchedCharactersCount < matchedCharactersCount)
                 {
                     key = QString::null;
                 }
@@ -170,7 +164,8 @@ int OsmAnd::ObfReaderUtilities::scanIndexedStringTable(
                 const auto oldLimit = cis->PushLimit(length);
 
                 if (!key.isNull())
-                    matchedCharactersCount = scanIndexedStringTable(cis, query, outValues, strictMatch, key, matchedCharactersCount);
+                    matchedCharactersCount = scanIndexedStringTable(
+                        cis, query, queryKey, outValues, strictMatch, key, matchedCharactersCount);
                 else
                     cis->Skip(cis->BytesUntilLimit());
 
@@ -186,6 +181,29 @@ int OsmAnd::ObfReaderUtilities::scanIndexedStringTable(
     }
 }
 
+int OsmAnd::ObfReaderUtilities::matchIndexedStringTableKey(
+    const QString& key,
+    const CollatorStringMatcher_P::Key& keyKey,
+    const QString& query,
+    const CollatorStringMatcher_P::Key& queryKey,
+    const bool strictMatch)
+{
+    if (strictMatch)
+    {
+        if (key.startsWith(query, Qt::CaseInsensitive))
+            return query.length();
+        if (query.startsWith(key, Qt::CaseInsensitive))
+            return key.length();
+        return -1;
+    }
+
+    if (CollatorStringMatcher_P::startsWith(keyKey, queryKey, true, false, false))
+        return query.length();
+    if (CollatorStringMatcher_P::startsWith(queryKey, keyKey, true, false, false))
+        return key.length();
+    return -1;
+}
+
 void OsmAnd::ObfReaderUtilities::readTileBox(gpb::io::CodedInputStream* cis, AreaI& outArea)
 {
     for (;;)
@@ -16,6 +16,7 @@
 
 #include "OsmAndCore.h"
 #include "PointsAndAreas.h"
+#include "CollatorStringMatcher_P.h"
 
 namespace OsmAnd
 {
@@ -26,6 +27,16 @@ namespace OsmAnd
 
     struct ObfReaderUtilities Q_DECL_FINAL
     {
+    private:
+        static int scanIndexedStringTable(
+            gpb::io::CodedInputStream* cis,
+            const QString& query,
+            const CollatorStringMatcher_P::Key& queryKey,
+            QVector<uint32_t>& outValues,
+            const bool strictMatch,
+            const QString& keysPrefix,
+            const int matchedCharactersCount);
+    public:
         static bool readQString(gpb::io::CodedInputStream* cis, QString& output);
         static int32_t readSInt32(gpb::io::CodedInputStream* cis);
         static int64_t readSInt64(gpb::io::CodedInputStream* cis);
@@ -39,6 +50,13 @@ namespace OsmAnd
             const bool strictMatch = false,
             const QString& keysPrefix = QString(),
             const int matchedCharactersCount = 0);
+        // Number of characters key of indexed string table and query match by, or -1 if they don't match
+        static int matchIndexedStringTableKey(
+            const QString& key,
+            const CollatorStringMatcher_P::Key& keyKey,
+            const QString& query,
+            const CollatorStringMatcher_P::Key& queryKey,
+            const bool strictMatch);
         static void readTileBox(gpb::io::CodedInputStream* cis, AreaI& outArea);
 
         static void skipUnknownField(gpb::io::CodedInputStream* cis, int tag);
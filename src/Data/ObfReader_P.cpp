@@ -11,6 +11,8 @@
 
 #include "QIODeviceInputStream.h"
 #include "QFileDeviceInputStream.h"
+#include "QFileMapping.h"
+#include "QFileMappingInputStream.h"
 #include "ObfFile.h"
 #include "ObfFile_P.h"
 #include "ObfInfo.h"
@@ -25,6 +27,7 @@
 #include "ObfPoiSectionInfo.h"
 #include "ObfPoiSectionReader_P.h"
 #include "ObfReaderUtilities.h"
+#include "ObfNameIndex.h"
 #include "Logging.h"
 
 //#define OSMAND_TRACE_OBF_READERS 1
@@ -36,8 +39,10 @@ using google::protobuf::internal::WireFormatLite;
 
 OsmAnd::ObfReader_P::ObfReader_P(
     ObfReader* const owner_,
-    const std::shared_ptr<QIODevice>& input_)
+    const std::shared_ptr<QIODevice>& input_,
+    const std::shared_ptr<const QFileMapping>& memoryMapping_ /*= nullptr*/)
     : _input(input_)
+    , _memoryMapping(memoryMapping_)
 #if OSMAND_VERIFY_OBF_READER_THREAD
     , _threadId(QThread::currentThreadId())
 #endif // OSMAND_VERIFY_OBF_READER_THREAD
@@ -75,16 +80,16 @@ bool OsmAnd::ObfReader_P::open()
 
     // Create zero-copy input stream
     gpb::io::ZeroCopyInputStream* zcis = nullptr;
-    if (const auto inputFileDevice = std::dynamic_pointer_cast<QFileDevice>(_input))
+    if (_memoryMapping)
+        zcis = new QFileMappingInputStream(_memoryMapping);
+    else if (const auto inputFileDevice = std::dynamic_pointer_cast<QFileDevice>(_input))
         zcis = new QFileDeviceInputStream(inputFileDevice);
     else
         zcis = new QIODeviceInputStream(_input);
     _zeroCopyInputStream.reset(zcis);
 
     // Create coded input stream wrapper
-    const auto cis = new gpb::io::CodedInputStream(zcis);
-    cis->SetTotalBytesLimit(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-    _codedInputStream.reset(cis);
+    createCodedInputStream();
 
 #if OSMAND_TRACE_OBF_READERS
     if (const auto inputFileDevice = std::dynamic_pointer_cast<QFileDevice>(_input))
@@ -140,6 +145,50 @@ bool OsmAnd::ObfReader_P::close()
     return true;
 }
 
+void OsmAnd::ObfReader_P::createCodedInputStream()
+{
+    const auto cis = new gpb::io::CodedInputStream(_zeroCopyInputStream.get());
+    cis->SetTotalBytesLimit(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+    _codedInputStream.reset(cis);
+}
+
+bool OsmAnd::ObfReader_P::rewind()
+{
+#if OSMAND_VERIFY_OBF_READER_THREAD
+    if (_threadId != QThread::currentThreadId())
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "ObfReader(%p) was accessed from thread %p, but created in thread %p",
+            owner.get(),
+            QThread::currentThreadId(),
+            _threadId);
+#   if OSMAND_VERIFY_OBF_READER_THREAD > 1
+        assert(false);
+#   endif // OSMAND_VERIFY_OBF_READER_THREAD > 1
+    }
+#endif // OSMAND_VERIFY_OBF_READER_THREAD
+
+    if (!isOpened())
+        return false;
+
+    // Destroy coded input stream first, so that all pushed limits are dropped and
+    // unread buffer is returned back to zero-copy input stream
+    _codedInputStream.reset();
+
+    // Move zero-copy input stream back to the beginning of the file, while keeping underlying device opened
+    auto bytesToBackUp = _zeroCopyInputStream->ByteCount();
+    while (bytesToBackUp > 0)
+    {
+        const auto count = static_cast<int>(std::min<gpb::int64>(bytesToBackUp, std::numeric_limits<int>::max()));
+        _zeroCopyInputStream->BackUp(count);
+        bytesToBackUp -= count;
+    }
+
+    createCodedInputStream();
+
+    return true;
+}
+
 std::shared_ptr<const OsmAnd::ObfInfo> OsmAnd::ObfReader_P::obtainInfo() const
 {
 #if OSMAND_VERIFY_OBF_READER_THREAD
@@ -208,6 +257,24 @@ std::shared_ptr<OsmAnd::gpb::io::CodedInputStream> OsmAnd::ObfReader_P::getCoded
     return _codedInputStream;
 }
 
+void OsmAnd::ObfReader_P::adviseDataBlock(const uint64_t offset, const uint64_t length) const
+{
+    // Data blocks are read from start to end, so ask for the whole block at once
+    if (_memoryMapping)
+        _memoryMapping->advise(offset, length, QFileMapping::AccessPattern::WillNeed);
+}
+
+std::shared_ptr<const OsmAnd::ObfNameIndex> OsmAnd::ObfReader_P::obtainNameIndex(
+    const uint32_t sectionOffset,
+    const size_t estimatedMemorySize,
+    const std::function<std::shared_ptr<const ObfNameIndex> ()> buildNameIndex) const
+{
+    if (!owner->obfFile)
+        return nullptr;
+
+    return owner->obfFile->_p->obtainNameIndex(sectionOffset, estimatedMemorySize, buildNameIndex);
+}
+
 bool OsmAnd::ObfReader_P::readInfo(const ObfReader_P& reader, std::shared_ptr<ObfInfo>& outInfo)
 {
     const auto cis = reader.getCodedInputStream().get();
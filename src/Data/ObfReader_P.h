@@ -31,6 +31,8 @@ namespace OsmAnd
     static const int TRANSPORT_STOP_ZOOM = 24;
 
     class ObfInfo;
+    class QFileMapping;
+    class ObfNameIndex;
 
     class ObfReader;
     class ObfReader_P Q_DECL_FINAL
@@ -39,8 +41,10 @@ namespace OsmAnd
 
     private:
         const std::shared_ptr<QIODevice> _input;
+        const std::shared_ptr<const QFileMapping> _memoryMapping;
         std::shared_ptr<gpb::io::ZeroCopyInputStream> _zeroCopyInputStream;
         std::shared_ptr<gpb::io::CodedInputStream> _codedInputStream;
+        void createCodedInputStream();
 
         mutable std::shared_ptr<const ObfInfo> _obfInfo;
         static bool readInfo(const ObfReader_P& reader, std::shared_ptr<ObfInfo>& info);
@@ -50,7 +54,10 @@ namespace OsmAnd
         const Qt::HANDLE _threadId;
 #endif // OSMAND_VERIFY_OBF_READER_THREAD
     protected:
-        ObfReader_P(ObfReader* const owner, const std::shared_ptr<QIODevice>& input);
+        ObfReader_P(
+            ObfReader* const owner,
+            const std::shared_ptr<QIODevice>& input,
+            const std::shared_ptr<const QFileMapping>& memoryMapping = nullptr);
     public:
         virtual ~ObfReader_P();
 
@@ -59,11 +66,21 @@ namespace OsmAnd
         bool isOpened() const;
         bool open();
         bool close();
+        bool rewind();
 
         std::shared_ptr<const ObfInfo> obtainInfo() const;
 
         std::shared_ptr<gpb::io::CodedInputStream> getCodedInputStream() const;
 
+        void adviseDataBlock(const uint64_t offset, const uint64_t length) const;
+
+        // Resident name index of section, if reader is bound to file and index fits into memory budget.
+        // Size of encoded index is used as estimate of its memory size until index is built.
+        std::shared_ptr<const ObfNameIndex> obtainNameIndex(
+            const uint32_t sectionOffset,
+            const size_t estimatedMemorySize,
+            const std::function<std::shared_ptr<const ObfNameIndex> ()> buildNameIndex) const;
+
     friend class OsmAnd::ObfReader;
     };
 }
@@ -76,6 +76,26 @@ bool OsmAnd::GeoTiffCollection::removeOlderTilesFromCache(const RasterType cache
     return _p->removeOlderTilesFromCache(cache, time);
 }
 
+void OsmAnd::GeoTiffCollection::setMaxCachedDatasets(const int maxCachedDatasets)
+{
+    _p->setMaxCachedDatasets(maxCachedDatasets);
+}
+
+int OsmAnd::GeoTiffCollection::getMaxCachedDatasets() const
+{
+    return _p->getMaxCachedDatasets();
+}
+
+void OsmAnd::GeoTiffCollection::setBlockCacheSize(const int64_t size)
+{
+    GDALSetCacheMax64(size);
+}
+
+int64_t OsmAnd::GeoTiffCollection::getBlockCacheSize()
+{
+    return GDALGetCacheMax64();
+}
+
 OsmAnd::ZoomLevel OsmAnd::GeoTiffCollection::getMinZoom() const
 {
     return _p->getMinZoom();
@@ -107,3 +127,57 @@ bool OsmAnd::GeoTiffCollection::calculateHeights(
 {
     return _p->calculateHeights(zoom, tileSize, points31, outHeights);
 }
+
+void OsmAnd::GeoTiffCollection::registerHeightsConsumer(
+    const uint32_t tileSize,
+    const uint32_t overlap,
+    const bool processed) const
+{
+    _p->registerHeightsConsumer(tileSize, overlap, processed);
+}
+
+void OsmAnd::GeoTiffCollection::unregisterHeightsConsumer(
+    const uint32_t tileSize,
+    const uint32_t overlap,
+    const bool processed) const
+{
+    _p->unregisterHeightsConsumer(tileSize, overlap, processed);
+}
+
+int OsmAnd::GeoTiffCollection::buildOverviews(
+    const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/)
+{
+    return _p->buildOverviews(queryController);
+}
+
+bool OsmAnd::GeoTiffCollection::pregenerateTiles(
+    const PregenerationRequest& request,
+    PregenerationProgress* const pOutProgress /*= nullptr*/,
+    const PregenerationProgressCallback progressCallback /*= nullptr*/,
+    const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/) const
+{
+    return _p->pregenerateTiles(request, pOutProgress, progressCallback, queryController);
+}
+
+OsmAnd::GeoTiffCollection::CachedProduct::CachedProduct()
+    : rasterType(RasterType::Heightmap)
+    , tileSize(0)
+    , overlap(0)
+{
+}
+
+OsmAnd::GeoTiffCollection::PregenerationRequest::PregenerationRequest()
+    : minZoom(MinZoomLevel)
+    , maxZoom(MinZoomLevel)
+{
+}
+
+OsmAnd::GeoTiffCollection::PregenerationProgress::PregenerationProgress()
+    : totalTilesCount(0)
+    , processedTilesCount(0)
+    , cachedProductsCount(0)
+    , generatedProductsCount(0)
+    , emptyProductsCount(0)
+    , failedProductsCount(0)
+{
+}
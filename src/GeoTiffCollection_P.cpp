@@ -1,9 +1,13 @@
 #include "GeoTiffCollection_P.h"
 #include "GeoTiffCollection.h"
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 #include "ignore_warnings_on_external_includes.h"
+#include <QThreadPool>
+#include <QWaitCondition>
 #include <gdal_priv.h>
 #include <gdal_utils.h>
 #include <cpl_conv.h>
@@ -14,7 +18,9 @@
 #include "IMapElevationDataProvider.h"
 #include "OsmAndCore_private.h"
 #include "QKeyValueIterator.h"
+#include "QRunnableFunctor.h"
 #include "Stopwatch.h"
+#include "TerrainAnalysis.h"
 #include "Utilities.h"
 #include "Logging.h"
 
@@ -28,10 +34,16 @@ OsmAnd::GeoTiffCollection_P::GeoTiffCollection_P(
     : _fileSystemWatcher(useFileWatcher ? new QFileSystemWatcher() : NULL)
     , _lastUnusedSourceOriginId(0)
     , _collectedSourcesInvalidated(1)
+    , _cachedDatasetsGeneration(0)
+    , _maxCachedDatasets(GeoTiffCollection::DefaultMaxCachedDatasets)
     , owner(owner_)
 {
     _minZoom.storeRelease(ZoomLevel9);
     _pixelSize31.storeRelease(0);
+    // Cost of each shared heights entry is measured in kilobytes
+    _sharedHeights.setMaxCost(32 * 1024);
+    // Cost of each color table is 1, since color files are small
+    _colorTables.setMaxCost(16);
     if (_fileSystemWatcher)
     {
         _fileSystemWatcher->moveToThread(gMainThread);
@@ -56,12 +68,303 @@ OsmAnd::GeoTiffCollection_P::~GeoTiffCollection_P()
 
         _fileSystemWatcher->deleteLater();
     }
+
+    closeCachedDatasets();
 }
 
 void OsmAnd::GeoTiffCollection_P::invalidateCollectedSources()
 {
     _pixelSize31.storeRelease(0);
     _collectedSourcesInvalidated.fetchAndAddOrdered(1);
+
+    // Files may have changed, so datasets opened so far should not be reused
+    closeCachedDatasets();
+    clearSharedHeights();
+}
+
+std::shared_ptr<GDALDataset> OsmAnd::GeoTiffCollection_P::leaseDataset(const QString& filePath) const
+{
+    GDALDataset* dataset = nullptr;
+    int generation;
+    {
+        QMutexLocker scopedLocker(&_cachedDatasetsMutex);
+
+        generation = _cachedDatasetsGeneration;
+
+        // Take most recently used dataset of this file, if any
+        for (int idx = _cachedDatasets.size() - 1; idx >= 0; idx--)
+        {
+            if (_cachedDatasets[idx].filePath == filePath)
+            {
+                dataset = _cachedDatasets[idx].dataset;
+                _cachedDatasets.removeAt(idx);
+                break;
+            }
+        }
+    }
+
+    if (!dataset)
+    {
+        // Overviews built in local cache are accessed through virtual dataset that refers to the file
+        const auto overviewsFilePath = getOverviewsFilePath(filePath);
+        const auto hasCachedOverviews = !overviewsFilePath.isEmpty() &&
+            QFile::exists(overviewsFilePath + QStringLiteral(".ovr")) &&
+            QFileInfo(overviewsFilePath).lastModified() >= QFileInfo(filePath).lastModified();
+        dataset = (GDALDataset*) GDALOpen(qPrintable(hasCachedOverviews ? overviewsFilePath : filePath), GA_ReadOnly);
+    }
+    if (!dataset)
+        return nullptr;
+
+    // Dataset is used only by the lessee, and is returned to cache once released
+    return std::shared_ptr<GDALDataset>(dataset,
+        [this, filePath, generation]
+        (GDALDataset* const dataset)
+        {
+            releaseDataset(filePath, dataset, generation);
+        });
+}
+
+void OsmAnd::GeoTiffCollection_P::releaseDataset(
+    const QString& filePath,
+    GDALDataset* const dataset,
+    const int generation) const
+{
+    QList<GDALDataset*> datasetsToClose;
+    {
+        QMutexLocker scopedLocker(&_cachedDatasetsMutex);
+
+        const auto maxCachedDatasets = _maxCachedDatasets.loadAcquire();
+        if (generation != _cachedDatasetsGeneration || maxCachedDatasets <= 0)
+        {
+            datasetsToClose.push_back(dataset);
+        }
+        else
+        {
+            CachedDataset cachedDataset;
+            cachedDataset.filePath = filePath;
+            cachedDataset.dataset = dataset;
+            _cachedDatasets.push_back(cachedDataset);
+
+            while (_cachedDatasets.size() > maxCachedDatasets)
+                datasetsToClose.push_back(_cachedDatasets.takeFirst().dataset);
+        }
+    }
+
+    for (const auto dataset : constOf(datasetsToClose))
+        GDALClose(dataset);
+}
+
+QString OsmAnd::GeoTiffCollection_P::getOverviewsFilePath(const QString& filePath) const
+{
+    QMutexLocker scopedLocker(&_localCacheDirMutex);
+
+    if (_localCacheDir.path().isEmpty())
+        return QString();
+
+    const auto hash = qHash(filePath);
+    return _localCacheDir.path() + QDir::separator() + QStringLiteral("overviews") + QDir::separator()
+        + QStringLiteral("%1_%2.vrt").arg(QFileInfo(filePath).completeBaseName()).arg(hash, 8, 16, QLatin1Char('0'));
+}
+
+GDALRasterBand* OsmAnd::GeoTiffCollection_P::selectOverview(
+    GDALRasterBand* const band,
+    const PointI& tileLength,
+    GDALRasterIOExtraArg& extraArg,
+    PointI& dataOffset,
+    PointI& dataSize) const
+{
+    if (tileLength.x <= 0 || tileLength.y <= 0)
+        return band;
+    const auto downsampling = std::min(extraArg.dfXSize / tileLength.x, extraArg.dfYSize / tileLength.y);
+    if (downsampling < 2.0)
+        return band;
+
+    // Coarsest overview, that still has at least resolution of tile
+    GDALRasterBand* overview = nullptr;
+    double overviewFactor = 1.0;
+    const auto overviewCount = band->GetOverviewCount();
+    for (int overviewIndex = 0; overviewIndex < overviewCount; overviewIndex++)
+    {
+        const auto candidate = band->GetOverview(overviewIndex);
+        if (!candidate || candidate->GetXSize() <= 0 || candidate->GetYSize() <= 0)
+            continue;
+        const auto factor = static_cast<double>(band->GetXSize()) / static_cast<double>(candidate->GetXSize());
+        if (factor > overviewFactor && factor <= downsampling)
+        {
+            overview = candidate;
+            overviewFactor = factor;
+        }
+    }
+    if (!overview)
+        return band;
+
+    const PointD factor(
+        static_cast<double>(band->GetXSize()) / static_cast<double>(overview->GetXSize()),
+        static_cast<double>(band->GetYSize()) / static_cast<double>(overview->GetYSize()));
+    const PointD offset(extraArg.dfXOff / factor.x, extraArg.dfYOff / factor.y);
+    const PointD size(extraArg.dfXSize / factor.x, extraArg.dfYSize / factor.y);
+    const PointI overviewDataOffset(
+        static_cast<int32_t>(std::floor(offset.x)),
+        static_cast<int32_t>(std::floor(offset.y)));
+    const PointI overviewDataSize(
+        std::min(static_cast<int32_t>(std::ceil(offset.x + size.x)), overview->GetXSize()) - overviewDataOffset.x,
+        std::min(static_cast<int32_t>(std::ceil(offset.y + size.y)), overview->GetYSize()) - overviewDataOffset.y);
+    if (overviewDataSize.x <= 0 || overviewDataSize.y <= 0)
+        return band;
+
+    extraArg.dfXOff = offset.x;
+    extraArg.dfYOff = offset.y;
+    extraArg.dfXSize = size.x;
+    extraArg.dfYSize = size.y;
+    dataOffset = overviewDataOffset;
+    dataSize = overviewDataSize;
+    return overview;
+}
+
+void OsmAnd::GeoTiffCollection_P::closeCachedDatasets() const
+{
+    QList<CachedDataset> cachedDatasets;
+    {
+        QMutexLocker scopedLocker(&_cachedDatasetsMutex);
+
+        // Datasets that are leased at the moment will be closed once released
+        _cachedDatasetsGeneration++;
+        cachedDatasets.swap(_cachedDatasets);
+    }
+
+    for (const auto& cachedDataset : constOf(cachedDatasets))
+        GDALClose(cachedDataset.dataset);
+}
+
+void OsmAnd::GeoTiffCollection_P::setMaxCachedDatasets(const int maxCachedDatasets)
+{
+    _maxCachedDatasets.storeRelease(maxCachedDatasets);
+
+    QList<GDALDataset*> datasetsToClose;
+    {
+        QMutexLocker scopedLocker(&_cachedDatasetsMutex);
+
+        while (_cachedDatasets.size() > qMax(maxCachedDatasets, 0))
+            datasetsToClose.push_back(_cachedDatasets.takeFirst().dataset);
+    }
+
+    for (const auto dataset : constOf(datasetsToClose))
+        GDALClose(dataset);
+}
+
+int OsmAnd::GeoTiffCollection_P::getMaxCachedDatasets() const
+{
+    return _maxCachedDatasets.loadAcquire();
+}
+
+void OsmAnd::GeoTiffCollection_P::registerHeightsConsumer(
+    const uint32_t tileSize,
+    const uint32_t overlap,
+    const bool processed) const
+{
+    QMutexLocker scopedLocker(&_sharedHeightsMutex);
+
+    _heightsConsumers[{ tileSize, overlap, processed }]++;
+}
+
+void OsmAnd::GeoTiffCollection_P::unregisterHeightsConsumer(
+    const uint32_t tileSize,
+    const uint32_t overlap,
+    const bool processed) const
+{
+    QMutexLocker scopedLocker(&_sharedHeightsMutex);
+
+    const HeightsGrid grid = { tileSize, overlap, processed };
+    const auto citConsumers = _heightsConsumers.find(grid);
+    if (citConsumers == _heightsConsumers.end())
+        return;
+    if (--(*citConsumers) > 0)
+        return;
+    _heightsConsumers.erase(citConsumers);
+
+    // Heights of grid that has no consumers anymore would never be taken, while heights of other grids still may
+    for (const auto& key : constOf(_sharedHeights.keys()))
+    {
+        if (key.grid == grid)
+            _sharedHeights.remove(key);
+    }
+}
+
+void OsmAnd::GeoTiffCollection_P::shareHeights(
+    const SharedHeightsKey& key,
+    const char* pHeights,
+    const int size,
+    const PointD& origin,
+    const PointD& resolution,
+    const int gcpCount,
+    const void* gcpList,
+    const int specification) const
+{
+    QMutexLocker scopedLocker(&_sharedHeightsMutex);
+
+    const auto consumersCount = _heightsConsumers.value(key.grid);
+    if (consumersCount < 2)
+        return;
+
+    const auto sharedHeights = std::make_shared<SharedHeights>();
+    sharedHeights->heights = QByteArray(pHeights, size);
+    sharedHeights->origin = origin;
+    sharedHeights->resolution = resolution;
+    sharedHeights->gcpCount = gcpCount;
+    if (gcpCount > 0)
+        sharedHeights->gcpList = QByteArray(reinterpret_cast<const char*>(gcpList), sizeof(GDAL_GCP) * gcpCount);
+    sharedHeights->specification = specification;
+    sharedHeights->pendingConsumers = consumersCount - 1;
+
+    _sharedHeights.insert(key,
+        new std::shared_ptr<SharedHeights>(sharedHeights),
+        std::max(1, size / 1024));
+}
+
+std::shared_ptr<const OsmAnd::GeoTiffCollection_P::SharedHeights> OsmAnd::GeoTiffCollection_P::takeSharedHeights(
+    const SharedHeightsKey& key) const
+{
+    QMutexLocker scopedLocker(&_sharedHeightsMutex);
+
+    const auto pSharedHeights = _sharedHeights.object(key);
+    if (!pSharedHeights)
+        return nullptr;
+
+    // Heights are released as soon as last consumer took them
+    const auto sharedHeights = *pSharedHeights;
+    if (--sharedHeights->pendingConsumers <= 0)
+        _sharedHeights.remove(key);
+
+    return sharedHeights;
+}
+
+void OsmAnd::GeoTiffCollection_P::clearSharedHeights() const
+{
+    QMutexLocker scopedLocker(&_sharedHeightsMutex);
+
+    _sharedHeights.clear();
+}
+
+std::shared_ptr<const OsmAnd::TerrainAnalysis::ColorTable> OsmAnd::GeoTiffCollection_P::obtainColorTable(
+    const QString& filename) const
+{
+    // Color files are rewritten under same names, so tables are found by content of file. Failures are not kept,
+    // so that file that can't be read right now is read again by next request.
+    QByteArray content;
+    if (!TerrainAnalysis::ColorTable::readFile(filename, content))
+        return nullptr;
+
+    QMutexLocker scopedLocker(&_colorTablesMutex);
+
+    if (const auto pColorTable = _colorTables.object(content))
+        return *pColorTable;
+
+    std::shared_ptr<TerrainAnalysis::ColorTable> colorTable(new TerrainAnalysis::ColorTable());
+    if (!TerrainAnalysis::ColorTable::parse(content, *colorTable))
+        return nullptr;
+    _colorTables.insert(content, new std::shared_ptr<const TerrainAnalysis::ColorTable>(colorTable));
+
+    return colorTable;
 }
 
 void OsmAnd::GeoTiffCollection_P::clearCollectedSources() const
@@ -287,7 +590,7 @@ inline OsmAnd::ZoomLevel OsmAnd::GeoTiffCollection_P::calcMaxZoom(
 inline OsmAnd::GeoTiffCollection_P::GeoTiffProperties OsmAnd::GeoTiffCollection_P::getGeoTiffProperties(
     const QString& filePath) const
 {   
-    if (const auto dataset = (GDALDataset*) GDALOpen(qPrintable(filePath), GA_ReadOnly))
+    if (const auto dataset = leaseDataset(filePath))
     {
         const auto bandCount = dataset->GetRasterCount();
         auto bandDataType = GDT_Unknown;
@@ -310,10 +613,8 @@ inline OsmAnd::GeoTiffCollection_P::GeoTiffProperties OsmAnd::GeoTiffCollection_
                 upperLeft31.y = upperLeft31.y - INT32_MAX - 1;
             const int32_t pixelSize31 =
                 std::ceil(qBound(0.0, geoTransform[1] * earthIn31 / earthInMeters, earthIn31 - 1.0));
-            GDALClose(dataset);
             return GeoTiffProperties(upperLeft31, lowerRight31, rasterSize, pixelSize31, bandCount, bandDataType);
         }
-        GDALClose(dataset);
     }
     return GeoTiffProperties();
 }
@@ -443,6 +744,31 @@ inline bool OsmAnd::GeoTiffCollection_P::postProcess(
     const void* gcpList,
     void* pBuffer) const
 {
+    if (procParameters.useNativeProcessing)
+    {
+        const auto isHillshade = procParameters.rasterType == GeoTiffCollection::RasterType::Hillshade;
+        const auto colors = obtainColorTable(procParameters.resultColorsFilename);
+        const auto slopeGrayscale = isHillshade
+            ? obtainColorTable(procParameters.intermediateColorsFilename)
+            : nullptr;
+        if (colors && (!isHillshade || slopeGrayscale))
+        {
+            const auto pHeights = reinterpret_cast<const float*>(pByteBuffer);
+            const auto pRGBA = static_cast<uint8_t*>(pBuffer);
+            if (isHillshade)
+            {
+                TerrainAnalysis::computeHillshadeRaster(pHeights, tileSize, overlap, tileResolution,
+                    static_cast<float>(TIFF_NODATA), *slopeGrayscale, *colors, pRGBA);
+            }
+            else
+            {
+                TerrainAnalysis::computeSlopeRaster(pHeights, tileSize, overlap, tileResolution,
+                    static_cast<float>(TIFF_NODATA), *colors, pRGBA);
+            }
+            return true;
+        }
+    }
+
     bool result = false;
     char dataPointer[24];
     auto pCharBuffer = const_cast<char*>(pByteBuffer);
@@ -919,6 +1245,10 @@ OsmAnd::GeoTiffCollection::CallResult OsmAnd::GeoTiffCollection_P::getGeoTiffDat
     auto pByteBuffer = static_cast<char*>(pBuffer);
     uint32_t bandSize;
 
+    // Heights of heightmap tiles and of ones processed into hillshade/slope rasters can be shared between consumers
+    const bool shareable = procParameters ? destDataType == GDT_Byte && bandCount == 4 : bandCount == 1 && !toBytes;
+    const SharedHeightsKey sharedHeightsKey = { tileId, zoom, { tileSize, overlap, procParameters != nullptr } };
+
     QReadLocker scopedLocker(&_collectedSourcesLock);
 
     // Files can have data for this tile
@@ -995,11 +1325,40 @@ OsmAnd::GeoTiffCollection::CallResult OsmAnd::GeoTiffCollection_P::getGeoTiffDat
                             return GeoTiffCollection::CallResult::Completed;
                     }
 
+                    // Heights could have been read already for another consumer of this tile
+                    const auto sharedHeights = shareable ? takeSharedHeights(sharedHeightsKey) : nullptr;
+                    if (sharedHeights)
+                    {
+                        bool result = true;
+                        int resultSize;
+                        if (procParameters)
+                        {
+                            result = postProcess(sharedHeights->heights.constData(), *procParameters, tileSize, overlap,
+                                sharedHeights->origin, sharedHeights->resolution, sharedHeights->gcpCount,
+                                sharedHeights->gcpList.constData(), pBuffer);
+                            resultSize = bandCount * (tileSize - overlap) * (tileSize - overlap);
+                        }
+                        else
+                        {
+                            memcpy(pBuffer, sharedHeights->heights.constData(), sharedHeights->heights.size());
+                            resultSize = sharedHeights->heights.size();
+                        }
+                        if (result && cacheDatabase && cacheDatabase->isOpened())
+                        {
+                            const auto currentTime = QDateTime::currentMSecsSinceEpoch();
+                            cacheDatabase->storeTileData(tileId, zoom, sharedHeights->specification,
+                                QByteArray::fromRawData(static_cast<const char*>(pBuffer), resultSize), currentTime);
+                        }
+                        return result
+                            ? GeoTiffCollection::CallResult::Completed
+                            : GeoTiffCollection::CallResult::Failed;
+                    }
+
                     // Tile is empty
                     bool empty = false;
 
                     bool result = false;
-                    if (const auto dataset = (GDALDataset*) GDALOpen(qPrintable(filePath), GA_ReadOnly))
+                    if (const auto dataset = leaseDataset(filePath))
                     {
                         // Read raster data from source Geotiff file
                         const auto rasterBandCount = dataset->GetRasterCount();
@@ -1115,11 +1474,21 @@ OsmAnd::GeoTiffCollection::CallResult OsmAnd::GeoTiffCollection_P::getGeoTiffDat
                                     auto pValues = reinterpret_cast<float*>(pData);
                                     std::fill(pValues, pValues + valueCount, static_cast<float>(noData));
                                 }
-                                result = result && band->RasterIO(GF_Read,
-                                    dataOffset.x, dataOffset.y,
-                                    dataSize.x, dataSize.y,
+                                // Much downsampled tiles are read from overview, so full-resolution data is not touched
+                                auto sourceBand = band;
+                                auto sourceExtraArg = extraArg;
+                                auto sourceDataOffset = dataOffset;
+                                auto sourceDataSize = dataSize;
+                                if (result)
+                                {
+                                    sourceBand = selectOverview(
+                                        band, tileLength, sourceExtraArg, sourceDataOffset, sourceDataSize);
+                                }
+                                result = result && sourceBand->RasterIO(GF_Read,
+                                    sourceDataOffset.x, sourceDataOffset.y,
+                                    sourceDataSize.x, sourceDataSize.y,
                                     pData + pShift, tileLength.x, tileLength.y,
-                                    dataType, 0, side, &extraArg) == CE_None;
+                                    dataType, 0, side, &sourceExtraArg) == CE_None;
                                 if (!result) break;
                                 pData += valueCount * pixelSizeInBytes;
                             }
@@ -1194,6 +1563,13 @@ OsmAnd::GeoTiffCollection::CallResult OsmAnd::GeoTiffCollection_P::getGeoTiffDat
                                 }
                                 else
                                 {
+                                    if (result && shareable)
+                                    {
+                                        shareHeights(sharedHeightsKey, pByteBuffer,
+                                            static_cast<int>(valueCount * sizeof(float)), tileOrigin, tileResolution,
+                                            gcpCount, gcpList, specification);
+                                    }
+
                                     // Produce hillshade/slope raster from heightmap data
                                     result = result && destDataType == GDT_Byte && bandCount == 4 &&
                                         postProcess(pByteBuffer, *procParameters, tileSize, overlap, tileOrigin,
@@ -1204,6 +1580,11 @@ OsmAnd::GeoTiffCollection::CallResult OsmAnd::GeoTiffCollection_P::getGeoTiffDat
                                 bandSize = (tileSize - overlap) * (tileSize - overlap) *
                                     (destDataType == GDT_Byte ? 1 : (destDataType == GDT_Int16 ? 2 : 4));
                             }
+                            else if (result && shareable)
+                            {
+                                shareHeights(sharedHeightsKey, pByteBuffer, static_cast<int>(bandSize),
+                                    tileOrigin, tileResolution, gcpCount, gcpList, specification);
+                            }
                             if (empty)
                                 result = true;
                             // Put raster data in cache database file
@@ -1214,7 +1595,6 @@ OsmAnd::GeoTiffCollection::CallResult OsmAnd::GeoTiffCollection_P::getGeoTiffDat
                                     QByteArray::fromRawData(pByteBuffer, bandCount * bandSize), currentTime);
                             }
                         }
-                        GDALClose(dataset);
                     }
                     if (!compose && !empty)
                     {
@@ -1234,6 +1614,12 @@ OsmAnd::GeoTiffCollection::CallResult OsmAnd::GeoTiffCollection_P::getGeoTiffDat
         bool result = true;
         if (atLeastOnePresent)
         {
+            if (!incomplete)
+            {
+                shareHeights(sharedHeightsKey, compositeTile.constData(), compositeTile.size(), compositeOrigin,
+                    compositeResolution, compositeGCPCount, compositeGCPList.constData(), compositeSpecification);
+            }
+
             // Produce hillshade/slope raster from heightmap data
             result = postProcess(compositeTile.constData(), *procParameters, tileSize, overlap, compositeOrigin,
                 compositeResolution, compositeGCPCount, compositeGCPList.constData(), pBuffer);
@@ -1322,3 +1708,371 @@ bool OsmAnd::GeoTiffCollection_P::calculateHeights(
     return true;
 }
 
+
+bool OsmAnd::GeoTiffCollection_P::pregenerateTiles(
+    const GeoTiffCollection::PregenerationRequest& request,
+    GeoTiffCollection::PregenerationProgress* const pOutProgress,
+    const GeoTiffCollection::PregenerationProgressCallback progressCallback,
+    const std::shared_ptr<const IQueryController>& queryController) const
+{
+    if (request.products.isEmpty() || request.minZoom > request.maxZoom)
+        return false;
+
+    // Generated products are useful only if they are put in local cache
+    QVector< std::shared_ptr<TileSqliteDatabase> > cacheDatabases;
+    {
+        QReadLocker scopedLocker(&_collectedSourcesLock);
+
+        for (const auto& product : constOf(request.products))
+        {
+            std::shared_ptr<TileSqliteDatabase> cacheDatabase;
+            switch (product.rasterType)
+            {
+                case GeoTiffCollection::RasterType::Hillshade:
+                    cacheDatabase = hillshadeCache;
+                    break;
+                case GeoTiffCollection::RasterType::Slope:
+                    cacheDatabase = slopeCache;
+                    break;
+                default:
+                    cacheDatabase = heightmapCache;
+            }
+            if (!cacheDatabase || !cacheDatabase->isOpened() || product.tileSize <= product.overlap)
+            {
+                LogPrintf(LogSeverityLevel::Error,
+                    "Failed to pre-generate GeoTIFF tiles: local cache is not available or product is invalid");
+                return false;
+            }
+            cacheDatabases.push_back(cacheDatabase);
+        }
+    }
+
+    // Tiles are enumerated lazily zoom by zoom. Within zoom level, rows and then columns go outwards from those of
+    // priority point, so that tiles around it are ready first.
+    struct Tile
+    {
+        TileId tileId;
+        ZoomLevel zoom;
+    };
+    struct Span
+    {
+        int32_t first;
+        int32_t count;
+        int32_t priorityIndex;
+
+        Span(const int32_t start, const int32_t end, const int32_t priority)
+            : first(start)
+            , count(end - start + 1)
+            , priorityIndex(qBound(start, priority, end) - start)
+        {
+        }
+
+        // Index-th element of span, in order of distance from priority element
+        int32_t elementAt(const int32_t index) const
+        {
+            const auto closerSideCount = qMin(priorityIndex, count - 1 - priorityIndex);
+            if (index <= 2 * closerSideCount)
+            {
+                const auto distance = (index + 1) / 2;
+                return first + priorityIndex + ((index & 1) ? -distance : distance);
+            }
+            const auto distance = index - closerSideCount;
+            return first + priorityIndex + (2 * priorityIndex > count - 1 ? -distance : distance);
+        }
+    };
+    const auto getSpans =
+        [request]
+        (const int zoom) -> std::pair<Span, Span>
+        {
+            const auto zoomShift = MaxZoomLevel - zoom;
+            return {
+                Span(
+                    request.area31.left() >> zoomShift,
+                    request.area31.right() >> zoomShift,
+                    request.priorityPoint31.x >> zoomShift),
+                Span(
+                    request.area31.top() >> zoomShift,
+                    request.area31.bottom() >> zoomShift,
+                    request.priorityPoint31.y >> zoomShift) };
+        };
+    int64_t totalTilesCount = 0;
+    for (int zoom = request.minZoom; zoom <= request.maxZoom; zoom++)
+    {
+        const auto spans = getSpans(zoom);
+        totalTilesCount += static_cast<int64_t>(spans.first.count) * spans.second.count;
+    }
+    if (totalTilesCount > std::numeric_limits<int>::max())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to pre-generate GeoTIFF tiles: %lld tiles requested",
+            static_cast<long long>(totalTilesCount));
+        return false;
+    }
+
+    struct State
+    {
+        QMutex mutex;
+        int nextZoom;
+        int32_t nextRowIndex;
+        int32_t nextColumnIndex;
+        QAtomicInt activeWorkersCount;
+        QWaitCondition allWorkersDone;
+        GeoTiffCollection::PregenerationProgress progress;
+    };
+    const auto state = std::make_shared<State>();
+    state->nextZoom = request.minZoom;
+    state->nextRowIndex = 0;
+    state->nextColumnIndex = 0;
+    state->progress.totalTilesCount = static_cast<int>(totalTilesCount);
+    const auto takeNextTile =
+        [state, request, getSpans]
+        (Tile& outTile) -> bool
+        {
+            QMutexLocker scopedLocker(&state->mutex);
+
+            for (; state->nextZoom <= request.maxZoom; state->nextZoom++, state->nextRowIndex = 0)
+            {
+                const auto spans = getSpans(state->nextZoom);
+                if (state->nextRowIndex >= spans.second.count)
+                    continue;
+
+                outTile.tileId = TileId::fromXY(
+                    spans.first.elementAt(state->nextColumnIndex),
+                    spans.second.elementAt(state->nextRowIndex));
+                outTile.zoom = static_cast<ZoomLevel>(state->nextZoom);
+                if (++state->nextColumnIndex >= spans.first.count)
+                {
+                    state->nextColumnIndex = 0;
+                    state->nextRowIndex++;
+                }
+                return true;
+            }
+            return false;
+        };
+
+    // Hillshade and slope of same tile are produced from heights that are read once
+    for (const auto& product : constOf(request.products))
+    {
+        const auto processed = product.rasterType != GeoTiffCollection::RasterType::Heightmap;
+        registerHeightsConsumer(product.tileSize, product.overlap, processed);
+    }
+
+    const auto processTiles =
+        [this, state, takeNextTile, request, cacheDatabases, progressCallback, queryController]
+        ()
+        {
+            QByteArray buffer;
+            Tile tile;
+            for (;;)
+            {
+                if (queryController && queryController->isAborted())
+                    break;
+
+                if (!takeNextTile(tile))
+                    break;
+
+                int cachedCount = 0;
+                int generatedCount = 0;
+                int emptyCount = 0;
+                int failedCount = 0;
+                for (int productIndex = 0; productIndex < request.products.size(); productIndex++)
+                {
+                    // Products that are in cache already were generated by previous run
+                    if (cacheDatabases[productIndex]->containsTileData(tile.tileId, tile.zoom))
+                    {
+                        cachedCount++;
+                        continue;
+                    }
+
+                    // Requested same way as consumers of these products do
+                    const auto& product = request.products[productIndex];
+                    const auto processed = product.rasterType != GeoTiffCollection::RasterType::Heightmap;
+                    const auto innerSize = product.tileSize - product.overlap;
+                    buffer.resize(static_cast<int>(processed
+                        ? innerSize * innerSize * 4
+                        : product.tileSize * product.tileSize * sizeof(float)));
+                    const auto result = getGeoTiffData(
+                        tile.tileId,
+                        tile.zoom,
+                        product.tileSize,
+                        product.overlap,
+                        processed ? 4 : 1,
+                        processed,
+                        buffer.data(),
+                        processed ? &product.procParameters : nullptr);
+                    switch (result)
+                    {
+                        case GeoTiffCollection::CallResult::Completed:
+                            generatedCount++;
+                            break;
+                        case GeoTiffCollection::CallResult::Empty:
+                            emptyCount++;
+                            break;
+                        default:
+                            failedCount++;
+                    }
+                }
+
+                QMutexLocker scopedLocker(&state->mutex);
+                auto& progress = state->progress;
+                progress.processedTilesCount++;
+                progress.cachedProductsCount += cachedCount;
+                progress.generatedProductsCount += generatedCount;
+                progress.emptyProductsCount += emptyCount;
+                progress.failedProductsCount += failedCount;
+                if (progressCallback)
+                    progressCallback(progress);
+            }
+
+            QMutexLocker scopedLocker(&state->mutex);
+            if (state->activeWorkersCount.fetchAndAddOrdered(-1) == 1)
+                state->allWorkersDone.wakeAll();
+        };
+
+    static QThreadPool threadPool;
+    const auto helpersCount = qMax(0, qMin(state->progress.totalTilesCount - 1, threadPool.maxThreadCount()));
+    state->activeWorkersCount.storeRelease(helpersCount + 1);
+    for (auto helperIndex = 0; helperIndex < helpersCount; helperIndex++)
+    {
+        const auto runnable = new QRunnableFunctor(
+            [processTiles]
+            (const QRunnableFunctor* const runnable)
+            {
+                Q_UNUSED(runnable);
+                processTiles();
+            });
+        runnable->setAutoDelete(true);
+        threadPool.start(runnable);
+    }
+
+    // Calling thread generates tiles as well
+    processTiles();
+
+    {
+        QMutexLocker scopedLocker(&state->mutex);
+        while (state->activeWorkersCount.loadAcquire() > 0)
+            state->allWorkersDone.wait(&state->mutex);
+
+        if (pOutProgress)
+            *pOutProgress = state->progress;
+    }
+
+    for (const auto& product : constOf(request.products))
+    {
+        const auto processed = product.rasterType != GeoTiffCollection::RasterType::Heightmap;
+        unregisterHeightsConsumer(product.tileSize, product.overlap, processed);
+    }
+
+    return !queryController || !queryController->isAborted();
+}
+
+int OsmAnd::GeoTiffCollection_P::buildOverviews(const std::shared_ptr<const IQueryController>& queryController)
+{
+    if (_collectedSourcesInvalidated.loadAcquire() > 0)
+        collectSources();
+
+    QStringList filePaths;
+    {
+        QReadLocker scopedLocker(&_collectedSourcesLock);
+
+        for (const auto& collectedSources : constOf(_collectedSources))
+            filePaths.append(collectedSources.keys());
+    }
+
+    const auto progressFunction =
+        []
+        (double complete, const char* message, void* pProgressData) -> int
+        {
+            Q_UNUSED(complete);
+            Q_UNUSED(message);
+            const auto queryController = static_cast<const IQueryController*>(pProgressData);
+            return queryController && queryController->isAborted() ? FALSE : TRUE;
+        };
+
+    int builtCount = 0;
+    for (const auto& filePath : constOf(filePaths))
+    {
+        if (queryController && queryController->isAborted())
+            break;
+
+        const auto overviewsFilePath = getOverviewsFilePath(filePath);
+        if (overviewsFilePath.isEmpty())
+        {
+            LogPrintf(LogSeverityLevel::Error, "Failed to build GeoTIFF overviews: local cache is not set");
+            return builtCount;
+        }
+        const QFileInfo overviewsFileInfo(overviewsFilePath);
+        if (QFile::exists(overviewsFilePath + QStringLiteral(".ovr")) &&
+            overviewsFileInfo.lastModified() >= QFileInfo(filePath).lastModified())
+        {
+            continue;
+        }
+
+        const std::shared_ptr<GDALDataset> dataset(
+            (GDALDataset*) GDALOpen(qPrintable(filePath), GA_ReadOnly),
+            []
+            (GDALDataset* const dataset)
+            {
+                if (dataset)
+                    GDALClose(dataset);
+            });
+        if (!dataset || dataset->GetRasterCount() <= 0)
+            continue;
+
+        // Files with internal overviews and small ones don't need extra overviews
+        const auto rasterSize = std::max(dataset->GetRasterXSize(), dataset->GetRasterYSize());
+        if (dataset->GetRasterBand(1)->GetOverviewCount() > 0 || rasterSize <= MinOverviewSize)
+            continue;
+
+        QVector<int> overviewLevels;
+        for (int level = 2; rasterSize / level >= MinOverviewSize; level *= 2)
+            overviewLevels.push_back(level);
+
+        // Overviews of read-only dataset are put in external file next to it, so virtual dataset that refers to
+        // the file is created in cache to get overviews there as well
+        QDir().mkpath(overviewsFileInfo.absolutePath());
+        const auto vrtDriver = GetGDALDriverManager()->GetDriverByName("VRT");
+        const auto vrtDataset = vrtDriver
+            ? vrtDriver->CreateCopy(qPrintable(overviewsFilePath), dataset.get(), FALSE, nullptr, nullptr, nullptr)
+            : nullptr;
+        if (!vrtDataset)
+        {
+            LogPrintf(LogSeverityLevel::Error,
+                "Failed to create virtual dataset for overviews of '%s'",
+                qPrintable(filePath));
+            continue;
+        }
+        GDALClose(vrtDataset);
+
+        bool ok = false;
+        if (const auto hDataset = GDALOpen(qPrintable(overviewsFilePath), GA_ReadOnly))
+        {
+            ok = GDALBuildOverviews(hDataset, "AVERAGE",
+                overviewLevels.size(), overviewLevels.data(),
+                0, nullptr,
+                progressFunction, const_cast<IQueryController*>(queryController.get())) == CE_None;
+            GDALClose(hDataset);
+        }
+        if (!ok)
+        {
+            if (!queryController || !queryController->isAborted())
+            {
+                LogPrintf(LogSeverityLevel::Error,
+                    "Failed to build overviews of '%s': %s",
+                    qPrintable(filePath),
+                    CPLGetLastErrorMsg());
+            }
+            QFile::remove(overviewsFilePath + QStringLiteral(".ovr"));
+            QFile::remove(overviewsFilePath);
+            continue;
+        }
+
+        builtCount++;
+    }
+
+    // Datasets opened so far don't have new overviews
+    if (builtCount > 0)
+        closeCachedDatasets();
+
+    return builtCount;
+}
@@ -10,6 +10,8 @@
 #include <QSet>
 #include <QList>
 #include <QReadWriteLock>
+#include <QMutex>
+#include <QCache>
 #include <QFileSystemWatcher>
 #include <QEventLoop>
 #include <gdal_priv.h>
@@ -20,6 +22,7 @@
 #include "PrivateImplementation.h"
 #include "GeoTiffCollection.h"
 #include "TileSqliteDatabase.h"
+#include "TerrainAnalysis.h"
 #include <OsmAndCore/PointsAndAreas.h>
 
 namespace OsmAnd
@@ -28,6 +31,31 @@ namespace OsmAnd
     class GeoTiffCollection_P__SignalProxy;
     class GeoTiffCollection_P Q_DECL_FINAL
     {
+    public:
+        // Geometry of tiles requested by heights consumers
+        struct HeightsGrid
+        {
+            uint32_t tileSize;
+            uint32_t overlap;
+            bool processed;
+
+            inline bool operator==(const HeightsGrid& that) const
+            {
+                return tileSize == that.tileSize && overlap == that.overlap && processed == that.processed;
+            }
+        };
+        struct SharedHeightsKey
+        {
+            TileId tileId;
+            ZoomLevel zoom;
+            HeightsGrid grid;
+
+            inline bool operator==(const SharedHeightsKey& that) const
+            {
+                return tileId.id == that.tileId.id && zoom == that.zoom && grid == that.grid;
+            }
+        };
+
     private:
     protected:
         GeoTiffCollection_P(GeoTiffCollection* owner, bool useFileWatcher = true);
@@ -118,6 +146,48 @@ namespace OsmAnd
         mutable QHash<GeoTiffCollection::SourceOriginId, QHash<QString, GeoTiffProperties>> _collectedSources;
         mutable QReadWriteLock _collectedSourcesLock;
 
+        // Idle opened datasets, least recently used first. Each dataset is used by single thread at a time.
+        struct CachedDataset
+        {
+            QString filePath;
+            GDALDataset* dataset;
+        };
+        mutable QMutex _cachedDatasetsMutex;
+        mutable QList<CachedDataset> _cachedDatasets;
+        mutable int _cachedDatasetsGeneration;
+        QAtomicInt _maxCachedDatasets;
+
+        // Heights read for one consumer, that are kept until other consumers of same grid take them
+        struct SharedHeights
+        {
+            QByteArray heights;
+            PointD origin;
+            PointD resolution;
+            int gcpCount;
+            QByteArray gcpList;
+            int specification;
+            int pendingConsumers;
+        };
+        mutable QMutex _sharedHeightsMutex;
+        mutable QHash<HeightsGrid, int> _heightsConsumers;
+        mutable QCache<SharedHeightsKey, std::shared_ptr<SharedHeights>> _sharedHeights;
+        void shareHeights(
+            const SharedHeightsKey& key,
+            const char* pHeights,
+            const int size,
+            const PointD& origin,
+            const PointD& resolution,
+            const int gcpCount,
+            const void* gcpList,
+            const int specification) const;
+        std::shared_ptr<const SharedHeights> takeSharedHeights(const SharedHeightsKey& key) const;
+        void clearSharedHeights() const;
+
+        // Color tables of native processing, by content of color file
+        mutable QMutex _colorTablesMutex;
+        mutable QCache<QByteArray, std::shared_ptr<const TerrainAnalysis::ColorTable>> _colorTables;
+        std::shared_ptr<const TerrainAnalysis::ColorTable> obtainColorTable(const QString& filename) const;
+
         std::shared_ptr<TileSqliteDatabase> heightmapCache;
         std::shared_ptr<TileSqliteDatabase> hillshadeCache;
         std::shared_ptr<TileSqliteDatabase> slopeCache;
@@ -133,6 +203,21 @@ namespace OsmAnd
         bool isPartOfTile(const AreaI& region31, const AreaI& area31) const;
         ZoomLevel calcMaxZoom(const int32_t pixelSize31, const uint32_t tileSize) const;
         GeoTiffProperties getGeoTiffProperties(const QString& filePath) const;
+        std::shared_ptr<GDALDataset> leaseDataset(const QString& filePath) const;
+        void releaseDataset(const QString& filePath, GDALDataset* const dataset, const int generation) const;
+        void closeCachedDatasets() const;
+
+        // Overviews are built in local cache for files that are larger than this and have no internal ones
+        enum {
+            MinOverviewSize = 256,
+        };
+        QString getOverviewsFilePath(const QString& filePath) const;
+        GDALRasterBand* selectOverview(
+            GDALRasterBand* const band,
+            const PointI& tileLength,
+            GDALRasterIOExtraArg& extraArg,
+            PointI& dataOffset,
+            PointI& dataSize) const;
         std::shared_ptr<TileSqliteDatabase> openCacheFile(const QString filename);
         bool isDataPresent(const char* pByteOffset, const GDALDataType dataType, const double noData) const;
         uint64_t multiplyParts(const uint64_t shade, const uint64_t slope) const;
@@ -168,6 +253,11 @@ namespace OsmAnd
         ZoomLevel getMinZoom() const;
         ZoomLevel getMaxZoom(const uint32_t tileSize) const;
 
+        void setMaxCachedDatasets(const int maxCachedDatasets);
+        int getMaxCachedDatasets() const;
+
+        int buildOverviews(const std::shared_ptr<const IQueryController>& queryController);
+
         GeoTiffCollection::CallResult getGeoTiffData(
             const TileId& tileId,
             const ZoomLevel zoom,
@@ -184,9 +274,28 @@ namespace OsmAnd
 			const QList<PointI>& points31,
 			QList<float>& outHeights) const;
 
+        bool pregenerateTiles(
+            const GeoTiffCollection::PregenerationRequest& request,
+            GeoTiffCollection::PregenerationProgress* const pOutProgress,
+            const GeoTiffCollection::PregenerationProgressCallback progressCallback,
+            const std::shared_ptr<const IQueryController>& queryController) const;
+
+        void registerHeightsConsumer(const uint32_t tileSize, const uint32_t overlap, const bool processed) const;
+        void unregisterHeightsConsumer(const uint32_t tileSize, const uint32_t overlap, const bool processed) const;
+
     friend class OsmAnd::GeoTiffCollection;
     friend class OsmAnd::GeoTiffCollection_P__SignalProxy;
     };
+
+    inline uint qHash(const GeoTiffCollection_P::HeightsGrid& grid, uint seed = 0)
+    {
+        return ::qHash((grid.tileSize << 16) ^ (grid.overlap << 1) ^ (grid.processed ? 1u : 0u), seed);
+    }
+
+    inline uint qHash(const GeoTiffCollection_P::SharedHeightsKey& key, uint seed = 0)
+    {
+        return ::qHash(key.tileId.id, seed) ^ ::qHash(static_cast<int>(key.zoom), seed) ^ qHash(key.grid, seed);
+    }
 }
 
 #endif // !defined(_OSMAND_CORE_GEOTIFF_COLLECTION_P_H_)
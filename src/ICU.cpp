@@ -8,6 +8,8 @@
 #include "QtExtensions.h"
 #include "ignore_warnings_on_external_includes.h"
 #include <QByteArray>
+#include <QHash>
+#include <QThreadStorage>
 #include <QVector>
 #include "restore_internal_warnings.h"
 
@@ -19,6 +21,8 @@
 #include <unicode/translit.h>
 #include <unicode/brkiter.h>
 #include <unicode/coll.h>
+#include <unicode/tblcoll.h>
+#include <unicode/coleitr.h>
 #include "restore_internal_warnings.h"
 
 #include "CoreResourcesEmbeddedBundle.h"
@@ -432,6 +436,54 @@ OSMAND_CORE_API QString OSMAND_CORE_CALL OsmAnd::ICU::stripAccentsAndDiacritics(
     return output;
 }
 
+QVector<uint32_t> OsmAnd::ICU::getPrimaryCollationWeights(const uint32_t codePoint)
+{
+    // Iterating collation elements needs collator that isn't shared with other threads
+    struct CollationContext
+    {
+        std::unique_ptr<RuleBasedCollator> collator;
+        QHash<uint32_t, QVector<uint32_t>> weights;
+    };
+    static QThreadStorage<CollationContext*> contexts;
+    if (!contexts.hasLocalData())
+    {
+        const auto context = new CollationContext();
+        if (g_pIcuCollator)
+            context->collator.reset(dynamic_cast<RuleBasedCollator*>(g_pIcuCollator->clone()));
+        contexts.setLocalData(context);
+    }
+    const auto context = contexts.localData();
+
+    const auto citWeights = context->weights.constFind(codePoint);
+    if (citWeights != context->weights.cend())
+        return *citWeights;
+
+    QVector<uint32_t> weights;
+    if (context->collator)
+    {
+        const std::unique_ptr<CollationElementIterator> itElements(
+            context->collator->createCollationElementIterator(UnicodeString(static_cast<UChar32>(codePoint))));
+        UErrorCode icuError = U_ZERO_ERROR;
+        for (auto order = itElements->next(icuError);
+            order != CollationElementIterator::NULLORDER && U_SUCCESS(icuError);
+            order = itElements->next(icuError))
+        {
+            // Ignorable elements, like combining accents, have no primary weight
+            const auto primaryOrder = CollationElementIterator::primaryOrder(order);
+            if (primaryOrder != 0)
+                weights.push_back(primaryOrder);
+        }
+    }
+    else
+    {
+        // Without collator, case folding is the closest match
+        weights.push_back(u_foldCase(static_cast<UChar32>(codePoint), U_FOLD_CASE_DEFAULT));
+    }
+    context->weights.insert(codePoint, weights);
+
+    return weights;
+}
+
 UnicodeString qStrToUniStr(QString input)
 {
     UnicodeString icuString(reinterpret_cast<const UChar*>(input.unicode()), input.length());
@@ -4,6 +4,9 @@
 #include "stdlib_common.h"
 
 #include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QVector>
+#include "restore_internal_warnings.h"
 
 #include "OsmAndCore.h"
 
@@ -13,6 +16,10 @@ namespace OsmAnd
     {
         bool initialize();
         void release();
+
+        // Primary weights of collation elements of character, so that strings equal for primary-strength collator
+        // have equal sequences of weights. Computed by collator of calling thread and cached per thread.
+        QVector<uint32_t> getPrimaryCollationWeights(const uint32_t codePoint);
     }
 }
 
@@ -7,3 +7,23 @@ OsmAnd::IGeoTiffCollection::IGeoTiffCollection()
 OsmAnd::IGeoTiffCollection::~IGeoTiffCollection()
 {
 }
+
+OsmAnd::IGeoTiffCollection::ProcessingParameters::ProcessingParameters()
+    : rasterType(RasterType::Heightmap)
+    , useNativeProcessing(true)
+{
+}
+
+void OsmAnd::IGeoTiffCollection::registerHeightsConsumer(
+    const uint32_t tileSize,
+    const uint32_t overlap,
+    const bool processed) const
+{
+}
+
+void OsmAnd::IGeoTiffCollection::unregisterHeightsConsumer(
+    const uint32_t tileSize,
+    const uint32_t overlap,
+    const bool processed) const
+{
+}
@@ -0,0 +1,176 @@
+#include "GeoTileGrid.h"
+
+#include <cmath>
+
+#include "ignore_warnings_on_external_includes.h"
+#include <gdal.h>
+#include <cpl_vsi.h>
+#include "restore_internal_warnings.h"
+
+#include "Logging.h"
+
+OsmAnd::GeoTileGrid::GeoTileGrid()
+    : width(0)
+    , height(0)
+{
+    geoTransform.fill(0.0);
+}
+
+OsmAnd::GeoTileGrid::~GeoTileGrid()
+{
+}
+
+size_t OsmAnd::GeoTileGrid::getMemorySize() const
+{
+    return static_cast<size_t>(bands.size()) * width * height * sizeof(float);
+}
+
+bool OsmAnd::GeoTileGrid::evaluate(const LatLon& latLon, QList<double>& outValues) const
+{
+    if (width == 0 || height == 0 || geoTransform[1] == 0.0 || geoTransform[5] == 0.0)
+        return false;
+
+    // Pixel coordinates, where pixel centers are at integer positions
+    const auto x = (latLon.longitude - geoTransform[0]) / geoTransform[1] - 0.5;
+    const auto y = (latLon.latitude - geoTransform[3]) / geoTransform[5] - 0.5;
+    if (x < -0.5 || y < -0.5 || x > width - 0.5 || y > height - 0.5)
+        return false;
+
+    const auto clampedX = qBound(0.0, x, static_cast<double>(width - 1));
+    const auto clampedY = qBound(0.0, y, static_cast<double>(height - 1));
+    const auto x0 = static_cast<uint32_t>(clampedX);
+    const auto y0 = static_cast<uint32_t>(clampedY);
+    const auto x1 = std::min(x0 + 1, width - 1);
+    const auto y1 = std::min(y0 + 1, height - 1);
+    const auto fx = clampedX - x0;
+    const auto fy = clampedY - y0;
+    const auto nearestIndex = (fy < 0.5 ? y0 : y1) * width + (fx < 0.5 ? x0 : x1);
+
+    outValues.append(0);
+    for (const auto& band : constOf(bands))
+    {
+        const auto pValues = band.values.constData();
+        const auto tl = pValues[y0 * width + x0];
+        const auto tr = pValues[y0 * width + x1];
+        const auto bl = pValues[y1 * width + x0];
+        const auto br = pValues[y1 * width + x1];
+
+        double value;
+        if (band.hasNoData && (tl == band.noData || tr == band.noData || bl == band.noData || br == band.noData))
+        {
+            // Near edge of data, nearest value is used
+            value = pValues[nearestIndex];
+            if (value == band.noData)
+                continue;
+        }
+        else
+        {
+            const auto top = tl + (tr - tl) * fx;
+            const auto bottom = bl + (br - bl) * fx;
+            value = top + (bottom - top) * fy;
+        }
+
+        if (band.hasMinValue && value < band.minValue)
+            value = band.minValue;
+        if (band.hasMaxValue && value > band.maxValue)
+            value = band.maxValue;
+
+        outValues.append(value);
+    }
+
+    return true;
+}
+
+std::shared_ptr<const OsmAnd::GeoTileGrid> OsmAnd::GeoTileGrid::decode(
+    const TileId geoTileId,
+    const QByteArray& geoTileData_)
+{
+    if (geoTileData_.isEmpty())
+        return nullptr;
+
+    // Map data to VSI memory. Same data may be decoded concurrently, so name is unique for each call.
+    auto geoTileData(geoTileData_);
+    const auto filename = QString::asprintf("/vsimem/geoTile@%p_%dx%d_grid",
+        &geoTileData, geoTileId.x, geoTileId.y);
+    const auto file = VSIFileFromMemBuffer(
+        qPrintable(filename),
+        reinterpret_cast<GByte*>(geoTileData.data()),
+        geoTileData.length(),
+        FALSE);
+    if (!file)
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to map geotiff %dx%d for decoding",
+            geoTileId.x,
+            geoTileId.y);
+        return nullptr;
+    }
+    VSIFCloseL(file);
+
+    std::shared_ptr<void> hDataset(
+        GDALOpen(qPrintable(filename), GA_ReadOnly),
+        [filename]
+        (auto hDataset)
+        {
+            GDALClose(hDataset);
+            VSIUnlink(qPrintable(filename));
+        });
+    if (!hDataset)
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to open %dx%d as GeoTIFF for decoding",
+            geoTileId.x,
+            geoTileId.y);
+        return nullptr;
+    }
+
+    const std::shared_ptr<GeoTileGrid> grid(new GeoTileGrid());
+    if (GDALGetGeoTransform(hDataset.get(), grid->geoTransform.data()) != CE_None)
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed get geo transform of %dx%d for decoding",
+            geoTileId.x,
+            geoTileId.y);
+        return nullptr;
+    }
+    grid->width = GDALGetRasterXSize(hDataset.get());
+    grid->height = GDALGetRasterYSize(hDataset.get());
+
+    const auto bandsCount = GDALGetRasterCount(hDataset.get());
+    grid->bands.resize(bandsCount);
+    for (int bandIndex = 0; bandIndex < bandsCount; bandIndex++)
+    {
+        const auto hBand = GDALGetRasterBand(hDataset.get(), bandIndex + 1);
+        auto& band = grid->bands[bandIndex];
+
+        int ok = FALSE;
+        band.noData = static_cast<float>(GDALGetRasterNoDataValue(hBand, &ok));
+        band.hasNoData = ok != FALSE;
+        band.minValue = GDALGetRasterMinimum(hBand, &ok);
+        band.hasMinValue = ok != FALSE;
+        band.maxValue = GDALGetRasterMaximum(hBand, &ok);
+        band.hasMaxValue = ok != FALSE;
+
+        band.values.resize(grid->width * grid->height);
+        const auto res = GDALRasterIO(
+            hBand,
+            GF_Read,
+            0, 0, grid->width, grid->height,
+            band.values.data(), grid->width, grid->height,
+            GDT_Float32,
+            0,
+            0);
+        if (res != CE_None)
+        {
+            LogPrintf(LogSeverityLevel::Error,
+                "Failed to decode band %d of %dx%d: %s",
+                bandIndex + 1,
+                geoTileId.x,
+                geoTileId.y,
+                CPLGetLastErrorMsg());
+            return nullptr;
+        }
+    }
+
+    return grid;
+}
@@ -0,0 +1,57 @@
+#ifndef _OSMAND_CORE_GEO_TILE_GRID_H_
+#define _OSMAND_CORE_GEO_TILE_GRID_H_
+
+#include "stdlib_common.h"
+#include <array>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "LatLon.h"
+
+namespace OsmAnd
+{
+    // All bands of weather GeoTIFF tile, decoded once into float grids georeferenced in longitude and latitude
+    class GeoTileGrid Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(GeoTileGrid);
+    public:
+        struct Band
+        {
+            QVector<float> values;
+            bool hasNoData;
+            float noData;
+            bool hasMinValue;
+            double minValue;
+            bool hasMaxValue;
+            double maxValue;
+        };
+
+    private:
+        GeoTileGrid();
+    protected:
+    public:
+        ~GeoTileGrid();
+
+        uint32_t width;
+        uint32_t height;
+        std::array<double, 6> geoTransform;
+        QVector<Band> bands;
+
+        size_t getMemorySize() const;
+
+        // Values are in the same form as ones of GeoTileEvaluator: leading 0, followed by values of bands that
+        // have data at given location. Values are interpolated bilinearly between pixel centers.
+        bool evaluate(const LatLon& latLon, QList<double>& outValues) const;
+
+        static std::shared_ptr<const GeoTileGrid> decode(const TileId geoTileId, const QByteArray& geoTileData);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_GEO_TILE_GRID_H_)
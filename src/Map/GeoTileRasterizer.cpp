@@ -9,7 +9,8 @@ OsmAnd::GeoTileRasterizer::GeoTileRasterizer(
     const QHash<BandIndex, std::shared_ptr<const GeoBandSettings>>& bandSettings_,
     const uint32_t tileSize_ /*= 256*/,
     const float densityFactor_ /*= 1.0f*/,
-    const QString& projSearchPath_ /*= QString()*/)
+    const QString& projSearchPath_ /*= QString()*/,
+    const bool useNativeProcessing_ /*= true*/)
     : _p(new GeoTileRasterizer_P(this))
     , geoTileData(geoTileData_)
     , tileId(tileId_)
@@ -19,6 +20,7 @@ OsmAnd::GeoTileRasterizer::GeoTileRasterizer(
     , tileSize(tileSize_)
     , densityFactor(densityFactor_)
     , projSearchPath(projSearchPath_)
+    , useNativeProcessing(useNativeProcessing_)
 {
 }
 
@@ -2,14 +2,13 @@
 #include "GeoTileRasterizer.h"
 
 #include <cassert>
+#include <limits>
 
 #include "ignore_warnings_on_external_includes.h"
 #include <gdal_priv.h>
 #include <cpl_vsi.h>
 #include <gdal_utils.h>
 #include <gdal_alg.h>
-#include <ogr_api.h>
-#include <ogrsf_frmts.h>
 #include <SkCanvas.h>
 #include <SkPath.h>
 #include "restore_internal_warnings.h"
@@ -18,6 +17,7 @@
 #include "Utilities.h"
 #include "SkiaUtilities.h"
 #include "GlobalMercator.h"
+#include "TerrainAnalysis.h"
 #include "WeatherTileResourceProvider.h"
 
 static QMutex _geoDataMutex;
@@ -64,6 +64,17 @@ QHash<OsmAnd::BandIndex, sk_sp<const SkImage>> OsmAnd::GeoTileRasterizer_P::rast
     
     if (owner->geoTileData.length() == 0)
         return QHash<BandIndex, sk_sp<const SkImage>>();
+
+    // Bands that native path fails to colorize are processed by GDAL
+    QList<BandIndex> gdalBands = owner->bands;
+    QHash<BandIndex, sk_sp<const SkImage>> bandImages;
+    if (owner->useNativeProcessing)
+    {
+        gdalBands.clear();
+        bandImages = rasterizeNatively(outEncImgData, fillEncImgData, gdalBands, queryController);
+        if (gdalBands.isEmpty())
+            return bandImages;
+    }
     
     TileId tileId = owner->tileId;
     ZoomLevel zoom = owner->zoom;
@@ -139,8 +150,7 @@ QHash<OsmAnd::BandIndex, sk_sp<const SkImage>> OsmAnd::GeoTileRasterizer_P::rast
     if (queryController && queryController->isAborted())
         return QHash<BandIndex, sk_sp<const SkImage>>();
 
-    QHash<BandIndex, sk_sp<const SkImage>> bandImages;
-    for (auto band : owner->bands)
+    for (auto band : constOf(gdalBands))
     {
         if (!owner->bandSettings.contains(band))
             continue;
@@ -403,6 +413,260 @@ QHash<OsmAnd::BandIndex, sk_sp<const SkImage>> OsmAnd::GeoTileRasterizer_P::rast
     return bandImages;
 }
 
+QHash<OsmAnd::BandIndex, sk_sp<const SkImage>> OsmAnd::GeoTileRasterizer_P::rasterizeNatively(
+    QHash<BandIndex, QByteArray>& outEncImgData,
+    bool fillEncImgData,
+    QList<BandIndex>& outFailedBands,
+    const std::shared_ptr<const IQueryController>& queryController) const
+{
+    QHash<BandIndex, sk_sp<const SkImage>> bandImages;
+
+    // All bands are decoded once, instead of cropping and warping each of them separately
+    const auto grid = GeoTileGrid::decode(owner->tileId, owner->geoTileData);
+    if (!grid)
+    {
+        for (const auto band : constOf(owner->bands))
+        {
+            if (owner->bandSettings.contains(band))
+                outFailedBands.push_back(band);
+        }
+        return bandImages;
+    }
+
+    if (queryController && queryController->isAborted())
+        return bandImages;
+
+    QVector<PixelSample> columns;
+    QVector<PixelSample> rows;
+    computePixelSamples(*grid, columns, rows);
+
+    const auto tileSize = owner->tileSize;
+    QByteArray pixels(tileSize * tileSize * 4, Qt::Uninitialized);
+    for (const auto band : constOf(owner->bands))
+    {
+        if (!owner->bandSettings.contains(band))
+            continue;
+
+        // Band numbers are 1-based, as in GDAL
+        const auto colors = obtainColorLookupTable(owner->bandSettings[band]->colorProfilePath);
+        if (band < 1 || band > grid->bands.size() || !colors)
+        {
+            outFailedBands.push_back(band);
+            continue;
+        }
+
+        colorizeBand(
+            *grid,
+            grid->bands[band - 1],
+            columns,
+            rows,
+            *colors,
+            reinterpret_cast<uint32_t*>(pixels.data()));
+
+        const auto image = SkiaUtilities::createSkImageARGB888With(
+            pixels, tileSize, tileSize, SkAlphaType::kUnpremul_SkAlphaType);
+        if (!image)
+        {
+            outFailedBands.push_back(band);
+            continue;
+        }
+        if (fillEncImgData)
+        {
+            const auto data = image->encodeToData(SkEncodedImageFormat::kPNG, 100);
+            if (!data)
+            {
+                outFailedBands.push_back(band);
+                continue;
+            }
+            outEncImgData.insert(band, QByteArray(reinterpret_cast<const char*>(data->bytes()), data->size()));
+        }
+        bandImages.insert(band, image);
+
+        if (queryController && queryController->isAborted())
+        {
+            outFailedBands.clear();
+            return QHash<BandIndex, sk_sp<const SkImage>>();
+        }
+    }
+
+    return bandImages;
+}
+
+void OsmAnd::GeoTileRasterizer_P::computePixelSamples(
+    const GeoTileGrid& grid,
+    QVector<PixelSample>& outColumns,
+    QVector<PixelSample>& outRows) const
+{
+    // Output pixels have same size as ones of GDAL chain, that warps to resolution of mercator zoom level
+    const GlobalMercator mercator;
+    const auto pixelsPerTile = static_cast<double>(mercator.tileSize);
+    const auto zoom = owner->zoom;
+
+    const auto makeSample =
+        []
+        (const double position, const uint32_t size) -> PixelSample
+        {
+            // Grid pixel centers are at integer positions
+            PixelSample sample;
+            sample.valid = position >= -0.5 && position <= size - 0.5;
+            const auto clamped = qBound(0.0, position, static_cast<double>(size - 1));
+            sample.index0 = static_cast<int32_t>(clamped);
+            sample.index1 = std::min(sample.index0 + 1, static_cast<int32_t>(size - 1));
+            sample.weight = static_cast<float>(clamped - sample.index0);
+            return sample;
+        };
+
+    // Mercator projection is separable: longitude depends only on column and latitude only on row
+    const auto tileSize = owner->tileSize;
+    outColumns.resize(tileSize);
+    for (uint32_t col = 0; col < tileSize; col++)
+    {
+        const auto longitude =
+            Utilities::getLongitudeFromTile(zoom, owner->tileId.x + (col + 0.5) / pixelsPerTile);
+        outColumns[col] = makeSample((longitude - grid.geoTransform[0]) / grid.geoTransform[1] - 0.5, grid.width);
+    }
+    outRows.resize(tileSize);
+    for (uint32_t row = 0; row < tileSize; row++)
+    {
+        const auto latitude =
+            Utilities::getLatitudeFromTile(zoom, owner->tileId.y + (row + 0.5) / pixelsPerTile);
+        outRows[row] = makeSample((latitude - grid.geoTransform[3]) / grid.geoTransform[5] - 0.5, grid.height);
+    }
+}
+
+void OsmAnd::GeoTileRasterizer_P::colorizeBand(
+    const GeoTileGrid& grid,
+    const GeoTileGrid::Band& band,
+    const QVector<PixelSample>& columns,
+    const QVector<PixelSample>& rows,
+    const ColorLookupTable& colors,
+    uint32_t* const pOutRGBA)
+{
+    const auto width = static_cast<uint32_t>(columns.size());
+    const auto pValues = band.values.constData();
+    const auto noDataValue = std::numeric_limits<float>::quiet_NaN();
+    QVector<float> rowValues(width);
+    QVector<int32_t> rowIndices(width);
+    auto pRowValues = rowValues.data();
+    auto pRowIndices = rowIndices.data();
+    auto pOutPixel = pOutRGBA;
+    for (const auto& rowSample : constOf(rows))
+    {
+        if (!rowSample.valid)
+        {
+            std::fill(pOutPixel, pOutPixel + width, colors.colors[ColorLookupTable::NoDataIndex]);
+            pOutPixel += width;
+            continue;
+        }
+
+        // Interpolate values of row, using NaN for no-data
+        const auto pTop = pValues + rowSample.index0 * grid.width;
+        const auto pBottom = pValues + rowSample.index1 * grid.width;
+        const auto fy = rowSample.weight;
+        for (uint32_t col = 0; col < width; col++)
+        {
+            const auto& columnSample = columns[col];
+            const auto tl = pTop[columnSample.index0];
+            const auto tr = pTop[columnSample.index1];
+            const auto bl = pBottom[columnSample.index0];
+            const auto br = pBottom[columnSample.index1];
+            const auto fx = columnSample.weight;
+
+            auto value = noDataValue;
+            if (band.hasNoData &&
+                (tl == band.noData || tr == band.noData || bl == band.noData || br == band.noData))
+            {
+                // Near edge of data, nearest value is used
+                const auto nearest = fy < 0.5f ? (fx < 0.5f ? tl : tr) : (fx < 0.5f ? bl : br);
+                if (nearest != band.noData)
+                    value = nearest;
+            }
+            else
+            {
+                const auto top = tl + (tr - tl) * fx;
+                const auto bottom = bl + (br - bl) * fx;
+                value = top + (bottom - top) * fy;
+            }
+            pRowValues[col] = columnSample.valid ? value : noDataValue;
+        }
+
+        // Branchless quantization and table lookup, that compiler is able to vectorize
+        const auto minValue = colors.minValue;
+        const auto scale = colors.scale;
+        const auto maxIndex = static_cast<float>(ColorLookupTable::Size - 1);
+        for (uint32_t col = 0; col < width; col++)
+        {
+            const auto value = pRowValues[col];
+            const auto isNoData = value != value;
+            const auto position = std::min(std::max((value - minValue) * scale + 0.5f, 0.0f), maxIndex);
+            const auto index = static_cast<int32_t>(isNoData ? 0.0f : position);
+            pRowIndices[col] = isNoData ? static_cast<int32_t>(ColorLookupTable::NoDataIndex) : index;
+        }
+        const auto pColors = colors.colors.data();
+        for (uint32_t col = 0; col < width; col++)
+            pOutPixel[col] = pColors[pRowIndices[col]];
+        pOutPixel += width;
+    }
+}
+
+std::shared_ptr<const OsmAnd::GeoTileRasterizer_P::ColorLookupTable> OsmAnd::GeoTileRasterizer_P::obtainColorLookupTable(
+    const QString& colorProfilePath)
+{
+    // Color profiles are shared by all tiles of band, so they're parsed and sampled only once per version of file
+    struct ColorLookupTableEntry
+    {
+        qint64 modificationTime;
+        qint64 size;
+        std::shared_ptr<const ColorLookupTable> colorLookupTable;
+    };
+    static QMutex colorLookupTablesMutex;
+    static QHash<QString, ColorLookupTableEntry> colorLookupTables;
+
+    VSIStatBufL stat;
+    if (VSIStatL(qPrintable(colorProfilePath), &stat) != 0)
+        return nullptr;
+    const qint64 modificationTime = stat.st_mtime;
+    const qint64 size = stat.st_size;
+
+    QMutexLocker scopedLocker(&colorLookupTablesMutex);
+
+    const auto citColorLookupTable = colorLookupTables.constFind(colorProfilePath);
+    if (citColorLookupTable != colorLookupTables.cend()
+        && citColorLookupTable->modificationTime == modificationTime
+        && citColorLookupTable->size == size)
+    {
+        return citColorLookupTable->colorLookupTable;
+    }
+
+    TerrainAnalysis::ColorTable colorTable;
+    if (!TerrainAnalysis::ColorTable::load(colorProfilePath, colorTable))
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "Color profile '%s' is not supported natively, GDAL will be used",
+            qPrintable(colorProfilePath));
+        colorLookupTables.insert(colorProfilePath, { modificationTime, size, nullptr });
+        return nullptr;
+    }
+
+    const std::shared_ptr<ColorLookupTable> colorLookupTable(new ColorLookupTable());
+    const auto minValue = colorTable.entries.first().value;
+    const auto maxValue = colorTable.entries.last().value;
+    const auto step = (maxValue - minValue) / (ColorLookupTable::Size - 1);
+    colorLookupTable->minValue = static_cast<float>(minValue);
+    colorLookupTable->scale = step > 0.0 ? static_cast<float>(1.0 / step) : 0.0f;
+    for (int index = 0; index < ColorLookupTable::Size; index++)
+    {
+        uint8_t rgba[4];
+        colorTable.lookup(minValue + index * step, rgba);
+        memcpy(&colorLookupTable->colors[index], rgba, 4);
+    }
+    // Same as 'gdaldem color-relief -alpha': transparent, unless color for 'nv' is specified
+    memcpy(&colorLookupTable->colors[ColorLookupTable::NoDataIndex], colorTable.noDataColor.data(), 4);
+
+    colorLookupTables.insert(colorProfilePath, { modificationTime, size, colorLookupTable });
+    return colorLookupTable;
+}
+
 QHash<OsmAnd::BandIndex, sk_sp<const SkImage>> OsmAnd::GeoTileRasterizer_P::rasterizeContours(
     std::shared_ptr<Metric>* const pOutMetric /*= nullptr*/,
     const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/)
@@ -532,11 +796,16 @@ QHash<OsmAnd::BandIndex, QList<std::shared_ptr<OsmAnd::GeoContour>>> OsmAnd::Geo
     if (queryController && queryController->isAborted())
         return QHash<BandIndex, QList<std::shared_ptr<GeoContour>>>();
 
-    QHash<BandIndex, QList<std::shared_ptr<GeoContour>>> bandContours;
+    QVector<BandGrid> bandsGrids;
+    QVector<QVector<double>> bandsLevels;
     for (auto band : owner->bands)
     {
         if (!owner->bandSettings.contains(band))
             continue;
+        const auto& contourLevels = owner->bandSettings[band]->contourLevels;
+        const auto citLevels = contourLevels.constFind(zoom);
+        if (citLevels == contourLevels.cend())
+            continue;
 
         auto bandIndexStr = QString::number(band).toLatin1();
         
@@ -606,157 +875,106 @@ QHash<OsmAnd::BandIndex, QList<std::shared_ptr<OsmAnd::GeoContour>>> OsmAnd::Geo
         if (queryController && queryController->isAborted())
             return QHash<BandIndex, QList<std::shared_ptr<GeoContour>>>();
 
-        if (owner->bandSettings.contains(band))
+        BandGrid bandGrid;
+        bandGrid.band = band;
+        if (!decodeBandGrid(hCroppedDS.get(), 1, bandGrid))
         {
-            auto levels = owner->bandSettings[band]->contourLevels;
-            if (levels.contains(zoom))
-            {
-                auto contours = evaluateBandContours(hCroppedDS.get(), 1, levels[zoom], tileBBox31, zoom);
-                if (!contours.empty())
-                    bandContours.insert(band, contours);
-            }
+            LogPrintf(LogSeverityLevel::Error,
+                "Failed to decode band %d of GeoTIFF %dx%d@%d: %s",
+                band,
+                tileId.x,
+                tileId.y,
+                zoom,
+                CPLGetLastErrorMsg());
+            return QHash<BandIndex, QList<std::shared_ptr<GeoContour>>>();
         }
+        bandsGrids.push_back(bandGrid);
+        bandsLevels.push_back(citLevels->toVector());
     }
 
-    return bandContours;
-}
+    if (queryController && queryController->isAborted())
+        return QHash<BandIndex, QList<std::shared_ptr<GeoContour>>>();
 
-QList<std::shared_ptr<OsmAnd::GeoContour>> OsmAnd::GeoTileRasterizer_P::evaluateBandContours(
-    GDALDatasetH hDataset,
-    const OsmAnd::BandIndex band,
-    QList<double>& levels,
-    const AreaI tileBBox31,
-    const ZoomLevel zoom)
-{
-    const char *pszDriverName = "ESRI Shapefile";
-    GDALDriver *driver = GetGDALDriverManager()->GetDriverByName(pszDriverName);
-    if (!driver)
+    // Contours of all bands are traced in parallel
+    QVector<ContourGenerator::Grid> grids;
+    for (const auto& bandGrid : constOf(bandsGrids))
     {
-        LogPrintf(LogSeverityLevel::Error, "%s driver not available", pszDriverName);
-        return QList<std::shared_ptr<GeoContour>>();
+        ContourGenerator::Grid grid;
+        grid.pValues = bandGrid.values.constData();
+        grid.width = bandGrid.width;
+        grid.height = bandGrid.height;
+        grid.hasNoData = bandGrid.hasNoData;
+        grid.noData = bandGrid.noData;
+        grids.push_back(grid);
     }
+    const auto gridsContours = ContourGenerator::generate(grids, bandsLevels);
 
-    auto rand = QRandomGenerator::global()->generate() % 1000;
-    const auto fileName = QString::asprintf("/vsimem/shapeFile%p_%d_%d_%dx%d@%d_contour_%d", this, band, levels.length(), tileBBox31.left(), tileBBox31.top(), zoom, rand);
-    std::shared_ptr<GDALDataset> spDataset(
-        driver->Create(qPrintable(fileName), 0, 0, 0, GDT_Float32, NULL),
-        [fileName]
-        (auto spDataset)
-        {
-            GDALClose(spDataset);
-            VSIUnlink(qPrintable(fileName));
-        }
-    );
-    if (!spDataset)
+    QHash<BandIndex, QList<std::shared_ptr<GeoContour>>> bandContours;
+    for (int bandGridIndex = 0; bandGridIndex < bandsGrids.size(); bandGridIndex++)
     {
-        LogPrintf(LogSeverityLevel::Error, "Creation of Gdal shape output file failed");
-        return QList<std::shared_ptr<GeoContour>>();
+        const auto& bandGrid = bandsGrids[bandGridIndex];
+        const auto contours = evaluateBandContours(bandGrid, gridsContours[bandGridIndex], tileBBox31);
+        if (!contours.empty())
+            bandContours.insert(bandGrid.band, contours);
     }
 
-    OGRLayer *layer = spDataset->CreateLayer("ContoursLayer", NULL, wkbMultiLineString, NULL );
-    if (!layer)
-    {
-        LogPrintf(LogSeverityLevel::Error, "Gdal layer creation failed %s", qPrintable(fileName));
-        return QList<std::shared_ptr<GeoContour>>();
-    }
-    
-    OGRFieldDefn valueField("Value", OFTReal);
-    if (layer->CreateField(&valueField) != OGRERR_NONE)
-    {
-        LogPrintf(LogSeverityLevel::Error, "Gdal layer creation value field failed");
-        return QList<std::shared_ptr<GeoContour>>();
-    }
-    
-    auto hBand = GDALGetRasterBand(hDataset, band);
+    return bandContours;
+}
 
-    QStringList levelsList;
-    for (auto level : levels)
-        levelsList << QString::number(level);
-    
-    char** options = nullptr;
-//    options = CSLAppendPrintf(options, "LEVEL_INTERVAL=%f", 2.0);
-    options = CSLAppendPrintf(options, "FIXED_LEVELS=%s", qPrintable(levelsList.join(QStringLiteral(","))));
-//    options = CSLAppendPrintf(options, "ID_FIELD=%d", 0);
-    options = CSLAppendPrintf(options, "ELEV_FIELD=%d", 0);
-//    options = CSLAppendPrintf(options, "ELEV_FIELD_MIN=%d", 2);
-//    options = CSLAppendPrintf(options, "ELEV_FIELD_MAX=%d", 3);
-    options = CSLAppendPrintf(options, "POLYGONIZE=NO");
-
-    auto err = GDALContourGenerateEx(hBand, layer, options, nullptr, NULL);
-    CSLDestroy(options);
-    
-    if (err != CE_None)
-    {
-        LogPrintf(LogSeverityLevel::Error,
-            "Failed to generate gdal layer contour lines: %s", CPLGetLastErrorMsg());
-        return QList<std::shared_ptr<GeoContour>>();
-    }
-    
-    OGRFeature *feature;
-    OGRMultiLineString *multiLine = static_cast<OGRMultiLineString *>(
-        OGRGeometryFactory::createGeometry(wkbMultiLineString));
-    QList<double> values;
-    layer->ResetReading();
-    
-    while ((feature = layer->GetNextFeature()) != nullptr)
-    {
-        OGRGeometry *geometry = feature->GetGeometryRef();
-        if (geometry == nullptr)
-        {
-            LogPrintf(LogSeverityLevel::Error,
-                "Gdal LineString feature without a geometry.");
-            OGRFeature::DestroyFeature(feature);
-            continue;
-        }
-        OGRwkbGeometryType eType = wkbFlatten(geometry->getGeometryType());
-        if (eType == wkbLineString)
-        {
-            if (multiLine->addGeometry(geometry) == OGRERR_NONE)
-                values << feature->GetFieldAsDouble(0);
-        }
-        else if (eType == wkbMultiLineString)
-        {
-            auto mls = geometry->toMultiLineString();
-            for (int iGeom = 0; iGeom < mls->getNumGeometries(); iGeom++)
-            {
-                if (multiLine->addGeometry(mls->getGeometryRef(iGeom)) == OGRERR_NONE)
-                    values << feature->GetFieldAsDouble(0);
-            }
-        }
-        OGRFeature::DestroyFeature(feature);
-    }
-    
-    if (multiLine->getNumGeometries() == 0)
-    {
-        OGRGeometryFactory::destroyGeometry(multiLine);
-        LogPrintf(LogSeverityLevel::Error,
-            "Did not get any LineString features");
-        return QList<std::shared_ptr<GeoContour>>();
-    }
+bool OsmAnd::GeoTileRasterizer_P::decodeBandGrid(
+    GDALDatasetH hDataset,
+    const int bandNumber,
+    BandGrid& outBandGrid) const
+{
+    const auto hBand = GDALGetRasterBand(hDataset, bandNumber);
+    if (!hBand || GDALGetGeoTransform(hDataset, outBandGrid.geoTransform.data()) != CE_None)
+        return false;
+
+    outBandGrid.width = GDALGetRasterXSize(hDataset);
+    outBandGrid.height = GDALGetRasterYSize(hDataset);
+    outBandGrid.values.resize(outBandGrid.width * outBandGrid.height);
+    int hasNoData = FALSE;
+    outBandGrid.noData = static_cast<float>(GDALGetRasterNoDataValue(hBand, &hasNoData));
+    outBandGrid.hasNoData = hasNoData != FALSE;
+
+    return GDALRasterIO(
+        hBand,
+        GF_Read,
+        0, 0, outBandGrid.width, outBandGrid.height,
+        outBandGrid.values.data(), outBandGrid.width, outBandGrid.height,
+        GDT_Float32,
+        0,
+        0) == CE_None;
+}
+
+QList<std::shared_ptr<OsmAnd::GeoContour>> OsmAnd::GeoTileRasterizer_P::evaluateBandContours(
+    const BandGrid& bandGrid,
+    const QList<ContourGenerator::Contour>& gridContours,
+    const AreaI tileBBox31) const
+{
+    const auto& geoTransform = bandGrid.geoTransform;
 
     QList<std::shared_ptr<GeoContour>> contours;
-    for (int iGeom = 0; iGeom < multiLine->getNumGeometries(); iGeom++)
+    for (const auto& gridContour : constOf(gridContours))
     {
-        auto geom = multiLine->getGeometryRef(iGeom);
-        auto count = geom->getNumPoints();
-        if (count > 1)
+        if (gridContour.points.size() < 2)
+            continue;
+
+        // Grid is georeferenced in longitude and latitude
+        QVector<PointI> points;
+        points.reserve(gridContour.points.size());
+        for (const auto& point : constOf(gridContour.points))
         {
-            QVector<PointI> points;
-            for (int i = 0; i < count; i++)
-            {
-                double x = geom->getX(i);
-                double y = geom->getY(i);
-                points << Utilities::convertLatLonTo31(LatLon(y, x));
-            }
-            auto segments = calculateVisibleSegments(points, tileBBox31);
-            for (auto& segment : constOf(segments))
-                if (segment.length() > 1)
-                    contours << std::make_shared<GeoContour>(values[iGeom], segment);
+            const auto x = geoTransform[0] + point.x * geoTransform[1] + point.y * geoTransform[2];
+            const auto y = geoTransform[3] + point.x * geoTransform[4] + point.y * geoTransform[5];
+            points << Utilities::convertLatLonTo31(LatLon(y, x));
         }
+        const auto segments = calculateVisibleSegments(points, tileBBox31);
+        for (const auto& segment : constOf(segments))
+            if (segment.length() > 1)
+                contours << std::make_shared<GeoContour>(gridContour.level, segment);
     }
-    
-    OGRGeometryFactory::destroyGeometry(multiLine);
-    
+
     return contours;
 }
 
@@ -2,19 +2,21 @@
 #define _OSMAND_CORE_GEO_TILE_RASTERIZER_P_H_
 
 #include "stdlib_common.h"
+#include <array>
 
 #include "QtExtensions.h"
 #include <QDir>
 #include <QMutex>
 #include <QQueue>
 #include <QSet>
-#include <QRandomGenerator>
 #include <gdal.h>
 
 #include "OsmAndCore.h"
 #include "CommonTypes.h"
 #include "PrivateImplementation.h"
 #include "GeoTileRasterizer.h"
+#include "ContourGenerator.h"
+#include "GeoTileGrid.h"
 
 namespace OsmAnd
 {
@@ -32,6 +34,47 @@ namespace OsmAnd
             std::shared_ptr<Metric>* const pOutMetric = nullptr,
             const std::shared_ptr<const IQueryController>& queryController = nullptr);
 
+        // Color profile of band sampled over range of its values, so that colorization is single table lookup
+        struct ColorLookupTable
+        {
+            enum {
+                Size = 4096,
+                NoDataIndex = Size,
+            };
+
+            float minValue;
+            float scale;
+            // RGBA colors of sampled values, followed by color of no-data
+            std::array<uint32_t, Size + 1> colors;
+        };
+        static std::shared_ptr<const ColorLookupTable> obtainColorLookupTable(const QString& colorProfilePath);
+
+        // Source grid pixels that are interpolated for output row or column
+        struct PixelSample
+        {
+            int32_t index0;
+            int32_t index1;
+            float weight;
+            bool valid;
+        };
+        void computePixelSamples(
+            const GeoTileGrid& grid,
+            QVector<PixelSample>& outColumns,
+            QVector<PixelSample>& outRows) const;
+        static void colorizeBand(
+            const GeoTileGrid& grid,
+            const GeoTileGrid::Band& band,
+            const QVector<PixelSample>& columns,
+            const QVector<PixelSample>& rows,
+            const ColorLookupTable& colors,
+            uint32_t* const pOutRGBA);
+
+        QHash<BandIndex, sk_sp<const SkImage>> rasterizeNatively(
+            QHash<BandIndex, QByteArray>& outEncImgData,
+            bool fillEncImgData,
+            QList<BandIndex>& outFailedBands,
+            const std::shared_ptr<const IQueryController>& queryController) const;
+
         sk_sp<SkImage> rasterizeContours(
             GDALDatasetH hDataset,
             const OsmAnd::BandIndex band,
@@ -46,12 +89,23 @@ namespace OsmAnd
             std::shared_ptr<Metric>* const pOutMetric = nullptr,
             const std::shared_ptr<const IQueryController>& queryController = nullptr);
         
+        // Decoded band of cropped GeoTIFF
+        struct BandGrid
+        {
+            BandIndex band;
+            QVector<float> values;
+            uint32_t width;
+            uint32_t height;
+            bool hasNoData;
+            float noData;
+            std::array<double, 6> geoTransform;
+        };
+
+        bool decodeBandGrid(GDALDatasetH hDataset, const int bandNumber, BandGrid& outBandGrid) const;
         QList<std::shared_ptr<GeoContour>> evaluateBandContours(
-            GDALDatasetH hDataset,
-            const OsmAnd::BandIndex band,
-            QList<double>& levels,
-            const AreaI tileBBox31,
-            const ZoomLevel zoom);
+            const BandGrid& bandGrid,
+            const QList<ContourGenerator::Contour>& gridContours,
+            const AreaI tileBBox31) const;
 
         QVector<QVector<PointI>> calculateVisibleSegments(const QVector<PointI>& points, const AreaI bbox31) const;
 
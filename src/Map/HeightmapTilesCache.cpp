@@ -0,0 +1,188 @@
+#include "HeightmapTilesCache.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+OsmAnd::HeightmapTilesCache::HeightmapTilesCache(const size_t maxSize)
+{
+    // Cost of each entry is measured in kilobytes
+    _cache.setMaxCost(static_cast<int>(std::min<size_t>(maxSize / 1024, std::numeric_limits<int>::max())));
+}
+
+OsmAnd::HeightmapTilesCache::~HeightmapTilesCache()
+{
+}
+
+size_t OsmAnd::HeightmapTilesCache::getMaxSize() const
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    return static_cast<size_t>(_cache.maxCost()) * 1024;
+}
+
+void OsmAnd::HeightmapTilesCache::setMaxSize(const size_t maxSize)
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    _cache.setMaxCost(static_cast<int>(std::min<size_t>(maxSize / 1024, std::numeric_limits<int>::max())));
+}
+
+void OsmAnd::HeightmapTilesCache::clear()
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    _cache.clear();
+}
+
+OsmAnd::HeightmapTilesCache::Heights OsmAnd::HeightmapTilesCache::obtain(const Key& key) const
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    return getHeights(key);
+}
+
+void OsmAnd::HeightmapTilesCache::store(const Key& key, const Heights& heights)
+{
+    if (!heights || heights->size() != static_cast<int>(key.size * key.size))
+        return;
+
+    const auto cost = std::max(1, static_cast<int>(heights->size() * sizeof(float) / 1024));
+
+    QMutexLocker scopedLocker(&_lock);
+
+    _cache.insert(key, new Heights(heights), cost);
+}
+
+OsmAnd::HeightmapTilesCache::Heights OsmAnd::HeightmapTilesCache::getHeights(const Key& key) const
+{
+    // Also marks entry as most recently used
+    const auto pHeights = _cache.object(key);
+    return pHeights ? *pHeights : nullptr;
+}
+
+OsmAnd::HeightmapTilesCache::Heights OsmAnd::HeightmapTilesCache::deriveFromChildren(const Key& key) const
+{
+    if (key.zoom >= MaxZoomLevel || key.size <= key.overlap)
+        return nullptr;
+
+    std::array<Heights, 4> children;
+    {
+        QMutexLocker scopedLocker(&_lock);
+
+        for (int childIdx = 0; childIdx < 4; childIdx++)
+        {
+            Key childKey = key;
+            childKey.tileId.x = (key.tileId.x << 1) + (childIdx & 1);
+            childKey.tileId.y = (key.tileId.y << 1) + (childIdx >> 1);
+            childKey.zoom = static_cast<ZoomLevel>(key.zoom + 1);
+            children[childIdx] = getHeights(childKey);
+            if (!children[childIdx])
+                return nullptr;
+        }
+    }
+
+    // Pixel 'i' is centered at (i - halfOverlap) pixels from tile edge
+    const auto size = key.size;
+    const auto innerSize = static_cast<double>(size - key.overlap);
+    const auto halfOverlap = static_cast<double>(key.overlap) * 0.5 - 0.5;
+    const auto sampleChildren =
+        [&children, size, innerSize, halfOverlap]
+        (const double x, const double y) -> float
+        {
+            const auto childX = x - halfOverlap >= innerSize ? 1 : 0;
+            const auto childY = y - halfOverlap >= innerSize ? 1 : 0;
+            return sample(children[childY * 2 + childX]->constData(), size,
+                x - childX * innerSize, y - childY * innerSize);
+        };
+
+    // Each parent pixel covers 2x2 child pixels, so children are filtered with [1 2 1] kernel in both directions
+    const auto pHeights = std::make_shared<QVector<float>>(size * size);
+    auto pHeight = pHeights->data();
+    for (uint32_t row = 0; row < size; row++)
+    {
+        const auto y = 2.0 * (row - halfOverlap) + halfOverlap;
+        for (uint32_t col = 0; col < size; col++, pHeight++)
+        {
+            const auto x = 2.0 * (col - halfOverlap) + halfOverlap;
+            const auto top = sampleChildren(x - 1.0, y - 1.0) + 2.0f * sampleChildren(x, y - 1.0)
+                + sampleChildren(x + 1.0, y - 1.0);
+            const auto middle = sampleChildren(x - 1.0, y) + 2.0f * sampleChildren(x, y)
+                + sampleChildren(x + 1.0, y);
+            const auto bottom = sampleChildren(x - 1.0, y + 1.0) + 2.0f * sampleChildren(x, y + 1.0)
+                + sampleChildren(x + 1.0, y + 1.0);
+            *pHeight = (top + 2.0f * middle + bottom) / 16.0f;
+        }
+    }
+
+    return pHeights;
+}
+
+OsmAnd::HeightmapTilesCache::Heights OsmAnd::HeightmapTilesCache::deriveFromAncestor(const Key& key) const
+{
+    if (key.size <= key.overlap)
+        return nullptr;
+
+    Heights ancestor;
+    int zoomDelta = 1;
+    {
+        QMutexLocker scopedLocker(&_lock);
+
+        for (; zoomDelta <= MaxUpsampleZoomDelta && key.zoom - zoomDelta >= MinZoomLevel; zoomDelta++)
+        {
+            Key ancestorKey = key;
+            ancestorKey.tileId.x = key.tileId.x >> zoomDelta;
+            ancestorKey.tileId.y = key.tileId.y >> zoomDelta;
+            ancestorKey.zoom = static_cast<ZoomLevel>(key.zoom - zoomDelta);
+            if ((ancestor = getHeights(ancestorKey)))
+                break;
+        }
+    }
+    if (!ancestor)
+        return nullptr;
+
+    // Position of tile inside ancestor, in pixels of tile
+    const auto size = key.size;
+    const auto innerSize = static_cast<double>(size - key.overlap);
+    const auto halfOverlap = static_cast<double>(key.overlap) * 0.5 - 0.5;
+    const auto scale = 1.0 / static_cast<double>(1u << zoomDelta);
+    const auto offsetX = static_cast<double>(key.tileId.x - ((key.tileId.x >> zoomDelta) << zoomDelta)) * innerSize;
+    const auto offsetY = static_cast<double>(key.tileId.y - ((key.tileId.y >> zoomDelta) << zoomDelta)) * innerSize;
+
+    const auto pHeights = std::make_shared<QVector<float>>(size * size);
+    auto pHeight = pHeights->data();
+    for (uint32_t row = 0; row < size; row++)
+    {
+        const auto y = (row - halfOverlap + offsetY) * scale + halfOverlap;
+        for (uint32_t col = 0; col < size; col++, pHeight++)
+        {
+            const auto x = (col - halfOverlap + offsetX) * scale + halfOverlap;
+            *pHeight = sample(ancestor->constData(), size, x, y);
+        }
+    }
+
+    return pHeights;
+}
+
+float OsmAnd::HeightmapTilesCache::sample(
+    const float* const pHeights,
+    const uint32_t size,
+    const double x,
+    const double y)
+{
+    const auto maxCoordinate = static_cast<double>(size - 1);
+    const auto clampedX = qBound(0.0, x, maxCoordinate);
+    const auto clampedY = qBound(0.0, y, maxCoordinate);
+    const auto x0 = static_cast<uint32_t>(clampedX);
+    const auto y0 = static_cast<uint32_t>(clampedY);
+    const auto x1 = std::min(x0 + 1, size - 1);
+    const auto y1 = std::min(y0 + 1, size - 1);
+    const auto fx = static_cast<float>(clampedX - x0);
+    const auto fy = static_cast<float>(clampedY - y0);
+
+    const auto pTop = pHeights + y0 * size;
+    const auto pBottom = pHeights + y1 * size;
+    const auto top = pTop[x0] + (pTop[x1] - pTop[x0]) * fx;
+    const auto bottom = pBottom[x0] + (pBottom[x1] - pBottom[x0]) * fx;
+    return top + (bottom - top) * fy;
+}
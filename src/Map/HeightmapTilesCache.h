@@ -0,0 +1,73 @@
+#ifndef _OSMAND_CORE_HEIGHTMAP_TILES_CACHE_H_
+#define _OSMAND_CORE_HEIGHTMAP_TILES_CACHE_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QCache>
+#include <QMutex>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+
+namespace OsmAnd
+{
+    // In-memory LRU cache of decoded heightmap tiles. Missing tiles can be derived from cached tiles of
+    // adjacent zoom levels: downsampled from all 4 children or upsampled from closest ancestor.
+    class HeightmapTilesCache Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(HeightmapTilesCache);
+    public:
+        struct Key
+        {
+            TileId tileId;
+            ZoomLevel zoom;
+            uint32_t size;
+            uint32_t overlap;
+
+            inline bool operator==(const Key& that) const
+            {
+                return tileId.id == that.tileId.id && zoom == that.zoom && size == that.size && overlap == that.overlap;
+            }
+        };
+
+        // Heights of size x size pixels, where tile area is extended by overlap/2 pixels on each side
+        typedef std::shared_ptr<const QVector<float>> Heights;
+
+        enum {
+            // How many zoom levels up to look for a tile to upsample
+            MaxUpsampleZoomDelta = 4,
+        };
+    private:
+        mutable QMutex _lock;
+        QCache<Key, Heights> _cache;
+
+        Heights getHeights(const Key& key) const;
+
+        static float sample(const float* const pHeights, const uint32_t size, const double x, const double y);
+    protected:
+    public:
+        HeightmapTilesCache(const size_t maxSize);
+        ~HeightmapTilesCache();
+
+        size_t getMaxSize() const;
+        void setMaxSize(const size_t maxSize);
+        void clear();
+
+        Heights obtain(const Key& key) const;
+        void store(const Key& key, const Heights& heights);
+
+        Heights deriveFromChildren(const Key& key) const;
+        Heights deriveFromAncestor(const Key& key) const;
+    };
+
+    inline uint qHash(const HeightmapTilesCache::Key& key, uint seed = 0)
+    {
+        return ::qHash(key.tileId.id, seed) ^ ::qHash((key.size << 8) | (key.overlap << 5) | key.zoom, seed);
+    }
+}
+
+#endif // !defined(_OSMAND_CORE_HEIGHTMAP_TILES_CACHE_H_)
@@ -27,6 +27,10 @@ OsmAnd::HillshadeRasterMapLayerProvider::HillshadeRasterMapLayerProvider(
     , _maxVisibleZoom(maxZoom)
     , _priority(0)
 {
+    // Heights read for this layer are shared with other terrain layers of same tile size
+    const uint32_t overlap = HillshadeRasterMapLayerProvider_P::Overlap;
+    if (filesCollection)
+        filesCollection->registerHeightsConsumer(tileSize + overlap, overlap, true);
 }
 
 OsmAnd::HillshadeRasterMapLayerProvider::~HillshadeRasterMapLayerProvider()
@@ -34,6 +38,10 @@ OsmAnd::HillshadeRasterMapLayerProvider::~HillshadeRasterMapLayerProvider()
      QMutexLocker scopedLocker(&_threadPoolMutex);
     _threadPool->clear();
     delete _threadPool;
+
+    const uint32_t overlap = HillshadeRasterMapLayerProvider_P::Overlap;
+    if (filesCollection)
+        filesCollection->unregisterHeightsConsumer(_p->tileSize + overlap, overlap, true);
 }
 
 OsmAnd::MapStubStyle OsmAnd::HillshadeRasterMapLayerProvider::getDesiredStubsStyle() const
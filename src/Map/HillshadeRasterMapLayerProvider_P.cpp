@@ -97,8 +97,7 @@ bool OsmAnd::HillshadeRasterMapLayerProvider_P::obtainData(
 
     // Produce hillshade RGBA values from height values
     const int bandCount = 4;
-    // Extra pixels on both edges give more accurate hillshade calculations
-    const int overlap = 4;
+    const int overlap = Overlap;
     const auto bufferSize = tileSize * tileSize * bandCount;
     const auto pBuffer = new char[bufferSize];
     const auto result = owner->filesCollection->getGeoTiffData(
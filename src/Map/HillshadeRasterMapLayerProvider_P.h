@@ -38,6 +38,11 @@ namespace OsmAnd
             const uint32_t tileSize,
             const float densityFactor);
     public:
+        // Extra pixels on both edges give more accurate hillshade calculations
+        enum {
+            Overlap = 4,
+        };
+
         virtual ~HillshadeRasterMapLayerProvider_P();
 
         ImplementationInterface<HillshadeRasterMapLayerProvider> owner;
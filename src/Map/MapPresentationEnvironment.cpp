@@ -36,6 +36,11 @@ OsmAnd::MapPresentationEnvironment::getSettings() const
     return _p->getSettings();
 }
 
+unsigned int OsmAnd::MapPresentationEnvironment::getSettingsRevision() const
+{
+    return _p->getSettingsRevision();
+}
+
 void OsmAnd::MapPresentationEnvironment::setSettings(
     const QHash< OsmAnd::IMapStyle::ValueDefinitionId, MapStyleConstantValue >& newSettings)
 {
@@ -47,6 +52,12 @@ void OsmAnd::MapPresentationEnvironment::setSettings(const QHash< QString, QStri
     _p->setSettings(newSettings);
 }
 
+std::shared_ptr<OsmAnd::MapStyleEvaluationResultsCache> OsmAnd::MapPresentationEnvironment::getStyleEvaluationResultsCache(
+    const ZoomLevel zoom) const
+{
+    return _p->getStyleEvaluationResultsCache(zoom);
+}
+
 void OsmAnd::MapPresentationEnvironment::applyTo(MapStyleEvaluator& evaluator) const
 {
     _p->applyTo(evaluator);
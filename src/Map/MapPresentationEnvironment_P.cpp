@@ -12,6 +12,7 @@
 
 #include "MapStyleEvaluator.h"
 #include "MapStyleEvaluationResult.h"
+#include "MapStyleEvaluationResultsCache.h"
 #include "MapStyleValueDefinition.h"
 #include "MapStyleConstantValue.h"
 #include "MapStyleBuiltinValueDefinitions.h"
@@ -24,7 +25,8 @@
 #include "Logging.h"
 
 OsmAnd::MapPresentationEnvironment_P::MapPresentationEnvironment_P(MapPresentationEnvironment* owner_)
-    : owner(owner_)
+    : _settingsRevision(0)
+    , owner(owner_)
 {
 }
 
@@ -71,11 +73,44 @@ QHash< OsmAnd::IMapStyle::ValueDefinitionId, OsmAnd::MapStyleConstantValue > Osm
     return detachedOf(_settings);
 }
 
-void OsmAnd::MapPresentationEnvironment_P::setSettings(const QHash< OsmAnd::IMapStyle::ValueDefinitionId, MapStyleConstantValue >& newSettings)
+unsigned int OsmAnd::MapPresentationEnvironment_P::getSettingsRevision() const
 {
     QMutexLocker scopedLocker(&_settingsChangeMutex);
 
-    _settings = newSettings;
+    return _settingsRevision;
+}
+
+void OsmAnd::MapPresentationEnvironment_P::setSettings(const QHash< OsmAnd::IMapStyle::ValueDefinitionId, MapStyleConstantValue >& newSettings)
+{
+    {
+        QMutexLocker scopedLocker(&_settingsChangeMutex);
+
+        _settings = newSettings;
+        _settingsRevision++;
+    }
+
+    // Results evaluated with previous settings will never be requested again
+    resetStyleEvaluationResultsCaches();
+}
+
+std::shared_ptr<OsmAnd::MapStyleEvaluationResultsCache> OsmAnd::MapPresentationEnvironment_P::getStyleEvaluationResultsCache(
+    const ZoomLevel zoom) const
+{
+    QMutexLocker scopedLocker(&_styleEvaluationResultsCachesMutex);
+
+    auto& resultsCache = _styleEvaluationResultsCaches[zoom];
+    if (!resultsCache)
+        resultsCache.reset(new MapStyleEvaluationResultsCache());
+    return resultsCache;
+}
+
+void OsmAnd::MapPresentationEnvironment_P::resetStyleEvaluationResultsCaches()
+{
+    QMutexLocker scopedLocker(&_styleEvaluationResultsCachesMutex);
+
+    // Caches still in use by evaluators are released with them
+    for (auto& resultsCache : _styleEvaluationResultsCaches)
+        resultsCache.reset();
 }
 
 QHash<OsmAnd::IMapStyle::ValueDefinitionId, OsmAnd::MapStyleConstantValue> OsmAnd::MapPresentationEnvironment_P::resolveSettings(const QHash<QString, QString> &newSettings) const
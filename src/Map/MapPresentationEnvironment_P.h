@@ -2,6 +2,7 @@
 #define _OSMAND_CORE_MAP_PRESENTATION_ENVIRONMENT_P_H_
 
 #include "stdlib_common.h"
+#include <array>
 
 #include "QtExtensions.h"
 #include "ignore_warnings_on_external_includes.h"
@@ -28,6 +29,7 @@ namespace OsmAnd
     class UnresolvedMapStyle;
     class MapStyleEvaluator;
     class MapStyleEvaluator_P;
+    class MapStyleEvaluationResultsCache;
 
     class MapPresentationEnvironment_P Q_DECL_FINAL
     {
@@ -47,6 +49,7 @@ namespace OsmAnd
 
         mutable QMutex _settingsChangeMutex;
         QHash< IMapStyle::ValueDefinitionId, MapStyleConstantValue > _settings;
+        unsigned int _settingsRevision;
 
         std::shared_ptr<const IMapStyle::IAttribute> _defaultBackgroundColorAttribute;
         ColorARGB _defaultBackgroundColor;
@@ -89,6 +92,10 @@ namespace OsmAnd
         mutable QMutex _iconShieldsMutex;
         mutable QHash< QString, sk_sp<const SkImage> > _iconShields;
 
+        mutable QMutex _styleEvaluationResultsCachesMutex;
+        mutable std::array< std::shared_ptr<MapStyleEvaluationResultsCache>, ZoomLevelsCount > _styleEvaluationResultsCaches;
+        void resetStyleEvaluationResultsCaches();
+
         QByteArray obtainResourceByName(const QString& name) const;
     public:
         virtual ~MapPresentationEnvironment_P();
@@ -96,11 +103,13 @@ namespace OsmAnd
         ImplementationInterface<MapPresentationEnvironment> owner;
 
         QHash< IMapStyle::ValueDefinitionId, MapStyleConstantValue > getSettings() const;
+        unsigned int getSettingsRevision() const;
         void setSettings(const QHash< OsmAnd::IMapStyle::ValueDefinitionId, MapStyleConstantValue >& newSettings);
         
         void setSettings(const QHash< QString, QString >& newSettings);
 
         void applyTo(MapStyleEvaluator& evaluator) const;
+        std::shared_ptr<MapStyleEvaluationResultsCache> getStyleEvaluationResultsCache(const ZoomLevel zoom) const;
         void applyTo(MapStyleEvaluator &evaluator, const QHash< IMapStyle::ValueDefinitionId, MapStyleConstantValue > &settings) const;
 
         bool obtainShader(const QString& name, sk_sp<const SkImage>& outShader) const;
@@ -0,0 +1,68 @@
+#include "MapPrimitivesDiskCache.h"
+#include "MapPrimitivesDiskCache_P.h"
+
+OsmAnd::MapPrimitivesDiskCache::MapPrimitivesDiskCache(
+    const QString& filename_,
+    const uint64_t maxSize_ /*= DefaultMaxSize*/)
+    : _p(new MapPrimitivesDiskCache_P(this))
+    , filename(filename_)
+    , maxSize(maxSize_)
+{
+}
+
+OsmAnd::MapPrimitivesDiskCache::~MapPrimitivesDiskCache()
+{
+}
+
+bool OsmAnd::MapPrimitivesDiskCache::isOpened() const
+{
+    return _p->isOpened();
+}
+
+bool OsmAnd::MapPrimitivesDiskCache::open()
+{
+    return _p->open();
+}
+
+bool OsmAnd::MapPrimitivesDiskCache::close()
+{
+    return _p->close();
+}
+
+uint64_t OsmAnd::MapPrimitivesDiskCache::getSize() const
+{
+    return _p->getSize();
+}
+
+int OsmAnd::MapPrimitivesDiskCache::getHits() const
+{
+    return _p->getHits();
+}
+
+int OsmAnd::MapPrimitivesDiskCache::getMisses() const
+{
+    return _p->getMisses();
+}
+
+bool OsmAnd::MapPrimitivesDiskCache::obtainData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const uint64_t key,
+    QByteArray& outData)
+{
+    return _p->obtainData(tileId, zoom, key, outData);
+}
+
+bool OsmAnd::MapPrimitivesDiskCache::storeData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const uint64_t key,
+    const QByteArray& data)
+{
+    return _p->storeData(tileId, zoom, key, data);
+}
+
+bool OsmAnd::MapPrimitivesDiskCache::removeAllData()
+{
+    return _p->removeAllData();
+}
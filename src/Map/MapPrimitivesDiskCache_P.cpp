@@ -0,0 +1,377 @@
+#include "MapPrimitivesDiskCache_P.h"
+#include "MapPrimitivesDiskCache.h"
+
+#include "Logging.h"
+
+OsmAnd::MapPrimitivesDiskCache_P::MapPrimitivesDiskCache_P(MapPrimitivesDiskCache* const owner_)
+    : _isOpened(0)
+    , _size(0)
+    , _lastAccessStamp(0)
+    , _hits(0)
+    , _misses(0)
+    , owner(owner_)
+{
+}
+
+OsmAnd::MapPrimitivesDiskCache_P::~MapPrimitivesDiskCache_P()
+{
+    close();
+}
+
+bool OsmAnd::MapPrimitivesDiskCache_P::isOpened() const
+{
+    return _isOpened.loadAcquire() != 0;
+}
+
+bool OsmAnd::MapPrimitivesDiskCache_P::open()
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    if (isOpened())
+        return true;
+
+    sqlite3* pDatabase = nullptr;
+    const auto res = sqlite3_open16(owner->filename.utf16(), &pDatabase);
+    const std::shared_ptr<sqlite3> database(pDatabase, sqlite3_close);
+    if (res != SQLITE_OK)
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to open primitives cache '%s': %s (%s)",
+            qPrintable(owner->filename),
+            database ? sqlite3_errmsg(database.get()) : "N/A",
+            sqlite3_errstr(res));
+        return false;
+    }
+
+    // Cached data can always be regenerated, so durability is traded for speed
+    if (!execStatement(database, QStringLiteral("PRAGMA journal_mode = WAL")) ||
+        !execStatement(database, QStringLiteral("PRAGMA synchronous = NORMAL")))
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to configure primitives cache '%s': %s",
+            qPrintable(owner->filename),
+            sqlite3_errmsg(database.get()));
+        return false;
+    }
+
+    if (!execStatement(database, QStringLiteral(
+            "CREATE TABLE IF NOT EXISTS tiles("
+            "   x INTEGER NOT NULL,"
+            "   y INTEGER NOT NULL,"
+            "   z INTEGER NOT NULL,"
+            "   k INTEGER NOT NULL,"
+            "   data BLOB NOT NULL,"
+            "   size INTEGER NOT NULL,"
+            "   accessed INTEGER NOT NULL,"
+            "   PRIMARY KEY (x, y, z, k)"
+            ")")) ||
+        !execStatement(database, QStringLiteral("CREATE INDEX IF NOT EXISTS tiles_accessed ON tiles(accessed)")))
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to create tables in primitives cache '%s': %s",
+            qPrintable(owner->filename),
+            sqlite3_errmsg(database.get()));
+        return false;
+    }
+
+    const auto statement = prepareStatement(database,
+        QStringLiteral("SELECT COALESCE(SUM(size), 0), COALESCE(MAX(accessed), 0) FROM tiles"));
+    if (!statement || stepStatement(statement) <= 0)
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to read size of primitives cache '%s': %s",
+            qPrintable(owner->filename),
+            sqlite3_errmsg(database.get()));
+        return false;
+    }
+    _size = static_cast<uint64_t>(sqlite3_column_int64(statement.get(), 0));
+    _lastAccessStamp = sqlite3_column_int64(statement.get(), 1);
+
+    _database = database;
+    _isOpened.storeRelease(1);
+
+    return true;
+}
+
+bool OsmAnd::MapPrimitivesDiskCache_P::close()
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    if (!isOpened())
+        return true;
+
+    // Statements have to be finalized before database can be closed
+    _statements.clear();
+    _database.reset();
+    _size = 0;
+    _lastAccessStamp = 0;
+    _isOpened.storeRelease(0);
+
+    return true;
+}
+
+uint64_t OsmAnd::MapPrimitivesDiskCache_P::getSize() const
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    return _size;
+}
+
+int OsmAnd::MapPrimitivesDiskCache_P::getHits() const
+{
+    return _hits.loadAcquire();
+}
+
+int OsmAnd::MapPrimitivesDiskCache_P::getMisses() const
+{
+    return _misses.loadAcquire();
+}
+
+bool OsmAnd::MapPrimitivesDiskCache_P::obtainData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const uint64_t key,
+    QByteArray& outData)
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    if (!isOpened())
+        return false;
+
+    const auto selectStatement = obtainStatement(
+        QStringLiteral("SELECT data FROM tiles WHERE x=?1 AND y=?2 AND z=?3 AND k=?4"));
+    if (!selectStatement || !configureStatement(selectStatement, tileId, zoom, key))
+        return false;
+
+    const auto res = stepStatement(selectStatement);
+    if (res <= 0)
+    {
+        if (res < 0)
+        {
+            LogPrintf(
+                LogSeverityLevel::Error,
+                "Failed to obtain cached primitives of %dx%d@%d: %s",
+                tileId.x,
+                tileId.y,
+                zoom,
+                sqlite3_errmsg(_database.get()));
+        }
+
+        _misses.fetchAndAddOrdered(1);
+        return false;
+    }
+    outData = QByteArray(
+        static_cast<const char*>(sqlite3_column_blob(selectStatement.get(), 0)),
+        sqlite3_column_bytes(selectStatement.get(), 0));
+    _hits.fetchAndAddOrdered(1);
+
+    // Mark entry as most recently used
+    const auto updateStatement = obtainStatement(
+        QStringLiteral("UPDATE tiles SET accessed=?5 WHERE x=?1 AND y=?2 AND z=?3 AND k=?4"));
+    if (!updateStatement || !configureStatement(updateStatement, tileId, zoom, key) ||
+        sqlite3_bind_int64(updateStatement.get(), 5, ++_lastAccessStamp) != SQLITE_OK ||
+        stepStatement(updateStatement) < 0)
+    {
+        LogPrintf(
+            LogSeverityLevel::Warning,
+            "Failed to update access stamp of cached primitives of %dx%d@%d: %s",
+            tileId.x,
+            tileId.y,
+            zoom,
+            sqlite3_errmsg(_database.get()));
+    }
+
+    return true;
+}
+
+bool OsmAnd::MapPrimitivesDiskCache_P::storeData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const uint64_t key,
+    const QByteArray& data)
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    if (!isOpened())
+        return false;
+
+    // Entry may be replaced, so account its size first
+    uint64_t previousSize = 0;
+    const auto selectStatement = obtainStatement(
+        QStringLiteral("SELECT size FROM tiles WHERE x=?1 AND y=?2 AND z=?3 AND k=?4"));
+    if (!selectStatement || !configureStatement(selectStatement, tileId, zoom, key))
+        return false;
+    if (stepStatement(selectStatement) > 0)
+        previousSize = static_cast<uint64_t>(sqlite3_column_int64(selectStatement.get(), 0));
+
+    const auto insertStatement = obtainStatement(
+        QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, k, data, size, accessed) VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7)"));
+    if (!insertStatement || !configureStatement(insertStatement, tileId, zoom, key) ||
+        sqlite3_bind_blob(insertStatement.get(), 5, data.constData(), data.size(), SQLITE_STATIC) != SQLITE_OK ||
+        sqlite3_bind_int64(insertStatement.get(), 6, data.size()) != SQLITE_OK ||
+        sqlite3_bind_int64(insertStatement.get(), 7, ++_lastAccessStamp) != SQLITE_OK)
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to configure query for cached primitives of %dx%d@%d",
+            tileId.x,
+            tileId.y,
+            zoom);
+        return false;
+    }
+    if (stepStatement(insertStatement) < 0)
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to store cached primitives of %dx%d@%d: %s",
+            tileId.x,
+            tileId.y,
+            zoom,
+            sqlite3_errmsg(_database.get()));
+        return false;
+    }
+    _size = _size - previousSize + static_cast<uint64_t>(data.size());
+
+    if (_size > owner->maxSize)
+        evictLeastRecentlyUsed();
+
+    return true;
+}
+
+bool OsmAnd::MapPrimitivesDiskCache_P::removeAllData()
+{
+    QMutexLocker scopedLocker(&_lock);
+
+    if (!isOpened())
+        return false;
+
+    if (!execStatement(_database, QStringLiteral("DELETE FROM tiles")))
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to clear primitives cache '%s': %s",
+            qPrintable(owner->filename),
+            sqlite3_errmsg(_database.get()));
+        return false;
+    }
+    _size = 0;
+
+    return true;
+}
+
+bool OsmAnd::MapPrimitivesDiskCache_P::evictLeastRecentlyUsed()
+{
+    // Evict down to 3/4 of the limit, so that eviction doesn't happen on each store
+    const auto targetSize = owner->maxSize / 4 * 3;
+
+    const auto selectStatement = obtainStatement(
+        QStringLiteral("SELECT accessed, size FROM tiles ORDER BY accessed ASC"));
+    if (!selectStatement)
+        return false;
+
+    auto size = _size;
+    int64_t accessStampThreshold = -1;
+    while (size > targetSize && stepStatement(selectStatement) > 0)
+    {
+        accessStampThreshold = sqlite3_column_int64(selectStatement.get(), 0);
+        size -= std::min(size, static_cast<uint64_t>(sqlite3_column_int64(selectStatement.get(), 1)));
+    }
+    if (accessStampThreshold < 0)
+        return true;
+
+    const auto deleteStatement = obtainStatement(
+        QStringLiteral("DELETE FROM tiles WHERE accessed<=?1"));
+    if (!deleteStatement ||
+        sqlite3_bind_int64(deleteStatement.get(), 1, accessStampThreshold) != SQLITE_OK ||
+        stepStatement(deleteStatement) < 0)
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to evict data from primitives cache '%s': %s",
+            qPrintable(owner->filename),
+            sqlite3_errmsg(_database.get()));
+        return false;
+    }
+    _size = size;
+
+    return true;
+}
+
+bool OsmAnd::MapPrimitivesDiskCache_P::configureStatement(
+    const std::shared_ptr<sqlite3_stmt>& statement,
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const uint64_t key) const
+{
+    return sqlite3_bind_int(statement.get(), 1, tileId.x) == SQLITE_OK
+        && sqlite3_bind_int(statement.get(), 2, tileId.y) == SQLITE_OK
+        && sqlite3_bind_int(statement.get(), 3, static_cast<int>(zoom)) == SQLITE_OK
+        && sqlite3_bind_int64(statement.get(), 4, static_cast<sqlite3_int64>(key)) == SQLITE_OK;
+}
+
+std::shared_ptr<sqlite3_stmt> OsmAnd::MapPrimitivesDiskCache_P::obtainStatement(const QString& sql)
+{
+    auto& statement = _statements[sql];
+    if (!statement)
+    {
+        statement = prepareStatement(_database, sql);
+        if (!statement)
+        {
+            _statements.remove(sql);
+            return nullptr;
+        }
+    }
+
+    // Returned reference doesn't finalize statement, but resets it for next use
+    const auto cachedStatement = statement;
+    return std::shared_ptr<sqlite3_stmt>(cachedStatement.get(),
+        [cachedStatement]
+        (sqlite3_stmt* const pStatement)
+        {
+            sqlite3_reset(pStatement);
+            sqlite3_clear_bindings(pStatement);
+        });
+}
+
+std::shared_ptr<sqlite3_stmt> OsmAnd::MapPrimitivesDiskCache_P::prepareStatement(
+    const std::shared_ptr<sqlite3>& db,
+    const QString& sql)
+{
+    sqlite3_stmt* pStatement = nullptr;
+    const auto res = sqlite3_prepare16_v2(db.get(), sql.utf16(), -1, &pStatement, nullptr);
+    const std::shared_ptr<sqlite3_stmt> statement(pStatement, sqlite3_finalize);
+    if (res != SQLITE_OK)
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to prepare statement from '%s': %s (%s)",
+            qPrintable(sql),
+            sqlite3_errmsg(db.get()),
+            sqlite3_errstr(res));
+        return nullptr;
+    }
+    return statement;
+}
+
+int OsmAnd::MapPrimitivesDiskCache_P::stepStatement(const std::shared_ptr<sqlite3_stmt>& statement)
+{
+    switch (sqlite3_step(statement.get()))
+    {
+        case SQLITE_ROW:
+            return 1;
+        case SQLITE_DONE:
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+bool OsmAnd::MapPrimitivesDiskCache_P::execStatement(const std::shared_ptr<sqlite3>& db, const QString& sql)
+{
+    const auto statement = prepareStatement(db, sql);
+    return statement && stepStatement(statement) >= 0;
+}
@@ -0,0 +1,77 @@
+#ifndef _OSMAND_CORE_MAP_PRIMITIVES_DISK_CACHE_P_H_
+#define _OSMAND_CORE_MAP_PRIMITIVES_DISK_CACHE_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QAtomicInt>
+#include <QMutex>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include "restore_internal_warnings.h"
+
+#include "ignore_warnings_on_external_includes.h"
+#include <sqlite3.h>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "MapPrimitivesDiskCache.h"
+
+namespace OsmAnd
+{
+    class MapPrimitivesDiskCache;
+    class MapPrimitivesDiskCache_P Q_DECL_FINAL
+    {
+    private:
+        mutable QMutex _lock;
+        std::shared_ptr<sqlite3> _database;
+        QHash<QString, std::shared_ptr<sqlite3_stmt>> _statements;
+        QAtomicInt _isOpened;
+
+        // Total size of stored data and last used access stamp, maintained in memory to avoid scans
+        uint64_t _size;
+        int64_t _lastAccessStamp;
+
+        mutable QAtomicInt _hits;
+        mutable QAtomicInt _misses;
+
+        bool configureStatement(
+            const std::shared_ptr<sqlite3_stmt>& statement,
+            const TileId tileId,
+            const ZoomLevel zoom,
+            const uint64_t key) const;
+        bool evictLeastRecentlyUsed();
+
+        std::shared_ptr<sqlite3_stmt> obtainStatement(const QString& sql);
+
+        static std::shared_ptr<sqlite3_stmt> prepareStatement(const std::shared_ptr<sqlite3>& db, const QString& sql);
+        static int stepStatement(const std::shared_ptr<sqlite3_stmt>& statement);
+        static bool execStatement(const std::shared_ptr<sqlite3>& db, const QString& sql);
+    protected:
+        MapPrimitivesDiskCache_P(MapPrimitivesDiskCache* owner);
+    public:
+        ~MapPrimitivesDiskCache_P();
+
+        ImplementationInterface<MapPrimitivesDiskCache> owner;
+
+        bool isOpened() const;
+        bool open();
+        bool close();
+
+        uint64_t getSize() const;
+        int getHits() const;
+        int getMisses() const;
+
+        bool obtainData(const TileId tileId, const ZoomLevel zoom, const uint64_t key, QByteArray& outData);
+        bool storeData(const TileId tileId, const ZoomLevel zoom, const uint64_t key, const QByteArray& data);
+        bool removeAllData();
+
+    friend class OsmAnd::MapPrimitivesDiskCache;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_PRIMITIVES_DISK_CACHE_P_H_)
@@ -30,6 +30,16 @@ OsmAnd::ZoomLevel OsmAnd::MapPrimitivesProvider::getMaxZoom() const
     return mapObjectsProvider->getMaxZoom();
 }
 
+std::shared_ptr<OsmAnd::MapPrimitivesDiskCache> OsmAnd::MapPrimitivesProvider::getDiskCache() const
+{
+    return _p->getDiskCache();
+}
+
+void OsmAnd::MapPrimitivesProvider::setDiskCache(const std::shared_ptr<MapPrimitivesDiskCache>& diskCache)
+{
+    _p->setDiskCache(diskCache);
+}
+
 bool OsmAnd::MapPrimitivesProvider::obtainTiledPrimitives(
     const Request& request,
     std::shared_ptr<Data>& outTiledPrimitives,
@@ -6,13 +6,33 @@
 #   define OSMAND_PERFORMANCE_METRICS 0
 #endif // !defined(OSMAND_PERFORMANCE_METRICS)
 
+#include "ignore_warnings_on_external_includes.h"
+#include <QMap>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include "restore_internal_warnings.h"
+
+#include "QtCommon.h"
 #include "IMapObjectsProvider.h"
+#include "ObfMapObjectsProvider.h"
+#include "IObfsCollection.h"
+#include "ObfDataInterface.h"
+#include "ObfReader.h"
+#include "ObfFile.h"
+#include "MapPresentationEnvironment.h"
+#include "ResolvedMapStyle.h"
+#include "MapStyleProgram.h"
+#include "MapStyleValueDefinition.h"
+#include "MapPrimitivesSerializer.h"
 #include "Stopwatch.h"
 #include "Utilities.h"
 #include "Logging.h"
 
 OsmAnd::MapPrimitivesProvider_P::MapPrimitivesProvider_P(MapPrimitivesProvider* owner_)
     : _primitiviserCache(new MapPrimitiviser::Cache())
+    , _diskCacheStyleKeySettingsRevision(0)
     , owner(owner_)
 {
 }
@@ -113,6 +133,24 @@ bool OsmAnd::MapPrimitivesProvider_P::obtainTiledPrimitives(
 #endif // OSMAND_PERFORMANCE_METRICS
         );
 
+    // Try to restore tile from disk cache, if there's one
+    uint64_t diskCacheKey = 0;
+    const auto diskCache = getDiskCache();
+    const auto useDiskCache = diskCache && diskCache->isOpened() && computeDiskCacheKey(request, diskCacheKey);
+    if (useDiskCache)
+    {
+        std::shared_ptr<MapPrimitivesProvider::Data> restoredTiledData;
+        if (restoreFromDiskCache(diskCache, diskCacheKey, request, tileEntry, restoredTiledData))
+        {
+            publishTiledData(tileEntry, restoredTiledData);
+            outTiledPrimitives = restoredTiledData;
+
+            if (metric)
+                metric->elapsedTime = totalStopwatch.elapsed();
+            return true;
+        }
+    }
+
     // Obtain map objects data tile
     std::shared_ptr<IMapObjectsProvider::Data> dataTile;
     std::shared_ptr<Metric> submetric;
@@ -205,16 +243,14 @@ bool OsmAnd::MapPrimitivesProvider_P::obtainTiledPrimitives(
 
     // Publish new tile
     outTiledPrimitives = newTiledData;
+    publishTiledData(tileEntry, newTiledData);
 
-    // Store weak reference to new tile and mark it as 'Loaded'
-    tileEntry->dataIsPresent = true;
-    tileEntry->dataWeakRef = newTiledData;
-    tileEntry->setState(TileState::Loaded);
-
-    // Notify that tile has been loaded
+    // Persist tile for next sessions
+    if (useDiskCache && primitivisedObjects)
     {
-        QWriteLocker scopedLcoker(&tileEntry->loadedConditionLock);
-        tileEntry->loadedCondition.wakeAll();
+        QByteArray serializedData;
+        if (MapPrimitivesSerializer::serialize(*primitivisedObjects, dataTile->tileSurfaceType, serializedData))
+            diskCache->storeData(request.tileId, request.zoom, diskCacheKey, serializedData);
     }
 
     if (metric)
@@ -248,6 +284,205 @@ bool OsmAnd::MapPrimitivesProvider_P::obtainTiledPrimitives(
     return true;
 }
 
+void OsmAnd::MapPrimitivesProvider_P::publishTiledData(
+    const std::shared_ptr<TileEntry>& tileEntry,
+    const std::shared_ptr<MapPrimitivesProvider::Data>& tiledData)
+{
+    // Store weak reference to new tile and mark it as 'Loaded'
+    tileEntry->dataIsPresent = true;
+    tileEntry->dataWeakRef = tiledData;
+    tileEntry->setState(TileState::Loaded);
+
+    // Notify that tile has been loaded
+    {
+        QWriteLocker scopedLcoker(&tileEntry->loadedConditionLock);
+        tileEntry->loadedCondition.wakeAll();
+    }
+}
+
+std::shared_ptr<OsmAnd::MapPrimitivesDiskCache> OsmAnd::MapPrimitivesProvider_P::getDiskCache() const
+{
+    QReadLocker scopedLocker(&_diskCacheLock);
+
+    return _diskCache;
+}
+
+void OsmAnd::MapPrimitivesProvider_P::setDiskCache(const std::shared_ptr<MapPrimitivesDiskCache>& diskCache)
+{
+    QWriteLocker scopedLocker(&_diskCacheLock);
+
+    _diskCache = diskCache;
+}
+
+bool OsmAnd::MapPrimitivesProvider_P::computeDiskCacheKey(
+    const MapPrimitivesProvider::Request& request,
+    uint64_t& outKey) const
+{
+    const auto obfMapObjectsProvider = std::dynamic_pointer_cast<const ObfMapObjectsProvider>(owner->mapObjectsProvider);
+    QByteArray styleKey;
+    if (!obfMapObjectsProvider || !obtainDiskCacheStyleKey(styleKey))
+        return false;
+
+    QByteArray keyData;
+    QDataStream stream(&keyData, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << styleKey;
+
+    // Data sources, only those that provide data for this tile, so that change of any other file keeps this tile
+    const auto tileBBox31 = Utilities::tileBoundingBox31(request.tileId, request.zoom);
+    QMap<QString, std::pair<uint64_t, qint64>> obfFilesStamps;
+    {
+        const auto dataInterface = obfMapObjectsProvider->obfsCollection->obtainDataInterface(
+            &tileBBox31,
+            request.zoom,
+            request.zoom,
+            ObfDataTypesMask().set(ObfDataType::Map).set(ObfDataType::Routing));
+        for (const auto& obfReader : constOf(dataInterface->obfReaders))
+        {
+            const auto& obfFile = obfReader->obfFile;
+            obfFilesStamps.insert(obfFile->filePath, { obfFile->fileSize, getObfFileModificationTime(*obfFile) });
+        }
+    }
+    for (const auto& obfFileStampEntry : rangeOf(constOf(obfFilesStamps)))
+    {
+        stream << obfFileStampEntry.key();
+        stream << static_cast<quint64>(obfFileStampEntry.value().first);
+        stream << obfFileStampEntry.value().second;
+    }
+
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    const auto hash = QCryptographicHash::hash(keyData, QCryptographicHash::Sha1);
+    outKey = 0;
+    memcpy(&outKey, hash.constData(), qMin(static_cast<size_t>(hash.size()), sizeof(outKey)));
+    return true;
+}
+
+bool OsmAnd::MapPrimitivesProvider_P::obtainDiskCacheStyleKey(QByteArray& outStyleKey) const
+{
+    const auto& environment = owner->primitiviser->environment;
+
+    // Tiles can only be fingerprinted when style is known
+    const auto resolvedMapStyle = std::dynamic_pointer_cast<const ResolvedMapStyle>(environment->mapStyle);
+    const auto obfMapObjectsProvider = std::dynamic_pointer_cast<const ObfMapObjectsProvider>(owner->mapObjectsProvider);
+    if (!resolvedMapStyle || !resolvedMapStyle->getProgram() || !obfMapObjectsProvider)
+        return false;
+
+    // Everything but settings is immutable, so key is serialized again only once settings were changed
+    const auto settingsRevision = environment->getSettingsRevision();
+    {
+        QMutexLocker scopedLocker(&_diskCacheStyleKeyMutex);
+        if (!_diskCacheStyleKey.isEmpty() && _diskCacheStyleKeySettingsRevision == settingsRevision)
+        {
+            outStyleKey = _diskCacheStyleKey;
+            return true;
+        }
+    }
+
+    QByteArray keyData;
+    QDataStream stream(&keyData, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << static_cast<quint32>(MapPrimitivesSerializer::FormatVersion);
+    stream << static_cast<qint32>(owner->mode) << static_cast<quint32>(owner->tileSize);
+    stream << static_cast<quint32>(obfMapObjectsProvider->mode);
+
+    // Style and presentation
+    stream << static_cast<quint64>(resolvedMapStyle->getProgram()->fingerprint);
+    stream << environment->displayDensityFactor << environment->mapScaleFactor << environment->symbolsScaleFactor;
+    stream << environment->localeLanguageId << static_cast<qint32>(environment->languagePreference);
+    auto disabledAttributes = environment->disabledAttributes.toList();
+    std::sort(disabledAttributes);
+    stream << disabledAttributes;
+
+    // Settings, by names of value definitions since identifiers are not persistent
+    const auto settingsValues = environment->getSettings();
+    QMap<QString, QString> settings;
+    for (const auto& settingEntry : rangeOf(constOf(settingsValues)))
+    {
+        const auto& valueDefinition = resolvedMapStyle->getValueDefinitionRefById(settingEntry.key());
+        if (!valueDefinition)
+            continue;
+
+        const auto& value = settingEntry.value();
+        settings.insert(valueDefinition->name,
+            valueDefinition->dataType == MapStyleValueDataType::String && !value.isComplex
+                ? resolvedMapStyle->getStringById(value.asSimple.asUInt)
+                : value.toString(valueDefinition->dataType));
+    }
+    stream << settings;
+
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    // Settings changed meanwhile are noticed by next key, since revision was obtained before them
+    outStyleKey = QCryptographicHash::hash(keyData, QCryptographicHash::Sha1);
+    {
+        QMutexLocker scopedLocker(&_diskCacheStyleKeyMutex);
+        _diskCacheStyleKey = outStyleKey;
+        _diskCacheStyleKeySettingsRevision = settingsRevision;
+    }
+    return true;
+}
+
+qint64 OsmAnd::MapPrimitivesProvider_P::getObfFileModificationTime(const ObfFile& obfFile) const
+{
+    QMutexLocker scopedLocker(&_obfFilesModificationTimesMutex);
+
+    // File is re-examined only if its size has changed, so that key of each tile doesn't cost a stat() per file
+    auto& entry = _obfFilesModificationTimes[obfFile.filePath];
+    if (entry.first != obfFile.fileSize || entry.second == 0)
+    {
+        entry.first = obfFile.fileSize;
+        entry.second = QFileInfo(obfFile.filePath).lastModified().toMSecsSinceEpoch();
+    }
+    return entry.second;
+}
+
+bool OsmAnd::MapPrimitivesProvider_P::restoreFromDiskCache(
+    const std::shared_ptr<MapPrimitivesDiskCache>& diskCache,
+    const uint64_t diskCacheKey,
+    const MapPrimitivesProvider::Request& request,
+    const std::shared_ptr<TileEntry>& tileEntry,
+    std::shared_ptr<MapPrimitivesProvider::Data>& outTiledData) const
+{
+    QByteArray serializedData;
+    if (!diskCache->obtainData(request.tileId, request.zoom, diskCacheKey, serializedData))
+        return false;
+
+    auto surfaceType = MapSurfaceType::Undefined;
+    QList< std::shared_ptr<const MapObject> > mapObjects;
+    const auto primitivisedObjects = MapPrimitivesSerializer::deserialize(
+        serializedData,
+        owner->primitiviser->environment,
+        surfaceType,
+        mapObjects);
+    if (!primitivisedObjects)
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "Failed to restore cached primitives of %dx%d@%d",
+            request.tileId.x,
+            request.tileId.y,
+            request.zoom);
+        return false;
+    }
+
+    const std::shared_ptr<IMapObjectsProvider::Data> dataTile(new IMapObjectsProvider::Data(
+        request.tileId,
+        request.zoom,
+        surfaceType,
+        mapObjects));
+    outTiledData.reset(new MapPrimitivesProvider::Data(
+        request.tileId,
+        request.zoom,
+        dataTile,
+        primitivisedObjects,
+        new RetainableCacheMetadata(tileEntry, nullptr)));
+
+    return true;
+}
+
 OsmAnd::MapPrimitivesProvider_P::RetainableCacheMetadata::RetainableCacheMetadata(
     const std::shared_ptr<TileEntry>& tileEntry,
     const std::shared_ptr<const IMapDataProvider::RetainableCacheMetadata>& binaryMapRetainableCacheMetadata_)
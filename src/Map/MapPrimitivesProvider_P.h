@@ -9,6 +9,7 @@
 #include "QtExtensions.h"
 #include "ignore_warnings_on_external_includes.h"
 #include <QHash>
+#include <QByteArray>
 #include <QAtomicInt>
 #include <QMutex>
 #include <QReadWriteLock>
@@ -25,9 +26,12 @@
 #include "MapPrimitiviser.h"
 #include "MapPrimitivesProvider.h"
 #include "MapPrimitivesProvider_Metrics.h"
+#include "MapPrimitivesDiskCache.h"
 
 namespace OsmAnd
 {
+    class ObfFile;
+
     class MapPrimitivesProvider_P Q_DECL_FINAL
     {
     private:
@@ -64,6 +68,18 @@ namespace OsmAnd
 
         const std::shared_ptr<MapPrimitiviser::Cache> _primitiviserCache;
 
+        mutable QReadWriteLock _diskCacheLock;
+        std::shared_ptr<MapPrimitivesDiskCache> _diskCache;
+
+        // Key of style and settings, computed once per revision of settings
+        mutable QMutex _diskCacheStyleKeyMutex;
+        mutable QByteArray _diskCacheStyleKey;
+        mutable unsigned int _diskCacheStyleKeySettingsRevision;
+
+        // Per OBF file: size and modification time it had when last examined
+        mutable QMutex _obfFilesModificationTimesMutex;
+        mutable QHash< QString, std::pair<uint64_t, qint64> > _obfFilesModificationTimes;
+
         struct RetainableCacheMetadata : public IMapDataProvider::RetainableCacheMetadata
         {
             RetainableCacheMetadata(
@@ -74,11 +90,30 @@ namespace OsmAnd
             std::weak_ptr<TileEntry> tileEntryWeakRef;
             std::shared_ptr<const IMapDataProvider::RetainableCacheMetadata> binaryMapRetainableCacheMetadata;
         };
+
+        void publishTiledData(
+            const std::shared_ptr<TileEntry>& tileEntry,
+            const std::shared_ptr<MapPrimitivesProvider::Data>& tiledData);
+
+        bool computeDiskCacheKey(
+            const MapPrimitivesProvider::Request& request,
+            uint64_t& outKey) const;
+        bool obtainDiskCacheStyleKey(QByteArray& outStyleKey) const;
+        qint64 getObfFileModificationTime(const ObfFile& obfFile) const;
+        bool restoreFromDiskCache(
+            const std::shared_ptr<MapPrimitivesDiskCache>& diskCache,
+            const uint64_t diskCacheKey,
+            const MapPrimitivesProvider::Request& request,
+            const std::shared_ptr<TileEntry>& tileEntry,
+            std::shared_ptr<MapPrimitivesProvider::Data>& outTiledData) const;
     public:
         ~MapPrimitivesProvider_P();
 
         ImplementationInterface<MapPrimitivesProvider> owner;
 
+        std::shared_ptr<MapPrimitivesDiskCache> getDiskCache() const;
+        void setDiskCache(const std::shared_ptr<MapPrimitivesDiskCache>& diskCache);
+
         bool obtainData(
             const IMapDataProvider::Request& request,
             std::shared_ptr<IMapDataProvider::Data>& outData,
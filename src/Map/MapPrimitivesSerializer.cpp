@@ -0,0 +1,690 @@
+#include "MapPrimitivesSerializer.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QHash>
+#include <QSet>
+#include <QIODevice>
+#include <QStringList>
+#include "restore_internal_warnings.h"
+
+#include "QtCommon.h"
+#include "MapPresentationEnvironment.h"
+#include "MapStyleEvaluationResult.h"
+#include "Logging.h"
+
+OsmAnd::MapPrimitivesSerializer::RestoredTraits::RestoredTraits()
+    : hasSharingKey(false)
+    , sharingKey(0)
+    , hasSortingKey(false)
+    , sortingKey(0)
+    , minZoom(MinZoomLevel)
+    , maxZoom(MaxZoomLevel)
+    , layerType(MapObject::LayerType::Zero)
+{
+}
+
+OsmAnd::MapPrimitivesSerializer::RestoredObfSectionInfo::RestoredObfSectionInfo(const QString& name_)
+    : ObfSectionInfo(nullptr)
+{
+    name = name_;
+}
+
+OsmAnd::MapPrimitivesSerializer::RestoredObfSectionInfo::~RestoredObfSectionInfo()
+{
+}
+
+void OsmAnd::MapPrimitivesSerializer::writePoints(QDataStream& stream, const QVector<PointI>& points)
+{
+    stream << static_cast<qint32>(points.size());
+    for (const auto& point : constOf(points))
+        stream << static_cast<qint32>(point.x) << static_cast<qint32>(point.y);
+}
+
+bool OsmAnd::MapPrimitivesSerializer::readCount(QDataStream& stream, const int itemMinSize, qint32& outCount)
+{
+    outCount = 0;
+    stream >> outCount;
+    if (outCount < 0 || stream.status() != QDataStream::Ok)
+        return false;
+
+    // Corrupted count must not cause allocation of more items than remaining data may hold
+    const auto device = stream.device();
+    return !device || static_cast<qint64>(outCount) * itemMinSize <= device->bytesAvailable();
+}
+
+bool OsmAnd::MapPrimitivesSerializer::readPoints(QDataStream& stream, QVector<PointI>& outPoints)
+{
+    qint32 count = 0;
+    if (!readCount(stream, 2 * sizeof(qint32), count))
+        return false;
+
+    outPoints.resize(count);
+    auto pPoint = outPoints.data();
+    for (auto pointIdx = 0; pointIdx < count; pointIdx++, pPoint++)
+    {
+        qint32 x, y;
+        stream >> x >> y;
+        pPoint->x = x;
+        pPoint->y = y;
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+bool OsmAnd::MapPrimitivesSerializer::serialize(
+    const MapPrimitiviser::PrimitivisedObjects& primitivisedObjects,
+    const MapSurfaceType surfaceType,
+    QByteArray& outData)
+{
+    typedef MapPrimitiviser::Primitive Primitive;
+
+    // Collect source objects, their attribute mappings and OBF sections
+    QList< std::shared_ptr<const MapObject> > mapObjects;
+    QHash<const MapObject*, int> mapObjectsIndices;
+    QList< std::shared_ptr<const MapObject::AttributeMapping> > attributeMappings;
+    QHash<const MapObject::AttributeMapping*, int> attributeMappingsIndices;
+    QList< QSet<uint32_t> > attributeMappingsUsedIds;
+    QStringList sectionsNames;
+    QHash<QString, int> sectionsIndices;
+    const auto registerMapObject =
+        [&mapObjects, &mapObjectsIndices, &attributeMappings, &attributeMappingsIndices, &attributeMappingsUsedIds]
+        (const std::shared_ptr<const MapObject>& mapObject) -> bool
+        {
+            if (!mapObject)
+                return false;
+            if (mapObjectsIndices.contains(mapObject.get()))
+                return true;
+            mapObjectsIndices.insert(mapObject.get(), mapObjects.size());
+            mapObjects.push_back(mapObject);
+
+            const auto& attributeMapping = mapObject->attributeMapping;
+            if (!attributeMapping)
+                return true;
+            auto attributeMappingIndex = attributeMappingsIndices.value(attributeMapping.get(), -1);
+            if (attributeMappingIndex < 0)
+            {
+                attributeMappingIndex = attributeMappings.size();
+                attributeMappingsIndices.insert(attributeMapping.get(), attributeMappingIndex);
+                attributeMappings.push_back(attributeMapping);
+
+                // Quick-access attributes are always kept, since they're looked up without object
+                QSet<uint32_t> usedIds;
+                for (const auto attributeId : constOf(attributeMapping->nameAttributeIds))
+                    usedIds.insert(attributeId);
+                usedIds.insert(attributeMapping->refAttributeId);
+                usedIds.insert(attributeMapping->naturalCoastlineAttributeId);
+                usedIds.insert(attributeMapping->naturalLandAttributeId);
+                usedIds.insert(attributeMapping->naturalCoastlineBrokenAttributeId);
+                usedIds.insert(attributeMapping->naturalCoastlineLineAttributeId);
+                usedIds.insert(attributeMapping->onewayAttributeId);
+                usedIds.insert(attributeMapping->onewayReverseAttributeId);
+                attributeMappingsUsedIds.push_back(qMove(usedIds));
+            }
+
+            auto& usedIds = attributeMappingsUsedIds[attributeMappingIndex];
+            for (const auto attributeId : constOf(mapObject->attributeIds))
+                usedIds.insert(attributeId);
+            for (const auto attributeId : constOf(mapObject->additionalAttributeIds))
+                usedIds.insert(attributeId);
+            for (const auto attributeId : constOf(mapObject->captionsOrder))
+                usedIds.insert(attributeId);
+            for (const auto attributeId : rangeOf(constOf(mapObject->captions)))
+                usedIds.insert(attributeId.key());
+
+            return true;
+        };
+
+    QHash<const Primitive*, int> primitivesIndices;
+    for (const auto& primitivesGroup : constOf(primitivisedObjects.primitivesGroups))
+    {
+        if (!registerMapObject(primitivesGroup->sourceObject))
+            return false;
+
+        for (const auto primitives : { &primitivesGroup->polygons, &primitivesGroup->polylines, &primitivesGroup->points })
+        {
+            for (const auto& primitive : constOf(*primitives))
+                primitivesIndices.insert(primitive.get(), primitivesIndices.size());
+        }
+    }
+    for (const auto& symbolsGroup : rangeOf(constOf(primitivisedObjects.symbolsGroups)))
+    {
+        if (!registerMapObject(symbolsGroup.key()))
+            return false;
+    }
+    for (const auto& mapObject : constOf(mapObjects))
+    {
+        const auto obfMapObject = std::dynamic_pointer_cast<const ObfMapObject>(mapObject);
+        if (!obfMapObject || !obfMapObject->obfSection || sectionsIndices.contains(obfMapObject->obfSection->name))
+            continue;
+
+        sectionsIndices.insert(obfMapObject->obfSection->name, sectionsNames.size());
+        sectionsNames.push_back(obfMapObject->obfSection->name);
+    }
+
+    outData.clear();
+    QDataStream stream(&outData, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << static_cast<quint32>(FormatVersion);
+    stream << static_cast<qint32>(surfaceType);
+    stream << static_cast<qint32>(primitivisedObjects.zoom);
+    stream << primitivisedObjects.scaleDivisor31ToPixel.x << primitivisedObjects.scaleDivisor31ToPixel.y;
+
+    // Attribute mappings, limited to referenced entries
+    stream << static_cast<qint32>(attributeMappings.size());
+    for (auto attributeMappingIdx = 0; attributeMappingIdx < attributeMappings.size(); attributeMappingIdx++)
+    {
+        const auto& attributeMapping = attributeMappings[attributeMappingIdx];
+
+        auto usedIds = attributeMappingsUsedIds[attributeMappingIdx].toList();
+        std::sort(usedIds);
+        QList< std::pair<uint32_t, const MapObject::AttributeMapping::TagValue*> > entries;
+        for (const auto attributeId : constOf(usedIds))
+        {
+            if (const auto pTagValue = attributeMapping->decodeMap.getRef(attributeId))
+                entries.push_back({ attributeId, pTagValue });
+        }
+
+        stream << static_cast<qint32>(entries.size());
+        for (const auto& entry : constOf(entries))
+            stream << static_cast<quint32>(entry.first) << entry.second->tag << entry.second->value;
+        stream << static_cast<quint32>(attributeMapping->layerLowestAttributeId);
+    }
+
+    stream << sectionsNames;
+
+    // Source objects
+    stream << static_cast<qint32>(mapObjects.size());
+    for (const auto& mapObject : constOf(mapObjects))
+    {
+        auto kind = ObjectKind::Generic;
+        auto sectionIndex = -1;
+        auto id = ObfObjectId::invalidId();
+        if (const auto obfMapObject = std::dynamic_pointer_cast<const ObfMapObject>(mapObject))
+        {
+            kind = ObjectKind::Obf;
+            if (obfMapObject->obfSection)
+                sectionIndex = sectionsIndices.value(obfMapObject->obfSection->name, -1);
+            id = obfMapObject->id;
+        }
+        else if (std::dynamic_pointer_cast<const MapPrimitiviser::CoastlineMapObject>(mapObject))
+            kind = ObjectKind::Coastline;
+        else if (std::dynamic_pointer_cast<const MapPrimitiviser::SurfaceMapObject>(mapObject))
+            kind = ObjectKind::Surface;
+
+        stream << static_cast<quint8>(kind);
+        stream << static_cast<qint32>(attributeMappingsIndices.value(mapObject->attributeMapping.get(), -1));
+        stream << static_cast<qint32>(sectionIndex);
+        stream << static_cast<quint64>(id.id);
+
+        MapObject::SharingKey sharingKey = 0;
+        const auto hasSharingKey = mapObject->obtainSharingKey(sharingKey);
+        MapObject::SortingKey sortingKey = 0;
+        const auto hasSortingKey = mapObject->obtainSortingKey(sortingKey);
+        stream << hasSharingKey << static_cast<quint64>(sharingKey);
+        stream << hasSortingKey << static_cast<quint64>(sortingKey);
+        stream << static_cast<qint32>(mapObject->getMinZoomLevel());
+        stream << static_cast<qint32>(mapObject->getMaxZoomLevel());
+        stream << static_cast<qint32>(mapObject->getLayerType());
+
+        stream << mapObject->isArea << mapObject->isCoastline;
+        writePoints(stream, mapObject->points31);
+        stream << static_cast<qint32>(mapObject->innerPolygonsPoints31.size());
+        for (const auto& innerPolygonPoints31 : constOf(mapObject->innerPolygonsPoints31))
+            writePoints(stream, innerPolygonPoints31);
+        stream
+            << static_cast<qint32>(mapObject->bbox31.top())
+            << static_cast<qint32>(mapObject->bbox31.left())
+            << static_cast<qint32>(mapObject->bbox31.bottom())
+            << static_cast<qint32>(mapObject->bbox31.right());
+
+        stream << mapObject->attributeIds << mapObject->additionalAttributeIds;
+        stream << mapObject->captions << mapObject->captionsOrder;
+        stream << static_cast<qint32>(mapObject->labelX) << static_cast<qint32>(mapObject->labelY);
+    }
+
+    // Primitives, grouped by source object
+    stream << static_cast<qint32>(primitivisedObjects.primitivesGroups.size());
+    for (const auto& primitivesGroup : constOf(primitivisedObjects.primitivesGroups))
+    {
+        stream << static_cast<qint32>(mapObjectsIndices[primitivesGroup->sourceObject.get()]);
+        for (const auto primitives : { &primitivesGroup->polygons, &primitivesGroup->polylines, &primitivesGroup->points })
+        {
+            stream << static_cast<qint32>(primitives->size());
+            for (const auto& primitive : constOf(*primitives))
+            {
+                stream << static_cast<quint32>(primitive->type);
+                stream << static_cast<quint32>(primitive->attributeIdIndex);
+                stream << static_cast<qint32>(primitive->evaluationResult.entries.size());
+                for (const auto& entry : constOf(primitive->evaluationResult.entries))
+                    stream << static_cast<qint32>(entry.first) << entry.second;
+                stream << static_cast<qint32>(primitive->zOrder);
+                stream << static_cast<qint64>(primitive->doubledArea);
+            }
+        }
+    }
+    for (const auto primitives : { &primitivisedObjects.polygons, &primitivisedObjects.polylines, &primitivisedObjects.points })
+    {
+        stream << static_cast<qint32>(primitives->size());
+        for (const auto& primitive : constOf(*primitives))
+        {
+            const auto primitiveIndex = primitivesIndices.value(primitive.get(), -1);
+            if (primitiveIndex < 0)
+                return false;
+            stream << static_cast<qint32>(primitiveIndex);
+        }
+    }
+
+    // Symbols
+    stream << static_cast<qint32>(primitivisedObjects.symbolsGroups.size());
+    for (const auto& symbolsGroupEntry : rangeOf(constOf(primitivisedObjects.symbolsGroups)))
+    {
+        const auto& symbolsGroup = symbolsGroupEntry.value();
+
+        stream << static_cast<qint32>(mapObjectsIndices[symbolsGroupEntry.key().get()]);
+        stream << static_cast<qint32>(symbolsGroup->symbols.size());
+        for (const auto& symbol : constOf(symbolsGroup->symbols))
+        {
+            const auto textSymbol = std::dynamic_pointer_cast<const MapPrimitiviser::TextSymbol>(symbol);
+            const auto iconSymbol = std::dynamic_pointer_cast<const MapPrimitiviser::IconSymbol>(symbol);
+            const auto primitiveIndex = primitivesIndices.value(symbol->primitive.get(), -1);
+            if ((!textSymbol && !iconSymbol) || primitiveIndex < 0)
+                return false;
+
+            stream << static_cast<quint8>(textSymbol ? SymbolKind::Text : SymbolKind::Icon);
+            stream << static_cast<qint32>(primitiveIndex);
+            stream << static_cast<qint32>(symbol->location31.x) << static_cast<qint32>(symbol->location31.y);
+            stream << static_cast<qint32>(symbol->order);
+            stream << symbol->drawAlongPath;
+            stream << symbol->intersectsWith;
+            stream << symbol->intersectionSizeFactor << symbol->intersectionSize << symbol->intersectionMargin;
+            stream << symbol->minDistance << symbol->scaleFactor;
+
+            if (textSymbol)
+            {
+                stream << textSymbol->value;
+                stream << static_cast<qint32>(textSymbol->languageId);
+                stream << textSymbol->drawOnPath;
+                stream << static_cast<qint32>(textSymbol->placement);
+                stream << static_cast<qint32>(textSymbol->additionalPlacements.size());
+                for (const auto placement : constOf(textSymbol->additionalPlacements))
+                    stream << static_cast<qint32>(placement);
+                stream << static_cast<qint32>(textSymbol->verticalOffset);
+                stream << static_cast<quint32>(textSymbol->color.argb);
+                stream << static_cast<qint32>(textSymbol->size);
+                stream << static_cast<qint32>(textSymbol->shadowRadius);
+                stream << static_cast<quint32>(textSymbol->shadowColor.argb);
+                stream << static_cast<qint32>(textSymbol->wrapWidth);
+                stream << textSymbol->isBold << textSymbol->isItalic;
+                stream << textSymbol->shieldResourceName << textSymbol->underlayIconResourceName;
+            }
+            else
+            {
+                stream << iconSymbol->resourceName;
+                stream << iconSymbol->underlayResourceNames << iconSymbol->overlayResourceNames;
+                stream << iconSymbol->offsetFactor.x << iconSymbol->offsetFactor.y;
+                stream << iconSymbol->shieldResourceName;
+            }
+        }
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+
+std::shared_ptr<OsmAnd::MapPrimitiviser::PrimitivisedObjects> OsmAnd::MapPrimitivesSerializer::deserialize(
+    const QByteArray& data,
+    const std::shared_ptr<const MapPresentationEnvironment>& mapPresentationEnvironment,
+    MapSurfaceType& outSurfaceType,
+    QList< std::shared_ptr<const MapObject> >& outMapObjects)
+{
+    typedef MapPrimitiviser::Primitive Primitive;
+    typedef MapPrimitiviser::PrimitivesGroup PrimitivesGroup;
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 formatVersion = 0;
+    stream >> formatVersion;
+    if (formatVersion != FormatVersion)
+        return nullptr;
+
+    qint32 surfaceType = 0;
+    qint32 zoom = 0;
+    PointD scaleDivisor31ToPixel;
+    stream >> surfaceType >> zoom >> scaleDivisor31ToPixel.x >> scaleDivisor31ToPixel.y;
+    if (stream.status() != QDataStream::Ok || zoom < MinZoomLevel || zoom > MaxZoomLevel)
+        return nullptr;
+
+    // Attribute mappings
+    qint32 attributeMappingsCount = 0;
+    if (!readCount(stream, 2 * sizeof(qint32), attributeMappingsCount))
+        return nullptr;
+    QVector< std::shared_ptr<const MapObject::AttributeMapping> > attributeMappings;
+    attributeMappings.reserve(attributeMappingsCount);
+    for (auto attributeMappingIdx = 0; attributeMappingIdx < attributeMappingsCount; attributeMappingIdx++)
+    {
+        const std::shared_ptr<MapObject::AttributeMapping> attributeMapping(new MapObject::AttributeMapping());
+
+        qint32 entriesCount = 0;
+        if (!readCount(stream, 3 * sizeof(qint32), entriesCount))
+            return nullptr;
+        for (auto entryIdx = 0; entryIdx < entriesCount; entryIdx++)
+        {
+            quint32 attributeId;
+            QString tag;
+            QString value;
+            stream >> attributeId >> tag >> value;
+            if (stream.status() != QDataStream::Ok)
+                return nullptr;
+            attributeMapping->registerMapping(attributeId, tag, value);
+        }
+        quint32 layerLowestAttributeId;
+        stream >> layerLowestAttributeId;
+        attributeMapping->layerLowestAttributeId = layerLowestAttributeId;
+        attributeMapping->verifyRequiredMappingRegistered();
+
+        attributeMappings.push_back(attributeMapping);
+    }
+
+    // Sections
+    QStringList sectionsNames;
+    stream >> sectionsNames;
+    QVector< std::shared_ptr<const ObfSectionInfo> > sections;
+    sections.reserve(sectionsNames.size());
+    for (const auto& sectionName : constOf(sectionsNames))
+        sections.push_back(std::make_shared<RestoredObfSectionInfo>(sectionName));
+
+    // Source objects
+    qint32 mapObjectsCount = 0;
+    if (!readCount(stream, sizeof(quint8) + 2 * sizeof(qint32) + sizeof(quint64), mapObjectsCount))
+        return nullptr;
+    QVector< std::shared_ptr<const MapObject> > mapObjects;
+    mapObjects.reserve(mapObjectsCount);
+    for (auto mapObjectIdx = 0; mapObjectIdx < mapObjectsCount; mapObjectIdx++)
+    {
+        quint8 kind;
+        qint32 attributeMappingIndex;
+        qint32 sectionIndex;
+        quint64 id;
+        stream >> kind >> attributeMappingIndex >> sectionIndex >> id;
+        if (stream.status() != QDataStream::Ok
+            || attributeMappingIndex >= attributeMappings.size()
+            || sectionIndex >= sections.size())
+        {
+            return nullptr;
+        }
+
+        RestoredTraits traits;
+        quint64 sharingKey;
+        quint64 sortingKey;
+        qint32 minZoom;
+        qint32 maxZoom;
+        qint32 layerType;
+        stream >> traits.hasSharingKey >> sharingKey;
+        stream >> traits.hasSortingKey >> sortingKey;
+        stream >> minZoom >> maxZoom >> layerType;
+        traits.sharingKey = sharingKey;
+        traits.sortingKey = sortingKey;
+        traits.minZoom = static_cast<ZoomLevel>(minZoom);
+        traits.maxZoom = static_cast<ZoomLevel>(maxZoom);
+        traits.layerType = static_cast<MapObject::LayerType>(layerType);
+
+        std::shared_ptr<MapObject> mapObject;
+        switch (static_cast<ObjectKind>(kind))
+        {
+            case ObjectKind::Obf:
+            {
+                std::shared_ptr<const ObfSectionInfo> section;
+                if (sectionIndex >= 0)
+                    section = sections[sectionIndex];
+                else
+                    section.reset(new RestoredObfSectionInfo(QString()));
+
+                const std::shared_ptr< RestoredMapObject<ObfMapObject> > obfMapObject(
+                    new RestoredMapObject<ObfMapObject>(section));
+                obfMapObject->traits = traits;
+                obfMapObject->id.id = id;
+                mapObject = obfMapObject;
+                break;
+            }
+            case ObjectKind::Coastline:
+            {
+                const auto coastlineMapObject = std::make_shared< RestoredMapObject<MapPrimitiviser::CoastlineMapObject> >();
+                coastlineMapObject->traits = traits;
+                mapObject = coastlineMapObject;
+                break;
+            }
+            case ObjectKind::Surface:
+            {
+                const auto surfaceMapObject = std::make_shared< RestoredMapObject<MapPrimitiviser::SurfaceMapObject> >();
+                surfaceMapObject->traits = traits;
+                mapObject = surfaceMapObject;
+                break;
+            }
+            case ObjectKind::Generic:
+            {
+                const auto genericMapObject = std::make_shared< RestoredMapObject<MapObject> >();
+                genericMapObject->traits = traits;
+                mapObject = genericMapObject;
+                break;
+            }
+            default:
+                return nullptr;
+        }
+        if (attributeMappingIndex >= 0)
+            mapObject->attributeMapping = attributeMappings[attributeMappingIndex];
+
+        stream >> mapObject->isArea >> mapObject->isCoastline;
+        if (!readPoints(stream, mapObject->points31))
+            return nullptr;
+        qint32 innerPolygonsCount = 0;
+        if (!readCount(stream, sizeof(qint32), innerPolygonsCount))
+            return nullptr;
+        for (auto innerPolygonIdx = 0; innerPolygonIdx < innerPolygonsCount; innerPolygonIdx++)
+        {
+            QVector<PointI> innerPolygonPoints31;
+            if (!readPoints(stream, innerPolygonPoints31))
+                return nullptr;
+            mapObject->innerPolygonsPoints31.push_back(qMove(innerPolygonPoints31));
+        }
+        qint32 top, left, bottom, right;
+        stream >> top >> left >> bottom >> right;
+        mapObject->bbox31 = AreaI(top, left, bottom, right);
+
+        stream >> mapObject->attributeIds >> mapObject->additionalAttributeIds;
+        stream >> mapObject->captions >> mapObject->captionsOrder;
+        qint32 labelX, labelY;
+        stream >> labelX >> labelY;
+        mapObject->labelX = labelX;
+        mapObject->labelY = labelY;
+
+        if (stream.status() != QDataStream::Ok)
+            return nullptr;
+        mapObjects.push_back(mapObject);
+    }
+
+    const std::shared_ptr<MapPrimitiviser::PrimitivisedObjects> primitivisedObjects(
+        new MapPrimitiviser::PrimitivisedObjects(
+            mapPresentationEnvironment,
+            nullptr,
+            static_cast<ZoomLevel>(zoom),
+            scaleDivisor31ToPixel));
+
+    // Primitives, grouped by source object
+    qint32 primitivesGroupsCount = 0;
+    if (!readCount(stream, 4 * sizeof(qint32), primitivesGroupsCount))
+        return nullptr;
+    QVector< std::shared_ptr<const Primitive> > primitives;
+    for (auto primitivesGroupIdx = 0; primitivesGroupIdx < primitivesGroupsCount; primitivesGroupIdx++)
+    {
+        qint32 mapObjectIndex = -1;
+        stream >> mapObjectIndex;
+        if (stream.status() != QDataStream::Ok || mapObjectIndex < 0 || mapObjectIndex >= mapObjects.size())
+            return nullptr;
+
+        const std::shared_ptr<PrimitivesGroup> primitivesGroup(new PrimitivesGroup(mapObjects[mapObjectIndex]));
+        for (const auto groupPrimitives : { &primitivesGroup->polygons, &primitivesGroup->polylines, &primitivesGroup->points })
+        {
+            qint32 primitivesCount = 0;
+            if (!readCount(stream, 4 * sizeof(qint32) + sizeof(qint64), primitivesCount))
+                return nullptr;
+            for (auto primitiveIdx = 0; primitiveIdx < primitivesCount; primitiveIdx++)
+            {
+                quint32 type;
+                quint32 attributeIdIndex;
+                qint32 entriesCount = 0;
+                stream >> type >> attributeIdIndex;
+                if (!readCount(stream, 2 * sizeof(qint32), entriesCount))
+                    return nullptr;
+
+                MapStyleEvaluationResult evaluationResult;
+                for (auto entryIdx = 0; entryIdx < entriesCount; entryIdx++)
+                {
+                    qint32 valueDefId;
+                    QVariant value;
+                    stream >> valueDefId >> value;
+                    if (valueDefId < 0 || stream.status() != QDataStream::Ok)
+                        return nullptr;
+                    evaluationResult.setValue(valueDefId, value);
+                }
+
+                qint32 zOrder;
+                qint64 doubledArea;
+                stream >> zOrder >> doubledArea;
+
+                const std::shared_ptr<Primitive> primitive(new Primitive(
+                    primitivesGroup,
+                    static_cast<MapPrimitiviser::PrimitiveType>(type),
+                    attributeIdIndex,
+                    evaluationResult));
+                primitive->zOrder = zOrder;
+                primitive->doubledArea = doubledArea;
+
+                groupPrimitives->push_back(primitive);
+                primitives.push_back(primitive);
+            }
+        }
+
+        primitivisedObjects->primitivesGroups.push_back(primitivesGroup);
+    }
+    for (const auto tilePrimitives : { &primitivisedObjects->polygons, &primitivisedObjects->polylines, &primitivisedObjects->points })
+    {
+        qint32 primitivesCount = 0;
+        if (!readCount(stream, sizeof(qint32), primitivesCount))
+            return nullptr;
+        tilePrimitives->reserve(primitivesCount);
+        for (auto primitiveIdx = 0; primitiveIdx < primitivesCount; primitiveIdx++)
+        {
+            qint32 primitiveIndex = -1;
+            stream >> primitiveIndex;
+            if (primitiveIndex < 0 || primitiveIndex >= primitives.size())
+                return nullptr;
+            tilePrimitives->push_back(primitives[primitiveIndex]);
+        }
+    }
+
+    // Symbols
+    qint32 symbolsGroupsCount = 0;
+    if (!readCount(stream, 2 * sizeof(qint32), symbolsGroupsCount))
+        return nullptr;
+    for (auto symbolsGroupIdx = 0; symbolsGroupIdx < symbolsGroupsCount; symbolsGroupIdx++)
+    {
+        qint32 mapObjectIndex = -1;
+        qint32 symbolsCount = 0;
+        stream >> mapObjectIndex;
+        if (stream.status() != QDataStream::Ok || mapObjectIndex < 0 || mapObjectIndex >= mapObjects.size())
+            return nullptr;
+        if (!readCount(stream, sizeof(quint8) + 4 * sizeof(qint32), symbolsCount))
+            return nullptr;
+
+        const auto& mapObject = mapObjects[mapObjectIndex];
+        const std::shared_ptr<MapPrimitiviser::SymbolsGroup> symbolsGroup(new MapPrimitiviser::SymbolsGroup(mapObject));
+        for (auto symbolIdx = 0; symbolIdx < symbolsCount; symbolIdx++)
+        {
+            quint8 kind;
+            qint32 primitiveIndex = -1;
+            stream >> kind >> primitiveIndex;
+            if (stream.status() != QDataStream::Ok || primitiveIndex < 0 || primitiveIndex >= primitives.size())
+                return nullptr;
+            const auto& primitive = primitives[primitiveIndex];
+
+            std::shared_ptr<MapPrimitiviser::Symbol> symbol;
+            std::shared_ptr<MapPrimitiviser::TextSymbol> textSymbol;
+            std::shared_ptr<MapPrimitiviser::IconSymbol> iconSymbol;
+            if (static_cast<SymbolKind>(kind) == SymbolKind::Text)
+            {
+                textSymbol.reset(new MapPrimitiviser::TextSymbol(primitive));
+                symbol = textSymbol;
+            }
+            else if (static_cast<SymbolKind>(kind) == SymbolKind::Icon)
+            {
+                iconSymbol.reset(new MapPrimitiviser::IconSymbol(primitive));
+                symbol = iconSymbol;
+            }
+            else
+                return nullptr;
+
+            qint32 x, y, order;
+            stream >> x >> y >> order;
+            symbol->location31 = PointI(x, y);
+            symbol->order = order;
+            stream >> symbol->drawAlongPath;
+            stream >> symbol->intersectsWith;
+            stream >> symbol->intersectionSizeFactor >> symbol->intersectionSize >> symbol->intersectionMargin;
+            stream >> symbol->minDistance >> symbol->scaleFactor;
+
+            if (textSymbol)
+            {
+                qint32 languageId, placement, additionalPlacementsCount;
+                stream >> textSymbol->value;
+                stream >> languageId;
+                textSymbol->languageId = static_cast<LanguageId>(languageId);
+                stream >> textSymbol->drawOnPath;
+                stream >> placement;
+                textSymbol->placement = static_cast<MapPrimitiviser::TextSymbol::Placement>(placement);
+                if (!readCount(stream, sizeof(qint32), additionalPlacementsCount))
+                    return nullptr;
+                for (auto placementIdx = 0; placementIdx < additionalPlacementsCount; placementIdx++)
+                {
+                    stream >> placement;
+                    textSymbol->additionalPlacements.push_back(
+                        static_cast<MapPrimitiviser::TextSymbol::Placement>(placement));
+                }
+
+                qint32 verticalOffset, size, shadowRadius, wrapWidth;
+                quint32 color, shadowColor;
+                stream >> verticalOffset >> color >> size >> shadowRadius >> shadowColor >> wrapWidth;
+                textSymbol->verticalOffset = verticalOffset;
+                textSymbol->color.argb = color;
+                textSymbol->size = size;
+                textSymbol->shadowRadius = shadowRadius;
+                textSymbol->shadowColor.argb = shadowColor;
+                textSymbol->wrapWidth = wrapWidth;
+                stream >> textSymbol->isBold >> textSymbol->isItalic;
+                stream >> textSymbol->shieldResourceName >> textSymbol->underlayIconResourceName;
+            }
+            else
+            {
+                stream >> iconSymbol->resourceName;
+                stream >> iconSymbol->underlayResourceNames >> iconSymbol->overlayResourceNames;
+                stream >> iconSymbol->offsetFactor.x >> iconSymbol->offsetFactor.y;
+                stream >> iconSymbol->shieldResourceName;
+            }
+
+            if (stream.status() != QDataStream::Ok)
+                return nullptr;
+            symbolsGroup->symbols.push_back(symbol);
+        }
+
+        primitivisedObjects->symbolsGroups.insert(mapObject, symbolsGroup);
+    }
+
+    outSurfaceType = static_cast<MapSurfaceType>(surfaceType);
+    outMapObjects.clear();
+    outMapObjects.reserve(mapObjects.size());
+    for (const auto& mapObject : constOf(mapObjects))
+        outMapObjects.push_back(mapObject);
+
+    return primitivisedObjects;
+}
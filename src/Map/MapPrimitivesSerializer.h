@@ -0,0 +1,134 @@
+#ifndef _OSMAND_CORE_MAP_PRIMITIVES_SERIALIZER_H_
+#define _OSMAND_CORE_MAP_PRIMITIVES_SERIALIZER_H_
+
+#include "stdlib_common.h"
+#include <utility>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QByteArray>
+#include <QDataStream>
+#include <QList>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "MapCommonTypes.h"
+#include "MapObject.h"
+#include "ObfMapObject.h"
+#include "ObfSectionInfo.h"
+#include "MapPrimitiviser.h"
+
+namespace OsmAnd
+{
+    class MapPresentationEnvironment;
+
+    // Compact binary form of primitivised objects, suitable for persistent storage.
+    // Source map objects are restored as standalone copies: geometry, attributes, captions, identifiers and
+    // sharing/sorting keys are kept, while attribute mappings only contain entries actually referenced.
+    class MapPrimitivesSerializer Q_DECL_FINAL
+    {
+    public:
+        enum {
+            FormatVersion = 1,
+        };
+
+        struct RestoredTraits Q_DECL_FINAL
+        {
+            RestoredTraits();
+
+            bool hasSharingKey;
+            MapObject::SharingKey sharingKey;
+            bool hasSortingKey;
+            MapObject::SortingKey sortingKey;
+            ZoomLevel minZoom;
+            ZoomLevel maxZoom;
+            MapObject::LayerType layerType;
+        };
+
+        template<typename BASE>
+        class RestoredMapObject Q_DECL_FINAL : public BASE
+        {
+            Q_DISABLE_COPY_AND_MOVE(RestoredMapObject);
+        public:
+            template<typename... ARGS>
+            RestoredMapObject(ARGS&&... args)
+                : BASE(std::forward<ARGS>(args)...)
+            {
+            }
+            virtual ~RestoredMapObject()
+            {
+            }
+
+            RestoredTraits traits;
+
+            virtual bool obtainSharingKey(MapObject::SharingKey& outKey) const Q_DECL_OVERRIDE
+            {
+                outKey = traits.sharingKey;
+                return traits.hasSharingKey;
+            }
+            virtual bool obtainSortingKey(MapObject::SortingKey& outKey) const Q_DECL_OVERRIDE
+            {
+                outKey = traits.sortingKey;
+                return traits.hasSortingKey;
+            }
+            virtual ZoomLevel getMinZoomLevel() const Q_DECL_OVERRIDE
+            {
+                return traits.minZoom;
+            }
+            virtual ZoomLevel getMaxZoomLevel() const Q_DECL_OVERRIDE
+            {
+                return traits.maxZoom;
+            }
+            virtual MapObject::LayerType getLayerType() const Q_DECL_OVERRIDE
+            {
+                return traits.layerType;
+            }
+        };
+
+        // Stands in for section of OBF file that restored object was read from
+        class RestoredObfSectionInfo Q_DECL_FINAL : public ObfSectionInfo
+        {
+            Q_DISABLE_COPY_AND_MOVE(RestoredObfSectionInfo);
+        public:
+            RestoredObfSectionInfo(const QString& name);
+            virtual ~RestoredObfSectionInfo();
+        };
+
+    private:
+        MapPrimitivesSerializer();
+        ~MapPrimitivesSerializer();
+
+        enum class ObjectKind : uint8_t
+        {
+            Generic = 0,
+            Obf,
+            Coastline,
+            Surface,
+        };
+
+        enum class SymbolKind : uint8_t
+        {
+            Text = 0,
+            Icon,
+        };
+
+        static void writePoints(QDataStream& stream, const QVector<PointI>& points);
+        static bool readCount(QDataStream& stream, const int itemMinSize, qint32& outCount);
+        static bool readPoints(QDataStream& stream, QVector<PointI>& outPoints);
+    protected:
+    public:
+        static bool serialize(
+            const MapPrimitiviser::PrimitivisedObjects& primitivisedObjects,
+            const MapSurfaceType surfaceType,
+            QByteArray& outData);
+
+        static std::shared_ptr<MapPrimitiviser::PrimitivisedObjects> deserialize(
+            const QByteArray& data,
+            const std::shared_ptr<const MapPresentationEnvironment>& mapPresentationEnvironment,
+            MapSurfaceType& outSurfaceType,
+            QList< std::shared_ptr<const MapObject> >& outMapObjects);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_PRIMITIVES_SERIALIZER_H_)
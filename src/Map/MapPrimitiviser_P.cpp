@@ -619,29 +619,36 @@ void OsmAnd::MapPrimitiviser_P::obtainPrimitives(
 
     const Stopwatch obtainPrimitivesStopwatch(metric != nullptr);
 
+    // Objects with same attributes, layer and shape evaluate identically, so results are shared by all tiles of zoom
+    const auto styleEvaluationResultsCache = env->getStyleEvaluationResultsCache(zoom);
+
     // Initialize shared settings for order evaluation
     MapStyleEvaluator orderEvaluator(env->mapStyle, env->displayDensityFactor * env->mapScaleFactor);
     env->applyTo(orderEvaluator);
     orderEvaluator.setIntegerValue(env->styleBuiltinValueDefs->id_INPUT_MINZOOM, zoom);
     orderEvaluator.setIntegerValue(env->styleBuiltinValueDefs->id_INPUT_MAXZOOM, zoom);
+    orderEvaluator.setResultsCache(styleEvaluationResultsCache);
 
     // Initialize shared settings for polygon evaluation
     MapStyleEvaluator polygonEvaluator(env->mapStyle, env->displayDensityFactor * env->mapScaleFactor);
     env->applyTo(polygonEvaluator);
     polygonEvaluator.setIntegerValue(env->styleBuiltinValueDefs->id_INPUT_MINZOOM, zoom);
     polygonEvaluator.setIntegerValue(env->styleBuiltinValueDefs->id_INPUT_MAXZOOM, zoom);
+    polygonEvaluator.setResultsCache(styleEvaluationResultsCache);
 
     // Initialize shared settings for polyline evaluation
     MapStyleEvaluator polylineEvaluator(env->mapStyle, env->displayDensityFactor * env->mapScaleFactor);
     env->applyTo(polylineEvaluator);
     polylineEvaluator.setIntegerValue(env->styleBuiltinValueDefs->id_INPUT_MINZOOM, zoom);
     polylineEvaluator.setIntegerValue(env->styleBuiltinValueDefs->id_INPUT_MAXZOOM, zoom);
+    polylineEvaluator.setResultsCache(styleEvaluationResultsCache);
 
     // Initialize shared settings for point evaluation
     MapStyleEvaluator pointEvaluator(env->mapStyle, env->displayDensityFactor * env->mapScaleFactor);
     env->applyTo(pointEvaluator);
     pointEvaluator.setIntegerValue(env->styleBuiltinValueDefs->id_INPUT_MINZOOM, zoom);
     pointEvaluator.setIntegerValue(env->styleBuiltinValueDefs->id_INPUT_MAXZOOM, zoom);
+    pointEvaluator.setResultsCache(styleEvaluationResultsCache);
 
     const auto pSharedPrimitivesGroups = cache ? cache->getPrimitivesGroupsPtr(zoom) : nullptr;
     QList< proper::shared_future< std::shared_ptr<const PrimitivesGroup> > > futureSharedPrimitivesGroups;
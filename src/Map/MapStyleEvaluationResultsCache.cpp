@@ -0,0 +1,84 @@
+#include "MapStyleEvaluationResultsCache.h"
+
+#include "QtExtensions.h"
+#include "QtCommon.h"
+
+bool OsmAnd::MapStyleEvaluationResultsCache::Key::operator==(const Key& that) const
+{
+    return rulesetType == that.rulesetType
+        && ptScaleFactor == that.ptScaleFactor
+        && inputs == that.inputs;
+}
+
+uint OsmAnd::qHash(const MapStyleEvaluationResultsCache::Key& key, const uint seed /*= 0*/)
+{
+    auto hash = ::qHash(static_cast<int>(key.rulesetType), seed);
+    hash = hash * 31u + ::qHash(key.ptScaleFactor, seed);
+    for (const auto input : constOf(key.inputs))
+        hash = hash * 31u + ::qHash(static_cast<quint64>(input), seed);
+    return hash;
+}
+
+OsmAnd::MapStyleEvaluationResultsCache::MapStyleEvaluationResultsCache(
+    const int maxEntriesCount_ /*= DefaultMaxEntriesCount*/)
+    : _maxEntriesCount(maxEntriesCount_)
+    , _hits(0)
+    , _misses(0)
+{
+}
+
+OsmAnd::MapStyleEvaluationResultsCache::~MapStyleEvaluationResultsCache()
+{
+}
+
+bool OsmAnd::MapStyleEvaluationResultsCache::get(const Key& key, Entry& outEntry) const
+{
+    QReadLocker scopedLocker(&_lock);
+
+    const auto citEntry = _entries.constFind(key);
+    if (citEntry == _entries.cend())
+    {
+        _misses.fetchAndAddOrdered(1);
+        return false;
+    }
+
+    outEntry = *citEntry;
+    _hits.fetchAndAddOrdered(1);
+    return true;
+}
+
+void OsmAnd::MapStyleEvaluationResultsCache::put(const Key& key, const Entry& entry)
+{
+    QWriteLocker scopedLocker(&_lock);
+
+    // Number of distinct signatures is normally small, so overflow means that inputs are too diverse
+    // for caching to pay off: just start over
+    if (_entries.size() >= _maxEntriesCount)
+        _entries.clear();
+
+    _entries.insert(key, entry);
+}
+
+void OsmAnd::MapStyleEvaluationResultsCache::clear()
+{
+    QWriteLocker scopedLocker(&_lock);
+
+    _entries.clear();
+}
+
+int OsmAnd::MapStyleEvaluationResultsCache::getEntriesCount() const
+{
+    QReadLocker scopedLocker(&_lock);
+
+    return _entries.size();
+}
+
+int OsmAnd::MapStyleEvaluationResultsCache::getHits() const
+{
+    return _hits.loadAcquire();
+}
+
+int OsmAnd::MapStyleEvaluationResultsCache::getMisses() const
+{
+    return _misses.loadAcquire();
+}
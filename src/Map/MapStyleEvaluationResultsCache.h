@@ -0,0 +1,71 @@
+#ifndef _OSMAND_CORE_MAP_STYLE_EVALUATION_RESULTS_CACHE_H_
+#define _OSMAND_CORE_MAP_STYLE_EVALUATION_RESULTS_CACHE_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+#include <QAtomicInt>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "MapCommonTypes.h"
+#include "MapStyleEvaluationResult.h"
+
+namespace OsmAnd
+{
+    // Thread-safe storage of ruleset evaluation results, keyed by values of all inputs the ruleset reads.
+    // Evaluations that depend on map object itself (e.g. 'additional') are never stored.
+    class MapStyleEvaluationResultsCache Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapStyleEvaluationResultsCache);
+    public:
+        struct Key Q_DECL_FINAL
+        {
+            MapStyleRulesetType rulesetType;
+            float ptScaleFactor;
+            // Each input is packed as (isSet << 32) | value
+            QVector<uint64_t> inputs;
+
+            bool operator==(const Key& that) const;
+        };
+
+        typedef QVector<MapStyleEvaluationResult::Packed::Entry> Values;
+        struct Entry Q_DECL_FINAL
+        {
+            bool success;
+            Values values;
+        };
+
+        enum {
+            DefaultMaxEntriesCount = 64 * 1024,
+        };
+
+    private:
+        mutable QReadWriteLock _lock;
+        QHash<Key, Entry> _entries;
+        const int _maxEntriesCount;
+
+        mutable QAtomicInt _hits;
+        mutable QAtomicInt _misses;
+    protected:
+    public:
+        MapStyleEvaluationResultsCache(const int maxEntriesCount = DefaultMaxEntriesCount);
+        ~MapStyleEvaluationResultsCache();
+
+        bool get(const Key& key, Entry& outEntry) const;
+        void put(const Key& key, const Entry& entry);
+        void clear();
+
+        int getEntriesCount() const;
+        int getHits() const;
+        int getMisses() const;
+    };
+
+    uint qHash(const MapStyleEvaluationResultsCache::Key& key, const uint seed = 0);
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_STYLE_EVALUATION_RESULTS_CACHE_H_)
@@ -4,6 +4,7 @@
 #include <cassert>
 
 #include "Logging.h"
+#include "MapStyleEvaluationResultsCache.h"
 
 OsmAnd::MapStyleEvaluator::MapStyleEvaluator(
     const std::shared_ptr<const IMapStyle>& mapStyle_,
@@ -34,6 +35,16 @@ void OsmAnd::MapStyleEvaluator::setIntegerValue(const IMapStyle::ValueDefinition
     _p->setIntegerValue(valueDefId, value);
 }
 
+std::shared_ptr<OsmAnd::MapStyleEvaluationResultsCache> OsmAnd::MapStyleEvaluator::getResultsCache() const
+{
+    return _p->getResultsCache();
+}
+
+void OsmAnd::MapStyleEvaluator::setResultsCache(const std::shared_ptr<MapStyleEvaluationResultsCache>& resultsCache)
+{
+    _p->setResultsCache(resultsCache);
+}
+
 void OsmAnd::MapStyleEvaluator::setFloatValue(const IMapStyle::ValueDefinitionId valueDefId, const float value)
 {
     _p->setFloatValue(valueDefId, value);
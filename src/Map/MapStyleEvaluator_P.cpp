@@ -11,12 +11,15 @@
 #include "MapStyleValueDefinition.h"
 #include "MapStyleEvaluationResult.h"
 #include "MapStyleConstantValue.h"
+#include "ResolvedMapStyle.h"
 #include "MapObject.h"
 #include "QKeyValueIterator.h"
 #include "Logging.h"
 
 OsmAnd::MapStyleEvaluator_P::MapStyleEvaluator_P(MapStyleEvaluator* owner_)
     : _builtinValueDefs(MapStyleBuiltinValueDefinitions::get())
+    , _programEvaluationResultAllocator(std::bind(&MapStyleEvaluator_P::allocateProgramEvaluationResult, this))
+    , _mapObjectAccessed(false)
     , owner(owner_)
     , intermediateEvaluationResultAllocator(std::bind(&MapStyleEvaluator_P::allocateIntermediateEvaluationResult, this))
 {
@@ -34,6 +37,14 @@ void OsmAnd::MapStyleEvaluator_P::prepare()
     _inputValuesShadow.reset(new ArrayMap<InputValue>(valueDefinitionsCount));
     _intermediateEvaluationResult.reset(new ArrayMap<IMapStyle::Value>(valueDefinitionsCount));
     _constantIntermediateEvaluationResult.reset(new ArrayMap<IMapStyle::Value>(valueDefinitionsCount));
+
+    if (const auto resolvedMapStyle = std::dynamic_pointer_cast<const ResolvedMapStyle>(owner->mapStyle))
+        _program = resolvedMapStyle->getProgram();
+    if (_program)
+    {
+        _programEvaluationResult.reset(new ProgramEvaluationResult(valueDefinitionsCount));
+        _constantProgramEvaluationResult.reset(new ProgramEvaluationResult(valueDefinitionsCount));
+    }
 }
 
 OsmAnd::ArrayMap<OsmAnd::IMapStyle::Value>* OsmAnd::MapStyleEvaluator_P::allocateIntermediateEvaluationResult()
@@ -41,6 +52,11 @@ OsmAnd::ArrayMap<OsmAnd::IMapStyle::Value>* OsmAnd::MapStyleEvaluator_P::allocat
     return new ArrayMap<IMapStyle::Value>(owner->mapStyle->getValueDefinitionsCount());
 }
 
+OsmAnd::MapStyleEvaluator_P::ProgramEvaluationResult* OsmAnd::MapStyleEvaluator_P::allocateProgramEvaluationResult()
+{
+    return new ProgramEvaluationResult(owner->mapStyle->getValueDefinitionsCount());
+}
+
 OsmAnd::MapStyleConstantValue OsmAnd::MapStyleEvaluator_P::evaluateConstantValue(
     const MapObject* const mapObject,
     const MapStyleValueDataType dataType,
@@ -341,35 +357,422 @@ void OsmAnd::MapStyleEvaluator_P::postprocessEvaluationResult(
             inputValues,
             constantEvaluationResult);
 
-        QVariant postprocessedValue;
-        switch (valueDef->dataType)
+        outResultStorage.setValue(valueDefId, postprocessValue(valueDef->dataType, constantRuleValue));
+    }
+}
+
+QVariant OsmAnd::MapStyleEvaluator_P::postprocessValue(
+    const MapStyleValueDataType dataType,
+    const MapStyleConstantValue& constantValue) const
+{
+    QVariant postprocessedValue;
+    switch (dataType)
+    {
+        case MapStyleValueDataType::Boolean:
+            assert(!constantValue.isComplex);
+            postprocessedValue = (constantValue.asSimple.asUInt != 0);
+            break;
+        case MapStyleValueDataType::Integer:
+            postprocessedValue = constantValue.isComplex
+                ? constantValue.asComplex.asInt.evaluate(owner->ptScaleFactor)
+                : constantValue.asSimple.asInt;
+            break;
+        case MapStyleValueDataType::Float:
+            postprocessedValue = constantValue.isComplex
+                ? constantValue.asComplex.asFloat.evaluate(owner->ptScaleFactor)
+                : constantValue.asSimple.asFloat;
+            break;
+        case MapStyleValueDataType::String:
+            assert(!constantValue.isComplex);
+            // Save value of a string instead of it's id
+            postprocessedValue = owner->mapStyle->getStringById(constantValue.asSimple.asUInt);
+            break;
+        case MapStyleValueDataType::Color:
+            assert(!constantValue.isComplex);
+            postprocessedValue = constantValue.asSimple.asUInt;
+            break;
+    }
+
+    return postprocessedValue;
+}
+
+OsmAnd::MapStyleConstantValue OsmAnd::MapStyleEvaluator_P::evaluateProgramValue(
+    const MapObject* const mapObject,
+    const MapStyleValueDataType dataType,
+    const MapStyleProgram::Value& value,
+    const std::shared_ptr<const InputValues>& inputValues,
+    OnDemand<ProgramEvaluationResult>& intermediateEvaluationResult) const
+{
+    if (!value.isDynamic)
+        return value.asConstantValue;
+
+    bool wasDisabled = false;
+    intermediateEvaluationResult->clear();
+    OnDemand<ProgramEvaluationResult> innerConstantEvaluationResult(_programEvaluationResultAllocator);
+    executeProgram(
+        mapObject,
+        value.attributeRootNode,
+        inputValues,
+        wasDisabled,
+        intermediateEvaluationResult.get(),
+        innerConstantEvaluationResult);
+
+    const MapStyleProgram::Index* pEvaluatedValueIndex = nullptr;
+    switch (dataType)
+    {
+        case MapStyleValueDataType::Boolean:
+            pEvaluatedValueIndex = intermediateEvaluationResult->getRef(_builtinValueDefs->id_OUTPUT_ATTR_BOOL_VALUE);
+            break;
+        case MapStyleValueDataType::Integer:
+            pEvaluatedValueIndex = intermediateEvaluationResult->getRef(_builtinValueDefs->id_OUTPUT_ATTR_INT_VALUE);
+            break;
+        case MapStyleValueDataType::Float:
+            pEvaluatedValueIndex = intermediateEvaluationResult->getRef(_builtinValueDefs->id_OUTPUT_ATTR_FLOAT_VALUE);
+            break;
+        case MapStyleValueDataType::String:
+            pEvaluatedValueIndex = intermediateEvaluationResult->getRef(_builtinValueDefs->id_OUTPUT_ATTR_STRING_VALUE);
+            break;
+        case MapStyleValueDataType::Color:
+            pEvaluatedValueIndex = intermediateEvaluationResult->getRef(_builtinValueDefs->id_OUTPUT_ATTR_COLOR_VALUE);
+            break;
+    }
+    if (!pEvaluatedValueIndex)
+        return MapStyleConstantValue();
+
+    const auto& evaluatedValue = _program->values[*pEvaluatedValueIndex];
+    if (!evaluatedValue.isDynamic)
+        return evaluatedValue.asConstantValue;
+
+    return evaluateProgramValue(
+        mapObject,
+        dataType,
+        evaluatedValue,
+        inputValues,
+        intermediateEvaluationResult);
+}
+
+bool OsmAnd::MapStyleEvaluator_P::checkProgramInput(
+    const MapObject* const mapObject,
+    const MapStyleProgram::InputCheck& inputCheck,
+    const std::shared_ptr<const InputValues>& inputValues,
+    OnDemand<ProgramEvaluationResult>& constantEvaluationResult) const
+{
+    const auto& ruleValue = _program->values[inputCheck.value];
+    const auto constantRuleValue = ruleValue.isDynamic
+        ? evaluateProgramValue(mapObject, inputCheck.dataType, ruleValue, inputValues, constantEvaluationResult)
+        : ruleValue.asConstantValue;
+
+    InputValue inputValue;
+    inputValues->get(inputCheck.valueDefId, inputValue);
+
+    switch (inputCheck.opcode)
+    {
+        case MapStyleProgram::Opcode::MinZoom:
+            assert(!constantRuleValue.isComplex);
+            return (constantRuleValue.asSimple.asInt <= inputValue.asInt);
+
+        case MapStyleProgram::Opcode::MaxZoom:
+            assert(!constantRuleValue.isComplex);
+            return (constantRuleValue.asSimple.asInt >= inputValue.asInt);
+
+        case MapStyleProgram::Opcode::Test:
+            return (inputValue.asInt == 1);
+
+        case MapStyleProgram::Opcode::IntEquals:
         {
-            case MapStyleValueDataType::Boolean:
-                assert(!constantRuleValue.isComplex);
-                postprocessedValue = (constantRuleValue.asSimple.asUInt != 0);
-                break;
-            case MapStyleValueDataType::Integer:
-                postprocessedValue = constantRuleValue.isComplex
-                    ? constantRuleValue.asComplex.asInt.evaluate(owner->ptScaleFactor)
-                    : constantRuleValue.asSimple.asInt;
-                break;
-            case MapStyleValueDataType::Float:
-                postprocessedValue = constantRuleValue.isComplex
-                    ? constantRuleValue.asComplex.asFloat.evaluate(owner->ptScaleFactor)
-                    : constantRuleValue.asSimple.asFloat;
-                break;
-            case MapStyleValueDataType::String:
-                assert(!constantRuleValue.isComplex);
-                // Save value of a string instead of it's id
-                postprocessedValue = owner->mapStyle->getStringById(constantRuleValue.asSimple.asUInt);
-                break;
-            case MapStyleValueDataType::Color:
-                assert(!constantRuleValue.isComplex);
-                postprocessedValue = constantRuleValue.asSimple.asUInt;
-                break;
+            const auto lvalue = constantRuleValue.isComplex
+                ? constantRuleValue.asComplex.asInt.evaluate(owner->ptScaleFactor)
+                : constantRuleValue.asSimple.asInt;
+            return (lvalue == inputValue.asInt);
+        }
+
+        case MapStyleProgram::Opcode::FloatEquals:
+        {
+            const auto lvalue = constantRuleValue.isComplex
+                ? constantRuleValue.asComplex.asFloat.evaluate(owner->ptScaleFactor)
+                : constantRuleValue.asSimple.asFloat;
+            return qFuzzyCompare(lvalue, inputValue.asFloat);
+        }
+
+        case MapStyleProgram::Opcode::Additional:
+        {
+            if (!mapObject)
+                return constantRuleValue.asSimple.asInt == inputValue.asInt;
+            _mapObjectAccessed = true;
+
+            if (inputCheck.additionalCondition != MapStyleProgram::InvalidIndex && mapObject->attributeMapping)
+                return checkAdditionalCondition(mapObject, inputCheck.additionalCondition);
+
+            assert(!constantRuleValue.isComplex);
+            const auto valueString = owner->mapStyle->getStringById(constantRuleValue.asSimple.asUInt);
+            const auto equalSignIdx = valueString.indexOf(QLatin1Char('='));
+            if (equalSignIdx >= 0)
+            {
+                const auto& tagRef = valueString.midRef(0, equalSignIdx);
+                const auto& valueRef = valueString.midRef(equalSignIdx + 1);
+                return mapObject->containsAttribute(tagRef, valueRef, true);
+            }
+            return mapObject->containsTag(valueString, true);
+        }
+    }
+
+    return false;
+}
+
+bool OsmAnd::MapStyleEvaluator_P::checkAdditionalCondition(
+    const MapObject* const mapObject,
+    const MapStyleProgram::Index conditionIndex) const
+{
+    if (_lastAttributeMapping != mapObject->attributeMapping)
+    {
+        _lastAttributeMapping = mapObject->attributeMapping;
+        _lastResolvedAdditionalConditions = _program->resolveAdditionalConditions(_lastAttributeMapping);
+    }
+
+    const auto& conditionAttributeIds = _lastResolvedAdditionalConditions->attributeIds[conditionIndex];
+    if (conditionAttributeIds.isEmpty())
+        return false;
+
+    const auto pBegin = conditionAttributeIds.constData();
+    const auto pEnd = pBegin + conditionAttributeIds.size();
+    for (const auto attributeId : constOf(mapObject->additionalAttributeIds))
+    {
+        if (std::binary_search(pBegin, pEnd, attributeId))
+            return true;
+    }
+
+    return false;
+}
+
+bool OsmAnd::MapStyleEvaluator_P::executeProgram(
+    const MapObject* const mapObject,
+    const MapStyleProgram::Index nodeIndex,
+    const std::shared_ptr<const InputValues>& inputValues,
+    bool& outDisabled,
+    ProgramEvaluationResult* const outResultStorage,
+    OnDemand<ProgramEvaluationResult>& constantEvaluationResult) const
+{
+    const auto& program = *_program;
+    const auto& node = program.nodes[nodeIndex];
+
+    // Input checks are ordered from cheapest to most expensive, so first failed one stops evaluation
+    auto pInputCheck = program.inputChecks.data() + node.firstInputCheck;
+    for (auto inputCheckIdx = 0u; inputCheckIdx < node.inputChecksCount; inputCheckIdx++, pInputCheck++)
+    {
+        if (!checkProgramInput(mapObject, *pInputCheck, inputValues, constantEvaluationResult))
+            return false;
+    }
+
+    // In case rule sets "disable", stop processing
+    if (node.disableValue != MapStyleProgram::InvalidIndex)
+    {
+        const auto disableValue = evaluateProgramValue(
+            mapObject,
+            _builtinValueDefs->OUTPUT_DISABLE->dataType,
+            program.values[node.disableValue],
+            inputValues,
+            constantEvaluationResult);
+
+        assert(!disableValue.isComplex);
+        if (disableValue.asSimple.asUInt != 0)
+        {
+            outDisabled = true;
+            return false;
         }
+    }
+
+    if (outResultStorage && !node.isSwitch)
+        fillResultFromProgramNode(node, *outResultStorage, true);
 
+    bool atLeastOneConditionalMatched = false;
+    auto pSubnode = program.subnodes.data() + node.firstConditionalSubnode;
+    for (auto subnodeIdx = 0u; subnodeIdx < node.conditionalSubnodesCount; subnodeIdx++, pSubnode++)
+    {
+        const auto evaluationResult = executeProgram(
+            mapObject,
+            *pSubnode,
+            inputValues,
+            outDisabled,
+            outResultStorage,
+            constantEvaluationResult);
+
+        if (evaluationResult)
+        {
+            atLeastOneConditionalMatched = true;
+            break;
+        }
+    }
+    if (!atLeastOneConditionalMatched && node.isSwitch)
+        return false;
+
+    if (outResultStorage && node.isSwitch)
+    {
+        // Fill values from <switch> keeping values previously set by <case>
+        fillResultFromProgramNode(node, *outResultStorage, false);
+    }
+
+    pSubnode = program.subnodes.data() + node.firstApplySubnode;
+    for (auto subnodeIdx = 0u; subnodeIdx < node.applySubnodesCount; subnodeIdx++, pSubnode++)
+    {
+        executeProgram(
+            mapObject,
+            *pSubnode,
+            inputValues,
+            outDisabled,
+            outResultStorage,
+            constantEvaluationResult);
+    }
+
+    if (outDisabled)
+        return false;
+
+    return true;
+}
+
+bool OsmAnd::MapStyleEvaluator_P::evaluateProgram(
+    const std::shared_ptr<const MapObject>& mapObject,
+    const MapStyleRulesetType rulesetType,
+    MapStyleEvaluationResult* const outResultStorage,
+    MapStyleEvaluationResultsCache::Values* const outEvaluatedValues) const
+{
+    _constantProgramEvaluationResult->clear();
+    OnDemand<ProgramEvaluationResult> constantEvaluationResult(_constantProgramEvaluationResult);
+
+    const auto pInputTag = _inputValues->getRef(_builtinValueDefs->id_INPUT_TAG);
+    const auto pInputValue = _inputValues->getRef(_builtinValueDefs->id_INPUT_VALUE);
+    if (pInputTag && pInputValue)
+    {
+        const auto evaluationResult = executeProgramRule(
+            mapObject,
+            rulesetType,
+            pInputTag->asUInt,
+            pInputValue->asUInt,
+            outResultStorage,
+            outEvaluatedValues,
+            constantEvaluationResult);
+        if (evaluationResult)
+            return true;
+    }
+
+    if (pInputTag)
+    {
+        const auto evaluationResult = executeProgramRule(
+            mapObject,
+            rulesetType,
+            pInputTag->asUInt,
+            ResolvedMapStyle::EmptyStringId,
+            outResultStorage,
+            outEvaluatedValues,
+            constantEvaluationResult);
+        if (evaluationResult)
+            return true;
+    }
+
+    return executeProgramRule(
+        mapObject,
+        rulesetType,
+        ResolvedMapStyle::EmptyStringId,
+        ResolvedMapStyle::EmptyStringId,
+        outResultStorage,
+        outEvaluatedValues,
+        constantEvaluationResult);
+}
+
+bool OsmAnd::MapStyleEvaluator_P::executeProgramRule(
+    const std::shared_ptr<const MapObject>& mapObject,
+    const MapStyleRulesetType rulesetType,
+    const IMapStyle::StringId tagStringId,
+    const IMapStyle::StringId valueStringId,
+    MapStyleEvaluationResult* const outResultStorage,
+    MapStyleEvaluationResultsCache::Values* const outEvaluatedValues,
+    OnDemand<ProgramEvaluationResult>& constantEvaluationResult) const
+{
+    const auto rootNodeIndex = _program->getRuleRootNode(
+        rulesetType,
+        TagValueId::compose(tagStringId, valueStringId));
+    if (rootNodeIndex == MapStyleProgram::InvalidIndex)
+        return false;
+
+    InputValue inputTag;
+    inputTag.asUInt = tagStringId;
+    _inputValuesShadow->set(_builtinValueDefs->id_INPUT_TAG, inputTag);
+
+    InputValue inputValue;
+    inputValue.asUInt = valueStringId;
+    _inputValuesShadow->set(_builtinValueDefs->id_INPUT_VALUE, inputValue);
+
+    if (outResultStorage)
+        _programEvaluationResult->clear();
+
+    bool wasDisabled = false;
+    const auto success = executeProgram(
+        mapObject.get(),
+        rootNodeIndex,
+        _inputValuesShadow,
+        wasDisabled,
+        _programEvaluationResult.get(),
+        constantEvaluationResult);
+    if (!success || wasDisabled)
+        return false;
+
+    if (outResultStorage)
+    {
+        postprocessProgramEvaluationResult(
+            mapObject.get(),
+            _inputValuesShadow,
+            *_programEvaluationResult,
+            *outResultStorage,
+            outEvaluatedValues,
+            constantEvaluationResult);
+    }
+
+    return true;
+}
+
+void OsmAnd::MapStyleEvaluator_P::fillResultFromProgramNode(
+    const MapStyleProgram::Node& node,
+    ProgramEvaluationResult& outResultStorage,
+    const bool allowOverride) const
+{
+    auto pOutput = _program->outputs.data() + node.firstOutput;
+    for (auto outputIdx = 0u; outputIdx < node.outputsCount; outputIdx++, pOutput++)
+    {
+        // If value already defined and override not allowed, do nothing
+        if (!allowOverride && outResultStorage.contains(pOutput->valueDefId))
+            continue;
+
+        outResultStorage.set(pOutput->valueDefId, pOutput->value);
+    }
+}
+
+void OsmAnd::MapStyleEvaluator_P::postprocessProgramEvaluationResult(
+    const MapObject* const mapObject,
+    const std::shared_ptr<const InputValues>& inputValues,
+    const ProgramEvaluationResult& intermediateResult,
+    MapStyleEvaluationResult& outResultStorage,
+    MapStyleEvaluationResultsCache::Values* const outEvaluatedValues,
+    OnDemand<ProgramEvaluationResult>& constantEvaluationResult) const
+{
+    for (ProgramEvaluationResult::KeyType idx = 0, count = intermediateResult.size(); idx < count; idx++)
+    {
+        const auto pValueIndex = intermediateResult.getRef(idx);
+        if (!pValueIndex)
+            continue;
+
+        const auto valueDefId = static_cast<IMapStyle::ValueDefinitionId>(idx);
+        const auto& valueDef = owner->mapStyle->getValueDefinitionRefById(valueDefId);
+
+        const auto constantRuleValue = evaluateProgramValue(
+            mapObject,
+            valueDef->dataType,
+            _program->values[*pValueIndex],
+            inputValues,
+            constantEvaluationResult);
+
+        const auto postprocessedValue = postprocessValue(valueDef->dataType, constantRuleValue);
         outResultStorage.setValue(valueDefId, postprocessedValue);
+        if (outEvaluatedValues)
+            outEvaluatedValues->push_back(MapStyleEvaluationResult::Packed::Entry(valueDefId, postprocessedValue));
     }
 }
 
@@ -409,6 +812,16 @@ void OsmAnd::MapStyleEvaluator_P::setFloatValue(const int valueDefId, const floa
     _inputValuesShadow->set(valueDefId, valueEntry);
 }
 
+std::shared_ptr<OsmAnd::MapStyleEvaluationResultsCache> OsmAnd::MapStyleEvaluator_P::getResultsCache() const
+{
+    return _resultsCache;
+}
+
+void OsmAnd::MapStyleEvaluator_P::setResultsCache(const std::shared_ptr<MapStyleEvaluationResultsCache>& resultsCache)
+{
+    _resultsCache = resultsCache;
+}
+
 void OsmAnd::MapStyleEvaluator_P::setStringValue(const int valueDefId, const QString& value)
 {
     InputValue valueEntry;
@@ -441,6 +854,50 @@ bool OsmAnd::MapStyleEvaluator_P::evaluate(
     //}
     //////////////////////////////////////////////////////////////////////////
 
+    if (_program)
+    {
+        if (!_resultsCache)
+            return evaluateProgram(mapObject, rulesetType, outResultStorage, nullptr);
+
+        MapStyleEvaluationResultsCache::Key key;
+        key.rulesetType = rulesetType;
+        key.ptScaleFactor = owner->ptScaleFactor;
+        const auto& rulesetInputs = _program->rulesetsInputs[static_cast<unsigned int>(rulesetType)];
+        key.inputs.reserve(static_cast<int>(rulesetInputs.size()));
+        for (const auto valueDefId : rulesetInputs)
+        {
+            const auto pInputValue = _inputValues->getRef(valueDefId);
+            key.inputs.push_back(pInputValue
+                ? ((static_cast<uint64_t>(1u) << 32) | pInputValue->asUInt)
+                : 0u);
+        }
+
+        MapStyleEvaluationResultsCache::Entry cachedEntry;
+        if (_resultsCache->get(key, cachedEntry))
+        {
+            if (outResultStorage)
+            {
+                for (const auto& value : constOf(cachedEntry.values))
+                    outResultStorage->setValue(value.first, value.second);
+            }
+            return cachedEntry.success;
+        }
+
+        _mapObjectAccessed = false;
+        MapStyleEvaluationResultsCache::Entry entry;
+        entry.success = evaluateProgram(
+            mapObject,
+            rulesetType,
+            outResultStorage,
+            outResultStorage ? &entry.values : nullptr);
+
+        // Result without values can't serve evaluations that need them
+        if (!_mapObjectAccessed && outResultStorage)
+            _resultsCache->put(key, entry);
+
+        return entry.success;
+    }
+
     const auto& ruleset = owner->mapStyle->getRuleset(rulesetType);
 
     _constantIntermediateEvaluationResult->clear();
@@ -489,6 +946,42 @@ bool OsmAnd::MapStyleEvaluator_P::evaluate(
     const std::shared_ptr<const IMapStyle::IAttribute>& attribute,
     MapStyleEvaluationResult* const outResultStorage) const
 {
+    const auto rootNodeIndex = _program
+        ? _program->getAttributeRootNode(attribute.get())
+        : MapStyleProgram::InvalidIndex;
+    if (rootNodeIndex != MapStyleProgram::InvalidIndex)
+    {
+        if (outResultStorage)
+            _programEvaluationResult->clear();
+
+        _constantProgramEvaluationResult->clear();
+        OnDemand<ProgramEvaluationResult> constantEvaluationResult(_constantProgramEvaluationResult);
+
+        bool wasDisabled = false;
+        const auto success = executeProgram(
+            nullptr,
+            rootNodeIndex,
+            _inputValues,
+            wasDisabled,
+            _programEvaluationResult.get(),
+            constantEvaluationResult);
+        if (!success || wasDisabled)
+            return false;
+
+        if (outResultStorage)
+        {
+            postprocessProgramEvaluationResult(
+                nullptr,
+                _inputValues,
+                *_programEvaluationResult,
+                *outResultStorage,
+                nullptr,
+                constantEvaluationResult);
+        }
+
+        return true;
+    }
+
     if (outResultStorage)
         _intermediateEvaluationResult->clear();
 
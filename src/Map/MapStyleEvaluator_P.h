@@ -5,6 +5,7 @@
 
 #include "QtExtensions.h"
 #include "ignore_warnings_on_external_includes.h"
+#include <QVariant>
 #include "restore_internal_warnings.h"
 
 #include "OsmAndCore.h"
@@ -13,6 +14,8 @@
 #include "PrivateImplementation.h"
 #include "MapStyleConstantValue.h"
 #include "IMapStyle.h"
+#include "MapStyleProgram.h"
+#include "MapStyleEvaluationResultsCache.h"
 
 namespace OsmAnd
 {
@@ -85,6 +88,78 @@ namespace OsmAnd
             const IntermediateEvaluationResult& intermediateResult,
             MapStyleEvaluationResult& outResultStorage,
             OnDemand<IntermediateEvaluationResult>& constantEvaluationResult) const;
+
+        QVariant postprocessValue(
+            const MapStyleValueDataType dataType,
+            const MapStyleConstantValue& constantValue) const;
+
+        // Compiled program of the style, if available. When set, it's used instead of walking rule trees
+        std::shared_ptr<const MapStyleProgram> _program;
+
+        // Program intermediate results refer to values of program by index
+        typedef ArrayMap<MapStyleProgram::Index> ProgramEvaluationResult;
+        std::shared_ptr<ProgramEvaluationResult> _programEvaluationResult;
+        std::shared_ptr<ProgramEvaluationResult> _constantProgramEvaluationResult;
+        const OnDemand<ProgramEvaluationResult>::Allocator _programEvaluationResultAllocator;
+        ProgramEvaluationResult* allocateProgramEvaluationResult();
+
+        // Map objects come in batches sharing same attribute mapping, so keep last resolved one at hand
+        mutable std::shared_ptr<const MapObject::AttributeMapping> _lastAttributeMapping;
+        mutable std::shared_ptr<const MapStyleProgram::ResolvedAdditionalConditions> _lastResolvedAdditionalConditions;
+        bool checkAdditionalCondition(const MapObject* const mapObject, const MapStyleProgram::Index conditionIndex) const;
+
+        std::shared_ptr<MapStyleEvaluationResultsCache> _resultsCache;
+        // Set when evaluation read data of map object, so its result can't be reused for other objects
+        mutable bool _mapObjectAccessed;
+
+        bool evaluateProgram(
+            const std::shared_ptr<const MapObject>& mapObject,
+            const MapStyleRulesetType rulesetType,
+            MapStyleEvaluationResult* const outResultStorage,
+            MapStyleEvaluationResultsCache::Values* const outEvaluatedValues) const;
+
+        MapStyleConstantValue evaluateProgramValue(
+            const MapObject* const mapObject,
+            const MapStyleValueDataType dataType,
+            const MapStyleProgram::Value& value,
+            const std::shared_ptr<const InputValues>& inputValues,
+            OnDemand<ProgramEvaluationResult>& intermediateEvaluationResult) const;
+
+        bool checkProgramInput(
+            const MapObject* const mapObject,
+            const MapStyleProgram::InputCheck& inputCheck,
+            const std::shared_ptr<const InputValues>& inputValues,
+            OnDemand<ProgramEvaluationResult>& constantEvaluationResult) const;
+
+        bool executeProgram(
+            const MapObject* const mapObject,
+            const MapStyleProgram::Index nodeIndex,
+            const std::shared_ptr<const InputValues>& inputValues,
+            bool& outDisabled,
+            ProgramEvaluationResult* const outResultStorage,
+            OnDemand<ProgramEvaluationResult>& constantEvaluationResult) const;
+
+        bool executeProgramRule(
+            const std::shared_ptr<const MapObject>& mapObject,
+            const MapStyleRulesetType rulesetType,
+            const IMapStyle::StringId tagStringId,
+            const IMapStyle::StringId valueStringId,
+            MapStyleEvaluationResult* const outResultStorage,
+            MapStyleEvaluationResultsCache::Values* const outEvaluatedValues,
+            OnDemand<ProgramEvaluationResult>& constantEvaluationResult) const;
+
+        void fillResultFromProgramNode(
+            const MapStyleProgram::Node& node,
+            ProgramEvaluationResult& outResultStorage,
+            const bool allowOverride) const;
+
+        void postprocessProgramEvaluationResult(
+            const MapObject* const mapObject,
+            const std::shared_ptr<const InputValues>& inputValues,
+            const ProgramEvaluationResult& intermediateResult,
+            MapStyleEvaluationResult& outResultStorage,
+            MapStyleEvaluationResultsCache::Values* const outEvaluatedValues,
+            OnDemand<ProgramEvaluationResult>& constantEvaluationResult) const;
     protected:
         MapStyleEvaluator_P(MapStyleEvaluator* owner);
     public:
@@ -100,6 +175,9 @@ namespace OsmAnd
         void setFloatValue(const IMapStyle::ValueDefinitionId valueDefId, const float value);
         void setStringValue(const IMapStyle::ValueDefinitionId valueDefId, const QString& value);
 
+        std::shared_ptr<MapStyleEvaluationResultsCache> getResultsCache() const;
+        void setResultsCache(const std::shared_ptr<MapStyleEvaluationResultsCache>& resultsCache);
+
         bool evaluate(
             const std::shared_ptr<const MapObject>& mapObject,
             const MapStyleRulesetType rulesetType,
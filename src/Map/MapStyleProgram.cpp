@@ -0,0 +1,456 @@
+#include "MapStyleProgram.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QVector>
+#include <QSet>
+#include <QMap>
+#include <QCryptographicHash>
+#include "restore_internal_warnings.h"
+
+#include "QtCommon.h"
+
+#include "MapStyleBuiltinValueDefinitions.h"
+#include "MapStyleValueDefinition.h"
+#include "QKeyValueIterator.h"
+
+namespace OsmAnd
+{
+    class MapStyleProgram::Compiler Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(Compiler);
+    private:
+        const IMapStyle& _mapStyle;
+        const std::shared_ptr<const MapStyleBuiltinValueDefinitions> _builtinValueDefs;
+        MapStyleProgram* const _program;
+
+        // Inputs referenced by nodes being compiled at the moment
+        QSet<IMapStyle::ValueDefinitionId>* _pCollectedInputs;
+        QSet<IMapStyle::ValueDefinitionId> _attributesInputs;
+
+        // Names of attributes by their root nodes, used to compute fingerprint
+        QHash<Index, QString> _attributesNames;
+
+        static int getInputCheckCost(const InputCheck& inputCheck, const Value& value)
+        {
+            // Cheap integer comparisons go first, so that most rules are rejected before any
+            // dynamic value is evaluated or any tag of map object is looked up
+            if (inputCheck.opcode == Opcode::Additional)
+                return 3;
+            if (value.isDynamic)
+                return 2;
+            if (inputCheck.opcode == Opcode::IntEquals || inputCheck.opcode == Opcode::FloatEquals)
+                return 1;
+            return 0;
+        }
+
+        Index allocateNode()
+        {
+            const auto nodeIndex = static_cast<Index>(_program->nodes.size());
+            _program->nodes.push_back(Node());
+            return nodeIndex;
+        }
+
+        Index compileAttribute(const std::shared_ptr<const IMapStyle::IAttribute>& attribute)
+        {
+            const auto citRootNode = _program->attributes.constFind(attribute.get());
+            if (citRootNode != _program->attributes.cend())
+                return *citRootNode;
+
+            // Register attribute before compiling it, since its rules may reference the attribute itself
+            const auto rootNodeIndex = allocateNode();
+            _program->attributes.insert(attribute.get(), rootNodeIndex);
+
+            const auto pPrevCollectedInputs = _pCollectedInputs;
+            _pCollectedInputs = &_attributesInputs;
+            compileNode(rootNodeIndex, attribute->getRootNodeRef());
+            _pCollectedInputs = pPrevCollectedInputs;
+
+            return rootNodeIndex;
+        }
+
+        Index compileValue(const IMapStyle::Value& value)
+        {
+            Value compiledValue;
+            compiledValue.isDynamic = value.isDynamic;
+            compiledValue.asConstantValue = value.asConstantValue;
+            compiledValue.attributeRootNode = value.isDynamic
+                ? compileAttribute(value.asDynamicValue.attribute)
+                : InvalidIndex;
+
+            const auto valueIndex = static_cast<Index>(_program->values.size());
+            _program->values.push_back(compiledValue);
+            return valueIndex;
+        }
+
+        Index compileAdditionalCondition(const IMapStyle::Value& value)
+        {
+            const auto conditionString = _mapStyle.getStringById(value.asConstantValue.asSimple.asUInt);
+
+            AdditionalCondition additionalCondition;
+            const auto equalSignIdx = conditionString.indexOf(QLatin1Char('='));
+            additionalCondition.hasValue = (equalSignIdx >= 0);
+            if (additionalCondition.hasValue)
+            {
+                additionalCondition.tag = conditionString.mid(0, equalSignIdx);
+                additionalCondition.value = conditionString.mid(equalSignIdx + 1);
+            }
+            else
+                additionalCondition.tag = conditionString;
+
+            const auto conditionIndex = static_cast<Index>(_program->additionalConditions.size());
+            _program->additionalConditions.push_back(additionalCondition);
+            return conditionIndex;
+        }
+
+        Index compileSubnodes(const QList< std::shared_ptr<const IMapStyle::IRuleNode> >& ruleNodes)
+        {
+            QVector<Index> subnodes;
+            subnodes.reserve(ruleNodes.size());
+            for (const auto& ruleNode : constOf(ruleNodes))
+            {
+                const auto subnodeIndex = allocateNode();
+                compileNode(subnodeIndex, ruleNode);
+                subnodes.push_back(subnodeIndex);
+            }
+
+            // Subnodes of each node occupy contiguous range
+            const auto firstSubnode = static_cast<Index>(_program->subnodes.size());
+            _program->subnodes.insert(_program->subnodes.end(), subnodes.cbegin(), subnodes.cend());
+            return firstSubnode;
+        }
+
+        void compileNode(const Index nodeIndex, const std::shared_ptr<const IMapStyle::IRuleNode>& ruleNode)
+        {
+            Node node;
+            node.isSwitch = ruleNode->getIsSwitch();
+            node.disableValue = InvalidIndex;
+
+            std::vector<InputCheck> inputChecks;
+            std::vector<Output> outputs;
+            const auto& ruleNodeValues = ruleNode->getValuesRef();
+            for (const auto& ruleValueEntry : rangeOf(constOf(ruleNodeValues)))
+            {
+                const auto valueDefId = ruleValueEntry.key();
+                const auto& valueDef = _mapStyle.getValueDefinitionRefById(valueDefId);
+
+                if (valueDefId == _builtinValueDefs->id_OUTPUT_DISABLE)
+                    node.disableValue = compileValue(ruleValueEntry.value());
+
+                if (valueDef->valueClass == MapStyleValueDefinition::Class::Input)
+                {
+                    InputCheck inputCheck;
+                    inputCheck.valueDefId = valueDefId;
+                    inputCheck.dataType = valueDef->dataType;
+                    inputCheck.value = compileValue(ruleValueEntry.value());
+                    inputCheck.additionalCondition = InvalidIndex;
+                    if (_pCollectedInputs)
+                        _pCollectedInputs->insert(valueDefId);
+                    if (valueDefId == _builtinValueDefs->id_INPUT_MINZOOM)
+                        inputCheck.opcode = Opcode::MinZoom;
+                    else if (valueDefId == _builtinValueDefs->id_INPUT_MAXZOOM)
+                        inputCheck.opcode = Opcode::MaxZoom;
+                    else if (valueDefId == _builtinValueDefs->id_INPUT_ADDITIONAL)
+                    {
+                        inputCheck.opcode = Opcode::Additional;
+                        if (!ruleValueEntry.value().isDynamic)
+                            inputCheck.additionalCondition = compileAdditionalCondition(ruleValueEntry.value());
+                    }
+                    else if (valueDefId == _builtinValueDefs->id_INPUT_TEST)
+                        inputCheck.opcode = Opcode::Test;
+                    else if (valueDef->dataType == MapStyleValueDataType::Float)
+                        inputCheck.opcode = Opcode::FloatEquals;
+                    else
+                        inputCheck.opcode = Opcode::IntEquals;
+                    inputChecks.push_back(inputCheck);
+                }
+                else if (valueDef->valueClass == MapStyleValueDefinition::Class::Output)
+                {
+                    Output output;
+                    output.valueDefId = valueDefId;
+                    output.dataType = valueDef->dataType;
+                    output.value = compileValue(ruleValueEntry.value());
+                    outputs.push_back(output);
+                }
+            }
+
+            const auto& values = _program->values;
+            std::stable_sort(inputChecks.begin(), inputChecks.end(),
+                [&values]
+                (const InputCheck& l, const InputCheck& r) -> bool
+                {
+                    return getInputCheckCost(l, values[l.value]) < getInputCheckCost(r, values[r.value]);
+                });
+
+            node.firstInputCheck = static_cast<Index>(_program->inputChecks.size());
+            node.inputChecksCount = static_cast<Index>(inputChecks.size());
+            _program->inputChecks.insert(_program->inputChecks.end(), inputChecks.cbegin(), inputChecks.cend());
+
+            node.firstOutput = static_cast<Index>(_program->outputs.size());
+            node.outputsCount = static_cast<Index>(outputs.size());
+            _program->outputs.insert(_program->outputs.end(), outputs.cbegin(), outputs.cend());
+
+            const auto& oneOfConditionalSubnodes = ruleNode->getOneOfConditionalSubnodesRef();
+            node.conditionalSubnodesCount = static_cast<Index>(oneOfConditionalSubnodes.size());
+            node.firstConditionalSubnode = compileSubnodes(oneOfConditionalSubnodes);
+
+            const auto& applySubnodes = ruleNode->getApplySubnodesRef();
+            node.applySubnodesCount = static_cast<Index>(applySubnodes.size());
+            node.firstApplySubnode = compileSubnodes(applySubnodes);
+
+            _program->nodes[nodeIndex] = node;
+        }
+
+        // Digests don't depend on indices, string ids or value definition ids, since all of them are assigned
+        // in order of hash tables iteration that varies between runs
+        QByteArray digestValue(const Index valueIndex, const MapStyleValueDataType dataType) const
+        {
+            QByteArray digest;
+            if (valueIndex == InvalidIndex)
+                return digest;
+
+            const auto& value = _program->values[valueIndex];
+            if (value.isDynamic)
+            {
+                digest.append('@');
+                digest.append(_attributesNames.value(value.attributeRootNode).toUtf8());
+                return digest;
+            }
+
+            if (dataType == MapStyleValueDataType::String && !value.asConstantValue.isComplex)
+            {
+                digest.append('t');
+                digest.append(_mapStyle.getStringById(value.asConstantValue.asSimple.asUInt).toUtf8());
+                return digest;
+            }
+
+            digest.append(value.asConstantValue.isComplex ? 'c' : 's');
+            digest.append(
+                reinterpret_cast<const char*>(&value.asConstantValue.asSimple.asUInt64),
+                sizeof(value.asConstantValue.asSimple.asUInt64));
+            return digest;
+        }
+
+        QByteArray digestValueDefinition(const IMapStyle::ValueDefinitionId valueDefId) const
+        {
+            const auto& valueDef = _mapStyle.getValueDefinitionRefById(valueDefId);
+            return valueDef ? valueDef->name.toUtf8() : QByteArray::number(valueDefId);
+        }
+
+        QByteArray digestNode(const Index nodeIndex) const
+        {
+            const auto& node = _program->nodes[nodeIndex];
+
+            QMap<QByteArray, QByteArray> inputs;
+            for (auto inputCheckIdx = 0u; inputCheckIdx < node.inputChecksCount; inputCheckIdx++)
+            {
+                const auto& inputCheck = _program->inputChecks[node.firstInputCheck + inputCheckIdx];
+                inputs.insert(
+                    digestValueDefinition(inputCheck.valueDefId),
+                    digestValue(inputCheck.value, inputCheck.dataType));
+            }
+            QMap<QByteArray, QByteArray> outputs;
+            for (auto outputIdx = 0u; outputIdx < node.outputsCount; outputIdx++)
+            {
+                const auto& output = _program->outputs[node.firstOutput + outputIdx];
+                outputs.insert(
+                    digestValueDefinition(output.valueDefId),
+                    digestValue(output.value, output.dataType));
+            }
+
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            hash.addData(node.isSwitch ? "S" : "N", 1);
+            for (const auto& inputEntry : rangeOf(constOf(inputs)))
+            {
+                hash.addData(inputEntry.key());
+                hash.addData("=", 1);
+                hash.addData(inputEntry.value());
+            }
+            hash.addData("|", 1);
+            for (const auto& outputEntry : rangeOf(constOf(outputs)))
+            {
+                hash.addData(outputEntry.key());
+                hash.addData("=", 1);
+                hash.addData(outputEntry.value());
+            }
+            hash.addData("?", 1);
+            for (auto subnodeIdx = 0u; subnodeIdx < node.conditionalSubnodesCount; subnodeIdx++)
+                hash.addData(digestNode(_program->subnodes[node.firstConditionalSubnode + subnodeIdx]));
+            hash.addData("!", 1);
+            for (auto subnodeIdx = 0u; subnodeIdx < node.applySubnodesCount; subnodeIdx++)
+                hash.addData(digestNode(_program->subnodes[node.firstApplySubnode + subnodeIdx]));
+            return hash.result();
+        }
+
+        uint64_t computeFingerprint()
+        {
+            QMap<QString, Index> attributes;
+            for (const auto& attributeEntry : rangeOf(constOf(_program->attributes)))
+            {
+                const auto name = _mapStyle.getStringById(attributeEntry.key()->getNameId());
+                attributes.insert(name, attributeEntry.value());
+                _attributesNames.insert(attributeEntry.value(), name);
+            }
+
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            for (const auto& attributeEntry : rangeOf(constOf(attributes)))
+            {
+                hash.addData(attributeEntry.key().toUtf8());
+                hash.addData(digestNode(attributeEntry.value()));
+            }
+            for (auto rulesetTypeIdx = 0u; rulesetTypeIdx < MapStyleRulesetTypesCount; rulesetTypeIdx++)
+            {
+                QMap<QString, Index> rules;
+                for (const auto& ruleEntry : rangeOf(constOf(_program->rulesets[rulesetTypeIdx])))
+                {
+                    const auto tagValueId = ruleEntry.key();
+                    const auto key = _mapStyle.getStringById(tagValueId.tagId)
+                        + QLatin1Char('=')
+                        + _mapStyle.getStringById(tagValueId.valueId);
+                    rules.insert(key, ruleEntry.value());
+                }
+
+                hash.addData(reinterpret_cast<const char*>(&rulesetTypeIdx), sizeof(rulesetTypeIdx));
+                for (const auto& ruleEntry : rangeOf(constOf(rules)))
+                {
+                    hash.addData(ruleEntry.key().toUtf8());
+                    hash.addData(digestNode(ruleEntry.value()));
+                }
+            }
+
+            uint64_t fingerprint = 0;
+            const auto result = hash.result();
+            memcpy(&fingerprint, result.constData(), qMin(static_cast<size_t>(result.size()), sizeof(fingerprint)));
+            return fingerprint;
+        }
+    public:
+        Compiler(const IMapStyle& mapStyle, MapStyleProgram* const program)
+            : _mapStyle(mapStyle)
+            , _builtinValueDefs(MapStyleBuiltinValueDefinitions::get())
+            , _program(program)
+            , _pCollectedInputs(nullptr)
+        {
+        }
+
+        void compile()
+        {
+            for (const auto& attribute : constOf(_mapStyle.getAttributes()))
+                compileAttribute(attribute);
+
+            for (auto rulesetTypeIdx = 0u; rulesetTypeIdx < MapStyleRulesetTypesCount; rulesetTypeIdx++)
+            {
+                const auto rulesetType = static_cast<MapStyleRulesetType>(rulesetTypeIdx);
+                const auto ruleset = _mapStyle.getRuleset(rulesetType);
+                auto& compiledRuleset = _program->rulesets[rulesetTypeIdx];
+                compiledRuleset.reserve(ruleset.size());
+
+                // Rule itself is selected by tag and value
+                QSet<IMapStyle::ValueDefinitionId> rulesetInputs;
+                rulesetInputs.insert(_builtinValueDefs->id_INPUT_TAG);
+                rulesetInputs.insert(_builtinValueDefs->id_INPUT_VALUE);
+
+                _pCollectedInputs = &rulesetInputs;
+                for (const auto& ruleEntry : rangeOf(constOf(ruleset)))
+                {
+                    const auto rootNodeIndex = allocateNode();
+                    compileNode(rootNodeIndex, ruleEntry.value()->getRootNodeRef());
+                    compiledRuleset.insert(ruleEntry.key(), rootNodeIndex);
+                }
+                _pCollectedInputs = nullptr;
+
+                rulesetInputs.unite(_attributesInputs);
+                auto& compiledRulesetInputs = _program->rulesetsInputs[rulesetTypeIdx];
+                compiledRulesetInputs.assign(rulesetInputs.cbegin(), rulesetInputs.cend());
+                std::sort(compiledRulesetInputs);
+            }
+
+            _program->nodes.shrink_to_fit();
+            _program->inputChecks.shrink_to_fit();
+            _program->outputs.shrink_to_fit();
+            _program->subnodes.shrink_to_fit();
+            _program->values.shrink_to_fit();
+            _program->additionalConditions.shrink_to_fit();
+
+            _program->fingerprint = computeFingerprint();
+        }
+    };
+}
+
+OsmAnd::MapStyleProgram::MapStyleProgram()
+    : fingerprint(0)
+{
+}
+
+OsmAnd::MapStyleProgram::~MapStyleProgram()
+{
+}
+
+std::shared_ptr<const OsmAnd::MapStyleProgram::ResolvedAdditionalConditions>
+OsmAnd::MapStyleProgram::resolveAdditionalConditions(
+    const std::shared_ptr<const MapObject::AttributeMapping>& attributeMapping) const
+{
+    {
+        QReadLocker scopedLocker(&_resolvedAdditionalConditionsLock);
+
+        const auto citResolved = _resolvedAdditionalConditions.constFind(attributeMapping.get());
+        // Mapping may have been destroyed and another one allocated at same address
+        if (citResolved != _resolvedAdditionalConditions.cend()
+            && (*citResolved)->attributeMapping.lock() == attributeMapping)
+        {
+            return *citResolved;
+        }
+    }
+
+    const std::shared_ptr<ResolvedAdditionalConditions> resolved(new ResolvedAdditionalConditions());
+    resolved->attributeMapping = attributeMapping;
+    resolved->attributeIds.resize(additionalConditions.size());
+    for (auto conditionIdx = 0u; conditionIdx < additionalConditions.size(); conditionIdx++)
+    {
+        const auto& additionalCondition = additionalConditions[conditionIdx];
+        auto& attributeIds = resolved->attributeIds[conditionIdx];
+
+        const auto citTagsGroup = attributeMapping->encodeMap.constFind(&additionalCondition.tag);
+        if (citTagsGroup == attributeMapping->encodeMap.cend())
+            continue;
+
+        if (additionalCondition.hasValue)
+        {
+            const auto citAttributeId = citTagsGroup->constFind(&additionalCondition.value);
+            if (citAttributeId != citTagsGroup->cend())
+                attributeIds.push_back(*citAttributeId);
+        }
+        else
+        {
+            attributeIds.reserve(citTagsGroup->size());
+            for (const auto attributeId : constOf(*citTagsGroup))
+                attributeIds.push_back(attributeId);
+            std::sort(attributeIds);
+        }
+    }
+
+    {
+        QWriteLocker scopedLocker(&_resolvedAdditionalConditionsLock);
+
+        // Drop entries of mappings that no longer exist
+        auto itResolved = mutableIteratorOf(_resolvedAdditionalConditions);
+        while (itResolved.hasNext())
+        {
+            if (itResolved.next().value()->attributeMapping.expired())
+                itResolved.remove();
+        }
+
+        _resolvedAdditionalConditions.insert(attributeMapping.get(), resolved);
+    }
+
+    return resolved;
+}
+
+std::shared_ptr<const OsmAnd::MapStyleProgram> OsmAnd::MapStyleProgram::compile(const IMapStyle& mapStyle)
+{
+    const std::shared_ptr<MapStyleProgram> program(new MapStyleProgram());
+    Compiler(mapStyle, program.get()).compile();
+    return program;
+}
@@ -0,0 +1,149 @@
+#ifndef _OSMAND_CORE_MAP_STYLE_PROGRAM_H_
+#define _OSMAND_CORE_MAP_STYLE_PROGRAM_H_
+
+#include "stdlib_common.h"
+#include <array>
+#include <vector>
+#include <limits>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QReadWriteLock>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "MapCommonTypes.h"
+#include "MapStyleConstantValue.h"
+#include "IMapStyle.h"
+#include "MapObject.h"
+
+namespace OsmAnd
+{
+    // Flat representation of all rule trees of a map style. Nodes, input checks, outputs and values are stored
+    // in dense arrays and reference each other by index, so evaluation doesn't touch any hash or shared pointer.
+    class MapStyleProgram Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapStyleProgram);
+    public:
+        typedef uint32_t Index;
+        enum : uint32_t {
+            InvalidIndex = std::numeric_limits<uint32_t>::max()
+        };
+
+        enum class Opcode : uint8_t
+        {
+            MinZoom,
+            MaxZoom,
+            Test,
+            IntEquals,
+            FloatEquals,
+            Additional,
+        };
+
+        struct Value
+        {
+            bool isDynamic;
+            MapStyleConstantValue asConstantValue;
+            // Root node of attribute that produces this value, if dynamic
+            Index attributeRootNode;
+        };
+
+        struct InputCheck
+        {
+            Opcode opcode;
+            MapStyleValueDataType dataType;
+            IMapStyle::ValueDefinitionId valueDefId;
+            Index value;
+            // Pre-parsed condition of constant 'additional' input, if any
+            Index additionalCondition;
+        };
+
+        // 'additional' condition in form of "tag=value" or just "tag"
+        struct AdditionalCondition
+        {
+            QString tag;
+            QString value;
+            bool hasValue;
+        };
+
+        // Additional conditions resolved against specific attribute mapping: for each condition,
+        // sorted identifiers of attributes that satisfy it
+        struct ResolvedAdditionalConditions
+        {
+            std::weak_ptr<const MapObject::AttributeMapping> attributeMapping;
+            std::vector< QVector<uint32_t> > attributeIds;
+        };
+
+        struct Output
+        {
+            IMapStyle::ValueDefinitionId valueDefId;
+            MapStyleValueDataType dataType;
+            Index value;
+        };
+
+        struct Node
+        {
+            bool isSwitch;
+            Index disableValue;
+
+            Index firstInputCheck;
+            Index inputChecksCount;
+            Index firstOutput;
+            Index outputsCount;
+            Index firstConditionalSubnode;
+            Index conditionalSubnodesCount;
+            Index firstApplySubnode;
+            Index applySubnodesCount;
+        };
+
+    private:
+        class Compiler;
+
+        mutable QReadWriteLock _resolvedAdditionalConditionsLock;
+        mutable QHash<
+            const MapObject::AttributeMapping*,
+            std::shared_ptr<const ResolvedAdditionalConditions> > _resolvedAdditionalConditions;
+    protected:
+        MapStyleProgram();
+    public:
+        ~MapStyleProgram();
+
+        std::vector<Node> nodes;
+        std::vector<InputCheck> inputChecks;
+        std::vector<Output> outputs;
+        std::vector<Index> subnodes;
+        std::vector<Value> values;
+        std::vector<AdditionalCondition> additionalConditions;
+
+        std::array< QHash<TagValueId, Index>, MapStyleRulesetTypesCount > rulesets;
+        // Sorted identifiers of all inputs that evaluation of ruleset may read, including ones read by attributes
+        std::array< std::vector<IMapStyle::ValueDefinitionId>, MapStyleRulesetTypesCount > rulesetsInputs;
+        QHash<const IMapStyle::IAttribute*, Index> attributes;
+        // Hash of style content, stable across sessions
+        uint64_t fingerprint;
+
+        inline Index getRuleRootNode(const MapStyleRulesetType rulesetType, const TagValueId ruleId) const
+        {
+            const auto& ruleset = rulesets[static_cast<unsigned int>(rulesetType)];
+            const auto citRootNode = ruleset.constFind(ruleId);
+            if (citRootNode == ruleset.cend())
+                return InvalidIndex;
+            return *citRootNode;
+        }
+
+        inline Index getAttributeRootNode(const IMapStyle::IAttribute* const attribute) const
+        {
+            return attributes.value(attribute, InvalidIndex);
+        }
+
+        std::shared_ptr<const ResolvedAdditionalConditions> resolveAdditionalConditions(
+            const std::shared_ptr<const MapObject::AttributeMapping>& attributeMapping) const;
+
+        static std::shared_ptr<const MapStyleProgram> compile(const IMapStyle& mapStyle);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_STYLE_PROGRAM_H_)
@@ -4,6 +4,8 @@
 #include "QtExtensions.h"
 #include "QtCommon.h"
 
+#include "MapStyleProgram.h"
+
 OsmAnd::ResolvedMapStyle::ResolvedMapStyle(const QList< std::shared_ptr<const UnresolvedMapStyle> >& unresolvedMapStylesChain_)
     : _p(new ResolvedMapStyle_P(this))
     , unresolvedMapStylesChain(unresolvedMapStylesChain_)
@@ -91,6 +93,17 @@ QString OsmAnd::ResolvedMapStyle::getStringById(const StringId id) const
     return _p->getStringById(id);
 }
 
+std::shared_ptr<const OsmAnd::MapStyleProgram> OsmAnd::ResolvedMapStyle::getProgram() const
+{
+    return _p->getProgram();
+}
+
+uint64_t OsmAnd::ResolvedMapStyle::getFingerprint() const
+{
+    const auto program = _p->getProgram();
+    return program ? program->fingerprint : 0;
+}
+
 std::shared_ptr<const OsmAnd::ResolvedMapStyle> OsmAnd::ResolvedMapStyle::resolveMapStylesChain(
     const QList< std::shared_ptr<const UnresolvedMapStyle> >& unresolvedMapStylesChain)
 {
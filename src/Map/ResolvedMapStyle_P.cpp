@@ -2,6 +2,7 @@
 
 #include "Logging.h"
 #include "MapStyleBuiltinValueDefinitions.h"
+#include "MapStyleProgram.h"
 #include "MapStyleValueDefinition.h"
 #include "QKeyValueIterator.h"
 #include "QtCommon.h"
@@ -426,6 +427,8 @@ bool OsmAnd::ResolvedMapStyle_P::resolve()
     if (!mergeAndResolveRulesets())
         return false;
 
+    _program = MapStyleProgram::compile(*owner);
+
     return true;
 }
 
@@ -519,3 +522,8 @@ QString OsmAnd::ResolvedMapStyle_P::getStringById(const StringId id) const
         return QString::null;
     return _stringsForwardLUT[id];
 }
+
+std::shared_ptr<const OsmAnd::MapStyleProgram> OsmAnd::ResolvedMapStyle_P::getProgram() const
+{
+    return _program;
+}
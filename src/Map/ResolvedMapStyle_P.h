@@ -19,6 +19,7 @@
 namespace OsmAnd
 {
     class MapStyleValueDefinition;
+    class MapStyleProgram;
 
     class ResolvedMapStyle;
     class ResolvedMapStyle_P Q_DECL_FINAL
@@ -79,6 +80,7 @@ namespace OsmAnd
         QHash<StringId, std::shared_ptr<const IMapStyle::IParameter> > _parameters;
         QHash<StringId, std::shared_ptr<const IMapStyle::IAttribute> > _attributes;
         std::array< QHash<TagValueId, std::shared_ptr<const IMapStyle::IRule> >, MapStyleRulesetTypesCount> _rulesets;
+        std::shared_ptr<const MapStyleProgram> _program;
     public:
         virtual ~ResolvedMapStyle_P();
 
@@ -108,6 +110,8 @@ namespace OsmAnd
 
         QString getStringById(const StringId id) const;
 
+        std::shared_ptr<const MapStyleProgram> getProgram() const;
+
     friend class OsmAnd::ResolvedMapStyle;
     };
 }
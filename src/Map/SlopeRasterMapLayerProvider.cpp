@@ -25,6 +25,10 @@ OsmAnd::SlopeRasterMapLayerProvider::SlopeRasterMapLayerProvider(
     , _maxVisibleZoom(maxZoom)
     , _priority(0)
 {
+    // Heights read for this layer are shared with other terrain layers of same tile size
+    const uint32_t overlap = SlopeRasterMapLayerProvider_P::Overlap;
+    if (filesCollection)
+        filesCollection->registerHeightsConsumer(tileSize + overlap, overlap, true);
 }
 
 OsmAnd::SlopeRasterMapLayerProvider::~SlopeRasterMapLayerProvider()
@@ -32,6 +36,10 @@ OsmAnd::SlopeRasterMapLayerProvider::~SlopeRasterMapLayerProvider()
      QMutexLocker scopedLocker(&_threadPoolMutex);
     _threadPool->clear();
     delete _threadPool;
+
+    const uint32_t overlap = SlopeRasterMapLayerProvider_P::Overlap;
+    if (filesCollection)
+        filesCollection->unregisterHeightsConsumer(_p->tileSize + overlap, overlap, true);
 }
 
 OsmAnd::MapStubStyle OsmAnd::SlopeRasterMapLayerProvider::getDesiredStubsStyle() const
@@ -82,8 +82,7 @@ bool OsmAnd::SlopeRasterMapLayerProvider_P::obtainData(
 
     // Produce slope RGBA values from height values
     const int bandCount = 4;
-    // Extra pixels on both edges give more accurate slope calculations
-    const int overlap = 4;
+    const int overlap = Overlap;
     const auto bufferSize = tileSize * tileSize * bandCount;
     const auto pBuffer = new char[bufferSize];
     const auto result = owner->filesCollection->getGeoTiffData(
@@ -37,6 +37,11 @@ namespace OsmAnd
             const uint32_t tileSize,
             const float densityFactor);
     public:
+        // Extra pixels on both edges give more accurate slope calculations
+        enum {
+            Overlap = 4,
+        };
+
         virtual ~SlopeRasterMapLayerProvider_P();
 
         ImplementationInterface<SlopeRasterMapLayerProvider> owner;
@@ -21,6 +21,9 @@ OsmAnd::SqliteHeightmapTileProvider::SqliteHeightmapTileProvider(
     , filesCollection(filesCollection_)
     , outputTileSize(outputTileSize_)
 {
+    // Heights read for this provider are shared with other heightmap consumers of same tile size
+    if (filesCollection)
+        filesCollection->registerHeightsConsumer(outputTileSize, SqliteHeightmapTileProvider_P::Overlap, false);
 }
 
 OsmAnd::SqliteHeightmapTileProvider::SqliteHeightmapTileProvider(
@@ -32,10 +35,15 @@ OsmAnd::SqliteHeightmapTileProvider::SqliteHeightmapTileProvider(
     , filesCollection(filesCollection_)
     , outputTileSize(outputTileSize_)
 {
+    // Heights read for this provider are shared with other heightmap consumers of same tile size
+    if (filesCollection)
+        filesCollection->registerHeightsConsumer(outputTileSize, SqliteHeightmapTileProvider_P::Overlap, false);
 }
 
 OsmAnd::SqliteHeightmapTileProvider::~SqliteHeightmapTileProvider()
 {
+    if (filesCollection)
+        filesCollection->unregisterHeightsConsumer(outputTileSize, SqliteHeightmapTileProvider_P::Overlap, false);
 }
 
 OsmAnd::ZoomLevel OsmAnd::SqliteHeightmapTileProvider::getMinZoom() const
@@ -53,6 +61,21 @@ uint32_t OsmAnd::SqliteHeightmapTileProvider::getTileSize() const
     return outputTileSize;
 }
 
+size_t OsmAnd::SqliteHeightmapTileProvider::getCacheSize() const
+{
+    return _p->getCacheSize();
+}
+
+void OsmAnd::SqliteHeightmapTileProvider::setCacheSize(const size_t cacheSize)
+{
+    _p->setCacheSize(cacheSize);
+}
+
+void OsmAnd::SqliteHeightmapTileProvider::clearCache()
+{
+    _p->clearCache();
+}
+
 bool OsmAnd::SqliteHeightmapTileProvider::supportsNaturalObtainData() const
 {
     return true;
@@ -17,7 +17,8 @@
 
 OsmAnd::SqliteHeightmapTileProvider_P::SqliteHeightmapTileProvider_P(
     SqliteHeightmapTileProvider* const owner_)
-    : owner(owner_)
+    : _heightmapTilesCache(SqliteHeightmapTileProvider::DefaultCacheSize)
+    , owner(owner_)
 {
 }
 
@@ -57,6 +58,59 @@ OsmAnd::ZoomLevel OsmAnd::SqliteHeightmapTileProvider_P::getMaxZoom() const
         return std::min(maxZoomDatabase, maxZoomTiff);
 }
 
+size_t OsmAnd::SqliteHeightmapTileProvider_P::getCacheSize() const
+{
+    return _heightmapTilesCache.getMaxSize();
+}
+
+void OsmAnd::SqliteHeightmapTileProvider_P::setCacheSize(const size_t cacheSize)
+{
+    _heightmapTilesCache.setMaxSize(cacheSize);
+}
+
+void OsmAnd::SqliteHeightmapTileProvider_P::clearCache()
+{
+    _heightmapTilesCache.clear();
+}
+
+OsmAnd::HeightmapTilesCache::Key OsmAnd::SqliteHeightmapTileProvider_P::getHeightmapTilesCacheKey(
+    const TileId tileId,
+    const ZoomLevel zoom) const
+{
+    HeightmapTilesCache::Key key;
+    key.tileId = tileId;
+    key.zoom = zoom;
+    key.size = owner->outputTileSize;
+    key.overlap = Overlap;
+    return key;
+}
+
+void OsmAnd::SqliteHeightmapTileProvider_P::storeInCache(
+    const HeightmapTilesCache::Key& key,
+    const float* const pHeights)
+{
+    const auto heights = std::make_shared<QVector<float>>(key.size*key.size);
+    memcpy(heights->data(), pHeights, key.size*key.size*sizeof(float));
+    _heightmapTilesCache.store(key, heights);
+}
+
+std::shared_ptr<OsmAnd::IMapDataProvider::Data> OsmAnd::SqliteHeightmapTileProvider_P::createData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const uint32_t size,
+    const HeightmapTilesCache::Heights& heights)
+{
+    // Data owns its buffer, so cached heights are copied
+    const auto pBuffer = new float[size*size];
+    memcpy(pBuffer, heights->constData(), size*size*sizeof(float));
+    return std::make_shared<IMapElevationDataProvider::Data>(
+        tileId,
+        zoom,
+        sizeof(float)*size,
+        size,
+        pBuffer);
+}
+
 bool OsmAnd::SqliteHeightmapTileProvider_P::obtainData(
     const IMapDataProvider::Request& request_,
     std::shared_ptr<IMapDataProvider::Data>& outData,
@@ -67,11 +121,31 @@ bool OsmAnd::SqliteHeightmapTileProvider_P::obtainData(
     if (pOutMetric)
         pOutMetric->reset();
 
+    // Decoded tile may be cached, or it can be downsampled from cached children
+    const auto cacheKey = getHeightmapTilesCacheKey(request.tileId, request.zoom);
+    auto heights = _heightmapTilesCache.obtain(cacheKey);
+    if (!heights)
+    {
+        heights = _heightmapTilesCache.deriveFromChildren(cacheKey);
+        if (heights)
+            _heightmapTilesCache.store(cacheKey, heights);
+    }
+    if (heights)
+    {
+        outData = createData(request.tileId, request.zoom, owner->outputTileSize, heights);
+        return true;
+    }
+
+    // Tile may be derived from ancestor only if no source has this zoom level for the area, since otherwise
+    // absence of data means that tile is empty
+    auto zoomLevelIsMissing = true;
     QByteArray data;
     if (owner->sourcesCollection)
     {
         for (const auto& database : owner->sourcesCollection->getTileSqliteDatabases(request.tileId, request.zoom))
         {
+            if (request.zoom >= database->getMinZoom() && request.zoom <= database->getMaxZoom())
+                zoomLevelIsMissing = false;
             if (database->obtainTileData(request.tileId, request.zoom, data) && !data.isEmpty())
             {
                 break;
@@ -80,12 +154,19 @@ bool OsmAnd::SqliteHeightmapTileProvider_P::obtainData(
     }
     if (data.isEmpty() && owner->filesCollection)
     {
+        if (request.zoom >= owner->filesCollection->getMinZoom()
+            && request.zoom <= owner->filesCollection->getMaxZoom(owner->outputTileSize))
+        {
+            zoomLevelIsMissing = false;
+        }
+
         // There was no data in db, so try to get it from GeoTIFF file
         const auto pBuffer = new float[owner->outputTileSize*owner->outputTileSize];
         const auto result = owner->filesCollection->getGeoTiffData(request.tileId, request.zoom,
-            owner->outputTileSize, 3, 1, false, pBuffer);
+            owner->outputTileSize, Overlap, 1, false, pBuffer);
         if (result == GeoTiffCollection::CallResult::Completed)
         {
+            storeInCache(cacheKey, pBuffer);
             outData = std::make_shared<IMapElevationDataProvider::Data>(
                 request.tileId,
                 request.zoom,
@@ -101,6 +182,15 @@ bool OsmAnd::SqliteHeightmapTileProvider_P::obtainData(
     }
     if (data.isEmpty())
     {
+        // Sources lack this zoom level for the area, while its ancestor was obtained. Derived tile isn't cached,
+        // so that it never hides real data of this tile.
+        heights = zoomLevelIsMissing ? _heightmapTilesCache.deriveFromAncestor(cacheKey) : nullptr;
+        if (heights)
+        {
+            outData = createData(request.tileId, request.zoom, owner->outputTileSize, heights);
+            return true;
+        }
+
         // There was no data at all, to avoid further requests, mark this tile as empty
         outData.reset();
         return true;
@@ -192,6 +282,7 @@ bool OsmAnd::SqliteHeightmapTileProvider_P::obtainData(
         return false;
     }
 
+    storeInCache(cacheKey, pBuffer);
     outData = std::make_shared<IMapElevationDataProvider::Data>(
         request.tileId,
         request.zoom,
@@ -10,6 +10,7 @@
 #include "PrivateImplementation.h"
 #include "IMapElevationDataProvider.h"
 #include "SqliteHeightmapTileProvider.h"
+#include "HeightmapTilesCache.h"
 
 namespace OsmAnd
 {
@@ -17,9 +18,23 @@ namespace OsmAnd
     {
         Q_DISABLE_COPY_AND_MOVE(SqliteHeightmapTileProvider_P);
     private:
+        HeightmapTilesCache _heightmapTilesCache;
+
+        HeightmapTilesCache::Key getHeightmapTilesCacheKey(const TileId tileId, const ZoomLevel zoom) const;
+        void storeInCache(const HeightmapTilesCache::Key& key, const float* const pHeights);
+        static std::shared_ptr<IMapDataProvider::Data> createData(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            const uint32_t size,
+            const HeightmapTilesCache::Heights& heights);
     protected:
         SqliteHeightmapTileProvider_P(SqliteHeightmapTileProvider* const owner);
     public:
+        // Extra pixels on both edges of heightmap tiles
+        enum {
+            Overlap = 3,
+        };
+
         ~SqliteHeightmapTileProvider_P();
 
         ImplementationInterface<SqliteHeightmapTileProvider> owner;
@@ -27,6 +42,10 @@ namespace OsmAnd
         ZoomLevel getMinZoom() const;
         ZoomLevel getMaxZoom() const;
 
+        size_t getCacheSize() const;
+        void setCacheSize(const size_t cacheSize);
+        void clearCache();
+
         virtual bool obtainData(
             const IMapDataProvider::Request& request,
             std::shared_ptr<IMapDataProvider::Data>& outData,
@@ -45,6 +45,22 @@ void OsmAnd::WeatherTileResourceProvider::obtainValueAsync(
     _p->obtainValueAsync(request, callback, collectMetric);
 }
 
+void OsmAnd::WeatherTileResourceProvider::obtainValues(
+    const ValuesRequest& request,
+    const ObtainValuesAsyncCallback callback,
+    const bool collectMetric /*= false*/)
+{
+    _p->obtainValues(request, callback, collectMetric);
+}
+
+void OsmAnd::WeatherTileResourceProvider::obtainValuesAsync(
+    const ValuesRequest& request,
+    const ObtainValuesAsyncCallback callback,
+    const bool collectMetric /*= false*/)
+{
+    _p->obtainValuesAsync(request, callback, collectMetric);
+}
+
 void OsmAnd::WeatherTileResourceProvider::obtainData(
     const TileRequest& request,
     const ObtainTileDataAsyncCallback callback,
@@ -133,6 +149,26 @@ int OsmAnd::WeatherTileResourceProvider::getMaxMissingDataUnderZoomShift(const W
         return 0;
 }
 
+void OsmAnd::WeatherTileResourceProvider::prefetch(const PrefetchRequest& request)
+{
+    _p->prefetch(request);
+}
+
+void OsmAnd::WeatherTileResourceProvider::cancelPrefetch()
+{
+    _p->cancelPrefetch();
+}
+
+OsmAnd::WeatherTileResourceProvider::PrefetchStatistics OsmAnd::WeatherTileResourceProvider::getPrefetchStatistics() const
+{
+    return _p->getPrefetchStatistics();
+}
+
+void OsmAnd::WeatherTileResourceProvider::resetPrefetchStatistics()
+{
+    _p->resetPrefetchStatistics();
+}
+
 void OsmAnd::WeatherTileResourceProvider::setBandSettings(const QHash<BandIndex, std::shared_ptr<const GeoBandSettings>>& bandSettings)
 {
     return _p->setBandSettings(bandSettings);
@@ -239,6 +275,45 @@ std::shared_ptr<OsmAnd::WeatherTileResourceProvider::ValueRequest> OsmAnd::Weath
     return std::shared_ptr<ValueRequest>(new ValueRequest(*this));
 }
 
+OsmAnd::WeatherTileResourceProvider::ValuesRequest::ValuesRequest()
+    : localData(false)
+{
+}
+
+OsmAnd::WeatherTileResourceProvider::ValuesRequest::ValuesRequest(const ValuesRequest& that)
+{
+    copy(*this, that);
+}
+
+OsmAnd::WeatherTileResourceProvider::ValuesRequest::~ValuesRequest()
+{
+}
+
+void OsmAnd::WeatherTileResourceProvider::ValuesRequest::copy(ValuesRequest& dst, const ValuesRequest& src)
+{
+    dst.clientId = src.clientId;
+    dst.dateTimes = src.dateTimes;
+    dst.points31 = src.points31;
+    dst.localData = src.localData;
+    dst.queryController = src.queryController;
+}
+
+std::shared_ptr<OsmAnd::WeatherTileResourceProvider::ValuesRequest> OsmAnd::WeatherTileResourceProvider::ValuesRequest::clone() const
+{
+    return std::shared_ptr<ValuesRequest>(new ValuesRequest(*this));
+}
+
+OsmAnd::WeatherTileResourceProvider::ValuesSample::ValuesSample()
+    : dateTime(0)
+    , point31(0, 0)
+    , available(false)
+{
+}
+
+OsmAnd::WeatherTileResourceProvider::ValuesSample::~ValuesSample()
+{
+}
+
 OsmAnd::WeatherTileResourceProvider::TileRequest::TileRequest()
     : dateTime(0)
     , weatherType(WeatherType::Raster)
@@ -277,6 +352,62 @@ std::shared_ptr<OsmAnd::WeatherTileResourceProvider::TileRequest> OsmAnd::Weathe
     return std::shared_ptr<TileRequest>(new TileRequest(*this));
 }
 
+OsmAnd::WeatherTileResourceProvider::PrefetchRequest::PrefetchRequest()
+    : dateTime(0)
+    , timeStep(60 * 60 * 1000)
+    , stepsForward(2)
+    , stepsBackward(1)
+    , zoom(InvalidZoomLevel)
+    , localData(false)
+{
+}
+
+OsmAnd::WeatherTileResourceProvider::PrefetchRequest::PrefetchRequest(const PrefetchRequest& that)
+{
+    copy(*this, that);
+}
+
+OsmAnd::WeatherTileResourceProvider::PrefetchRequest::~PrefetchRequest()
+{
+}
+
+void OsmAnd::WeatherTileResourceProvider::PrefetchRequest::copy(PrefetchRequest& dst, const PrefetchRequest& src)
+{
+    dst.dateTime = src.dateTime;
+    dst.timeStep = src.timeStep;
+    dst.stepsForward = src.stepsForward;
+    dst.stepsBackward = src.stepsBackward;
+    dst.tileIds = src.tileIds;
+    dst.zoom = src.zoom;
+    dst.rasterBands = src.rasterBands;
+    dst.contourBands = src.contourBands;
+    dst.localData = src.localData;
+}
+
+std::shared_ptr<OsmAnd::WeatherTileResourceProvider::PrefetchRequest> OsmAnd::WeatherTileResourceProvider::PrefetchRequest::clone() const
+{
+    return std::shared_ptr<PrefetchRequest>(new PrefetchRequest(*this));
+}
+
+OsmAnd::WeatherTileResourceProvider::PrefetchStatistics::PrefetchStatistics()
+    : scheduledTiles(0)
+    , preparedTiles(0)
+    , cancelledTiles(0)
+    , failedTiles(0)
+    , skippedTiles(0)
+    , hits(0)
+{
+}
+
+OsmAnd::WeatherTileResourceProvider::PrefetchStatistics::~PrefetchStatistics()
+{
+}
+
+double OsmAnd::WeatherTileResourceProvider::PrefetchStatistics::getHitRate() const
+{
+    return preparedTiles > 0 ? static_cast<double>(hits) / preparedTiles : 0.0;
+}
+
 OsmAnd::WeatherTileResourceProvider::DownloadGeoTileRequest::DownloadGeoTileRequest()
     : dateTime(0)
     , forceDownload(false)
@@ -9,9 +9,10 @@
 #include "GlobalMercator.h"
 #include "ArchiveReader.h"
 #include "FunctorQueryController.h"
-#include "GeoTileEvaluator.h"
 
 static const QString WEATHER_TILES_URL_PREFIX = QStringLiteral("https://osmand.net/weather/gfs/tiff/");
+static const int MAX_PREFETCHED_TILES = 4096;
+static const int MAX_PREFETCHED_CONTOUR_TILES = 256;
 
 OsmAnd::WeatherTileResourceProvider_P::WeatherTileResourceProvider_P(
     WeatherTileResourceProvider* const owner_,
@@ -25,11 +26,13 @@ OsmAnd::WeatherTileResourceProvider_P::WeatherTileResourceProvider_P(
     , _obtainValueThreadPool(new QThreadPool())
     , _obtainCacheDataThreadPool(new QThreadPool())
     , _obtainOnlineDataThreadPool(new QThreadPool())
+    , _prefetchThreadPool(new QThreadPool())
     , _bandSettings(bandSettings_)
     , _priority(0)
     , _obtainValuePriority(0)
     , _lastRequestedZoom(ZoomLevel::InvalidZoomLevel)
     , _requestVersion(0)
+    , _prefetchVersion(0)
     , webClient(webClient_)
     , localCachePath(localCachePath_)
     , projResourcesPath(projResourcesPath_)
@@ -39,6 +42,13 @@ OsmAnd::WeatherTileResourceProvider_P::WeatherTileResourceProvider_P(
     _obtainValueThreadPool->setMaxThreadCount(1);
     _obtainCacheDataThreadPool->setMaxThreadCount(1);
     _obtainOnlineDataThreadPool->setMaxThreadCount(4);
+    // Prefetch shouldn't compete with requested tiles
+    _prefetchThreadPool->setMaxThreadCount(1);
+
+    // Cost of decoded geo tile is measured in kilobytes
+    _geoTileGrids.setMaxCost(32 * 1024);
+    _prefetchedTiles.setMaxCost(MAX_PREFETCHED_TILES);
+    _prefetchedContours.setMaxCost(MAX_PREFETCHED_CONTOUR_TILES);
     
     auto geoDbCachePath = localCachePath
     + QDir::separator()
@@ -68,6 +78,8 @@ OsmAnd::WeatherTileResourceProvider_P::~WeatherTileResourceProvider_P()
     delete _obtainCacheDataThreadPool;
     _obtainOnlineDataThreadPool->clear();
     delete _obtainOnlineDataThreadPool;
+    _prefetchThreadPool->clear();
+    delete _prefetchThreadPool;
 }
 
 int OsmAnd::WeatherTileResourceProvider_P::getAndIncreasePriority()
@@ -304,6 +316,64 @@ int64_t OsmAnd::WeatherTileResourceProvider_P::obtainGeoTile(
     return outData.isEmpty() ? -1 : obtainedTime;
 }
 
+std::shared_ptr<const OsmAnd::GeoTileGrid> OsmAnd::WeatherTileResourceProvider_P::obtainGeoTileGrid(
+    const TileId geoTileId,
+    const int64_t dateTime,
+    const bool localData /*= false*/,
+    std::shared_ptr<const IQueryController> queryController /*= nullptr*/)
+{
+    const auto geoTileZoom = WeatherTileResourceProvider::getGeoTileZoom();
+    const GeoTileGridKey key(geoTileId.id, dateTime);
+
+    CachedGeoTileGrid cachedGrid;
+    {
+        QMutexLocker scopedLocker(&_geoTileGridsMutex);
+
+        if (const auto pCachedGrid = _geoTileGrids.object(key))
+            cachedGrid = *pCachedGrid;
+    }
+
+    // Local geo tile doesn't need to be read, if it's not newer than decoded one
+    if (cachedGrid.grid && localData)
+    {
+        int64_t time = 0;
+        if (obtainGeoTileTime(geoTileId, geoTileZoom, dateTime, time) && time == cachedGrid.time)
+            return cachedGrid.grid;
+    }
+
+    QByteArray geoTileData;
+    const auto time = obtainGeoTile(geoTileId, geoTileZoom, dateTime, geoTileData, false, localData, queryController);
+    if (time <= 0)
+        return nullptr;
+    if (cachedGrid.grid && time == cachedGrid.time)
+        return cachedGrid.grid;
+
+    {
+        QWriteLocker scopedLocker(&_lock);
+
+        _currentEvaluatingTileIds << geoTileId;
+    }
+    const auto grid = GeoTileGrid::decode(geoTileId, geoTileData);
+    {
+        QWriteLocker scopedLocker(&_lock);
+
+        _currentEvaluatingTileIds.removeOne(geoTileId);
+    }
+    if (!grid)
+        return nullptr;
+
+    {
+        QMutexLocker scopedLocker(&_geoTileGridsMutex);
+
+        const auto pCachedGrid = new CachedGeoTileGrid();
+        pCachedGrid->grid = grid;
+        pCachedGrid->time = time;
+        _geoTileGrids.insert(key, pCachedGrid, std::max(1, static_cast<int>(grid->getMemorySize() / 1024)));
+    }
+
+    return grid;
+}
+
 void OsmAnd::WeatherTileResourceProvider_P::lockGeoTile(const TileId tileId, const ZoomLevel zoom)
 {
     QMutexLocker scopedLocker(&_geoTilesInProcessMutex);
@@ -323,40 +393,72 @@ void OsmAnd::WeatherTileResourceProvider_P::unlockGeoTile(const TileId tileId, c
     _waitUntilAnyGeoTileIsProcessed.wakeAll();
 }
 
-void OsmAnd::WeatherTileResourceProvider_P::lockRasterTile(const TileId tileId, const ZoomLevel zoom)
+void OsmAnd::WeatherTileResourceProvider_P::lockRasterTile(
+    const TileId tileId, const ZoomLevel zoom, const int64_t dateTime)
 {
     QMutexLocker scopedLocker(&_rasterTilesInProcessMutex);
 
-    while(_rasterTilesInProcess[zoom].contains(tileId))
+    const TileInProcessKey key(tileId.id, dateTime);
+    while(_rasterTilesInProcess[zoom].contains(key))
         _waitUntilAnyRasterTileIsProcessed.wait(&_rasterTilesInProcessMutex);
 
-    _rasterTilesInProcess[zoom].insert(tileId);
+    _rasterTilesInProcess[zoom].insert(key);
+}
+
+bool OsmAnd::WeatherTileResourceProvider_P::tryLockRasterTile(
+    const TileId tileId, const ZoomLevel zoom, const int64_t dateTime)
+{
+    QMutexLocker scopedLocker(&_rasterTilesInProcessMutex);
+
+    const TileInProcessKey key(tileId.id, dateTime);
+    if (_rasterTilesInProcess[zoom].contains(key))
+        return false;
+
+    _rasterTilesInProcess[zoom].insert(key);
+    return true;
 }
 
-void OsmAnd::WeatherTileResourceProvider_P::unlockRasterTile(const TileId tileId, const ZoomLevel zoom)
+void OsmAnd::WeatherTileResourceProvider_P::unlockRasterTile(
+    const TileId tileId, const ZoomLevel zoom, const int64_t dateTime)
 {
     QMutexLocker scopedLocker(&_rasterTilesInProcessMutex);
 
-    _rasterTilesInProcess[zoom].remove(tileId);
+    _rasterTilesInProcess[zoom].remove(TileInProcessKey(tileId.id, dateTime));
 
     _waitUntilAnyRasterTileIsProcessed.wakeAll();
 }
 
-void OsmAnd::WeatherTileResourceProvider_P::lockContourTile(const TileId tileId, const ZoomLevel zoom)
+void OsmAnd::WeatherTileResourceProvider_P::lockContourTile(
+    const TileId tileId, const ZoomLevel zoom, const int64_t dateTime)
 {
     QMutexLocker scopedLocker(&_contourTilesInProcessMutex);
 
-    while(_contourTilesInProcess[zoom].contains(tileId))
+    const TileInProcessKey key(tileId.id, dateTime);
+    while(_contourTilesInProcess[zoom].contains(key))
         _waitUntilAnyContourTileIsProcessed.wait(&_contourTilesInProcessMutex);
 
-    _contourTilesInProcess[zoom].insert(tileId);
+    _contourTilesInProcess[zoom].insert(key);
 }
 
-void OsmAnd::WeatherTileResourceProvider_P::unlockContourTile(const TileId tileId, const ZoomLevel zoom)
+bool OsmAnd::WeatherTileResourceProvider_P::tryLockContourTile(
+    const TileId tileId, const ZoomLevel zoom, const int64_t dateTime)
 {
     QMutexLocker scopedLocker(&_contourTilesInProcessMutex);
 
-    _contourTilesInProcess[zoom].remove(tileId);
+    const TileInProcessKey key(tileId.id, dateTime);
+    if (_contourTilesInProcess[zoom].contains(key))
+        return false;
+
+    _contourTilesInProcess[zoom].insert(key);
+    return true;
+}
+
+void OsmAnd::WeatherTileResourceProvider_P::unlockContourTile(
+    const TileId tileId, const ZoomLevel zoom, const int64_t dateTime)
+{
+    QMutexLocker scopedLocker(&_contourTilesInProcessMutex);
+
+    _contourTilesInProcess[zoom].remove(TileInProcessKey(tileId.id, dateTime));
 
     _waitUntilAnyContourTileIsProcessed.wakeAll();
 }
@@ -410,6 +512,30 @@ void OsmAnd::WeatherTileResourceProvider_P::obtainValueAsync(
     _obtainValueThreadPool->start(task, priority);
 }
 
+void OsmAnd::WeatherTileResourceProvider_P::obtainValues(
+    const WeatherTileResourceProvider::ValuesRequest& request,
+    const WeatherTileResourceProvider::ObtainValuesAsyncCallback callback,
+    const bool collectMetric /*= false*/)
+{
+    const auto requestClone = request.clone();
+    ObtainValuesTask *task = new ObtainValuesTask(shared_from_this(), requestClone, callback, collectMetric);
+    task->run();
+    delete task;
+}
+
+void OsmAnd::WeatherTileResourceProvider_P::obtainValuesAsync(
+    const WeatherTileResourceProvider::ValuesRequest& request,
+    const WeatherTileResourceProvider::ObtainValuesAsyncCallback callback,
+    const bool collectMetric /*= false*/)
+{
+    const auto requestClone = request.clone();
+    const ObtainValueRequestId requestId = request.clientId + QStringLiteral("_values");
+    const auto priority = getAndIncreaseObtainValuePriority(requestId);
+    ObtainValuesTask *task = new ObtainValuesTask(shared_from_this(), requestClone, callback, collectMetric);
+    task->setAutoDelete(true);
+    _obtainValueThreadPool->start(task, priority);
+}
+
 void OsmAnd::WeatherTileResourceProvider_P::obtainData(
     const WeatherTileResourceProvider::TileRequest& request,
     const WeatherTileResourceProvider::ObtainTileDataAsyncCallback callback,
@@ -441,6 +567,203 @@ void OsmAnd::WeatherTileResourceProvider_P::obtainDataAsync(
         _obtainOnlineDataThreadPool->start(task, getAndIncreasePriority());
 }
 
+void OsmAnd::WeatherTileResourceProvider_P::prefetch(const WeatherTileResourceProvider::PrefetchRequest& request)
+{
+    int prefetchVersion;
+    int requestVersion;
+    {
+        QWriteLocker scopedLocker(&_lock);
+
+        prefetchVersion = ++_prefetchVersion;
+        requestVersion = _requestVersion;
+    }
+    if (request.tileIds.isEmpty() || request.zoom == InvalidZoomLevel || request.timeStep <= 0)
+        return;
+
+    // Closest time steps go first, following ones before preceding ones
+    QList<int64_t> dateTimes;
+    for (int step = 1; step <= std::max(request.stepsForward, request.stepsBackward); step++)
+    {
+        if (step <= request.stepsForward)
+            dateTimes.push_back(request.dateTime + step * request.timeStep);
+        if (step <= request.stepsBackward)
+            dateTimes.push_back(request.dateTime - step * request.timeStep);
+    }
+
+    // Prefetch is cancelled by next prefetch, as well as by change of version of tile requests
+    const std::weak_ptr<WeatherTileResourceProvider_P> weakProvider = shared_from_this();
+    const auto prefetchQueryController = std::make_shared<FunctorQueryController>(
+        [weakProvider, prefetchVersion, requestVersion]
+        (const FunctorQueryController* const queryController) -> bool
+        {
+            const auto provider = weakProvider.lock();
+            return !provider
+                || provider->getCurrentPrefetchVersion() != prefetchVersion
+                || provider->getCurrentRequestVersion() != requestVersion;
+        });
+
+    int priority = 0;
+    for (const auto dateTime : constOf(dateTimes))
+    {
+        for (const auto& tileId : constOf(request.tileIds))
+        {
+            for (const auto weatherType : { WeatherType::Raster, WeatherType::Contour })
+            {
+                const auto& bands = weatherType == WeatherType::Raster ? request.rasterBands : request.contourBands;
+                if (bands.isEmpty())
+                    continue;
+
+                const PrefetchedTileKey key = { weatherType, tileId, request.zoom, dateTime };
+                {
+                    QMutexLocker scopedLocker(&_prefetchMutex);
+
+                    const auto pPrefetchedBands = _prefetchedTiles.object(key);
+                    if (pPrefetchedBands && *pPrefetchedBands == bands)
+                        continue;
+                    const auto pPrefetchedContours = _prefetchedContours.object(key);
+                    if (pPrefetchedContours && pPrefetchedContours->bands == bands)
+                        continue;
+                    _prefetchStatistics.scheduledTiles++;
+                }
+
+                const auto tileRequest = std::make_shared<WeatherTileResourceProvider::TileRequest>();
+                tileRequest->dateTime = dateTime;
+                tileRequest->weatherType = weatherType;
+                tileRequest->tileId = tileId;
+                tileRequest->zoom = request.zoom;
+                tileRequest->bands = bands;
+                tileRequest->localData = request.localData;
+                tileRequest->cacheOnly = false;
+                tileRequest->version = requestVersion;
+                tileRequest->queryController = prefetchQueryController;
+
+                const WeatherTileResourceProvider::ObtainTileDataAsyncCallback callback =
+                    [weakProvider, key, prefetchVersion, requestVersion, bands]
+                    (const bool requestSucceeded,
+                        const std::shared_ptr<WeatherTileResourceProvider::Data>& data,
+                        const std::shared_ptr<Metric>& metric)
+                    {
+                        const auto provider = weakProvider.lock();
+                        if (!provider)
+                            return;
+
+                        const auto cancelled = provider->getCurrentPrefetchVersion() != prefetchVersion
+                            || provider->getCurrentRequestVersion() != requestVersion;
+                        provider->onPrefetchedTile(key, cancelled, bands, requestSucceeded ? data : nullptr);
+                    };
+
+                const auto task = new ObtainTileTask(shared_from_this(), tileRequest, callback, false, true);
+                task->setAutoDelete(true);
+                // Tasks are taken in order they were scheduled, cancelled ones finish immediately
+                _prefetchThreadPool->start(task, --priority);
+            }
+        }
+    }
+}
+
+void OsmAnd::WeatherTileResourceProvider_P::cancelPrefetch()
+{
+    QWriteLocker scopedLocker(&_lock);
+
+    _prefetchVersion++;
+}
+
+int OsmAnd::WeatherTileResourceProvider_P::getCurrentPrefetchVersion() const
+{
+    QReadLocker scopedLocker(&_lock);
+
+    return _prefetchVersion;
+}
+
+void OsmAnd::WeatherTileResourceProvider_P::onPrefetchedTile(
+    const PrefetchedTileKey& key,
+    const bool cancelled,
+    const QList<BandIndex>& bands,
+    const std::shared_ptr<WeatherTileResourceProvider::Data>& data)
+{
+    // Contours are valid only until geo tile they were evaluated from is updated
+    int64_t geoTileTime = 0;
+    if (data && key.weatherType == WeatherType::Contour)
+    {
+        const auto geoTileZoom = WeatherTileResourceProvider::getGeoTileZoom();
+        const auto geoTileId = key.zoom > geoTileZoom
+            ? Utilities::getTileIdOverscaledByZoomShift(key.tileId, key.zoom - geoTileZoom)
+            : key.tileId;
+        obtainGeoTileTime(geoTileId, geoTileZoom, key.dateTime, geoTileTime);
+    }
+
+    QMutexLocker scopedLocker(&_prefetchMutex);
+
+    if (!data)
+    {
+        if (cancelled)
+            _prefetchStatistics.cancelledTiles++;
+        else
+            _prefetchStatistics.failedTiles++;
+        return;
+    }
+
+    _prefetchStatistics.preparedTiles++;
+    _prefetchedTiles.insert(key, new QList<BandIndex>(bands));
+
+    if (key.weatherType == WeatherType::Contour)
+    {
+        const auto pPrefetchedContours = new PrefetchedContours();
+        pPrefetchedContours->bands = bands;
+        pPrefetchedContours->geoTileTime = geoTileTime;
+        pPrefetchedContours->contourMap = data->contourMap;
+        _prefetchedContours.insert(key, pPrefetchedContours);
+    }
+}
+
+void OsmAnd::WeatherTileResourceProvider_P::onPrefetchedTileSkipped(const PrefetchedTileKey& key)
+{
+    LogPrintf(LogSeverityLevel::Debug,
+        "Skip prefetching of weather tile %dx%dx%d that is being prepared", key.tileId.x, key.tileId.y, key.zoom);
+
+    QMutexLocker scopedLocker(&_prefetchMutex);
+
+    _prefetchStatistics.skippedTiles++;
+}
+
+void OsmAnd::WeatherTileResourceProvider_P::registerPrefetchHit(const PrefetchedTileKey& key, const bool served)
+{
+    QMutexLocker scopedLocker(&_prefetchMutex);
+
+    if (_prefetchedTiles.remove(key) && served)
+        _prefetchStatistics.hits++;
+}
+
+bool OsmAnd::WeatherTileResourceProvider_P::obtainPrefetchedContours(
+    const PrefetchedTileKey& key,
+    const QList<BandIndex>& bands,
+    const int64_t geoTileTime,
+    QHash<BandIndex, QList<std::shared_ptr<GeoContour>>>& outContourMap)
+{
+    QMutexLocker scopedLocker(&_prefetchMutex);
+
+    const auto pPrefetchedContours = _prefetchedContours.object(key);
+    if (!pPrefetchedContours || pPrefetchedContours->bands != bands || pPrefetchedContours->geoTileTime != geoTileTime)
+        return false;
+
+    outContourMap = pPrefetchedContours->contourMap;
+    return true;
+}
+
+OsmAnd::WeatherTileResourceProvider::PrefetchStatistics OsmAnd::WeatherTileResourceProvider_P::getPrefetchStatistics() const
+{
+    QMutexLocker scopedLocker(&_prefetchMutex);
+
+    return _prefetchStatistics;
+}
+
+void OsmAnd::WeatherTileResourceProvider_P::resetPrefetchStatistics()
+{
+    QMutexLocker scopedLocker(&_prefetchMutex);
+
+    _prefetchStatistics = WeatherTileResourceProvider::PrefetchStatistics();
+}
+
 void OsmAnd::WeatherTileResourceProvider_P::downloadGeoTiles(
     const WeatherTileResourceProvider::DownloadGeoTileRequest& request,
     const WeatherTileResourceProvider::DownloadGeoTilesAsyncCallback callback,
@@ -829,39 +1152,11 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainValueTask::run()
         Utilities::getTileNumberY(geoTileZoom, latLon.latitude)
     );
 
-    QByteArray geoTileData;
-    if (provider->obtainGeoTile(
-        geoTileId, geoTileZoom, dateTime, geoTileData, false, localData, request->queryController) > 0)
+    const auto grid = provider->obtainGeoTileGrid(geoTileId, dateTime, localData, request->queryController);
+    if (grid && grid->evaluate(latLon, values))
     {
-        GeoTileEvaluator *evaluator = new GeoTileEvaluator(
-            geoTileId,
-            geoTileData,
-            zoom,
-            provider->projResourcesPath
-        );
-
-        {
-            QWriteLocker scopedLocker(&provider->_lock);
-
-            provider->_currentEvaluatingTileIds << geoTileId;
-        }
-
-        if (evaluator->evaluate(latLon, values))
-        {
-            provider->setCachedValues(point31, zoom, dateTimeStr, values);
-            callback(true, values, nullptr);
-        }
-        else
-        {
-            callback(false, QList<double>(), nullptr);
-        }
-        delete evaluator;
-
-        {
-            QWriteLocker scopedLocker(&provider->_lock);
-
-            provider->_currentEvaluatingTileIds.removeOne(geoTileId);
-        }
+        provider->setCachedValues(point31, zoom, dateTimeStr, values);
+        callback(true, values, nullptr);
     }
     else
     {
@@ -874,15 +1169,86 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainValueTask::setPriority(int pri
     _priority = priority;
 }
 
+OsmAnd::WeatherTileResourceProvider_P::ObtainValuesTask::ObtainValuesTask(
+    const std::shared_ptr<WeatherTileResourceProvider_P>& provider,
+    const std::shared_ptr<WeatherTileResourceProvider::ValuesRequest> request_,
+    const WeatherTileResourceProvider::ObtainValuesAsyncCallback callback_,
+    const bool collectMetric_ /*= false*/)
+    : _provider(provider)
+    , request(request_)
+    , callback(callback_)
+    , collectMetric(collectMetric_)
+{
+}
+
+OsmAnd::WeatherTileResourceProvider_P::ObtainValuesTask::~ObtainValuesTask()
+{
+}
+
+void OsmAnd::WeatherTileResourceProvider_P::ObtainValuesTask::run()
+{
+    const auto provider = _provider.lock();
+    if (!provider)
+        return;
+
+    const auto geoTileZoom = WeatherTileResourceProvider::getGeoTileZoom();
+    const auto& queryController = request->queryController;
+
+    QList<LatLon> latLons;
+    QList<TileId> geoTileIds;
+    for (const auto& point31 : constOf(request->points31))
+    {
+        const auto latLon = Utilities::convert31ToLatLon(point31);
+        latLons.push_back(latLon);
+        geoTileIds.push_back(TileId::fromXY(
+            Utilities::getTileNumberX(geoTileZoom, latLon.longitude),
+            Utilities::getTileNumberY(geoTileZoom, latLon.latitude)));
+    }
+
+    QList<WeatherTileResourceProvider::ValuesSample> samples;
+    for (const auto dateTime : constOf(request->dateTimes))
+    {
+        // Each geo tile is obtained once per date-time, even if it failed to be obtained
+        QHash<TileId, std::shared_ptr<const GeoTileGrid>> grids;
+        for (int pointIndex = 0; pointIndex < latLons.size(); pointIndex++)
+        {
+            if (queryController && queryController->isAborted())
+            {
+                callback(false, QList<WeatherTileResourceProvider::ValuesSample>(), nullptr);
+                return;
+            }
+
+            const auto& geoTileId = geoTileIds[pointIndex];
+            auto itGrid = grids.find(geoTileId);
+            if (itGrid == grids.end())
+            {
+                itGrid = grids.insert(geoTileId,
+                    provider->obtainGeoTileGrid(geoTileId, dateTime, request->localData, queryController));
+            }
+
+            WeatherTileResourceProvider::ValuesSample sample;
+            sample.dateTime = dateTime;
+            sample.point31 = request->points31[pointIndex];
+            if (const auto& grid = *itGrid)
+                sample.available = grid->evaluate(latLons[pointIndex], sample.values);
+            samples.push_back(sample);
+        }
+    }
+
+    callback(true, samples, nullptr);
+}
+
 OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::ObtainTileTask(
     const std::shared_ptr<WeatherTileResourceProvider_P>& provider,
     const std::shared_ptr<WeatherTileResourceProvider::TileRequest> request_,
     const WeatherTileResourceProvider::ObtainTileDataAsyncCallback callback_,
-    const bool collectMetric_ /*= false*/)
+    const bool collectMetric_ /*= false*/,
+    const bool prefetch_ /*= false*/)
     : _provider(provider)
     , request(request_)
     , callback(callback_)
     , collectMetric(collectMetric_)
+    , prefetch(prefetch_)
 {
 }
 
@@ -966,14 +1332,23 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainRasterTile()
     }
 
     if (!localData)
-        provider->lockRasterTile(tileId, zoom);
+    {
+        // Prefetch doesn't wait for tile that is being prepared by tile request, since it's not needed anymore
+        if (!prefetch)
+            provider->lockRasterTile(tileId, zoom, dateTime);
+        else if (!provider->tryLockRasterTile(tileId, zoom, dateTime))
+        {
+            provider->onPrefetchedTileSkipped({ WeatherType::Raster, tileId, zoom, dateTime });
+            return;
+        }
+    }
 
     ZoomLevel geoTileZoom = WeatherTileResourceProvider::getGeoTileZoom();
     TileId geoTileId;
     if (zoom < geoTileZoom)
     {
         if (!localData)
-            provider->unlockRasterTile(tileId, zoom);
+            provider->unlockRasterTile(tileId, zoom, dateTime);
 
         // Underzoom for geo tiles currently not supported
         LogPrintf(LogSeverityLevel::Error,
@@ -1019,6 +1394,12 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainRasterTile()
         }
     }
 
+    if (!prefetch)
+    {
+        const PrefetchedTileKey key = { WeatherType::Raster, tileId, zoom, dateTime };
+        provider->registerPrefetchHit(key, missingBands.empty());
+    }
+
     if (missingBands.empty() && localData)
     {
         auto image = createTileImage(images, bands);
@@ -1050,7 +1431,7 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainRasterTile()
     if (geoTileTime <= 0)
     {
         if (!localData)
-            provider->unlockRasterTile(tileId, zoom);
+            provider->unlockRasterTile(tileId, zoom, dateTime);
 
         if (!cacheOnly)
         {
@@ -1063,7 +1444,7 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainRasterTile()
     if (request->queryController && request->queryController->isAborted())
     {
         if (!localData)
-            provider->unlockRasterTile(tileId, zoom);
+            provider->unlockRasterTile(tileId, zoom, dateTime);
 
         LogPrintf(LogSeverityLevel::Debug,
             "Stop creating tile image of weather tile %dx%dx%d.", tileId.x, tileId.y, zoom);
@@ -1074,7 +1455,7 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainRasterTile()
 
     if (missingBands.empty() && minRasterizedTime >= geoTileTime)
     {
-        provider->unlockRasterTile(tileId, zoom);
+        provider->unlockRasterTile(tileId, zoom, dateTime);
 
         auto image = createTileImage(images, bands);
         if (image)
@@ -1123,7 +1504,7 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainRasterTile()
     if (request->queryController && request->queryController->isAborted())
     {
         if (!localData)
-            provider->unlockRasterTile(tileId, zoom);
+            provider->unlockRasterTile(tileId, zoom, dateTime);
 
         LogPrintf(LogSeverityLevel::Debug,
             "Stop creating tile image of weather tile %dx%dx%d.", tileId.x, tileId.y, zoom);
@@ -1151,7 +1532,7 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainRasterTile()
     }
     
     if (!localData)
-        provider->unlockRasterTile(tileId, zoom);
+        provider->unlockRasterTile(tileId, zoom, dateTime);
     
     if (request->version != provider->getCurrentRequestVersion())
     {
@@ -1223,7 +1604,16 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainContourTile()
     }
     
     if (!localData)
-        provider->lockContourTile(tileId, zoom);
+    {
+        // Prefetch doesn't wait for tile that is being prepared by tile request, since it's not needed anymore
+        if (!prefetch)
+            provider->lockContourTile(tileId, zoom, dateTime);
+        else if (!provider->tryLockContourTile(tileId, zoom, dateTime))
+        {
+            provider->onPrefetchedTileSkipped({ WeatherType::Contour, tileId, zoom, dateTime });
+            return;
+        }
+    }
 
     QHash<BandIndex, QList<std::shared_ptr<GeoContour>>> contourMap;
                 
@@ -1233,7 +1623,7 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainContourTile()
     if (zoom < geoTileZoom)
     {
         if (!localData)
-            provider->unlockContourTile(tileId, zoom);
+            provider->unlockContourTile(tileId, zoom, dateTime);
 
         // Underzoom for geo tiles currently not supported
         LogPrintf(LogSeverityLevel::Error,
@@ -1250,11 +1640,37 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainContourTile()
     {
         geoTileId = tileId;
     }
+
+    if (!prefetch)
+    {
+        const PrefetchedTileKey key = { WeatherType::Contour, tileId, zoom, dateTime };
+        int64_t geoTileTime = 0;
+        const auto served = provider->obtainGeoTileTime(geoTileId, geoTileZoom, dateTime, geoTileTime)
+            && provider->obtainPrefetchedContours(key, bands, geoTileTime, contourMap);
+        provider->registerPrefetchHit(key, served);
+        if (served)
+        {
+            if (!localData)
+                provider->unlockContourTile(tileId, zoom, dateTime);
+
+            auto data = std::make_shared<OsmAnd::WeatherTileResourceProvider::Data>(
+                tileId,
+                cacheOnly ? InvalidZoomLevel : zoom,
+                AlphaChannelPresence::Present,
+                provider->densityFactor,
+                nullptr,
+                contourMap
+            );
+            callback(true, data, nullptr);
+            return;
+        }
+    }
+
     if (provider->obtainGeoTile(
         geoTileId, geoTileZoom, dateTime, geoTileData, false, localData, request->queryController) <= 0)
     {
         if (!localData)
-            provider->unlockContourTile(tileId, zoom);
+            provider->unlockContourTile(tileId, zoom, dateTime);
 
         if (!cacheOnly)
         {
@@ -1267,7 +1683,7 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainContourTile()
     if (request->queryController && request->queryController->isAborted())
     {
         if (!localData)
-            provider->unlockContourTile(tileId, zoom);
+            provider->unlockContourTile(tileId, zoom, dateTime);
 
         LogPrintf(LogSeverityLevel::Debug,
             "Stop creating weather contour tile %dx%dx%d.", tileId.x, tileId.y, zoom);
@@ -1299,7 +1715,7 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainContourTile()
     if (request->queryController && request->queryController->isAborted())
     {
         if (!localData)
-            provider->unlockContourTile(tileId, zoom);
+            provider->unlockContourTile(tileId, zoom, dateTime);
 
         LogPrintf(LogSeverityLevel::Debug,
             "Stop creating weather contour tile %dx%dx%d.", tileId.x, tileId.y, zoom);
@@ -1309,7 +1725,7 @@ void OsmAnd::WeatherTileResourceProvider_P::ObtainTileTask::obtainContourTile()
     }
     
     if (!localData)
-        provider->unlockContourTile(tileId, zoom);
+        provider->unlockContourTile(tileId, zoom, dateTime);
     
     if (evaluatedContours.empty())
     {
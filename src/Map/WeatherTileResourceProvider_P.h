@@ -6,6 +6,7 @@
 #include "QtExtensions.h"
 #include "ignore_warnings_on_external_includes.h"
 #include <QDir>
+#include <QCache>
 #include <QMutex>
 #include <QQueue>
 #include <QSet>
@@ -21,6 +22,7 @@
 #include "WeatherTileResourceProvider.h"
 #include "TileSqliteDatabase.h"
 #include "Nullable.h"
+#include "GeoTileGrid.h"
 
 namespace OsmAnd
 {
@@ -54,6 +56,27 @@ namespace OsmAnd
             void setPriority(int priority);
         };
         
+        class OSMAND_CORE_API ObtainValuesTask : public QRunnable
+        {
+            Q_DISABLE_COPY_AND_MOVE(ObtainValuesTask);
+        private:
+            const std::weak_ptr<WeatherTileResourceProvider_P> _provider;
+        protected:
+        public:
+            ObtainValuesTask(
+                 const std::shared_ptr<WeatherTileResourceProvider_P>& provider,
+                 const std::shared_ptr<WeatherTileResourceProvider::ValuesRequest> request,
+                 const WeatherTileResourceProvider::ObtainValuesAsyncCallback callback,
+                 const bool collectMetric = false);
+            virtual ~ObtainValuesTask();
+
+            const std::shared_ptr<WeatherTileResourceProvider::ValuesRequest> request;
+            const WeatherTileResourceProvider::ObtainValuesAsyncCallback callback;
+            const bool collectMetric;
+
+            virtual void run() Q_DECL_OVERRIDE;
+        };
+
         class OSMAND_CORE_API ObtainTileTask : public QRunnable
         {
             Q_DISABLE_COPY_AND_MOVE(ObtainTileTask);
@@ -73,12 +96,14 @@ namespace OsmAnd
                  const std::shared_ptr<WeatherTileResourceProvider_P>& provider,
                  const std::shared_ptr<WeatherTileResourceProvider::TileRequest> request,
                  const WeatherTileResourceProvider::ObtainTileDataAsyncCallback callback,
-                 const bool collectMetric = false);
+                 const bool collectMetric = false,
+                 const bool prefetch = false);
             virtual ~ObtainTileTask();
             
             const std::shared_ptr<WeatherTileResourceProvider::TileRequest> request;
             const WeatherTileResourceProvider::ObtainTileDataAsyncCallback callback;
             const bool collectMetric;
+            const bool prefetch;
 
             virtual void run() Q_DECL_OVERRIDE;
         };
@@ -105,6 +130,21 @@ namespace OsmAnd
             virtual void run() Q_DECL_OVERRIDE;
         };
 
+    public:
+        struct PrefetchedTileKey
+        {
+            WeatherType weatherType;
+            TileId tileId;
+            ZoomLevel zoom;
+            int64_t dateTime;
+
+            inline bool operator==(const PrefetchedTileKey& that) const
+            {
+                return weatherType == that.weatherType && tileId.id == that.tileId.id && zoom == that.zoom
+                    && dateTime == that.dateTime;
+            }
+        };
+
     private:
         typedef QString ObtainValueRequestId;
 
@@ -112,6 +152,7 @@ namespace OsmAnd
         QThreadPool *_obtainValueThreadPool;
         QThreadPool *_obtainCacheDataThreadPool;
         QThreadPool *_obtainOnlineDataThreadPool;
+        QThreadPool *_prefetchThreadPool;
 
         QHash<BandIndex, std::shared_ptr<const GeoBandSettings>> _bandSettings;
 
@@ -127,6 +168,7 @@ namespace OsmAnd
         QList<BandIndex> _lastRequestedBands;
         bool _lastRequestedLocalData;
         int _requestVersion;
+        int _prefetchVersion;
 
         int getAndIncreasePriority();
         int getAndIncreaseObtainValuePriority(const ObtainValueRequestId& requestId);
@@ -138,8 +180,11 @@ namespace OsmAnd
         mutable QReadWriteLock _geoDbLock;
         std::shared_ptr<TileSqliteDatabase> _geoTilesDb;
 
+        // Raster and contour tiles are processed separately for each date-time
+        typedef QPair<uint64_t, int64_t> TileInProcessKey;
+
         mutable QMutex _rasterTilesInProcessMutex;
-        std::array< QSet< TileId >, ZoomLevelsCount > _rasterTilesInProcess;
+        std::array< QSet< TileInProcessKey >, ZoomLevelsCount > _rasterTilesInProcess;
         QWaitCondition _waitUntilAnyRasterTileIsProcessed;
 
         mutable QReadWriteLock _rasterDbLock;
@@ -147,7 +192,7 @@ namespace OsmAnd
         std::shared_ptr<OsmAnd::TileSqliteDatabase> createRasterTilesDatabase(BandIndex band);
 
         mutable QMutex _contourTilesInProcessMutex;
-        std::array< QSet< TileId >, ZoomLevelsCount > _contourTilesInProcess;
+        std::array< QSet< TileInProcessKey >, ZoomLevelsCount > _contourTilesInProcess;
         QWaitCondition _waitUntilAnyContourTileIsProcessed;
 
         mutable QReadWriteLock _cachedValuesLock;
@@ -156,6 +201,43 @@ namespace OsmAnd
         QString _cachedValuesDateTimeStr;
         QList<double> _cachedValues;
         
+        // Decoded geo tiles by tile and date-time, along with time of geo tile they were decoded from
+        struct CachedGeoTileGrid
+        {
+            std::shared_ptr<const GeoTileGrid> grid;
+            int64_t time;
+        };
+        typedef QPair<uint64_t, int64_t> GeoTileGridKey;
+        mutable QMutex _geoTileGridsMutex;
+        QCache<GeoTileGridKey, CachedGeoTileGrid> _geoTileGrids;
+
+        // Tiles prepared by prefetch (with their bands), that weren't requested yet. Least recently prepared
+        // ones are evicted first. Contour tiles aren't stored in database, so prefetched ones are kept in memory.
+        struct PrefetchedContours
+        {
+            QList<BandIndex> bands;
+            int64_t geoTileTime;
+            QHash<BandIndex, QList<std::shared_ptr<GeoContour>>> contourMap;
+        };
+        mutable QMutex _prefetchMutex;
+        QCache<PrefetchedTileKey, QList<BandIndex>> _prefetchedTiles;
+        QCache<PrefetchedTileKey, PrefetchedContours> _prefetchedContours;
+        WeatherTileResourceProvider::PrefetchStatistics _prefetchStatistics;
+
+        int getCurrentPrefetchVersion() const;
+        void onPrefetchedTile(
+            const PrefetchedTileKey& key,
+            const bool cancelled,
+            const QList<BandIndex>& bands,
+            const std::shared_ptr<WeatherTileResourceProvider::Data>& data);
+        void onPrefetchedTileSkipped(const PrefetchedTileKey& key);
+        void registerPrefetchHit(const PrefetchedTileKey& key, const bool served);
+        bool obtainPrefetchedContours(
+            const PrefetchedTileKey& key,
+            const QList<BandIndex>& bands,
+            const int64_t geoTileTime,
+            QHash<BandIndex, QList<std::shared_ptr<GeoContour>>>& outContourMap);
+
         bool getCachedValues(const PointI point31, const ZoomLevel zoom, const QString& dateTimeStr, QList<double>& values);
         void setCachedValues(const PointI point31, const ZoomLevel zoom, const QString& dateTimeStr, const QList<double>& values);
 
@@ -199,6 +281,16 @@ namespace OsmAnd
             const WeatherTileResourceProvider::ObtainValueAsyncCallback callback,
             const bool collectMetric = false);
         
+        void obtainValues(
+            const WeatherTileResourceProvider::ValuesRequest& request,
+            const WeatherTileResourceProvider::ObtainValuesAsyncCallback callback,
+            const bool collectMetric = false);
+
+        void obtainValuesAsync(
+            const WeatherTileResourceProvider::ValuesRequest& request,
+            const WeatherTileResourceProvider::ObtainValuesAsyncCallback callback,
+            const bool collectMetric = false);
+
         void obtainData(
             const WeatherTileResourceProvider::TileRequest& request,
             const WeatherTileResourceProvider::ObtainTileDataAsyncCallback callback,
@@ -209,6 +301,11 @@ namespace OsmAnd
             const WeatherTileResourceProvider::ObtainTileDataAsyncCallback callback,
             const bool collectMetric = false);
 
+        void prefetch(const WeatherTileResourceProvider::PrefetchRequest& request);
+        void cancelPrefetch();
+        WeatherTileResourceProvider::PrefetchStatistics getPrefetchStatistics() const;
+        void resetPrefetchStatistics();
+
         void downloadGeoTiles(
             const WeatherTileResourceProvider::DownloadGeoTileRequest& request,
             const WeatherTileResourceProvider::DownloadGeoTilesAsyncCallback callback,
@@ -246,12 +343,20 @@ namespace OsmAnd
             bool localData = false,
             std::shared_ptr<const IQueryController> queryController = nullptr);
 
+        std::shared_ptr<const GeoTileGrid> obtainGeoTileGrid(
+            const TileId geoTileId,
+            const int64_t dateTime,
+            const bool localData = false,
+            std::shared_ptr<const IQueryController> queryController = nullptr);
+
         void lockGeoTile(const TileId tileId, const ZoomLevel zoom);
         void unlockGeoTile(const TileId tileId, const ZoomLevel zoom);
-        void lockRasterTile(const TileId tileId, const ZoomLevel zoom);
-        void unlockRasterTile(const TileId tileId, const ZoomLevel zoom);
-        void lockContourTile(const TileId tileId, const ZoomLevel zoom);
-        void unlockContourTile(const TileId tileId, const ZoomLevel zoom);
+        void lockRasterTile(const TileId tileId, const ZoomLevel zoom, const int64_t dateTime);
+        bool tryLockRasterTile(const TileId tileId, const ZoomLevel zoom, const int64_t dateTime);
+        void unlockRasterTile(const TileId tileId, const ZoomLevel zoom, const int64_t dateTime);
+        void lockContourTile(const TileId tileId, const ZoomLevel zoom, const int64_t dateTime);
+        bool tryLockContourTile(const TileId tileId, const ZoomLevel zoom, const int64_t dateTime);
+        void unlockContourTile(const TileId tileId, const ZoomLevel zoom, const int64_t dateTime);
 
         std::shared_ptr<TileSqliteDatabase> getGeoTilesDatabase();
         std::shared_ptr<TileSqliteDatabase> getRasterTilesDatabase(BandIndex band);
@@ -278,6 +383,12 @@ namespace OsmAnd
 
     friend class OsmAnd::WeatherTileResourceProvider;
     };
+
+    inline uint qHash(const WeatherTileResourceProvider_P::PrefetchedTileKey& key, uint seed = 0)
+    {
+        return ::qHash(key.tileId.id, seed) ^ ::qHash(key.dateTime, seed)
+            ^ ::qHash((static_cast<int>(key.weatherType) << 8) | key.zoom, seed);
+    }
 }
 
 #endif // !defined(_OSMAND_CORE_WEATHER_TILE_RESOURCE_PROVIDER_P_H_)
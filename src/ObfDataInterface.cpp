@@ -7,6 +7,10 @@
 #include <QSet>
 #include <QHash>
 #include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include <QAtomicInt>
 #include "restore_internal_warnings.h"
 
 #include "Ref.h"
@@ -31,9 +35,17 @@
 #include "IQueryController.h"
 #include "FunctorQueryController.h"
 #include "QKeyValueIterator.h"
-
-OsmAnd::ObfDataInterface::ObfDataInterface(const QList< std::shared_ptr<const ObfReader> >& obfReaders_)
-    : obfReaders(obfReaders_)
+#include "QRunnableFunctor.h"
+#include "Utilities.h"
+#include "Logging.h"
+
+OsmAnd::ObfDataInterface::ObfDataInterface(
+    const QList< std::shared_ptr<const ObfReader> >& obfReaders_,
+    const ObtainReaderFunction obtainAdditionalReader /*= nullptr*/)
+    : _parallelReadingEnabled(false)
+    , _parallelReadingThreadPool(nullptr)
+    , _obtainAdditionalReader(obtainAdditionalReader)
+    , obfReaders(obfReaders_)
 {
 }
 
@@ -41,6 +53,150 @@ OsmAnd::ObfDataInterface::~ObfDataInterface()
 {
 }
 
+bool OsmAnd::ObfDataInterface::isParallelReadingEnabled() const
+{
+    return _parallelReadingEnabled;
+}
+
+void OsmAnd::ObfDataInterface::setParallelReadingEnabled(const bool enabled, QThreadPool* const threadPool /*= nullptr*/)
+{
+    _parallelReadingEnabled = enabled;
+    _parallelReadingThreadPool = threadPool;
+}
+
+bool OsmAnd::ObfDataInterface::shouldReadInParallel() const
+{
+    // Each reader can be used only by one thread at a time, so there's nothing to parallelize with single reader
+    return _parallelReadingEnabled && obfReaders.size() > 1;
+}
+
+QThreadPool* OsmAnd::ObfDataInterface::getDefaultParallelReadingThreadPool()
+{
+    static QThreadPool threadPool;
+    return &threadPool;
+}
+
+void OsmAnd::ObfDataInterface::runInParallel(const QVector<ParallelTask>& tasks) const
+{
+    if (tasks.isEmpty())
+        return;
+
+    struct State
+    {
+        QAtomicInt nextTaskIndex;
+        QAtomicInt pendingTasksCount;
+        QMutex mutex;
+        QWaitCondition allTasksDone;
+    };
+    const auto state = std::make_shared<State>();
+    state->pendingTasksCount.storeRelease(tasks.size());
+
+    const auto runTasks =
+        [state, tasks]
+        ()
+        {
+            for (;;)
+            {
+                const auto taskIndex = state->nextTaskIndex.fetchAndAddOrdered(1);
+                if (taskIndex >= tasks.size())
+                    break;
+
+                tasks[taskIndex]();
+
+                if (state->pendingTasksCount.fetchAndAddOrdered(-1) == 1)
+                {
+                    QMutexLocker scopedLocker(&state->mutex);
+                    state->allTasksDone.wakeAll();
+                }
+            }
+        };
+
+    const auto threadPool = _parallelReadingThreadPool
+        ? _parallelReadingThreadPool
+        : getDefaultParallelReadingThreadPool();
+    const auto helpersCount = qMin(tasks.size() - 1, threadPool->maxThreadCount());
+    for (auto helperIndex = 0; helperIndex < helpersCount; helperIndex++)
+    {
+        const auto runnable = new QRunnableFunctor(
+            [runTasks]
+            (const QRunnableFunctor* const runnable)
+            {
+                Q_UNUSED(runnable);
+                runTasks();
+            });
+        runnable->setAutoDelete(true);
+        threadPool->start(runnable);
+    }
+
+    // Calling thread executes tasks as well, so that progress is made even if pool is saturated
+    runTasks();
+
+    QMutexLocker scopedLocker(&state->mutex);
+    while (state->pendingTasksCount.loadAcquire() > 0)
+        state->allTasksDone.wait(&state->mutex);
+}
+
+void OsmAnd::ObfDataInterface::runOnReadersInParallel(const QVector<ReaderTask>& tasks) const
+{
+    // Readers that are not used by any task at the moment, by reader of this data interface they substitute
+    QMutex idleReadersMutex;
+    QWaitCondition idleReaderReleased;
+    QHash< const ObfReader*, QList< std::shared_ptr<const ObfReader> > > idleReaders;
+    for (const auto& task : constOf(tasks))
+    {
+        auto& readers = idleReaders[task.first.get()];
+        if (readers.isEmpty())
+            readers.push_back(task.first);
+    }
+
+    const auto leaseReader =
+        [this, &idleReadersMutex, &idleReaderReleased, &idleReaders]
+        (const std::shared_ptr<const ObfReader>& obfReader) -> std::shared_ptr<const ObfReader>
+        {
+            {
+                QMutexLocker scopedLocker(&idleReadersMutex);
+                auto& readers = idleReaders[obfReader.get()];
+                if (!readers.isEmpty())
+                    return readers.takeLast();
+            }
+
+            // All readers of the file are busy, so one more is obtained from source of readers (or opened).
+            // Readers that are not backed by a file can't be reopened, so task has to wait for one to be released.
+            if (obfReader->obfFile)
+            {
+                const auto additionalReader = _obtainAdditionalReader
+                    ? _obtainAdditionalReader(obfReader->obfFile)
+                    : std::shared_ptr<const ObfReader>(new ObfReader(obfReader->obfFile));
+                if (additionalReader && additionalReader->isOpened() && additionalReader->obtainInfo())
+                    return additionalReader;
+            }
+
+            QMutexLocker scopedLocker(&idleReadersMutex);
+            auto& readers = idleReaders[obfReader.get()];
+            while (readers.isEmpty())
+                idleReaderReleased.wait(&idleReadersMutex);
+            return readers.takeLast();
+        };
+
+    QVector<ParallelTask> parallelTasks;
+    parallelTasks.reserve(tasks.size());
+    for (const auto& task : constOf(tasks))
+    {
+        parallelTasks.push_back(
+            [task, &leaseReader, &idleReadersMutex, &idleReaderReleased, &idleReaders]
+            ()
+            {
+                const auto obfReader = leaseReader(task.first);
+                task.second(obfReader);
+
+                QMutexLocker scopedLocker(&idleReadersMutex);
+                idleReaders[task.first.get()].push_back(obfReader);
+                idleReaderReleased.wakeAll();
+            });
+    }
+    runInParallel(parallelTasks);
+}
+
 bool OsmAnd::ObfDataInterface::loadObfFiles(
     QList< std::shared_ptr<const ObfFile> >* outFiles /*= nullptr*/,
     const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/)
@@ -72,6 +228,21 @@ bool OsmAnd::ObfDataInterface::loadBinaryMapObjects(
     ObfMapSectionReader_Metrics::Metric_loadMapObjects* const metric /*= nullptr*/,
     bool coastlineOnly /*= false*/)
 {
+    // Metric is not designed to be updated concurrently
+    if (shouldReadInParallel() && !metric)
+    {
+        return loadBinaryMapObjectsInParallel(
+            resultOut,
+            outSurfaceType,
+            zoom,
+            bbox31,
+            filterById,
+            cache,
+            outReferencedCacheEntries,
+            queryController,
+            coastlineOnly);
+    }
+
     auto mergedSurfaceType = MapSurfaceType::Undefined;
     std::shared_ptr<const ObfReader> basemapReader;
 
@@ -189,6 +360,176 @@ bool OsmAnd::ObfDataInterface::loadBinaryMapObjects(
     return true;
 }
 
+bool OsmAnd::ObfDataInterface::loadBinaryMapObjectsInParallel(
+    QList< std::shared_ptr<const OsmAnd::BinaryMapObject> >* resultOut,
+    MapSurfaceType* outSurfaceType,
+    const ZoomLevel zoom,
+    const AreaI* const bbox31,
+    const ObfMapSectionReader::FilterByIdFunction filterById,
+    ObfMapSectionReader::DataBlocksCache* cache,
+    QList< std::shared_ptr<const ObfMapSectionReader::DataBlock> >* outReferencedCacheEntries,
+    const std::shared_ptr<const IQueryController>& queryController,
+    bool coastlineOnly)
+{
+    struct Job
+    {
+        std::shared_ptr<const ObfReader> obfReader;
+        ZoomLevel zoom;
+        const AreaI* pBbox31;
+        bool coastlineOnly;
+        bool isBasemap;
+
+        QList< std::shared_ptr<const BinaryMapObject> > mapObjects;
+        QList< std::shared_ptr<const ObfMapSectionReader::DataBlock> > referencedCacheEntries;
+        MapSurfaceType surfaceType;
+    };
+    std::vector<Job> jobs;
+    jobs.reserve(obfReaders.size() + 1);
+
+    // Same basemap selection as in sequential mode
+    std::shared_ptr<const ObfReader> basemapReader;
+    for (const auto& obfReader : constOf(obfReaders))
+    {
+        const auto& obfInfo = obfReader->obtainInfo();
+        if (obfInfo->isBasemapWithCoastlines)
+        {
+            if (basemapReader)
+            {
+                LogPrintf(LogSeverityLevel::Warning, "More than 1 basemap available");
+                continue;
+            }
+            basemapReader = obfReader;
+
+            if (zoom > static_cast<ZoomLevel>(ObfMapSectionLevel::MaxBasemapZoomLevel))
+                continue;
+        }
+
+        Job job;
+        job.obfReader = obfReader;
+        job.zoom = zoom;
+        job.pBbox31 = bbox31;
+        job.coastlineOnly = coastlineOnly;
+        job.isBasemap = false;
+        job.surfaceType = MapSurfaceType::Undefined;
+        jobs.push_back(qMove(job));
+    }
+
+    // Basemap reader was skipped above in this case, so it's safe to use it in separate job
+    AreaI basemapBBox31;
+    if (basemapReader && zoom > static_cast<ZoomLevel>(ObfMapSectionLevel::MaxBasemapZoomLevel) && !coastlineOnly)
+    {
+        Job job;
+        job.obfReader = basemapReader;
+        job.zoom = static_cast<ZoomLevel>(ObfMapSectionLevel::MaxBasemapZoomLevel);
+        job.pBbox31 = nullptr;
+        if (bbox31)
+        {
+            basemapBBox31 = Utilities::roundBoundingBox31(
+                *bbox31,
+                static_cast<ZoomLevel>(ObfMapSectionLevel::MaxBasemapZoomLevel));
+            job.pBbox31 = &basemapBBox31;
+        }
+        job.coastlineOnly = false;
+        job.isBasemap = true;
+        job.surfaceType = MapSurfaceType::Undefined;
+        jobs.push_back(qMove(job));
+    }
+
+    QMutex callbacksMutex;
+    ObfMapSectionReader::FilterByIdFunction serializedFilterById;
+    if (filterById)
+    {
+        serializedFilterById =
+            [filterById, &callbacksMutex]
+            (const std::shared_ptr<const ObfMapSectionInfo>& section,
+                const ObfMapSectionReader::DataBlockId& blockId,
+                const ObfObjectId mapObjectId,
+                const AreaI& bbox,
+                const ZoomLevel firstZoomLevel,
+                const ZoomLevel lastZoomLevel,
+                const ZoomLevel requestedZoomLevel) -> bool
+            {
+                QMutexLocker scopedLocker(&callbacksMutex);
+                return filterById(section, blockId, mapObjectId, bbox, firstZoomLevel, lastZoomLevel, requestedZoomLevel);
+            };
+    }
+
+    QVector<ParallelTask> tasks;
+    tasks.reserve(static_cast<int>(jobs.size()));
+    for (auto& job : jobs)
+    {
+        const auto pJob = &job;
+        tasks.push_back(
+            [pJob, resultOut, serializedFilterById, cache, outReferencedCacheEntries, queryController]
+            ()
+            {
+                const auto& obfInfo = pJob->obfReader->obtainInfo();
+                for (const auto& mapSection : constOf(obfInfo->mapSections))
+                {
+                    if (queryController && queryController->isAborted())
+                        return;
+
+                    auto surfaceTypeToMerge = MapSurfaceType::Undefined;
+                    OsmAnd::ObfMapSectionReader::loadMapObjects(
+                        pJob->obfReader,
+                        mapSection,
+                        pJob->zoom,
+                        pJob->pBbox31,
+                        resultOut ? &pJob->mapObjects : nullptr,
+                        &surfaceTypeToMerge,
+                        serializedFilterById,
+                        nullptr,
+                        cache,
+                        outReferencedCacheEntries ? &pJob->referencedCacheEntries : nullptr,
+                        queryController,
+                        nullptr,
+                        pJob->coastlineOnly);
+
+                    // Basemap must always have a surface type defined
+                    assert(!pJob->isBasemap || surfaceTypeToMerge != MapSurfaceType::Undefined);
+                    if (surfaceTypeToMerge != MapSurfaceType::Undefined)
+                    {
+                        if (pJob->surfaceType == MapSurfaceType::Undefined)
+                            pJob->surfaceType = surfaceTypeToMerge;
+                        else if (pJob->surfaceType != surfaceTypeToMerge)
+                            pJob->surfaceType = MapSurfaceType::Mixed;
+                    }
+                }
+            });
+    }
+    runInParallel(tasks);
+
+    if (queryController && queryController->isAborted())
+        return false;
+
+    // Merge results in order of jobs, so that output doesn't depend on scheduling
+    auto mergedSurfaceType = MapSurfaceType::Undefined;
+    for (const auto& job : constOf(jobs))
+    {
+        if (resultOut)
+            resultOut->append(job.mapObjects);
+        if (outReferencedCacheEntries)
+            outReferencedCacheEntries->append(job.referencedCacheEntries);
+
+        if (job.surfaceType != MapSurfaceType::Undefined)
+        {
+            if (mergedSurfaceType == MapSurfaceType::Undefined)
+                mergedSurfaceType = job.surfaceType;
+            else if (mergedSurfaceType != job.surfaceType)
+                mergedSurfaceType = MapSurfaceType::Mixed;
+        }
+    }
+
+    // In case there was a basemap present, Undefined is Land
+    if (mergedSurfaceType == MapSurfaceType::Undefined && !basemapReader)
+        mergedSurfaceType = MapSurfaceType::FullLand;
+
+    if (outSurfaceType)
+        *outSurfaceType = mergedSurfaceType;
+
+    return true;
+}
+
 bool OsmAnd::ObfDataInterface::loadRoads(
     const RoutingDataLevel dataLevel,
     const AreaI* const bbox31 /*= nullptr*/,
@@ -200,6 +541,79 @@ bool OsmAnd::ObfDataInterface::loadRoads(
     const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/,
     ObfRoutingSectionReader_Metrics::Metric_loadRoads* const metric /*= nullptr*/)
 {
+    // Metric is not designed to be updated concurrently
+    if (shouldReadInParallel() && !metric)
+    {
+        QMutex callbacksMutex;
+        FilterRoadsByIdFunction serializedFilterById;
+        if (filterById)
+        {
+            serializedFilterById =
+                [filterById, &callbacksMutex]
+                (const std::shared_ptr<const ObfRoutingSectionInfo>& section,
+                    const ObfRoutingSectionDataBlockId& blockId,
+                    const ObfObjectId roadId,
+                    const AreaI& bbox) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return filterById(section, blockId, roadId, bbox);
+                };
+        }
+        ObfRoutingSectionReader::VisitorFunction serializedVisitor;
+        if (visitor)
+        {
+            serializedVisitor =
+                [visitor, &callbacksMutex]
+                (const std::shared_ptr<const OsmAnd::Road>& road) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return visitor(road);
+                };
+        }
+
+        QVector< QList< std::shared_ptr<const OsmAnd::Road> > > roadsPerReader(obfReaders.size());
+        QVector< QList< std::shared_ptr<const ObfRoutingSectionReader::DataBlock> > > referencedCacheEntriesPerReader(
+            obfReaders.size());
+        QVector<ParallelTask> tasks;
+        tasks.reserve(obfReaders.size());
+        for (auto readerIndex = 0; readerIndex < obfReaders.size(); readerIndex++)
+        {
+            const auto& obfReader = obfReaders[readerIndex];
+            const auto pRoads = resultOut ? &roadsPerReader[readerIndex] : nullptr;
+            const auto pReferencedCacheEntries = outReferencedCacheEntries
+                ? &referencedCacheEntriesPerReader[readerIndex]
+                : nullptr;
+            tasks.push_back(
+                [obfReader, dataLevel, bbox31, pRoads, serializedFilterById, serializedVisitor, cache, pReferencedCacheEntries, queryController]
+                ()
+                {
+                    ObfDataInterface(QList< std::shared_ptr<const ObfReader> >() << obfReader).loadRoads(
+                        dataLevel,
+                        bbox31,
+                        pRoads,
+                        serializedFilterById,
+                        serializedVisitor,
+                        cache,
+                        pReferencedCacheEntries,
+                        queryController);
+                });
+        }
+        runInParallel(tasks);
+
+        if (queryController && queryController->isAborted())
+            return false;
+
+        for (auto readerIndex = 0; readerIndex < obfReaders.size(); readerIndex++)
+        {
+            if (resultOut)
+                resultOut->append(roadsPerReader[readerIndex]);
+            if (outReferencedCacheEntries)
+                outReferencedCacheEntries->append(referencedCacheEntriesPerReader[readerIndex]);
+        }
+
+        return true;
+    }
+
     for (const auto& obfReader : constOf(obfReaders))
     {
         if (queryController && queryController->isAborted())
@@ -498,6 +912,67 @@ bool OsmAnd::ObfDataInterface::loadAmenities(
     const ObfPoiSectionReader::VisitorFunction visitor /*= nullptr*/,
     const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/)
 {
+    if (shouldReadInParallel())
+    {
+        QMutex callbacksMutex;
+        TileAcceptorFunction serializedTileFilter;
+        if (tileFilter)
+        {
+            serializedTileFilter =
+                [tileFilter, &callbacksMutex]
+                (const TileId tileId, const ZoomLevel zoomLevel) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return tileFilter(tileId, zoomLevel);
+                };
+        }
+        ObfPoiSectionReader::VisitorFunction serializedVisitor;
+        if (visitor)
+        {
+            serializedVisitor =
+                [visitor, &callbacksMutex]
+                (const std::shared_ptr<const OsmAnd::Amenity>& amenity) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return visitor(amenity);
+                };
+        }
+
+        QVector< QList< std::shared_ptr<const OsmAnd::Amenity> > > amenitiesPerReader(obfReaders.size());
+        QVector<ParallelTask> tasks;
+        tasks.reserve(obfReaders.size());
+        for (auto readerIndex = 0; readerIndex < obfReaders.size(); readerIndex++)
+        {
+            const auto& obfReader = obfReaders[readerIndex];
+            const auto pAmenities = outAmenities ? &amenitiesPerReader[readerIndex] : nullptr;
+            tasks.push_back(
+                [obfReader, pAmenities, pBbox31, serializedTileFilter, zoomFilter, categoriesFilter, serializedVisitor, queryController]
+                ()
+                {
+                    ObfDataInterface(QList< std::shared_ptr<const ObfReader> >() << obfReader).loadAmenities(
+                        pAmenities,
+                        pBbox31,
+                        serializedTileFilter,
+                        zoomFilter,
+                        categoriesFilter,
+                        serializedVisitor,
+                        queryController);
+                });
+        }
+        runInParallel(tasks);
+
+        if (queryController && queryController->isAborted())
+            return false;
+
+        if (outAmenities)
+        {
+            for (const auto& amenities : constOf(amenitiesPerReader))
+                outAmenities->append(amenities);
+        }
+
+        return true;
+    }
+
     for (const auto& obfReader : constOf(obfReaders))
     {
         if (queryController && queryController->isAborted())
@@ -638,64 +1113,143 @@ bool OsmAnd::ObfDataInterface::scanAmenitiesByName(
             });
     }
 
-    for (const auto& orderedSection : constOf(orderedSections))
-    {
-        if (queryController && queryController->isAborted())
-            return false;
-
-        const auto& obfReader = orderedSection.first;
-        const auto& poiSection = orderedSection.second;
-
-        QSet<ObfPoiCategoryId> categoriesFilterById;
-        if (categoriesFilter)
+    const auto scanSection =
+        [&query, xy31, pBbox31, categoriesFilter, queryController]
+        (const OrderedSection& orderedSection,
+            QList< std::shared_ptr<const OsmAnd::Amenity> >* const outAmenities,
+            const TileAcceptorFunction& tileFilter,
+            const ObfPoiSectionReader::VisitorFunction& visitor)
         {
-            std::shared_ptr<const ObfPoiSectionCategories> categories;
-            OsmAnd::ObfPoiSectionReader::loadCategories(
-                obfReader,
-                poiSection,
-                categories,
-                queryController);
+            const auto& obfReader = orderedSection.first;
+            const auto& poiSection = orderedSection.second;
 
-            if (!categories)
-                continue;
-
-            for (const auto& categoriesFilterEntry : rangeOf(constOf(*categoriesFilter)))
+            QSet<ObfPoiCategoryId> categoriesFilterById;
+            if (categoriesFilter)
             {
-                const auto mainCategoryIndex = categories->mainCategories.indexOf(categoriesFilterEntry.key());
-                if (mainCategoryIndex < 0)
-                    continue;
+                std::shared_ptr<const ObfPoiSectionCategories> categories;
+                OsmAnd::ObfPoiSectionReader::loadCategories(
+                    obfReader,
+                    poiSection,
+                    categories,
+                    queryController);
 
-                const auto& subcategories = categories->subCategories[mainCategoryIndex];
-                if (categoriesFilterEntry.value().isEmpty())
-                {
-                    for (auto subCategoryIndex = 0; subCategoryIndex < subcategories.size(); subCategoryIndex++)
-                        categoriesFilterById.insert(ObfPoiCategoryId::create(mainCategoryIndex, subCategoryIndex));
-                }
-                else
+                if (!categories)
+                    return;
+
+                for (const auto& categoriesFilterEntry : rangeOf(constOf(*categoriesFilter)))
                 {
-                    for (const auto& subcategory : constOf(categoriesFilterEntry.value()))
+                    const auto mainCategoryIndex = categories->mainCategories.indexOf(categoriesFilterEntry.key());
+                    if (mainCategoryIndex < 0)
+                        continue;
+
+                    const auto& subcategories = categories->subCategories[mainCategoryIndex];
+                    if (categoriesFilterEntry.value().isEmpty())
                     {
-                        const auto subCategoryIndex = subcategories.indexOf(subcategory);
-                        if (subCategoryIndex < 0)
-                            continue;
+                        for (auto subCategoryIndex = 0; subCategoryIndex < subcategories.size(); subCategoryIndex++)
+                            categoriesFilterById.insert(ObfPoiCategoryId::create(mainCategoryIndex, subCategoryIndex));
+                    }
+                    else
+                    {
+                        for (const auto& subcategory : constOf(categoriesFilterEntry.value()))
+                        {
+                            const auto subCategoryIndex = subcategories.indexOf(subcategory);
+                            if (subCategoryIndex < 0)
+                                continue;
 
-                        categoriesFilterById.insert(ObfPoiCategoryId::create(mainCategoryIndex, subCategoryIndex));
+                            categoriesFilterById.insert(ObfPoiCategoryId::create(mainCategoryIndex, subCategoryIndex));
+                        }
                     }
                 }
             }
+
+            OsmAnd::ObfPoiSectionReader::scanAmenitiesByName(
+                obfReader,
+                poiSection,
+                query,
+                outAmenities,
+                xy31,
+                pBbox31,
+                tileFilter,
+                categoriesFilter ? &categoriesFilterById : nullptr,
+                visitor,
+                queryController);
+        };
+
+    if (shouldReadInParallel())
+    {
+        QMutex callbacksMutex;
+        TileAcceptorFunction serializedTileFilter;
+        if (tileFilter)
+        {
+            serializedTileFilter =
+                [tileFilter, &callbacksMutex]
+                (const TileId tileId, const ZoomLevel zoomLevel) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return tileFilter(tileId, zoomLevel);
+                };
+        }
+        ObfPoiSectionReader::VisitorFunction serializedVisitor;
+        if (visitor)
+        {
+            serializedVisitor =
+                [visitor, &callbacksMutex]
+                (const std::shared_ptr<const OsmAnd::Amenity>& amenity) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return visitor(amenity);
+                };
+        }
+
+        // Sections of same reader are scanned by one task in their sorted order, while output of each section
+        // is collected separately to be merged in same order as sequential scan would produce
+        QHash< std::shared_ptr<const ObfReader>, QVector<int> > sectionsIndicesByReader;
+        for (auto sectionIndex = 0; sectionIndex < static_cast<int>(orderedSections.size()); sectionIndex++)
+            sectionsIndicesByReader[orderedSections[sectionIndex].first].push_back(sectionIndex);
+
+        QVector< QList< std::shared_ptr<const OsmAnd::Amenity> > > amenitiesPerSection(
+            static_cast<int>(orderedSections.size()));
+        QVector<ParallelTask> tasks;
+        tasks.reserve(sectionsIndicesByReader.size());
+        for (const auto& sectionsIndices : constOf(sectionsIndicesByReader))
+        {
+            tasks.push_back(
+                [sectionsIndices, &orderedSections, &amenitiesPerSection, outAmenities, &scanSection, serializedTileFilter, serializedVisitor, queryController]
+                ()
+                {
+                    for (const auto sectionIndex : constOf(sectionsIndices))
+                    {
+                        if (queryController && queryController->isAborted())
+                            return;
+
+                        scanSection(
+                            orderedSections[sectionIndex],
+                            outAmenities ? &amenitiesPerSection[sectionIndex] : nullptr,
+                            serializedTileFilter,
+                            serializedVisitor);
+                    }
+                });
         }
+        runInParallel(tasks);
+
+        if (queryController && queryController->isAborted())
+            return false;
 
-        OsmAnd::ObfPoiSectionReader::scanAmenitiesByName(
-            obfReader,
-            poiSection,
-            query,
-            outAmenities,
-            xy31,
-            pBbox31,
-            tileFilter,
-            categoriesFilter ? &categoriesFilterById : nullptr,
-            visitor,
-            queryController);
+        if (outAmenities)
+        {
+            for (const auto& amenities : constOf(amenitiesPerSection))
+                outAmenities->append(amenities);
+        }
+
+        return true;
+    }
+
+    for (const auto& orderedSection : constOf(orderedSections))
+    {
+        if (queryController && queryController->isAborted())
+            return false;
+
+        scanSection(orderedSection, outAmenities, tileFilter, visitor);
     }
 
     return true;
@@ -874,8 +1428,12 @@ bool OsmAnd::ObfDataInterface::scanAddressesByName(
     const bool includeStreets /*= true*/,
     const bool strictMatch /*= false*/,
     const ObfAddressSectionReader::VisitorFunction visitor /*= nullptr*/,
-    const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/)
+    const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/,
+    const PointI* const xy31 /*= nullptr*/,
+    const AddressSectionFilterFunction sectionFilter /*= nullptr*/)
 {
+    typedef std::pair< std::shared_ptr<const ObfReader>, Ref<ObfAddressSectionInfo> > OrderedSection;
+    std::vector< OrderedSection > orderedSections;
     for (const auto& obfReader : constOf(obfReaders))
     {
         if (queryController && queryController->isAborted())
@@ -898,6 +1456,37 @@ bool OsmAnd::ObfDataInterface::scanAddressesByName(
                     continue;
             }
 
+            orderedSections.push_back(OrderedSection(obfReader, addressSection));
+        }
+    }
+
+    if (xy31)
+    {
+        const auto position31 = *xy31;
+
+        // Sections that contain given point go first, then ones closer to it
+        std::stable_sort(
+            orderedSections.begin(),
+            orderedSections.end(),
+            [position31]
+            (const OrderedSection& l, const OrderedSection& r) -> bool
+            {
+                return Utilities::squareDistance31(position31, l.second->area31)
+                    < Utilities::squareDistance31(position31, r.second->area31);
+            });
+    }
+
+    const auto scanSection =
+        [&query, matcherMode, bbox31, streetGroupTypesFilter, includeStreets, strictMatch, queryController]
+        (const std::shared_ptr<const ObfReader>& obfReader,
+            const Ref<ObfAddressSectionInfo>& addressSection,
+            QList< std::shared_ptr<const OsmAnd::Address> >* const outAddresses,
+            const AddressSectionFilterFunction& sectionFilter,
+            const ObfAddressSectionReader::VisitorFunction& visitor)
+        {
+            if (sectionFilter && !sectionFilter(addressSection))
+                return;
+
             OsmAnd::ObfAddressSectionReader::scanAddressesByName(
                 obfReader,
                 addressSection,
@@ -910,7 +1499,78 @@ bool OsmAnd::ObfDataInterface::scanAddressesByName(
                 strictMatch,
                 visitor,
                 queryController);
+        };
+
+    if (_parallelReadingEnabled && orderedSections.size() > 1)
+    {
+        QMutex callbacksMutex;
+        AddressSectionFilterFunction serializedSectionFilter;
+        if (sectionFilter)
+        {
+            serializedSectionFilter =
+                [sectionFilter, &callbacksMutex]
+                (const std::shared_ptr<const ObfAddressSectionInfo>& addressSection) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return sectionFilter(addressSection);
+                };
+        }
+        ObfAddressSectionReader::VisitorFunction serializedVisitor;
+        if (visitor)
+        {
+            serializedVisitor =
+                [visitor, &callbacksMutex]
+                (const std::shared_ptr<const OsmAnd::Address>& address) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return visitor(address);
+                };
+        }
+
+        // Each section is a separate task, started in sorted order. Output of each section is collected
+        // separately to be merged in same order as sequential scan would produce.
+        QVector< QList< std::shared_ptr<const OsmAnd::Address> > > addressesPerSection(
+            static_cast<int>(orderedSections.size()));
+        QVector<ReaderTask> tasks;
+        tasks.reserve(static_cast<int>(orderedSections.size()));
+        for (auto sectionIndex = 0; sectionIndex < static_cast<int>(orderedSections.size()); sectionIndex++)
+        {
+            tasks.push_back(ReaderTask(
+                orderedSections[sectionIndex].first,
+                [sectionIndex, &orderedSections, &addressesPerSection, outAddresses, &scanSection, serializedSectionFilter, serializedVisitor, queryController]
+                (const std::shared_ptr<const ObfReader>& leasedReader)
+                {
+                    if (queryController && queryController->isAborted())
+                        return;
+
+                    scanSection(
+                        leasedReader,
+                        orderedSections[sectionIndex].second,
+                        outAddresses ? &addressesPerSection[sectionIndex] : nullptr,
+                        serializedSectionFilter,
+                        serializedVisitor);
+                }));
         }
+        runOnReadersInParallel(tasks);
+
+        if (queryController && queryController->isAborted())
+            return false;
+
+        if (outAddresses)
+        {
+            for (const auto& addresses : constOf(addressesPerSection))
+                outAddresses->append(addresses);
+        }
+
+        return true;
+    }
+
+    for (const auto& orderedSection : constOf(orderedSections))
+    {
+        if (queryController && queryController->isAborted())
+            return false;
+
+        scanSection(orderedSection.first, orderedSection.second, outAddresses, sectionFilter, visitor);
     }
 
     return true;
@@ -1003,6 +1663,75 @@ bool OsmAnd::ObfDataInterface::loadStreetsFromGroups(
     const ObfAddressSectionReader::StreetVisitorFunction visitor /*= nullptr*/,
     const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/)
 {
+    if (_parallelReadingEnabled && streetGroups.size() > 1)
+    {
+        QMutex callbacksMutex;
+        ObfAddressSectionReader::StreetVisitorFunction serializedVisitor;
+        if (visitor)
+        {
+            serializedVisitor =
+                [visitor, &callbacksMutex]
+                (const std::shared_ptr<const OsmAnd::Street>& street) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return visitor(street);
+                };
+        }
+
+        // Each street group (city) is a separate task
+        QVector<ReaderTask> tasks;
+        for (const auto& obfReader : constOf(obfReaders))
+        {
+            const auto& obfInfo = obfReader->obtainInfo();
+            for (const auto& addressSection : constOf(obfInfo->addressSections))
+            {
+                if (bbox31)
+                {
+                    bool accept = false;
+                    accept = accept || addressSection->area31.contains(*bbox31);
+                    accept = accept || addressSection->area31.intersects(*bbox31);
+                    accept = accept || bbox31->contains(addressSection->area31);
+
+                    if (!accept)
+                        continue;
+                }
+
+                for (const auto& streetGroup : constOf(streetGroups))
+                {
+                    if (addressSection != streetGroup->obfSection)
+                        continue;
+
+                    tasks.push_back(ReaderTask(
+                        obfReader,
+                        [streetGroup, resultOut, bbox31, serializedVisitor, &callbacksMutex, queryController]
+                        (const std::shared_ptr<const ObfReader>& leasedReader)
+                        {
+                            if (queryController && queryController->isAborted())
+                                return;
+
+                            QList< std::shared_ptr<const Street> > intermediateResult;
+                            OsmAnd::ObfAddressSectionReader::loadStreetsFromGroup(
+                                leasedReader,
+                                streetGroup,
+                                resultOut ? &intermediateResult : nullptr,
+                                bbox31,
+                                serializedVisitor,
+                                queryController);
+
+                            if (resultOut)
+                            {
+                                QMutexLocker scopedLocker(&callbacksMutex);
+                                resultOut->insert(streetGroup, intermediateResult);
+                            }
+                        }));
+                }
+            }
+        }
+        runOnReadersInParallel(tasks);
+
+        return !queryController || !queryController->isAborted();
+    }
+
     for (const auto& obfReader : constOf(obfReaders))
     {
         if (queryController && queryController->isAborted())
@@ -1092,6 +1821,75 @@ bool OsmAnd::ObfDataInterface::loadBuildingsFromStreets(
     const ObfAddressSectionReader::BuildingVisitorFunction visitor /*= nullptr*/,
     const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/)
 {
+    if (_parallelReadingEnabled && streets.size() > 1)
+    {
+        QMutex callbacksMutex;
+        ObfAddressSectionReader::BuildingVisitorFunction serializedVisitor;
+        if (visitor)
+        {
+            serializedVisitor =
+                [visitor, &callbacksMutex]
+                (const std::shared_ptr<const OsmAnd::Building>& building) -> bool
+                {
+                    QMutexLocker scopedLocker(&callbacksMutex);
+                    return visitor(building);
+                };
+        }
+
+        // Each street is a separate task
+        QVector<ReaderTask> tasks;
+        for (const auto& obfReader : constOf(obfReaders))
+        {
+            const auto& obfInfo = obfReader->obtainInfo();
+            for (const auto& addressSection : constOf(obfInfo->addressSections))
+            {
+                if (bbox31)
+                {
+                    bool accept = false;
+                    accept = accept || addressSection->area31.contains(*bbox31);
+                    accept = accept || addressSection->area31.intersects(*bbox31);
+                    accept = accept || bbox31->contains(addressSection->area31);
+
+                    if (!accept)
+                        continue;
+                }
+
+                for (const auto& street : constOf(streets))
+                {
+                    if (addressSection != street->streetGroup->obfSection)
+                        continue;
+
+                    tasks.push_back(ReaderTask(
+                        obfReader,
+                        [street, resultOut, bbox31, serializedVisitor, &callbacksMutex, queryController]
+                        (const std::shared_ptr<const ObfReader>& leasedReader)
+                        {
+                            if (queryController && queryController->isAborted())
+                                return;
+
+                            QList< std::shared_ptr<const Building> > intermediateResult;
+                            OsmAnd::ObfAddressSectionReader::loadBuildingsFromStreet(
+                                leasedReader,
+                                street,
+                                resultOut ? &intermediateResult : nullptr,
+                                bbox31,
+                                serializedVisitor,
+                                queryController);
+
+                            if (resultOut)
+                            {
+                                QMutexLocker scopedLocker(&callbacksMutex);
+                                resultOut->insert(street, intermediateResult);
+                            }
+                        }));
+                }
+            }
+        }
+        runOnReadersInParallel(tasks);
+
+        return !queryController || !queryController->isAborted();
+    }
+
     for (const auto& obfReader : constOf(obfReaders))
     {
         if (queryController && queryController->isAborted())
@@ -0,0 +1,172 @@
+#include "ObfReadersPool.h"
+
+#include "Common.h"
+#include "ObfReader.h"
+#include "ObfFile.h"
+
+OsmAnd::ObfReadersPool::ObfReadersPool(const int maxIdleReadersPerFile_)
+    : _lastGeneration(0)
+    , _maxIdleReadersPerFile(maxIdleReadersPerFile_)
+    , _useSharedMemoryMapping(false)
+{
+}
+
+OsmAnd::ObfReadersPool::~ObfReadersPool()
+{
+}
+
+int OsmAnd::ObfReadersPool::getMaxIdleReadersPerFile() const
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    return _maxIdleReadersPerFile;
+}
+
+void OsmAnd::ObfReadersPool::setMaxIdleReadersPerFile(const int maxIdleReadersPerFile)
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    _maxIdleReadersPerFile = maxIdleReadersPerFile;
+    for (auto& entry : _entries)
+    {
+        while (entry.idleReaders.size() > qMax(_maxIdleReadersPerFile, 0))
+            entry.idleReaders.removeLast();
+    }
+}
+
+bool OsmAnd::ObfReadersPool::getUseSharedMemoryMapping() const
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    return _useSharedMemoryMapping;
+}
+
+void OsmAnd::ObfReadersPool::setUseSharedMemoryMapping(const bool useSharedMemoryMapping)
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    if (_useSharedMemoryMapping == useSharedMemoryMapping)
+        return;
+    _useSharedMemoryMapping = useSharedMemoryMapping;
+
+    // Readers that were opened in other mode are not reusable anymore
+    _invalidations.fetchAndAddOrdered(_entries.size());
+    _entries.clear();
+}
+
+std::shared_ptr<const OsmAnd::ObfReader> OsmAnd::ObfReadersPool::obtainReader(
+    const std::shared_ptr<const ObfFile>& obfFile)
+{
+    std::shared_ptr<ObfReader> obfReader;
+    unsigned int generation;
+    bool useSharedMemoryMapping;
+    {
+        QMutexLocker scopedLocker(&_entriesMutex);
+
+        auto itEntry = _entries.find(obfFile->filePath);
+        if (itEntry != _entries.end() && itEntry->obfFile != obfFile)
+        {
+            // Entry belongs to previous instance of the same file, so it's outdated
+            _entries.erase(itEntry);
+            itEntry = _entries.end();
+            _invalidations.fetchAndAddOrdered(1);
+        }
+        if (itEntry == _entries.end())
+        {
+            Entry entry;
+            entry.obfFile = obfFile;
+            entry.generation = ++_lastGeneration;
+            itEntry = _entries.insert(obfFile->filePath, entry);
+        }
+
+        generation = itEntry->generation;
+        useSharedMemoryMapping = _useSharedMemoryMapping;
+        if (!itEntry->idleReaders.isEmpty())
+            obfReader = itEntry->idleReaders.takeLast();
+    }
+
+    if (obfReader)
+        _hits.fetchAndAddOrdered(1);
+    else
+    {
+        _misses.fetchAndAddOrdered(1);
+        obfReader = std::make_shared<ObfReader>(obfFile, useSharedMemoryMapping);
+    }
+
+    // Lease holds the reader and returns it to the pool (if pool is still alive) upon release
+    const std::weak_ptr<ObfReadersPool> weakPool = shared_from_this();
+    return std::shared_ptr<const ObfReader>(
+        obfReader.get(),
+        [weakPool, obfReader, generation]
+        (const ObfReader* const)
+        {
+            if (const auto pool = weakPool.lock())
+                pool->release(obfReader, generation);
+        });
+}
+
+void OsmAnd::ObfReadersPool::release(const std::shared_ptr<ObfReader>& obfReader, const unsigned int generation)
+{
+    // Reader may have been left in the middle of some section, so move it back to the beginning.
+    // Reader is still exclusively owned by the lease here, so no lock is needed for that
+    if (!obfReader->rewind())
+        return;
+
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    const auto itEntry = _entries.find(obfReader->obfFile->filePath);
+    if (itEntry == _entries.end() || itEntry->generation != generation)
+        return;
+    if (itEntry->idleReaders.size() >= _maxIdleReadersPerFile)
+        return;
+
+    itEntry->idleReaders.push_back(obfReader);
+}
+
+void OsmAnd::ObfReadersPool::invalidate(const QString& filePath)
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    if (_entries.remove(filePath) > 0)
+        _invalidations.fetchAndAddOrdered(1);
+}
+
+void OsmAnd::ObfReadersPool::clear()
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    _invalidations.fetchAndAddOrdered(_entries.size());
+    _entries.clear();
+}
+
+unsigned int OsmAnd::ObfReadersPool::getHits() const
+{
+    return static_cast<unsigned int>(_hits.loadAcquire());
+}
+
+unsigned int OsmAnd::ObfReadersPool::getMisses() const
+{
+    return static_cast<unsigned int>(_misses.loadAcquire());
+}
+
+unsigned int OsmAnd::ObfReadersPool::getInvalidations() const
+{
+    return static_cast<unsigned int>(_invalidations.loadAcquire());
+}
+
+unsigned int OsmAnd::ObfReadersPool::getIdleReadersCount() const
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    unsigned int idleReadersCount = 0;
+    for (const auto& entry : constOf(_entries))
+        idleReadersCount += entry.idleReaders.size();
+    return idleReadersCount;
+}
+
+void OsmAnd::ObfReadersPool::resetCounters()
+{
+    _hits.storeRelease(0);
+    _misses.storeRelease(0);
+    _invalidations.storeRelease(0);
+}
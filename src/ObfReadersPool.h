@@ -0,0 +1,68 @@
+#ifndef _OSMAND_CORE_OBF_READERS_POOL_H_
+#define _OSMAND_CORE_OBF_READERS_POOL_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QAtomicInt>
+
+#include "OsmAndCore.h"
+
+namespace OsmAnd
+{
+    class ObfFile;
+    class ObfReader;
+
+    // Pool of already opened ObfReaders. Each reader is leased exclusively and gets returned back to the pool
+    // (rewound to the beginning of the file) once the last reference to the lease is released.
+    class ObfReadersPool Q_DECL_FINAL : public std::enable_shared_from_this<ObfReadersPool>
+    {
+        Q_DISABLE_COPY_AND_MOVE(ObfReadersPool);
+    private:
+        struct Entry
+        {
+            std::shared_ptr<const ObfFile> obfFile;
+            unsigned int generation;
+            QList< std::shared_ptr<ObfReader> > idleReaders;
+        };
+
+        mutable QMutex _entriesMutex;
+        QHash<QString, Entry> _entries;
+        unsigned int _lastGeneration;
+        int _maxIdleReadersPerFile;
+        bool _useSharedMemoryMapping;
+
+        QAtomicInt _hits;
+        QAtomicInt _misses;
+        QAtomicInt _invalidations;
+
+        void release(const std::shared_ptr<ObfReader>& obfReader, const unsigned int generation);
+    protected:
+    public:
+        ObfReadersPool(const int maxIdleReadersPerFile);
+        ~ObfReadersPool();
+
+        int getMaxIdleReadersPerFile() const;
+        void setMaxIdleReadersPerFile(const int maxIdleReadersPerFile);
+
+        bool getUseSharedMemoryMapping() const;
+        void setUseSharedMemoryMapping(const bool useSharedMemoryMapping);
+
+        std::shared_ptr<const ObfReader> obtainReader(const std::shared_ptr<const ObfFile>& obfFile);
+
+        void invalidate(const QString& filePath);
+        void clear();
+
+        unsigned int getHits() const;
+        unsigned int getMisses() const;
+        unsigned int getInvalidations() const;
+        unsigned int getIdleReadersCount() const;
+        void resetCounters();
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_OBF_READERS_POOL_H_)
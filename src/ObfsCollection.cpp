@@ -60,6 +60,41 @@ bool OsmAnd::ObfsCollection::remove(const SourceOriginId entryId)
     return _p->remove(entryId);
 }
 
+int OsmAnd::ObfsCollection::getMaxIdleReadersPerFile() const
+{
+    return _p->getMaxIdleReadersPerFile();
+}
+
+void OsmAnd::ObfsCollection::setMaxIdleReadersPerFile(const int maxIdleReadersPerFile)
+{
+    _p->setMaxIdleReadersPerFile(maxIdleReadersPerFile);
+}
+
+OsmAnd::ObfsCollection::ReadersPoolStatistics OsmAnd::ObfsCollection::getReadersPoolStatistics() const
+{
+    return _p->getReadersPoolStatistics();
+}
+
+void OsmAnd::ObfsCollection::resetReadersPoolStatistics()
+{
+    _p->resetReadersPoolStatistics();
+}
+
+void OsmAnd::ObfsCollection::clearReadersPool()
+{
+    _p->clearReadersPool();
+}
+
+bool OsmAnd::ObfsCollection::getUseSharedMemoryMapping() const
+{
+    return _p->getUseSharedMemoryMapping();
+}
+
+void OsmAnd::ObfsCollection::setUseSharedMemoryMapping(const bool useSharedMemoryMapping)
+{
+    _p->setUseSharedMemoryMapping(useSharedMemoryMapping);
+}
+
 QList< std::shared_ptr<const OsmAnd::ObfFile> >OsmAnd::ObfsCollection::getObfFiles() const
 {
     return _p->getObfFiles();
@@ -4,23 +4,31 @@
 #include <cassert>
 
 #include "QtCommon.h"
+#include <QThread>
 
 #include "OsmAndCore_private.h"
 #include "ObfReader.h"
 #include "ObfDataInterface.h"
 #include "ObfFile.h"
 #include "ObfInfo.h"
+#include "ObfMapSectionInfo.h"
+#include "ObfRoutingSectionInfo.h"
+#include "ObfAddressSectionInfo.h"
+#include "ObfPoiSectionInfo.h"
+#include "ObfTransportSectionInfo.h"
 #include "QKeyValueIterator.h"
 #include "Stopwatch.h"
 #include "Utilities.h"
 #include "Logging.h"
 #include "CachedOsmandIndexes.h"
+#include "ObfReadersPool.h"
 
 OsmAnd::ObfsCollection_P::ObfsCollection_P(ObfsCollection* owner_)
     : owner(owner_)
     , _fileSystemWatcher(new QFileSystemWatcher())
     , _lastUnusedSourceOriginId(0)
     , _collectedSourcesInvalidated(1)
+    , _readersPool(new ObfReadersPool(QThread::idealThreadCount()))
 {
     _fileSystemWatcher->moveToThread(gMainThread);
 
@@ -49,6 +57,7 @@ void OsmAnd::ObfsCollection_P::collectSources() const
 {
     QWriteLocker scopedLocker1(&_collectedSourcesLock);
     QReadLocker scopedLocker2(&_sourcesOriginsLock);
+    QWriteLocker scopedLocker3(&_sectionsIndexLock);
 
     // Capture how many invalidations are going to be processed
     const auto invalidationsToProcess = _collectedSourcesInvalidated.loadAcquire();
@@ -102,6 +111,8 @@ void OsmAnd::ObfsCollection_P::collectSources() const
             for(const auto& itCollectedSource : rangeOf(collectedSources))
             {
                 const auto obfFile = itCollectedSource.value();
+                _readersPool->invalidate(itCollectedSource.key());
+                unindexObfFile(obfFile);
 
                 //NOTE: OBF should have been locked here, but since file is gone anyways, this lock is quite useless
 
@@ -121,6 +132,8 @@ void OsmAnd::ObfsCollection_P::collectSources() const
             if (QFile::exists(sourceFilename))
                 continue;
             const auto obfFile = itObfFileEntry.value();
+            _readersPool->invalidate(sourceFilename);
+            unindexObfFile(obfFile);
 
             //NOTE: OBF should have been locked here, but since file is gone anyways, this lock is quite useless
 
@@ -161,10 +174,13 @@ void OsmAnd::ObfsCollection_P::collectSources() const
                 {
                     if (obfFileInfo.size() == (*itCollectedObfFile)->fileSize)
                         continue;
+                    unindexObfFile(*itCollectedObfFile);
                 }
 
                 auto obfFile = cachedOsmandIndexes->getObfFile(obfFilePath);
                 collectedSources.insert(obfFilePath, obfFile);
+                _readersPool->invalidate(obfFilePath);
+                indexObfFile(obfFile);
             }
 
             if (directoryAsSourceOrigin->isRecursive)
@@ -197,10 +213,13 @@ void OsmAnd::ObfsCollection_P::collectSources() const
                 QFileInfo obfFileInfo(obfFilePath);
                 if (obfFileInfo.size() == (*itCollectedObfFile)->fileSize)
                     continue;
+                unindexObfFile(*itCollectedObfFile);
             }
 
             auto obfFile = cachedOsmandIndexes->getObfFile(obfFilePath);
             collectedSources.insert(obfFilePath, obfFile);
+            _readersPool->invalidate(obfFilePath);
+            indexObfFile(obfFile);
         }
     }
 
@@ -215,6 +234,120 @@ void OsmAnd::ObfsCollection_P::collectSources() const
     LogPrintf(LogSeverityLevel::Info, "Collected OBF sources in %fs", collectSourcesStopwatch.elapsed());
 }
 
+bool OsmAnd::ObfsCollection_P::indexObfFile(const std::shared_ptr<const ObfFile>& obfFile) const
+{
+    // Basemaps are used regardless of the area, so there's no need to index them. Files without
+    // information can not be indexed yet, so they are checked on demand and indexed later
+    const auto& obfInfo = obfFile->obfInfo;
+    if (!obfInfo || obfInfo->isBasemap || obfInfo->isBasemapWithCoastlines)
+    {
+        _unindexedObfFiles.insert(obfFile);
+        return false;
+    }
+
+    QList< std::shared_ptr<const IndexedSection> > indexedSections;
+    const auto indexSection =
+        [this, obfFile, &indexedSections]
+        (const ObfDataType dataType, const AreaI& area31, const ZoomLevel minZoom, const ZoomLevel maxZoom)
+        {
+            const std::shared_ptr<IndexedSection> indexedSection(new IndexedSection());
+            indexedSection->obfFile = obfFile;
+            indexedSection->dataType = dataType;
+            indexedSection->area31 = area31;
+            indexedSection->minZoom = minZoom;
+            indexedSection->maxZoom = maxZoom;
+
+            if (_sectionsTrees[static_cast<int>(dataType)].insert(indexedSection, area31))
+                indexedSections.push_back(indexedSection);
+        };
+
+    for (const auto& mapSection : constOf(obfInfo->mapSections))
+    {
+        for (const auto& level : constOf(mapSection->levels))
+            indexSection(ObfDataType::Map, level->area31, level->minZoom, level->maxZoom);
+    }
+    for (const auto& routingSection : constOf(obfInfo->routingSections))
+        indexSection(ObfDataType::Routing, routingSection->area31, MinZoomLevel, MaxZoomLevel);
+    for (const auto& addressSection : constOf(obfInfo->addressSections))
+        indexSection(ObfDataType::Address, addressSection->area31, MinZoomLevel, MaxZoomLevel);
+    for (const auto& poiSection : constOf(obfInfo->poiSections))
+        indexSection(ObfDataType::POI, poiSection->area31, MinZoomLevel, MaxZoomLevel);
+    for (const auto& transportSection : constOf(obfInfo->transportSections))
+        indexSection(ObfDataType::Transport, transportSection->area31, MinZoomLevel, MaxZoomLevel);
+
+    _unindexedObfFiles.remove(obfFile);
+    _indexedObfFiles.insert(obfFile, indexedSections);
+
+    return true;
+}
+
+void OsmAnd::ObfsCollection_P::unindexObfFile(const std::shared_ptr<const ObfFile>& obfFile) const
+{
+    _unindexedObfFiles.remove(obfFile);
+
+    const auto itIndexedObfFile = _indexedObfFiles.find(obfFile);
+    if (itIndexedObfFile == _indexedObfFiles.end())
+        return;
+
+    for (const auto& indexedSection : constOf(*itIndexedObfFile))
+    {
+        auto& sectionsTree = _sectionsTrees[static_cast<int>(indexedSection->dataType)];
+        if (!sectionsTree.removeOne(indexedSection, SectionsTree::BBox(indexedSection->area31)))
+            sectionsTree.removeOneSlow(indexedSection);
+    }
+    _indexedObfFiles.erase(itIndexedObfFile);
+}
+
+void OsmAnd::ObfsCollection_P::selectObfFiles(
+    const AreaI* const pBbox31,
+    const ZoomLevel minZoomLevel,
+    const ZoomLevel maxZoomLevel,
+    const ObfDataTypesMask desiredDataTypes,
+    QList< std::shared_ptr<const ObfFile> >& outIndexedObfFiles,
+    QList< std::shared_ptr<const ObfFile> >& outUnindexedObfFiles) const
+{
+    QReadLocker scopedLocker(&_sectionsIndexLock);
+
+    QSet<const ObfFile*> selectedObfFiles;
+    QList< std::shared_ptr<const IndexedSection> > selectedSections;
+    const SectionsTree::Acceptor acceptor =
+        [minZoomLevel, maxZoomLevel, &selectedObfFiles]
+        (const std::shared_ptr<const IndexedSection>& indexedSection, const SectionsTree::BBox& bbox) -> bool
+        {
+            Q_UNUSED(bbox);
+
+            if (minZoomLevel > indexedSection->maxZoom || indexedSection->minZoom > maxZoomLevel)
+                return false;
+
+            // Only first matching section of each file is needed
+            if (selectedObfFiles.contains(indexedSection->obfFile.get()))
+                return false;
+            selectedObfFiles.insert(indexedSection->obfFile.get());
+
+            return true;
+        };
+
+    for (auto dataTypeIndex = 0; dataTypeIndex < ObfDataTypesCount; dataTypeIndex++)
+    {
+        if (!desiredDataTypes.isSet(static_cast<ObfDataType>(dataTypeIndex)))
+            continue;
+
+        const auto& sectionsTree = _sectionsTrees[dataTypeIndex];
+        if (pBbox31)
+            sectionsTree.query(*pBbox31, selectedSections, false, acceptor);
+        else
+            sectionsTree.get(selectedSections, acceptor);
+    }
+
+    outIndexedObfFiles.reserve(outIndexedObfFiles.size() + selectedSections.size());
+    for (const auto& selectedSection : constOf(selectedSections))
+        outIndexedObfFiles.push_back(selectedSection->obfFile);
+
+    outUnindexedObfFiles.reserve(outUnindexedObfFiles.size() + _unindexedObfFiles.size());
+    for (const auto& obfFile : constOf(_unindexedObfFiles))
+        outUnindexedObfFiles.push_back(obfFile);
+}
+
 QList<OsmAnd::ObfsCollection::SourceOriginId> OsmAnd::ObfsCollection_P::getSourceOriginIds() const
 {
     QReadLocker scopedLocker(&_sourcesOriginsLock);
@@ -340,6 +473,46 @@ bool OsmAnd::ObfsCollection_P::remove(const ObfsCollection::SourceOriginId entry
     return true;
 }
 
+int OsmAnd::ObfsCollection_P::getMaxIdleReadersPerFile() const
+{
+    return _readersPool->getMaxIdleReadersPerFile();
+}
+
+void OsmAnd::ObfsCollection_P::setMaxIdleReadersPerFile(const int maxIdleReadersPerFile)
+{
+    _readersPool->setMaxIdleReadersPerFile(maxIdleReadersPerFile);
+}
+
+OsmAnd::ObfsCollection::ReadersPoolStatistics OsmAnd::ObfsCollection_P::getReadersPoolStatistics() const
+{
+    ObfsCollection::ReadersPoolStatistics statistics;
+    statistics.hits = _readersPool->getHits();
+    statistics.misses = _readersPool->getMisses();
+    statistics.invalidations = _readersPool->getInvalidations();
+    statistics.idleReaders = _readersPool->getIdleReadersCount();
+    return statistics;
+}
+
+void OsmAnd::ObfsCollection_P::resetReadersPoolStatistics()
+{
+    _readersPool->resetCounters();
+}
+
+void OsmAnd::ObfsCollection_P::clearReadersPool()
+{
+    _readersPool->clear();
+}
+
+bool OsmAnd::ObfsCollection_P::getUseSharedMemoryMapping() const
+{
+    return _readersPool->getUseSharedMemoryMapping();
+}
+
+void OsmAnd::ObfsCollection_P::setUseSharedMemoryMapping(const bool useSharedMemoryMapping)
+{
+    _readersPool->setUseSharedMemoryMapping(useSharedMemoryMapping);
+}
+
 QList< std::shared_ptr<const OsmAnd::ObfFile> > OsmAnd::ObfsCollection_P::getObfFiles() const
 {
     // Check if sources were invalidated
@@ -363,7 +536,8 @@ QList< std::shared_ptr<const OsmAnd::ObfFile> > OsmAnd::ObfsCollection_P::getObf
 std::shared_ptr<OsmAnd::ObfDataInterface> OsmAnd::ObfsCollection_P::obtainDataInterface(
     const std::shared_ptr<const ObfFile> obfFile) const
 {
-    return std::shared_ptr<ObfDataInterface>(new ObfDataInterface({ std::make_shared<ObfReader>(obfFile) }));
+    return std::shared_ptr<ObfDataInterface>(new ObfDataInterface(
+        { _readersPool->obtainReader(obfFile) }, getReadersPoolSource()));
 }
 
 std::shared_ptr<OsmAnd::ObfDataInterface> OsmAnd::ObfsCollection_P::obtainDataInterface(
@@ -388,40 +562,74 @@ std::shared_ptr<OsmAnd::ObfDataInterface> OsmAnd::ObfsCollection_P::obtainDataIn
     {
         QReadLocker scopedLocker(&_collectedSourcesLock);
 
-        for (const auto& collectedSources : constOf(_collectedSources))
+        // Select candidates using spatial index of sections, files that are not indexed are checked as usual
+        QList< std::shared_ptr<const ObfFile> > indexedObfFiles;
+        QList< std::shared_ptr<const ObfFile> > unindexedObfFiles;
+        selectObfFiles(
+            pBbox31,
+            minZoomLevel,
+            maxZoomLevel,
+            desiredDataTypes,
+            indexedObfFiles,
+            unindexedObfFiles);
+
+        obfReaders.reserve(indexedObfFiles.size() + unindexedObfFiles.size());
+        for (const auto& obfFile : constOf(indexedObfFiles))
+        {
+            auto obfReader = _readersPool->obtainReader(obfFile);
+            if (!obfReader->isOpened() || !obfReader->obtainInfo())
+                continue;
+
+            obfReaders.push_back(qMove(obfReader));
+        }
+
+        QList< std::shared_ptr<const ObfFile> > obfFilesToIndex;
+        for (const auto& obfFile : constOf(unindexedObfFiles))
         {
-            obfReaders.reserve(obfReaders.size() + collectedSources.size());
-            for (const auto& obfFile : constOf(collectedSources))
+            // Open file in any case to obtain information (or reuse already opened one)
+            auto obfReader = _readersPool->obtainReader(obfFile);
+            if (!obfReader->isOpened() || !obfReader->obtainInfo())
+                continue;
+
+            if (!obfFile->obfInfo->isBasemap && !obfFile->obfInfo->isBasemapWithCoastlines)
             {
-                // If OBF information already available, perform check
-                if (obfFile->obfInfo &&
-                    !obfFile->obfInfo->isBasemap &&
-                    !obfFile->obfInfo->isBasemapWithCoastlines)
-                {
-                    bool accept = obfFile->obfInfo->containsDataFor(pBbox31, minZoomLevel, maxZoomLevel, desiredDataTypes);
-                    if (!accept)
-                        continue;
-                }
+                obfFilesToIndex.push_back(obfFile);
 
-                // Otherwise, open file in any case to repeat check
-                std::shared_ptr<const ObfReader> obfReader(new ObfReader(obfFile));
-                if (!obfReader->isOpened() || !obfReader->obtainInfo())
+                bool accept = obfFile->obfInfo->containsDataFor(pBbox31, minZoomLevel, maxZoomLevel, desiredDataTypes);
+                if (!accept)
                     continue;
+            }
 
-                // Repeat checks if needed
-                if (!obfFile->obfInfo->isBasemap && !obfFile->obfInfo->isBasemapWithCoastlines)
-                {
-                    bool accept = obfFile->obfInfo->containsDataFor(pBbox31, minZoomLevel, maxZoomLevel, desiredDataTypes);
-                    if (!accept)
-                        continue;
-                }
+            obfReaders.push_back(qMove(obfReader));
+        }
 
-                obfReaders.push_back(qMove(obfReader));
+        // Index files that now have information, so that next time they are selected by the index
+        if (!obfFilesToIndex.isEmpty())
+        {
+            QWriteLocker scopedIndexLocker(&_sectionsIndexLock);
+
+            for (const auto& obfFile : constOf(obfFilesToIndex))
+            {
+                if (_unindexedObfFiles.contains(obfFile))
+                    indexObfFile(obfFile);
             }
         }
     }
 
-    return std::shared_ptr<ObfDataInterface>(new ObfDataInterface(obfReaders));
+    return std::shared_ptr<ObfDataInterface>(new ObfDataInterface(obfReaders, getReadersPoolSource()));
+}
+
+OsmAnd::ObfDataInterface::ObtainReaderFunction OsmAnd::ObfsCollection_P::getReadersPoolSource() const
+{
+    // Additional readers are leased from the pool as well, so they are reused and invalidated along with others
+    const std::weak_ptr<ObfReadersPool> weakReadersPool = _readersPool;
+    return
+        [weakReadersPool]
+        (const std::shared_ptr<const ObfFile>& obfFile) -> std::shared_ptr<const ObfReader>
+        {
+            const auto readersPool = weakReadersPool.lock();
+            return readersPool ? readersPool->obtainReader(obfFile) : nullptr;
+        };
 }
 
 void OsmAnd::ObfsCollection_P::onDirectoryChanged(const QString& path)
@@ -431,5 +639,6 @@ void OsmAnd::ObfsCollection_P::onDirectoryChanged(const QString& path)
 
 void OsmAnd::ObfsCollection_P::onFileChanged(const QString& path)
 {
+    _readersPool->invalidate(path);
     invalidateCollectedSources();
 }
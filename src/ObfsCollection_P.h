@@ -2,6 +2,7 @@
 #define _OSMAND_CORE_OBFS_COLLECTION_P_H_
 
 #include "stdlib_common.h"
+#include <array>
 
 #include "QtExtensions.h"
 #include <QDir>
@@ -15,12 +16,14 @@
 #include "OsmAndCore.h"
 #include "CommonTypes.h"
 #include "PrivateImplementation.h"
+#include "QuadTree.h"
 #include "ObfsCollection.h"
+#include "ObfDataInterface.h"
 
 namespace OsmAnd
 {
     class ObfFile;
-    class ObfDataInterface;
+    class ObfReadersPool;
 
     class ObfsCollection;
     class ObfsCollection_P__SignalProxy;
@@ -84,6 +87,35 @@ namespace OsmAnd
         mutable QHash< ObfsCollection::SourceOriginId, QHash<QString, std::shared_ptr<ObfFile> > > _collectedSources;
         mutable QReadWriteLock _collectedSourcesLock;
         void collectSources() const;
+
+        struct IndexedSection
+        {
+            std::shared_ptr<const ObfFile> obfFile;
+            ObfDataType dataType;
+            AreaI area31;
+            ZoomLevel minZoom;
+            ZoomLevel maxZoom;
+        };
+        typedef QuadTree< std::shared_ptr<const IndexedSection>, AreaI::CoordType > SectionsTree;
+        enum {
+            ObfDataTypesCount = static_cast<int>(ObfDataType::Transport) + 1,
+        };
+        mutable std::array<SectionsTree, ObfDataTypesCount> _sectionsTrees;
+        mutable QHash< std::shared_ptr<const ObfFile>, QList< std::shared_ptr<const IndexedSection> > > _indexedObfFiles;
+        mutable QSet< std::shared_ptr<const ObfFile> > _unindexedObfFiles;
+        mutable QReadWriteLock _sectionsIndexLock;
+        bool indexObfFile(const std::shared_ptr<const ObfFile>& obfFile) const;
+        void unindexObfFile(const std::shared_ptr<const ObfFile>& obfFile) const;
+        void selectObfFiles(
+            const AreaI* const pBbox31,
+            const ZoomLevel minZoomLevel,
+            const ZoomLevel maxZoomLevel,
+            const ObfDataTypesMask desiredDataTypes,
+            QList< std::shared_ptr<const ObfFile> >& outIndexedObfFiles,
+            QList< std::shared_ptr<const ObfFile> >& outUnindexedObfFiles) const;
+
+        const std::shared_ptr<ObfReadersPool> _readersPool;
+        ObfDataInterface::ObtainReaderFunction getReadersPoolSource() const;
     public:
         virtual ~ObfsCollection_P();
 
@@ -98,6 +130,15 @@ namespace OsmAnd
         void setIndexCacheFile(const QFileInfo& indexCacheFile);
         bool remove(const ObfsCollection::SourceOriginId entryId);
 
+        int getMaxIdleReadersPerFile() const;
+        void setMaxIdleReadersPerFile(const int maxIdleReadersPerFile);
+        ObfsCollection::ReadersPoolStatistics getReadersPoolStatistics() const;
+        void resetReadersPoolStatistics();
+        void clearReadersPool();
+
+        bool getUseSharedMemoryMapping() const;
+        void setUseSharedMemoryMapping(const bool useSharedMemoryMapping);
+
         QList< std::shared_ptr<const ObfFile> > getObfFiles() const;
         std::shared_ptr<OsmAnd::ObfDataInterface> obtainDataInterface(
             const std::shared_ptr<const ObfFile> obfFile) const;
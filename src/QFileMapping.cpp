@@ -0,0 +1,122 @@
+#include "QFileMapping.h"
+
+#if !defined(Q_OS_WIN)
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif // !defined(Q_OS_WIN)
+
+#include "Logging.h"
+
+OsmAnd::QFileMapping::QFileMapping(const QString& filePath)
+    : _file(filePath)
+    , _mappedMemory(nullptr)
+    , _size(0)
+{
+    if (!_file.open(QIODevice::ReadOnly))
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "Failed to open '%s' for mapping: (%d) %s",
+            qPrintable(_file.fileName()),
+            static_cast<int>(_file.error()),
+            qPrintable(_file.errorString()));
+        return;
+    }
+
+    _size = _file.size();
+    if (_size <= 0)
+        return;
+
+    _mappedMemory = _file.map(0, _size);
+    if (!_mappedMemory)
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "Failed to map %" PRIi64 " bytes of '%s' (handle 0x%08x) into memory: (%d) %s",
+            _size,
+            qPrintable(_file.fileName()),
+            _file.handle(),
+            static_cast<int>(_file.error()),
+            qPrintable(_file.errorString()));
+        _size = 0;
+        return;
+    }
+}
+
+OsmAnd::QFileMapping::~QFileMapping()
+{
+    if (_mappedMemory)
+    {
+        if (!_file.unmap(_mappedMemory))
+        {
+            LogPrintf(LogSeverityLevel::Warning,
+                "Failed to unmap memory %p of '%s': (%d) %s",
+                _mappedMemory,
+                qPrintable(_file.fileName()),
+                static_cast<int>(_file.error()),
+                qPrintable(_file.errorString()));
+        }
+        _mappedMemory = nullptr;
+    }
+
+    if (_file.isOpen())
+        _file.close();
+}
+
+bool OsmAnd::QFileMapping::isMapped() const
+{
+    return _mappedMemory != nullptr;
+}
+
+const uint8_t* OsmAnd::QFileMapping::data() const
+{
+    return _mappedMemory;
+}
+
+qint64 OsmAnd::QFileMapping::size() const
+{
+    return _size;
+}
+
+QString OsmAnd::QFileMapping::fileName() const
+{
+    return _file.fileName();
+}
+
+bool OsmAnd::QFileMapping::advise(const AccessPattern accessPattern) const
+{
+    return advise(0, _size, accessPattern);
+}
+
+bool OsmAnd::QFileMapping::advise(const qint64 offset, const qint64 length, const AccessPattern accessPattern) const
+{
+    if (!_mappedMemory || offset < 0 || length <= 0 || offset >= _size)
+        return false;
+
+#if !defined(Q_OS_WIN)
+    int advice = POSIX_MADV_NORMAL;
+    switch (accessPattern)
+    {
+        case AccessPattern::Normal:
+            advice = POSIX_MADV_NORMAL;
+            break;
+        case AccessPattern::Random:
+            advice = POSIX_MADV_RANDOM;
+            break;
+        case AccessPattern::Sequential:
+            advice = POSIX_MADV_SEQUENTIAL;
+            break;
+        case AccessPattern::WillNeed:
+            advice = POSIX_MADV_WILLNEED;
+            break;
+    }
+
+    // Advised range has to start at page boundary
+    static const qint64 pageSize = static_cast<qint64>(sysconf(_SC_PAGESIZE));
+    const auto alignedOffset = offset - (offset % pageSize);
+    const auto alignedLength = qMin(offset + length, _size) - alignedOffset;
+
+    return posix_madvise(_mappedMemory + alignedOffset, static_cast<size_t>(alignedLength), advice) == 0;
+#else
+    Q_UNUSED(accessPattern);
+    return false;
+#endif // !defined(Q_OS_WIN)
+}
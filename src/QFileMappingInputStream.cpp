@@ -0,0 +1,70 @@
+#include "QFileMappingInputStream.h"
+
+#include <limits>
+
+namespace OsmAnd
+{
+    namespace gpb = google::protobuf;
+}
+
+OsmAnd::QFileMappingInputStream::QFileMappingInputStream(
+    const std::shared_ptr<const QFileMapping>& mapping_,
+    const size_t sliceSize_ /*= DefaultSliceSize*/)
+    : _mapping(mapping_)
+    , _size(_mapping->size())
+    , _sliceSize(qMin<qint64>(static_cast<qint64>(sliceSize_), std::numeric_limits<int>::max()))
+    , _currentPosition(0)
+    , mapping(_mapping)
+{
+}
+
+OsmAnd::QFileMappingInputStream::~QFileMappingInputStream()
+{
+}
+
+bool OsmAnd::QFileMappingInputStream::Next(const void** data, int* size)
+{
+    // Check if current position is in valid range
+    if (Q_UNLIKELY(_currentPosition < 0 || _currentPosition >= _size || !_mapping->isMapped()))
+    {
+        *data = nullptr;
+        *size = 0;
+        return false;
+    }
+
+    // No copying or mapping here, just hand out next portion of already mapped memory
+    auto sliceSize = _sliceSize;
+    if (_currentPosition + sliceSize >= _size)
+        sliceSize = _size - _currentPosition;
+
+    *data = _mapping->data() + _currentPosition;
+    *size = static_cast<int>(sliceSize);
+
+    _currentPosition += sliceSize;
+    return true;
+}
+
+void OsmAnd::QFileMappingInputStream::BackUp(int count)
+{
+    if (count > _currentPosition)
+        _currentPosition = 0;
+    else
+        _currentPosition -= count;
+}
+
+bool OsmAnd::QFileMappingInputStream::Skip(int count)
+{
+    if (Q_UNLIKELY(_currentPosition + count >= _size))
+    {
+        _currentPosition = _size;
+        return false;
+    }
+
+    _currentPosition += count;
+    return true;
+}
+
+OsmAnd::gpb::int64 OsmAnd::QFileMappingInputStream::ByteCount() const
+{
+    return static_cast<gpb::int64>(_currentPosition);
+}
@@ -2,11 +2,13 @@
 
 #include "ObfDataInterface.h"
 #include "ObfAddressSectionReader.h"
+#include "ObfAddressSectionInfo.h"
 #include "Address.h"
 #include "Building.h"
 #include "Street.h"
 #include "StreetGroup.h"
 #include "StreetIntersection.h"
+#include "Utilities.h"
 
 OsmAnd::AddressesByNameSearch::AddressesByNameSearch(const std::shared_ptr<const IObfsCollection>& obfsCollection_)
     : BaseSearch(obfsCollection_)
@@ -26,6 +28,33 @@ void OsmAnd::AddressesByNameSearch::performSearch(
 
     const auto dataInterface = criteria.localResources.isEmpty() ? obfsCollection->obtainDataInterface(
         criteria.obfInfoAreaFilter.getValuePtrOrNullptr(), MinZoomLevel, MaxZoomLevel, ObfDataTypesMask().set(ObfDataType::Address)) : obfsCollection->obtainDataInterface(criteria.localResources);
+    dataInterface->setParallelReadingEnabled(criteria.parallelReading);
+
+    // Squared distances of reported results that are still among nearest ones, in ascending order.
+    // Visitors and filters are never called concurrently, so these are not guarded.
+    const auto limitNearestResults = criteria.xy31 && criteria.nearestResultsLimit > 0;
+    QVector<double> nearestResultsDistances;
+    const auto acceptNearestResult =
+        [&criteria, limitNearestResults, &nearestResultsDistances]
+        (const std::shared_ptr<const Address>& address) -> bool
+        {
+            if (!limitNearestResults)
+                return true;
+
+            const auto distance = Utilities::squareDistance31(*criteria.xy31, address->position31);
+            if (nearestResultsDistances.size() >= criteria.nearestResultsLimit)
+            {
+                if (distance >= nearestResultsDistances.last())
+                    return false;
+                nearestResultsDistances.removeLast();
+            }
+            const auto itInsertion = std::upper_bound(
+                nearestResultsDistances.begin(),
+                nearestResultsDistances.end(),
+                distance);
+            nearestResultsDistances.insert(itInsertion, distance);
+            return true;
+        };
 
     if (criteria.addressFilter != nullptr)
     {
@@ -35,7 +64,7 @@ void OsmAnd::AddressesByNameSearch::performSearch(
             case AddressType::StreetGroup:
             {
                 const ObfAddressSectionReader::StreetVisitorFunction visitorFunction =
-                [this, newResultEntryCallback, criteria_, criteria, &stringMatcher]
+                [this, newResultEntryCallback, criteria_, criteria, &stringMatcher, &acceptNearestResult]
                 (const std::shared_ptr<const OsmAnd::Street>& street) -> bool
                 {
                     bool accept = criteria.name.isEmpty();
@@ -47,7 +76,7 @@ void OsmAnd::AddressesByNameSearch::performSearch(
                             break;
                     }
                     
-                    if (accept)
+                    if (accept && acceptNearestResult(street))
                     {
                         ResultEntry resultEntry;
                         resultEntry.address = street;
@@ -74,7 +103,7 @@ void OsmAnd::AddressesByNameSearch::performSearch(
             case AddressType::Street:
             {
                 const ObfAddressSectionReader::BuildingVisitorFunction visitorFunction =
-                [this, newResultEntryCallback, criteria_, criteria, &stringMatcher]
+                [this, newResultEntryCallback, criteria_, criteria, &stringMatcher, &acceptNearestResult]
                 (const std::shared_ptr<const OsmAnd::Building>& building) -> bool
                 {
                     bool accept = true;
@@ -93,7 +122,7 @@ void OsmAnd::AddressesByNameSearch::performSearch(
                         }
                     }
                     
-                    if (accept)
+                    if (accept && acceptNearestResult(building))
                     {
                         ResultEntry resultEntry;
                         resultEntry.address = building;
@@ -117,7 +146,7 @@ void OsmAnd::AddressesByNameSearch::performSearch(
                 
                 
                 const ObfAddressSectionReader::IntersectionVisitorFunction intersectionVisitorFunction =
-                [this, newResultEntryCallback, criteria_, criteria, &stringMatcher]
+                [this, newResultEntryCallback, criteria_, criteria, &stringMatcher, &acceptNearestResult]
                 (const std::shared_ptr<const OsmAnd::StreetIntersection>& intersection) -> bool
                 {
                     bool accept = criteria.name.isEmpty();
@@ -129,7 +158,7 @@ void OsmAnd::AddressesByNameSearch::performSearch(
                             break;
                     }
                     
-                    if (accept)
+                    if (accept && acceptNearestResult(intersection))
                     {
                         ResultEntry resultEntry;
                         resultEntry.address = intersection;
@@ -156,16 +185,33 @@ void OsmAnd::AddressesByNameSearch::performSearch(
     else
     {
         const ObfAddressSectionReader::VisitorFunction visitorFunction =
-        [newResultEntryCallback, criteria_]
+        [newResultEntryCallback, criteria_, &acceptNearestResult]
         (const std::shared_ptr<const OsmAnd::Address>& address) -> bool
         {
+            if (!acceptNearestResult(address))
+                return false;
+
             ResultEntry resultEntry;
             resultEntry.address = address;
             newResultEntryCallback(criteria_, resultEntry);
             
             return true;
         };
-        
+
+        ObfDataInterface::AddressSectionFilterFunction sectionFilter;
+        if (limitNearestResults)
+        {
+            sectionFilter =
+                [&criteria, &nearestResultsDistances]
+                (const std::shared_ptr<const ObfAddressSectionInfo>& addressSection) -> bool
+                {
+                    // Section is skipped once it can't contain results nearer than already found ones
+                    return nearestResultsDistances.size() < criteria.nearestResultsLimit
+                        || Utilities::squareDistance31(*criteria.xy31, addressSection->area31)
+                            < nearestResultsDistances.last();
+                };
+        }
+
         dataInterface->scanAddressesByName(
                                            criteria.name,
                                            criteria.matcherMode,
@@ -175,7 +221,9 @@ void OsmAnd::AddressesByNameSearch::performSearch(
                                            criteria.includeStreets,
                                            criteria.strictMatch,
                                            visitorFunction,
-                                           queryController);
+                                           queryController,
+                                           criteria.xy31.getValuePtrOrNullptr(),
+                                           sectionFilter);
     }
 }
 
@@ -188,6 +236,24 @@ QVector<OsmAnd::AddressesByNameSearch::ResultEntry> OsmAnd::AddressesByNameSearc
                 [&result](const OsmAnd::ISearch::Criteria& criteria, const OsmAnd::BaseSearch::IResultEntry& resultEntry) {
         result.append(static_cast<const ResultEntry&>(resultEntry));
     });
+
+    // Results that were reported before nearer ones were found are dropped
+    if (criteria.xy31 && criteria.nearestResultsLimit > 0)
+    {
+        const auto xy31 = *criteria.xy31;
+        std::stable_sort(
+            result.begin(),
+            result.end(),
+            [xy31]
+            (const ResultEntry& l, const ResultEntry& r) -> bool
+            {
+                return Utilities::squareDistance31(xy31, l.address->position31)
+                    < Utilities::squareDistance31(xy31, r.address->position31);
+            });
+        if (result.size() > criteria.nearestResultsLimit)
+            result.resize(criteria.nearestResultsLimit);
+    }
+
     return result;
 
 }
@@ -197,6 +263,8 @@ OsmAnd::AddressesByNameSearch::Criteria::Criteria()
     , includeStreets(true)
     , matcherMode(StringMatcherMode::CHECK_STARTS_FROM_SPACE)
     , strictMatch(false)
+    , nearestResultsLimit(0)
+    , parallelReading(false)
 {
 }
 
@@ -0,0 +1,39 @@
+#include "NameSearchSession.h"
+#include "NameSearchSession_P.h"
+
+OsmAnd::NameSearchSession::NameSearchSession(
+    const std::shared_ptr<const AmenitiesByNameSearch>& search_,
+    const AmenitiesByNameSearch::Criteria& criteria,
+    const int maxKeptResults_ /*= DefaultMaxKeptResults*/)
+    : _p(new NameSearchSession_P(this, criteria))
+    , search(search_)
+    , maxKeptResults(maxKeptResults_)
+{
+}
+
+OsmAnd::NameSearchSession::NameSearchSession(
+    const std::shared_ptr<const AddressesByNameSearch>& search_,
+    const AddressesByNameSearch::Criteria& criteria,
+    const int maxKeptResults_ /*= DefaultMaxKeptResults*/)
+    : _p(new NameSearchSession_P(this, criteria))
+    , search(search_)
+    , maxKeptResults(maxKeptResults_)
+{
+}
+
+OsmAnd::NameSearchSession::~NameSearchSession()
+{
+}
+
+bool OsmAnd::NameSearchSession::performSearch(
+    const QString& name,
+    const ISearch::NewResultEntryCallback newResultEntryCallback,
+    const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/)
+{
+    return _p->performSearch(name, newResultEntryCallback, queryController);
+}
+
+void OsmAnd::NameSearchSession::reset()
+{
+    _p->reset();
+}
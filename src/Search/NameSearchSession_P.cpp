@@ -0,0 +1,217 @@
+#include "NameSearchSession_P.h"
+#include "NameSearchSession.h"
+
+#include "Amenity.h"
+#include "Address.h"
+#include "CollatorStringMatcher.h"
+#include "FunctorQueryController.h"
+#include "IQueryController.h"
+
+OsmAnd::NameSearchSession_P::NameSearchSession_P(
+    NameSearchSession* const owner_,
+    const AmenitiesByNameSearch::Criteria& criteria)
+    : _amenitiesCriteria(new AmenitiesByNameSearch::Criteria(criteria))
+    , _canNarrowResults(true)
+    , _hasKeptResults(false)
+    , owner(owner_)
+{
+}
+
+OsmAnd::NameSearchSession_P::NameSearchSession_P(
+    NameSearchSession* const owner_,
+    const AddressesByNameSearch::Criteria& criteria)
+    : _addressesCriteria(new AddressesByNameSearch::Criteria(criteria))
+    , _canNarrowResults(
+        criteria.postcode.isEmpty() &&
+        criteria.matcherMode != StringMatcherMode::CHECK_EQUALS &&
+        criteria.matcherMode != StringMatcherMode::CHECK_EQUALS_FROM_SPACE &&
+        !(criteria.xy31 && criteria.nearestResultsLimit > 0))
+    , _hasKeptResults(false)
+    , owner(owner_)
+{
+}
+
+OsmAnd::NameSearchSession_P::~NameSearchSession_P()
+{
+}
+
+std::shared_ptr<const OsmAnd::ISearch::Criteria> OsmAnd::NameSearchSession_P::makeCriteria(const QString& name) const
+{
+    if (_amenitiesCriteria)
+    {
+        const std::shared_ptr<AmenitiesByNameSearch::Criteria> criteria(
+            new AmenitiesByNameSearch::Criteria(*_amenitiesCriteria));
+        criteria->name = name;
+        return criteria;
+    }
+
+    const std::shared_ptr<AddressesByNameSearch::Criteria> criteria(
+        new AddressesByNameSearch::Criteria(*_addressesCriteria));
+    criteria->name = name;
+    return criteria;
+}
+
+bool OsmAnd::NameSearchSession_P::performSearch(
+    const QString& name,
+    const ISearch::NewResultEntryCallback newResultEntryCallback,
+    const std::shared_ptr<const IQueryController>& queryController)
+{
+    const auto searchId = _searchId.fetchAndAddOrdered(1) + 1;
+    const auto isAborted =
+        [this, searchId, queryController]
+        () -> bool
+        {
+            return _searchId.loadAcquire() != searchId || (queryController && queryController->isAborted());
+        };
+
+    const auto criteria = makeCriteria(name);
+
+    bool narrowResults = false;
+    QList< std::shared_ptr<const Amenity> > amenities;
+    QList< std::shared_ptr<const Address> > addresses;
+    {
+        QMutexLocker scopedLocker(&_keptResultsMutex);
+
+        if (_canNarrowResults && _hasKeptResults && name.startsWith(_keptResultsName))
+        {
+            narrowResults = true;
+            amenities = _keptAmenities;
+            addresses = _keptAddresses;
+        }
+    }
+
+    if (narrowResults)
+    {
+        // Names are matched same way as readers of OBF sections do
+        const CollatorStringMatcher stringMatcher(
+            name,
+            _amenitiesCriteria ? StringMatcherMode::CHECK_STARTS_FROM_SPACE : _addressesCriteria->matcherMode);
+        const auto matches =
+            [&stringMatcher]
+            (const QString& nativeName, const QHash<QString, QString>& localizedNames) -> bool
+            {
+                if (stringMatcher.matches(nativeName))
+                    return true;
+                for (const auto& localizedName : constOf(localizedNames))
+                {
+                    if (stringMatcher.matches(localizedName))
+                        return true;
+                }
+                return false;
+            };
+
+        QList< std::shared_ptr<const Amenity> > narrowedAmenities;
+        for (const auto& amenity : constOf(amenities))
+        {
+            if (isAborted())
+                return false;
+
+            auto accept = matches(amenity->nativeName, amenity->localizedNames);
+            for (const auto& additionalName : constOf(amenity->additionalNames))
+            {
+                if (accept)
+                    break;
+                accept = stringMatcher.matches(additionalName);
+            }
+            if (!accept)
+                continue;
+
+            narrowedAmenities.push_back(amenity);
+
+            AmenitiesByNameSearch::ResultEntry resultEntry;
+            resultEntry.amenity = amenity;
+            newResultEntryCallback(*criteria, resultEntry);
+        }
+
+        QList< std::shared_ptr<const Address> > narrowedAddresses;
+        for (const auto& address : constOf(addresses))
+        {
+            if (isAborted())
+                return false;
+
+            if (!matches(address->nativeName, address->localizedNames))
+                continue;
+
+            narrowedAddresses.push_back(address);
+
+            AddressesByNameSearch::ResultEntry resultEntry;
+            resultEntry.address = address;
+            newResultEntryCallback(*criteria, resultEntry);
+        }
+
+        keepResults(searchId, name, true, narrowedAmenities, narrowedAddresses);
+        return true;
+    }
+
+    // Results are kept as they come, unless there are too many of them
+    auto complete = true;
+    const auto maxKeptResults = owner->maxKeptResults;
+    const ISearch::NewResultEntryCallback keepingCallback =
+        [isAborted, newResultEntryCallback, maxKeptResults, &complete, &amenities, &addresses]
+        (const ISearch::Criteria& criteria, const ISearch::IResultEntry& resultEntry_)
+        {
+            if (isAborted())
+                return;
+
+            if (complete && amenities.size() + addresses.size() >= maxKeptResults)
+            {
+                complete = false;
+                amenities.clear();
+                addresses.clear();
+            }
+            if (complete)
+            {
+                if (const auto amenityEntry = dynamic_cast<const AmenitiesByNameSearch::ResultEntry*>(&resultEntry_))
+                    amenities.push_back(amenityEntry->amenity);
+                else if (const auto addressEntry = dynamic_cast<const AddressesByNameSearch::ResultEntry*>(&resultEntry_))
+                    addresses.push_back(addressEntry->address);
+            }
+
+            newResultEntryCallback(criteria, resultEntry_);
+        };
+    const std::shared_ptr<const IQueryController> searchQueryController(new FunctorQueryController(
+        [isAborted]
+        (const FunctorQueryController* const queryController) -> bool
+        {
+            Q_UNUSED(queryController);
+            return isAborted();
+        }));
+    owner->search->performSearch(*criteria, keepingCallback, searchQueryController);
+    if (isAborted())
+        return false;
+
+    keepResults(searchId, name, complete, amenities, addresses);
+    return true;
+}
+
+void OsmAnd::NameSearchSession_P::keepResults(
+    const int searchId,
+    const QString& name,
+    const bool complete,
+    const QList< std::shared_ptr<const Amenity> >& amenities,
+    const QList< std::shared_ptr<const Address> >& addresses)
+{
+    QMutexLocker scopedLocker(&_keptResultsMutex);
+
+    // Results of superseded search are of no use
+    if (_searchId.loadAcquire() != searchId)
+        return;
+
+    _hasKeptResults = complete;
+    _keptResultsName = name;
+    _keptAmenities = complete ? amenities : QList< std::shared_ptr<const Amenity> >();
+    _keptAddresses = complete ? addresses : QList< std::shared_ptr<const Address> >();
+}
+
+void OsmAnd::NameSearchSession_P::reset()
+{
+    // Search that may be running is superseded as well
+    _searchId.fetchAndAddOrdered(1);
+
+    QMutexLocker scopedLocker(&_keptResultsMutex);
+
+    _hasKeptResults = false;
+    _keptResultsName.clear();
+    _keptAmenities.clear();
+    _keptAddresses.clear();
+}
@@ -0,0 +1,71 @@
+#ifndef _OSMAND_CORE_NAME_SEARCH_SESSION_P_H_
+#define _OSMAND_CORE_NAME_SEARCH_SESSION_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QAtomicInt>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "PrivateImplementation.h"
+#include "AmenitiesByNameSearch.h"
+#include "AddressesByNameSearch.h"
+
+namespace OsmAnd
+{
+    class Amenity;
+    class Address;
+    class IQueryController;
+
+    class NameSearchSession;
+    class NameSearchSession_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(NameSearchSession_P);
+    private:
+        // Only one of these is set, according to type of search
+        const std::shared_ptr<const AmenitiesByNameSearch::Criteria> _amenitiesCriteria;
+        const std::shared_ptr<const AddressesByNameSearch::Criteria> _addressesCriteria;
+        // Results of extended name are subset of results of name, unless names are matched exactly or only
+        // nearest results are kept (then nearer ones may appear that were pushed out before)
+        const bool _canNarrowResults;
+
+        // Identifier of latest search, which supersedes all previous ones
+        QAtomicInt _searchId;
+
+        mutable QMutex _keptResultsMutex;
+        bool _hasKeptResults;
+        QString _keptResultsName;
+        QList< std::shared_ptr<const Amenity> > _keptAmenities;
+        QList< std::shared_ptr<const Address> > _keptAddresses;
+
+        std::shared_ptr<const ISearch::Criteria> makeCriteria(const QString& name) const;
+        void keepResults(
+            const int searchId,
+            const QString& name,
+            const bool complete,
+            const QList< std::shared_ptr<const Amenity> >& amenities,
+            const QList< std::shared_ptr<const Address> >& addresses);
+    protected:
+        NameSearchSession_P(NameSearchSession* const owner, const AmenitiesByNameSearch::Criteria& criteria);
+        NameSearchSession_P(NameSearchSession* const owner, const AddressesByNameSearch::Criteria& criteria);
+    public:
+        ~NameSearchSession_P();
+
+        ImplementationInterface<NameSearchSession> owner;
+
+        bool performSearch(
+            const QString& name,
+            const ISearch::NewResultEntryCallback newResultEntryCallback,
+            const std::shared_ptr<const IQueryController>& queryController);
+        void reset();
+
+    friend class OsmAnd::NameSearchSession;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_NAME_SEARCH_SESSION_P_H_)
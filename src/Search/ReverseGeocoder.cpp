@@ -38,6 +38,13 @@ std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry> OsmAnd::ReverseGeoco
     return result;
 }
 
+QVector<std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry>> OsmAnd::ReverseGeocoder::reverseGeocode(
+    const QVector<LatLon>& points,
+    const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/) const
+{
+    return _p->reverseGeocode(points, queryController);
+}
+
 OsmAnd::ReverseGeocoder::ResultEntry::ResultEntry()
 {
 }
@@ -1,17 +1,23 @@
 #include "ReverseGeocoder_P.h"
 
-#include "AddressesByNameSearch.h"
 #include "Building.h"
 #include "Logging.h"
 #include "ObfDataInterface.h"
+#include "ObfReader.h"
+#include "ObfInfo.h"
+#include "ObfAddressSectionInfo.h"
+#include "ObfAddressSectionReader.h"
 #include "Road.h"
 #include "Utilities.h"
+#include "AddressesByNameSearch.h"
 
 #include <OsmAndCore/Data/ObfRoutingSectionReader.h>
 #include <OsmAndCore/Search/CommonWords.h>
 
 #include <QStringBuilder>
 
+#include <limits>
+
 //
 //  OsmAnd-java/src/net/osmand/binary/GeocodingUtilities.java
 //  git revision c0fc23f823862a2290e84577b6a944e49cc87c33
@@ -28,6 +34,12 @@ const float DISTANCE_STREET_NAME_PROXIMITY_BY_NAME = 15000;
 const float THRESHOLD_MULTIPLIER_SKIP_BUILDINGS_AFTER = 1.5f;
 const float DISTANCE_BUILDING_PROXIMITY = 100;
 
+// Points of batch are processed by tiles of this zoom, so that nearby points reuse same streets found by name
+const OsmAnd::ZoomLevel BATCH_TILE_ZOOM = OsmAnd::ZoomLevel10;
+// Costs are in kilobytes of streets found by name, and in number of cached buildings
+const int TILES_STREETS_MAX_COST = 64 * 1024;
+const int STREETS_BUILDINGS_MAX_COST = 256 * 1024;
+
 OsmAnd::ReverseGeocoder_P::ReverseGeocoder_P(
         OsmAnd::ReverseGeocoder* owner_,
         const std::shared_ptr<const OsmAnd::IRoadLocator> &roadLocator_)
@@ -35,7 +47,8 @@ OsmAnd::ReverseGeocoder_P::ReverseGeocoder_P(
     , roadLocator(roadLocator_)
     , addressByNameSearch(std::make_shared<AddressesByNameSearch>(owner_->obfsCollection))
 {
-
+    _tilesStreets.setMaxCost(TILES_STREETS_MAX_COST);
+    _streetsBuildings.setMaxCost(STREETS_BUILDINGS_MAX_COST);
 }
 
 OsmAnd::ReverseGeocoder_P::~ReverseGeocoder_P()
@@ -52,11 +65,49 @@ void OsmAnd::ReverseGeocoder_P::performSearch(
     if (!criteria.latLon.isSet() && !criteria.position31.isSet())
         return;
     auto searchPoint = criteria.latLon.isSet() ? *criteria.latLon : Utilities::convert31ToLatLon(*criteria.position31);
-    QVector<std::shared_ptr<const ResultEntry>> roads = reverseGeocodeToRoads(searchPoint);
-    std::shared_ptr<const ResultEntry> result = justifyResult(roads);
+    std::shared_ptr<const ResultEntry> result = reverseGeocode(searchPoint);
     newResultEntryCallback(criteria, *result);
 }
 
+QVector<std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry>> OsmAnd::ReverseGeocoder_P::reverseGeocode(
+    const QVector<LatLon>& points,
+    const std::shared_ptr<const IQueryController>& queryController /*= nullptr*/) const
+{
+    QVector<std::shared_ptr<const ResultEntry>> results(points.size());
+
+    // Points are ordered by tile of batch, and by much smaller tile within it
+    const auto batchShift = ZoomLevel31 - BATCH_TILE_ZOOM;
+    const auto localShift = ZoomLevel31 - ZoomLevel16;
+    QVector< std::pair< std::pair<uint64_t, uint64_t>, int > > orderedPoints;
+    orderedPoints.reserve(points.size());
+    for (auto pointIndex = 0; pointIndex < points.size(); pointIndex++)
+    {
+        const auto point31 = Utilities::convertLatLonTo31(points[pointIndex]);
+        const auto batchTileId = TileId::fromXY(point31.x >> batchShift, point31.y >> batchShift);
+        const auto localTileId = TileId::fromXY(point31.x >> localShift, point31.y >> localShift);
+        orderedPoints.push_back({ { batchTileId.id, localTileId.id }, pointIndex });
+    }
+    std::sort(orderedPoints.begin(), orderedPoints.end());
+
+    for (const auto& orderedPoint : constOf(orderedPoints))
+    {
+        if (queryController && queryController->isAborted())
+            break;
+
+        const auto pointIndex = orderedPoint.second;
+        results[pointIndex] = reverseGeocode(points[pointIndex]);
+    }
+
+    return results;
+}
+
+std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry> OsmAnd::ReverseGeocoder_P::reverseGeocode(
+    const LatLon searchPoint) const
+{
+    QVector<std::shared_ptr<const ResultEntry>> roads = reverseGeocodeToRoads(searchPoint);
+    return justifyResult(roads);
+}
+
 bool OsmAnd::ReverseGeocoder_P::DISTANCE_COMPARATOR(
         const std::shared_ptr<const ResultEntry>& a,
         const std::shared_ptr<const ResultEntry>& b)
@@ -120,6 +171,22 @@ QString extractMainWord(const QStringList &streetNamesUsed)
     return mainWord;
 }
 
+QString getStreetNameKey(const QStringList &streetNamesUsed, bool addCommonWords)
+{
+    // Words never contain spaces, so joined words are equal only if lists of words are equal
+    return QString(addCommonWords ? QLatin1Char('+') : QLatin1Char('-')) % streetNamesUsed.join(QLatin1Char(' '));
+}
+
+OsmAnd::AreaI getBBox31(const double radius, const OsmAnd::PointI& position31)
+{
+    const auto bbox64 = OsmAnd::Utilities::boundingBox31FromAreaInMeters(radius, position31);
+    return OsmAnd::AreaI(
+        static_cast<int32_t>(qBound<int64_t>(0, bbox64.top(), std::numeric_limits<int32_t>::max())),
+        static_cast<int32_t>(qBound<int64_t>(0, bbox64.left(), std::numeric_limits<int32_t>::max())),
+        static_cast<int32_t>(qBound<int64_t>(0, bbox64.bottom(), std::numeric_limits<int32_t>::max())),
+        static_cast<int32_t>(qBound<int64_t>(0, bbox64.right(), std::numeric_limits<int32_t>::max())));
+}
+
 QVector<std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry>> OsmAnd::ReverseGeocoder_P::justifyReverseGeocodingSearch(
         const std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry>& road,
         double knownMinBuildingDistance) const
@@ -134,44 +201,25 @@ QVector<std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry>> OsmAnd::Rev
         addCommonWords = true;
         streetNamesUsed = prepareStreetName(road->streetName, addCommonWords);
     }
-    if (!streetNamesUsed.isEmpty())
+    if (!streetNamesUsed.isEmpty() && road->searchPoint31().isSet())
     {
-        QString mainWord = extractMainWord(streetNamesUsed);
-        OsmAnd::AddressesByNameSearch::Criteria criteria;
-        criteria.name = mainWord;
-        criteria.includeStreets = true;
-        criteria.strictMatch = true;
-        criteria.streetGroupTypesMask = ObfAddressStreetGroupTypesMask().set(ObfAddressStreetGroupType::CityOrTown);
-        criteria.bbox31 = Nullable<AreaI>((AreaI)Utilities::boundingBox31FromAreaInMeters(DISTANCE_STREET_NAME_PROXIMITY_BY_NAME, *road->searchPoint31()));
-        addressByNameSearch->performSearch(
-                    criteria,
-                    [&streetList, addCommonWords, streetNamesUsed, road](const OsmAnd::ISearch::Criteria& criteria,
-                    const OsmAnd::BaseSearch::IResultEntry& resultEntry) {
-            auto const& address = static_cast<const OsmAnd::AddressesByNameSearch::ResultEntry&>(resultEntry).address;
-            if (address->addressType == OsmAnd::AddressType::Street)
-            {
-                auto const& street = std::static_pointer_cast<const OsmAnd::Street>(address);
-                
-                if (prepareStreetName(street->nativeName, addCommonWords) == streetNamesUsed)
-                {
-                    if (road->searchPoint31().isSet())
-                    {
-                        double d = Utilities::distance(Utilities::convert31ToLatLon(street->position31), *road->searchPoint);
-                        if (d < DISTANCE_STREET_NAME_PROXIMITY_BY_NAME) {
-                            const std::shared_ptr<ResultEntry> rs = std::make_shared<ResultEntry>();
-                            rs->road = road->road;
-                            rs->street = street;
-                            rs->point = road->point;
-                            rs->streetGroup = street->streetGroup;
-                            rs->searchPoint = road->searchPoint;
-                            rs->connectionPoint = Utilities::convert31ToLatLon(street->position31);
-                            rs->setDistance(d);
-                            streetList.append(rs);
-                        }
-                    }
-                }
+        const auto streets = obtainStreets(
+            streetNamesUsed, addCommonWords, *road->searchPoint31(), DISTANCE_STREET_NAME_PROXIMITY_BY_NAME);
+        for (const auto& street : constOf(streets))
+        {
+            double d = Utilities::distance(Utilities::convert31ToLatLon(street->position31), *road->searchPoint);
+            if (d < DISTANCE_STREET_NAME_PROXIMITY_BY_NAME) {
+                const std::shared_ptr<ResultEntry> rs = std::make_shared<ResultEntry>();
+                rs->road = road->road;
+                rs->street = street;
+                rs->point = road->point;
+                rs->streetGroup = street->streetGroup;
+                rs->searchPoint = road->searchPoint;
+                rs->connectionPoint = Utilities::convert31ToLatLon(street->position31);
+                rs->setDistance(d);
+                streetList.append(rs);
             }
-        });
+        }
     }
 
     if (streetList.isEmpty())
@@ -217,12 +265,7 @@ QVector<std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry>> OsmAnd::Rev
         const std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry> street) const
 {
     QVector<std::shared_ptr<const ResultEntry>> result{};
-    const AreaI bbox = (AreaI)Utilities::boundingBox31FromAreaInMeters(DISTANCE_STREET_NAME_PROXIMITY_BY_NAME, *road->searchPoint31());
-    auto const& dataInterface = owner->obfsCollection->obtainDataInterface(&bbox);
-    QList<std::shared_ptr<const Street>> streets{street->street};
-    QHash<std::shared_ptr<const Street>, QList<std::shared_ptr<const Building>>> buildingsForStreet{};
-    dataInterface->loadBuildingsFromStreets(streets, &buildingsForStreet);
-    auto const& buildings = buildingsForStreet[street->street];
+    const auto buildings = obtainStreetBuildings(street->street, *road->searchPoint31());
     for (const std::shared_ptr<const Building> b : buildings)
     {
         auto makeResult = [b, street, &result](){
@@ -342,3 +385,117 @@ std::shared_ptr<const OsmAnd::ReverseGeocoder::ResultEntry> OsmAnd::ReverseGeoco
     std::sort(complete.begin(), complete.end(), DISTANCE_COMPARATOR);
     return !complete.isEmpty() ? complete[0] : std::make_shared<ResultEntry>();
 }
+
+QVector<std::shared_ptr<const OsmAnd::Street>> OsmAnd::ReverseGeocoder_P::obtainStreets(
+        const QStringList& streetNamesUsed,
+        const bool addCommonWords,
+        const PointI& position31,
+        const double radius) const
+{
+    // Streets are searched by name once for whole tile of batch extended by radius, so that they are exactly
+    // streets that name search would find for any point of that tile, once filtered by area around the point
+    const auto tileShift = ZoomLevel31 - BATCH_TILE_ZOOM;
+    const auto tileId = TileId::fromXY(position31.x >> tileShift, position31.y >> tileShift);
+    const TileStreetsKey key = { getStreetNameKey(streetNamesUsed, addCommonWords), tileId.id };
+
+    QVector<std::shared_ptr<const Street>> tileStreets;
+    bool found = false;
+    {
+        QMutexLocker scopedLocker(&_tilesStreetsMutex);
+        if (const auto pTileStreets = _tilesStreets.object(key))
+        {
+            tileStreets = *pTileStreets;
+            found = true;
+        }
+    }
+    if (!found)
+    {
+        const auto tileTopLeft31 = PointI(tileId.x << tileShift, tileId.y << tileShift);
+        const auto tileBottomRight31 = PointI(
+            static_cast<int32_t>(((static_cast<int64_t>(tileId.x) + 1) << tileShift) - 1),
+            static_cast<int32_t>(((static_cast<int64_t>(tileId.y) + 1) << tileShift) - 1));
+        const AreaI tileBBox31(
+            getBBox31(radius, tileTopLeft31).topLeft,
+            getBBox31(radius, tileBottomRight31).bottomRight);
+        tileStreets = findStreetsByName(streetNamesUsed, addCommonWords, tileBBox31);
+
+        size_t memorySize = 0;
+        for (const auto& street : constOf(tileStreets))
+        {
+            memorySize += sizeof(Street) + street->nativeName.size() * sizeof(QChar);
+            if (street->streetGroup)
+                memorySize += sizeof(StreetGroup) + street->streetGroup->nativeName.size() * sizeof(QChar);
+        }
+
+        // Streets that don't fit cache are still used by this lookup, and are searched by name again by next one
+        QMutexLocker scopedLocker(&_tilesStreetsMutex);
+        _tilesStreets.insert(
+            key,
+            new QVector<std::shared_ptr<const Street>>(tileStreets),
+            std::max(1, static_cast<int>(memorySize / 1024)));
+    }
+
+    const auto bbox31 = getBBox31(radius, position31);
+    QVector<std::shared_ptr<const Street>> result;
+    for (const auto& street : constOf(tileStreets))
+    {
+        if (bbox31.contains(street->position31))
+            result.push_back(street);
+    }
+    return result;
+}
+
+QVector<std::shared_ptr<const OsmAnd::Street>> OsmAnd::ReverseGeocoder_P::findStreetsByName(
+        const QStringList& streetNamesUsed,
+        const bool addCommonWords,
+        const AreaI& bbox31) const
+{
+    QVector<std::shared_ptr<const Street>> result{};
+
+    OsmAnd::AddressesByNameSearch::Criteria criteria;
+    criteria.name = extractMainWord(streetNamesUsed);
+    criteria.includeStreets = true;
+    criteria.strictMatch = true;
+    criteria.streetGroupTypesMask = ObfAddressStreetGroupTypesMask().set(ObfAddressStreetGroupType::CityOrTown);
+    criteria.bbox31 = Nullable<AreaI>(bbox31);
+    addressByNameSearch->performSearch(
+        criteria,
+        [&result, addCommonWords, &streetNamesUsed]
+        (const OsmAnd::ISearch::Criteria& criteria, const OsmAnd::BaseSearch::IResultEntry& resultEntry)
+        {
+            const auto& address = static_cast<const OsmAnd::AddressesByNameSearch::ResultEntry&>(resultEntry).address;
+            if (address->addressType != OsmAnd::AddressType::Street)
+                return;
+
+            const auto& street = std::static_pointer_cast<const OsmAnd::Street>(address);
+            if (prepareStreetName(street->nativeName, addCommonWords) == streetNamesUsed)
+                result.push_back(street);
+        });
+    return result;
+}
+
+QList<std::shared_ptr<const OsmAnd::Building>> OsmAnd::ReverseGeocoder_P::obtainStreetBuildings(
+        const std::shared_ptr<const Street>& street,
+        const PointI& position31) const
+{
+    const AddressKey key = { street->obfSection, street->offset };
+    {
+        QMutexLocker scopedLocker(&_streetsBuildingsMutex);
+        if (const auto pBuildings = _streetsBuildings.object(key))
+            return *pBuildings;
+    }
+
+    const AreaI bbox = (AreaI)Utilities::boundingBox31FromAreaInMeters(DISTANCE_STREET_NAME_PROXIMITY_BY_NAME, position31);
+    auto const& dataInterface = owner->obfsCollection->obtainDataInterface(&bbox);
+    QList<std::shared_ptr<const Street>> streets{street};
+    QHash<std::shared_ptr<const Street>, QList<std::shared_ptr<const Building>>> buildingsForStreet{};
+    dataInterface->loadBuildingsFromStreets(streets, &buildingsForStreet);
+    const auto buildings = buildingsForStreet.value(street);
+
+    QMutexLocker scopedLocker(&_streetsBuildingsMutex);
+    _streetsBuildings.insert(
+        key,
+        new QList<std::shared_ptr<const Building>>(buildings),
+        std::max(1, buildings.size()));
+    return buildings;
+}
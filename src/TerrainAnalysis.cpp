@@ -0,0 +1,351 @@
+#include "TerrainAnalysis.h"
+
+#include <cmath>
+
+#include "ignore_warnings_on_external_includes.h"
+#include <QtMath>
+#include <QRegularExpression>
+#include <QStringList>
+#include <cpl_vsi.h>
+#include "restore_internal_warnings.h"
+
+#include "QtCommon.h"
+
+#include "Logging.h"
+
+OsmAnd::TerrainAnalysis::TerrainAnalysis()
+{
+}
+
+OsmAnd::TerrainAnalysis::~TerrainAnalysis()
+{
+}
+
+inline float OsmAnd::TerrainAnalysis::approximateAtan(const float x)
+{
+    // Polynomial approximation for non-negative argument, with error about 1e-5 radians. Arguments above 1 are
+    // reduced by atan(x) = pi/2 - atan(1/x), selected without branches so that callers' loops can be vectorized.
+    const auto inverted = x > 1.0f;
+    const auto a = inverted ? 1.0f / x : x;
+    const auto aa = a * a;
+    const auto result =
+        a * (0.9998660f + aa * (-0.3302995f + aa * (0.1801410f + aa * (-0.0851330f + aa * 0.0208351f))));
+    return inverted ? 1.5707963f - result : result;
+}
+
+void OsmAnd::TerrainAnalysis::computeSlopeIndices(
+    const float* const pGradientsX,
+    const float* const pGradientsY,
+    const uint32_t count,
+    const float invResolutionX,
+    const float invResolutionY,
+    int32_t* const pSlopeIndices)
+{
+    const auto radiansToIndex = static_cast<float>(qRadiansToDegrees(1.0) * ColorTable::SlopeLookupTableResolution);
+    const auto maxIndex = static_cast<float>(ColorTable::SlopeLookupTableSize - 1);
+    for (uint32_t idx = 0; idx < count; idx++)
+    {
+        const auto x = pGradientsX[idx] * invResolutionX;
+        const auto y = pGradientsY[idx] * invResolutionY;
+        const auto slope = approximateAtan(std::sqrt(x * x + y * y) / 8.0f);
+
+        // Bounded, so that even NaN produces valid index
+        pSlopeIndices[idx] = static_cast<int32_t>(qBound(0.0f, slope * radiansToIndex + 0.5f, maxIndex));
+    }
+}
+
+void OsmAnd::TerrainAnalysis::computeGradients(
+    const float* const pHeights,
+    const uint32_t tileSize,
+    const uint32_t y,
+    const uint32_t x0,
+    const uint32_t count,
+    const float noData,
+    float* const pGradientsX,
+    float* const pGradientsY,
+    uint8_t* const pValid)
+{
+    std::fill(pGradientsX, pGradientsX + count, 0.0f);
+    std::fill(pGradientsY, pGradientsY + count, 0.0f);
+    std::fill(pValid, pValid + count, 0);
+
+    // Like GDAL (without -compute_edges), pixels at edges of heightmap have no value
+    if (y == 0 || y + 1 >= tileSize)
+        return;
+    const auto begin = std::max(x0, 1u);
+    const auto end = std::min(x0 + count, tileSize - 1);
+
+    // 3x3 window is:
+    //  a b c
+    //  d e f
+    //  g h i
+    const auto pTop = pHeights + (y - 1) * tileSize;
+    const auto pMiddle = pHeights + y * tileSize;
+    const auto pBottom = pHeights + (y + 1) * tileSize;
+    for (auto x = begin; x < end; x++)
+    {
+        const auto a = pTop[x - 1];
+        const auto b = pTop[x];
+        const auto c = pTop[x + 1];
+        const auto d = pMiddle[x - 1];
+        const auto e = pMiddle[x];
+        const auto f = pMiddle[x + 1];
+        const auto g = pBottom[x - 1];
+        const auto h = pBottom[x];
+        const auto i = pBottom[x + 1];
+
+        // Horn's formula, without division by resolution
+        const auto idx = x - x0;
+        pGradientsX[idx] = (a + d + d + g) - (c + f + f + i);
+        pGradientsY[idx] = (g + h + h + i) - (a + b + b + c);
+
+        // Branchless, so that loop can be vectorized
+        pValid[idx] = static_cast<uint8_t>(
+            (a != noData) & (b != noData) & (c != noData) &
+            (d != noData) & (e != noData) & (f != noData) &
+            (g != noData) & (h != noData) & (i != noData));
+    }
+}
+
+void OsmAnd::TerrainAnalysis::computeSlopeRaster(
+    const float* const pHeights,
+    const uint32_t tileSize,
+    const uint32_t overlap,
+    const PointD& resolution,
+    const float noData,
+    const ColorTable& colors,
+    uint8_t* const pOutRGBA)
+{
+    const auto resultOffset = overlap / 2;
+    const auto resultSize = tileSize - overlap;
+    const auto invResolutionX = static_cast<float>(1.0 / resolution.x);
+    const auto invResolutionY = static_cast<float>(1.0 / resolution.y);
+
+    // Slopes are quantized, so their colors are looked up in precomputed table
+    std::vector<std::array<uint8_t, 4>> colorsTable;
+    colors.buildSlopeLookupTable(colorsTable);
+
+    std::vector<float> gradientsX(resultSize);
+    std::vector<float> gradientsY(resultSize);
+    std::vector<int32_t> slopeIndices(resultSize);
+    std::vector<uint8_t> valid(resultSize);
+    auto pRGBA = pOutRGBA;
+    for (uint32_t row = 0; row < resultSize; row++)
+    {
+        computeGradients(pHeights, tileSize, resultOffset + row, resultOffset, resultSize, noData,
+            gradientsX.data(), gradientsY.data(), valid.data());
+        computeSlopeIndices(gradientsX.data(), gradientsY.data(), resultSize, invResolutionX, invResolutionY,
+            slopeIndices.data());
+
+        for (uint32_t col = 0; col < resultSize; col++, pRGBA += 4)
+        {
+            if (valid[col])
+                memcpy(pRGBA, colorsTable[slopeIndices[col]].data(), 4);
+            else
+                memcpy(pRGBA, colors.noDataColor.data(), 4);
+        }
+    }
+}
+
+void OsmAnd::TerrainAnalysis::computeHillshadeRaster(
+    const float* const pHeights,
+    const uint32_t tileSize,
+    const uint32_t overlap,
+    const PointD& resolution,
+    const float noData,
+    const ColorTable& slopeGrayscale,
+    const ColorTable& colors,
+    uint8_t* const pOutRGBA)
+{
+    const auto resultOffset = overlap / 2;
+    const auto resultSize = tileSize - overlap;
+    const auto invResolutionX = static_cast<float>(1.0 / resolution.x);
+    const auto invResolutionY = static_cast<float>(1.0 / resolution.y);
+
+    // Same as 'gdaldem hillshade -z 2': altitude 45, azimuth 315
+    const auto altitude = qDegreesToRadians(45.0);
+    const auto azimuth = qDegreesToRadians(315.0);
+    const auto zScaled = 2.0 / 8.0;
+    const auto sinAltitude = static_cast<float>(std::sin(altitude));
+    const auto sinAzimuthCosAltitudeZ = static_cast<float>(std::sin(azimuth) * std::cos(altitude) * zScaled);
+    const auto cosAzimuthCosAltitudeZ = static_cast<float>(std::cos(azimuth) * std::cos(altitude) * zScaled);
+    const auto squareZ = static_cast<float>(zScaled * zScaled);
+
+    // Blended values are bytes and slopes are quantized, so their colors are looked up in precomputed tables
+    std::array<std::array<uint8_t, 4>, 256> colorsTable;
+    colors.buildLookupTable(colorsTable);
+    std::vector<std::array<uint8_t, 4>> grayscaleTable;
+    slopeGrayscale.buildSlopeLookupTable(grayscaleTable);
+
+    std::vector<float> gradientsX(resultSize);
+    std::vector<float> gradientsY(resultSize);
+    std::vector<int32_t> slopeIndices(resultSize);
+    std::vector<float> shades(resultSize);
+    std::vector<uint8_t> valid(resultSize);
+    auto pRGBA = pOutRGBA;
+    for (uint32_t row = 0; row < resultSize; row++)
+    {
+        computeGradients(pHeights, tileSize, resultOffset + row, resultOffset, resultSize, noData,
+            gradientsX.data(), gradientsY.data(), valid.data());
+        computeSlopeIndices(gradientsX.data(), gradientsY.data(), resultSize, invResolutionX, invResolutionY,
+            slopeIndices.data());
+
+        for (uint32_t col = 0; col < resultSize; col++)
+        {
+            const auto x = gradientsX[col] * invResolutionX;
+            const auto y = gradientsY[col] * invResolutionY;
+            const auto xxPlusYY = x * x + y * y;
+
+            const auto cang = (sinAltitude - (y * cosAzimuthCosAltitudeZ - x * sinAzimuthCosAltitudeZ))
+                / std::sqrt(1.0f + squareZ * xxPlusYY);
+            shades[col] = cang <= 0.0f ? 1.0f : 1.0f + 254.0f * cang;
+        }
+
+        for (uint32_t col = 0; col < resultSize; col++, pRGBA += 4)
+        {
+            // Hillshade is modulated by grayscale of slope, same way as in blending of GDAL results
+            uint8_t blend = 0;
+            if (valid[col])
+            {
+                const auto grayscale = grayscaleTable[slopeIndices[col]][0];
+                const auto shade = static_cast<uint32_t>(shades[col] + 0.5f);
+                blend = static_cast<uint8_t>(((shade * grayscale) >> 8) + 1);
+            }
+            memcpy(pRGBA, colorsTable[blend].data(), 4);
+        }
+    }
+}
+
+OsmAnd::TerrainAnalysis::ColorTable::ColorTable()
+    : hasNoDataColor(false)
+{
+    noDataColor.fill(0);
+}
+
+void OsmAnd::TerrainAnalysis::ColorTable::lookup(const double value, uint8_t* const pRGBA) const
+{
+    if (entries.isEmpty())
+    {
+        memcpy(pRGBA, noDataColor.data(), 4);
+        return;
+    }
+
+    // First entry that is not less than value
+    const auto itEntry = std::lower_bound(entries.cbegin(), entries.cend(), value,
+        []
+        (const Entry& entry, const double value) -> bool
+        {
+            return entry.value < value;
+        });
+
+    if (itEntry == entries.cbegin() || itEntry == entries.cend())
+    {
+        const auto& entry = (itEntry == entries.cbegin()) ? entries.first() : entries.last();
+        for (int channel = 0; channel < 4; channel++)
+            pRGBA[channel] = static_cast<uint8_t>(entry.rgba[channel]);
+        return;
+    }
+
+    // Linear interpolation with rounding as done by GDAL
+    const auto& upper = *itEntry;
+    const auto& lower = *(itEntry - 1);
+    const auto ratio = (value - lower.value) / (upper.value - lower.value);
+    for (int channel = 0; channel < 4; channel++)
+    {
+        const auto component =
+            static_cast<int>(0.45 + lower.rgba[channel] + ratio * (upper.rgba[channel] - lower.rgba[channel]));
+        pRGBA[channel] = static_cast<uint8_t>(qBound(0, component, 255));
+    }
+}
+
+void OsmAnd::TerrainAnalysis::ColorTable::buildLookupTable(std::array<std::array<uint8_t, 4>, 256>& outTable) const
+{
+    for (int value = 0; value < 256; value++)
+        lookup(value, outTable[value].data());
+}
+
+void OsmAnd::TerrainAnalysis::ColorTable::buildSlopeLookupTable(std::vector<std::array<uint8_t, 4>>& outTable) const
+{
+    outTable.resize(SlopeLookupTableSize);
+    for (int idx = 0; idx < SlopeLookupTableSize; idx++)
+        lookup(static_cast<double>(idx) / SlopeLookupTableResolution, outTable[idx].data());
+}
+
+bool OsmAnd::TerrainAnalysis::ColorTable::parse(const QByteArray& content, ColorTable& outColorTable)
+{
+    outColorTable = ColorTable();
+
+    // Content may be padded with zeros
+    const auto length = content.indexOf('\0');
+    const auto text = QString::fromLatin1(length < 0 ? content : content.left(length));
+
+    const QRegularExpression separators(QStringLiteral("[\\s,:]+"));
+    for (const auto& line_ : text.split(QLatin1Char('\n')))
+    {
+        const auto line = line_.trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+            continue;
+
+        const auto tokens = line.split(separators, QString::SkipEmptyParts);
+        if (tokens.size() < 4)
+        {
+            // Named colors are not supported
+            return false;
+        }
+
+        Entry entry;
+        entry.rgba[3] = 255;
+        for (int channel = 0; channel < 4 && channel + 1 < tokens.size(); channel++)
+        {
+            bool ok = false;
+            entry.rgba[channel] = tokens[channel + 1].toInt(&ok);
+            if (!ok)
+                return false;
+        }
+
+        const auto& valueToken = tokens[0];
+        if (valueToken.compare(QLatin1String("nv"), Qt::CaseInsensitive) == 0)
+        {
+            outColorTable.hasNoDataColor = true;
+            for (int channel = 0; channel < 4; channel++)
+                outColorTable.noDataColor[channel] = static_cast<uint8_t>(qBound(0, entry.rgba[channel], 255));
+            continue;
+        }
+
+        // Percentages depend on statistics of source raster, so they're not supported
+        bool ok = false;
+        entry.value = valueToken.toDouble(&ok);
+        if (!ok)
+            return false;
+
+        outColorTable.entries.push_back(entry);
+    }
+
+    std::sort(outColorTable.entries.begin(), outColorTable.entries.end(),
+        []
+        (const Entry& l, const Entry& r) -> bool
+        {
+            return l.value < r.value;
+        });
+
+    return !outColorTable.entries.isEmpty();
+}
+
+bool OsmAnd::TerrainAnalysis::ColorTable::load(const QString& filename, ColorTable& outColorTable)
+{
+    QByteArray content;
+    return readFile(filename, content) && parse(content, outColorTable);
+}
+
+bool OsmAnd::TerrainAnalysis::ColorTable::readFile(const QString& filename, QByteArray& outContent)
+{
+    // Color files are usually located in GDAL's in-memory filesystem
+    GByte* pData = nullptr;
+    vsi_l_offset size = 0;
+    if (!VSIIngestFile(nullptr, qPrintable(filename), &pData, &size, 1024 * 1024))
+        return false;
+
+    outContent = QByteArray(reinterpret_cast<const char*>(pData), static_cast<int>(size));
+    VSIFree(pData);
+    return true;
+}
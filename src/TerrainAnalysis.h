@@ -0,0 +1,103 @@
+#ifndef _OSMAND_CORE_TERRAIN_ANALYSIS_H_
+#define _OSMAND_CORE_TERRAIN_ANALYSIS_H_
+
+#include "stdlib_common.h"
+#include <array>
+#include <vector>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include <OsmAndCore/PointsAndAreas.h>
+
+namespace OsmAnd
+{
+    // In-process equivalent of GDAL DEM processing chains used for terrain rasters. Slope, hillshade and
+    // colorization are computed from heightmap in single pass, without intermediate datasets. Results match
+    // 'gdaldem slope', 'gdaldem hillshade -z 2' and 'gdaldem color-relief' (with default Horn algorithm and
+    // linear color interpolation).
+    class TerrainAnalysis Q_DECL_FINAL
+    {
+    public:
+        // Color table in format of 'gdaldem color-relief' color file. Only absolute values and 'nv' are supported.
+        struct ColorTable Q_DECL_FINAL
+        {
+            struct Entry
+            {
+                double value;
+                std::array<int, 4> rgba;
+            };
+
+            // Slope colors are looked up in table with this many entries per degree, from 0 to 90 degrees
+            enum {
+                SlopeLookupTableResolution = 16,
+                SlopeLookupTableSize = 90 * SlopeLookupTableResolution + 1,
+            };
+
+            ColorTable();
+
+            QVector<Entry> entries;
+            bool hasNoDataColor;
+            std::array<uint8_t, 4> noDataColor;
+
+            void lookup(const double value, uint8_t* const pRGBA) const;
+            void buildLookupTable(std::array<std::array<uint8_t, 4>, 256>& outTable) const;
+            void buildSlopeLookupTable(std::vector<std::array<uint8_t, 4>>& outTable) const;
+
+            static bool parse(const QByteArray& content, ColorTable& outColorTable);
+            static bool load(const QString& filename, ColorTable& outColorTable);
+            static bool readFile(const QString& filename, QByteArray& outContent);
+        };
+
+    private:
+        TerrainAnalysis();
+        ~TerrainAnalysis();
+
+        static float approximateAtan(const float x);
+        static void computeSlopeIndices(
+            const float* const pGradientsX,
+            const float* const pGradientsY,
+            const uint32_t count,
+            const float invResolutionX,
+            const float invResolutionY,
+            int32_t* const pSlopeIndices);
+        static void computeGradients(
+            const float* const pHeights,
+            const uint32_t tileSize,
+            const uint32_t y,
+            const uint32_t x0,
+            const uint32_t count,
+            const float noData,
+            float* const pGradientsX,
+            float* const pGradientsY,
+            uint8_t* const pValid);
+    public:
+        // Both methods take tileSize x tileSize heights and produce RGBA raster of (tileSize - overlap) size,
+        // cropped by overlap/2 from each side
+        static void computeSlopeRaster(
+            const float* const pHeights,
+            const uint32_t tileSize,
+            const uint32_t overlap,
+            const PointD& resolution,
+            const float noData,
+            const ColorTable& colors,
+            uint8_t* const pOutRGBA);
+        static void computeHillshadeRaster(
+            const float* const pHeights,
+            const uint32_t tileSize,
+            const uint32_t overlap,
+            const PointD& resolution,
+            const float noData,
+            const ColorTable& slopeGrayscale,
+            const ColorTable& colors,
+            uint8_t* const pOutRGBA);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TERRAIN_ANALYSIS_H_)
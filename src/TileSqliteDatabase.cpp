@@ -210,6 +210,11 @@ bool OsmAnd::TileSqliteDatabase::storeTileData(
     return _p->storeTileData(tileId, zoom, specification, data, time);
 }
 
+bool OsmAnd::TileSqliteDatabase::storeTilesData(const QList<TileEntry>& tiles)
+{
+    return _p->storeTilesData(tiles);
+}
+
 bool OsmAnd::TileSqliteDatabase::updateTileDataFrom(
     const QString& dbFilePath,
     const QString* specName /* = nullptr */)
@@ -277,6 +282,32 @@ bool OsmAnd::TileSqliteDatabase::compact()
     return _p->compact();
 }
 
+OsmAnd::TileSqliteDatabase::TileEntry::TileEntry()
+    : tileId(TileId::zero())
+    , zoom(InvalidZoomLevel)
+    , specification(0)
+    , time(0)
+{
+}
+
+OsmAnd::TileSqliteDatabase::TileEntry::TileEntry(
+    const TileId tileId_,
+    const ZoomLevel zoom_,
+    const QByteArray& data_,
+    const int64_t time_ /*= 0*/,
+    const int64_t specification_ /*= 0*/)
+    : tileId(tileId_)
+    , zoom(zoom_)
+    , specification(specification_)
+    , data(data_)
+    , time(time_)
+{
+}
+
+OsmAnd::TileSqliteDatabase::TileEntry::~TileEntry()
+{
+}
+
 OsmAnd::TileSqliteDatabase::Meta::Meta()
 {
 }
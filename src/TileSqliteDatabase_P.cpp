@@ -6,12 +6,14 @@
 #include <QTime>
 #include "restore_internal_warnings.h"
 
+#include "QtCommon.h"
 #include "Logging.h"
 
 OsmAnd::TileSqliteDatabase_P::TileSqliteDatabase_P(
     TileSqliteDatabase* owner_
 )
     : _isOpened(0)
+    , _useReadConnections(0)
     , owner(owner_)
 {
 }
@@ -156,9 +158,22 @@ bool OsmAnd::TileSqliteDatabase_P::open(const bool withSpecification /* = false
                 }
             }
         }
+        // File-backed database can be read via separate per-thread connections, so that readers don't have to
+        // share main connection. WAL mode additionally allows these readers to proceed while data is written.
+        const auto useReadConnections = !owner->filename.isEmpty();
+        if (useReadConnections && !execStatement(database, QStringLiteral("PRAGMA journal_mode = WAL")))
+        {
+            LogPrintf(
+                LogSeverityLevel::Warning,
+                "Failed to enable WAL mode for '%s': %s",
+                qPrintable(filename),
+                sqlite3_errmsg(database.get()));
+        }
+
         resetCachedInfo();
         _database = database;
         _meta = meta;
+        _useReadConnections.storeRelease(useReadConnections ? 1 : 0);
         _isOpened.storeRelease(1);
     }
 
@@ -187,6 +202,21 @@ bool OsmAnd::TileSqliteDatabase_P::close(bool compact /* = true */)
         }
 
         resetCachedInfo();
+        {
+            // Connections that are still referenced by their threads are reopened once database is opened again
+            QMutexLocker readConnectionsLocker(&_readConnectionsLock);
+            for (const auto& weakReadConnection : constOf(_readConnections))
+            {
+                if (const auto readConnection = weakReadConnection.lock())
+                {
+                    readConnection->statements.clear();
+                    readConnection->database.reset();
+                }
+            }
+            _readConnections.clear();
+        }
+        _useReadConnections.storeRelease(0);
+        _statements.clear();
         _database.reset();
         _meta.reset();
         _isOpened.storeRelease(0);
@@ -1038,9 +1068,11 @@ bool OsmAnd::TileSqliteDatabase_P::containsTileData(OsmAnd::TileId tileId, OsmAn
 
         int res;
 
-        const auto sql = QStringLiteral("SELECT COUNT(*) FROM tiles WHERE x=:x AND y=:y AND z=:z");
-        const auto statement =
-            prepareStatement(_database, specification > 0 ? sql + QStringLiteral(" AND s=:s") : sql);
+        std::shared_ptr<sqlite3> database;
+        const auto statement = obtainReadStatement(specification > 0
+            ? QStringLiteral("SELECT COUNT(*) FROM tiles WHERE x=:x AND y=:y AND z=:z AND s=:s")
+            : QStringLiteral("SELECT COUNT(*) FROM tiles WHERE x=:x AND y=:y AND z=:z"),
+            database);
         if (!statement || !configureStatement(invertedY, invertedZoomValue, statement, tileId, zoom, specification))
         {
             LogPrintf(
@@ -1061,25 +1093,13 @@ bool OsmAnd::TileSqliteDatabase_P::containsTileData(OsmAnd::TileId tileId, OsmAn
                 tileId.y,
                 zoom,
                 specification,
-                sqlite3_errmsg(_database.get()));
+                sqlite3_errmsg(database.get()));
             return false;
         }
 
         if (res > 0)
         {
-            int64_t count = 0;
-            const auto countValue = readStatementValue(statement, 0);
-            if (!countValue.isNull())
-            {
-                bool ok = false;
-                const auto countI = countValue.toInt(&ok);
-                if (!ok)
-                {
-                    return false;
-                }
-                count = static_cast<int64_t>(countI);
-            }
-            return count > 0;
+            return sqlite3_column_int64(statement.get(), 0) > 0;
         }
 
         return false;
@@ -1115,9 +1135,11 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileTime(
 
         int res;
 
-        const auto sql = QStringLiteral("SELECT time FROM tiles WHERE x=:x AND y=:y AND z=:z");
-        const auto statement =
-            prepareStatement(_database, specification > 0 ? sql + QStringLiteral(" AND s=:s") : sql);
+        std::shared_ptr<sqlite3> database;
+        const auto statement = obtainReadStatement(specification > 0
+            ? QStringLiteral("SELECT time FROM tiles WHERE x=:x AND y=:y AND z=:z AND s=:s")
+            : QStringLiteral("SELECT time FROM tiles WHERE x=:x AND y=:y AND z=:z"),
+            database);
         if (!statement || !configureStatement(invertedY, invertedZoomValue, statement, tileId, zoom, specification))
         {
             LogPrintf(
@@ -1138,26 +1160,13 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileTime(
                 tileId.y,
                 zoom,
                 specification,
-                sqlite3_errmsg(_database.get()));
+                sqlite3_errmsg(database.get()));
             return false;
         }
 
         if (res > 0)
         {
-            int64_t time = 0;
-            const auto timeValue = readStatementValue(statement, 0);
-            if (!timeValue.isNull())
-            {
-                bool ok = false;
-                const auto timeLL = timeValue.toLongLong(&ok);
-                if (!ok)
-                {
-                    return false;
-                }
-                time = static_cast<int64_t>(timeLL);
-            }
-            
-            outTime = time;
+            outTime = readStatementTime(statement, 0);
             return true;
         }
     }
@@ -1191,10 +1200,11 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileData(
 
         int res;
 
-        const auto statement = prepareStatement(_database, timeSupported
+        std::shared_ptr<sqlite3> database;
+        const auto statement = obtainReadStatement(timeSupported
             ? QStringLiteral("SELECT image, time FROM tiles WHERE x=:x AND y=:y AND z=:z")
-            : QStringLiteral("SELECT image FROM tiles WHERE x=:x AND y=:y AND z=:z")
-        );
+            : QStringLiteral("SELECT image FROM tiles WHERE x=:x AND y=:y AND z=:z"),
+            database);
         if (!statement || !configureStatement(invertedY, invertedZoomValue, statement, tileId, zoom))
         {
             LogPrintf(
@@ -1213,29 +1223,17 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileData(
                 tileId.x,
                 tileId.y,
                 zoom,
-                sqlite3_errmsg(_database.get()));
+                sqlite3_errmsg(database.get()));
             return false;
         }
 
         if (res > 0)
         {
-            outData = readStatementValue(statement, 0).toByteArray();
+            readStatementBlob(statement, 0, outData);
 
             if (timeSupported && pOutTime)
             {
-                int64_t time = 0;
-                const auto timeValue = readStatementValue(statement, 1);
-                if (!timeValue.isNull())
-                {
-                    bool ok = false;
-                    const auto timeLL = timeValue.toLongLong(&ok);
-                    if (!ok)
-                    {
-                        return false;
-                    }
-                    time = static_cast<int64_t>(timeLL);
-                }
-                *pOutTime = time;
+                *pOutTime = readStatementTime(statement, 1);
             }
 
             return true;
@@ -1272,10 +1270,11 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileData(
 
         int res;
 
-        const auto statement = prepareStatement(_database, timeSupported
+        std::shared_ptr<sqlite3> database;
+        const auto statement = obtainReadStatement(timeSupported
             ? QStringLiteral("SELECT image, time FROM tiles WHERE x=:x AND y=:y AND z=:z AND s=:s")
-            : QStringLiteral("SELECT image FROM tiles WHERE x=:x AND y=:y AND z=:z AND s=:s")
-        );
+            : QStringLiteral("SELECT image FROM tiles WHERE x=:x AND y=:y AND z=:z AND s=:s"),
+            database);
         if (!statement || !configureStatement(invertedY, invertedZoomValue, statement, tileId, zoom, specification))
         {
             LogPrintf(
@@ -1296,29 +1295,17 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileData(
                 tileId.y,
                 zoom,
                 specification,
-                sqlite3_errmsg(_database.get()));
+                sqlite3_errmsg(database.get()));
             return false;
         }
 
         if (res > 0)
         {
-            outData = readStatementValue(statement, 0).toByteArray();
+            readStatementBlob(statement, 0, outData);
 
             if (timeSupported && pOutTime)
             {
-                int64_t time = 0;
-                const auto timeValue = readStatementValue(statement, 1);
-                if (!timeValue.isNull())
-                {
-                    bool ok = false;
-                    const auto timeLL = timeValue.toLongLong(&ok);
-                    if (!ok)
-                    {
-                        return false;
-                    }
-                    time = static_cast<int64_t>(timeLL);
-                }
-                *pOutTime = time;
+                *pOutTime = readStatementTime(statement, 1);
             }
 
             return true;
@@ -1354,10 +1341,11 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileData(
 
         int res;
 
-        const auto statement = prepareStatement(_database, timeSupported
+        std::shared_ptr<sqlite3> database;
+        const auto statement = obtainReadStatement(timeSupported
             ? QStringLiteral("SELECT image, time FROM tiles WHERE x=:x AND y=:y AND z=:z")
-            : QStringLiteral("SELECT image FROM tiles WHERE x=:x AND y=:y AND z=:z")
-        );
+            : QStringLiteral("SELECT image FROM tiles WHERE x=:x AND y=:y AND z=:z"),
+            database);
         if (!statement || !configureStatement(invertedY, invertedZoomValue, statement, tileId, zoom))
         {
             LogPrintf(
@@ -1376,29 +1364,17 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileData(
                 tileId.x,
                 tileId.y,
                 zoom,
-                sqlite3_errmsg(_database.get()));
+                sqlite3_errmsg(database.get()));
             return false;
         }
 
         if (res > 0)
         {
-            readStatementValue(statement, 0, outData);
+            readStatementBlob(statement, 0, outData);
 
             if (timeSupported && pOutTime)
             {
-                int64_t time = 0;
-                const auto timeValue = readStatementValue(statement, 1);
-                if (!timeValue.isNull())
-                {
-                    bool ok = false;
-                    const auto timeLL = timeValue.toLongLong(&ok);
-                    if (!ok)
-                    {
-                        return false;
-                    }
-                    time = static_cast<int64_t>(timeLL);
-                }
-                *pOutTime = time;
+                *pOutTime = readStatementTime(statement, 1);
             }
 
             return true;
@@ -1435,10 +1411,11 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileData(
 
         int res;
 
-        const auto statement = prepareStatement(_database, timeSupported
+        std::shared_ptr<sqlite3> database;
+        const auto statement = obtainReadStatement(timeSupported
             ? QStringLiteral("SELECT image, time FROM tiles WHERE x=:x AND y=:y AND z=:z AND s=:s")
-            : QStringLiteral("SELECT image FROM tiles WHERE x=:x AND y=:y AND z=:z AND s=:s")
-        );
+            : QStringLiteral("SELECT image FROM tiles WHERE x=:x AND y=:y AND z=:z AND s=:s"),
+            database);
         if (!statement || !configureStatement(invertedY, invertedZoomValue, statement, tileId, zoom, specification))
         {
             LogPrintf(
@@ -1459,29 +1436,17 @@ bool OsmAnd::TileSqliteDatabase_P::obtainTileData(
                 tileId.y,
                 zoom,
                 specification,
-                sqlite3_errmsg(_database.get()));
+                sqlite3_errmsg(database.get()));
             return false;
         }
 
         if (res > 0)
         {
-            readStatementValue(statement, 0, outData);
+            readStatementBlob(statement, 0, outData);
 
             if (timeSupported && pOutTime)
             {
-                int64_t time = 0;
-                const auto timeValue = readStatementValue(statement, 1);
-                if (!timeValue.isNull())
-                {
-                    bool ok = false;
-                    const auto timeLL = timeValue.toLongLong(&ok);
-                    if (!ok)
-                    {
-                        return false;
-                    }
-                    time = static_cast<int64_t>(timeLL);
-                }
-                *pOutTime = time;
+                *pOutTime = readStatementTime(statement, 1);
             }
 
             return true;
@@ -1510,10 +1475,9 @@ bool OsmAnd::TileSqliteDatabase_P::storeTileData(
     {
         QWriteLocker scopedLocker(&_lock);
 
-        const auto statement = prepareStatement(_database, timeSupported
+        const auto statement = obtainStatement(timeSupported
             ? QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, image, time) VALUES(:x, :y, :z, :data, :time)")
-            : QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, image) VALUES(:x, :y, :z, :data)")
-        );
+            : QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, image) VALUES(:x, :y, :z, :data)"));
         if (!statement || !configureStatement(invertedY, invertedZoomValue, statement, tileId, zoom))
         {
             LogPrintf(
@@ -1588,10 +1552,9 @@ bool OsmAnd::TileSqliteDatabase_P::storeTileData(
     {
         QWriteLocker scopedLocker(&_lock);
 
-        const auto statement = prepareStatement(_database, timeSupported
+        const auto statement = obtainStatement(timeSupported
             ? QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, s, image, time) VALUES(:x, :y, :z, :s, :data, :time)")
-            : QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, s, image) VALUES(:x, :y, :z, :s, :data)")
-        );
+            : QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, s, image) VALUES(:x, :y, :z, :s, :data)"));
         if (!statement || !configureStatement(invertedY, invertedZoomValue, statement, tileId, zoom, specification))
         {
             LogPrintf(
@@ -1650,6 +1613,168 @@ bool OsmAnd::TileSqliteDatabase_P::storeTileData(
     return true;
 }
 
+bool OsmAnd::TileSqliteDatabase_P::storeTilesData(const QList<TileEntry>& tiles_)
+{
+    if (!isOpened())
+    {
+        return false;
+    }
+
+    // Tiles of invalid zoom levels are rejected, yet remaining tiles are still stored
+    auto tiles = tiles_;
+    const auto itInvalidTiles = std::remove_if(tiles.begin(), tiles.end(),
+        []
+        (const TileEntry& tile) -> bool
+        {
+            return tile.zoom < MinZoomLevel || tile.zoom > MaxZoomLevel;
+        });
+    if (itInvalidTiles != tiles.end())
+    {
+        LogPrintf(
+            LogSeverityLevel::Warning,
+            "Skipped %d tiles of invalid zoom level",
+            static_cast<int>(std::distance(itInvalidTiles, tiles.end())));
+        tiles.erase(itInvalidTiles, tiles.end());
+    }
+    const auto allTilesValid = (tiles.size() == tiles_.size());
+
+    if (tiles.isEmpty())
+    {
+        return allTilesValid;
+    }
+
+    bool invertedY = isInvertedY();
+    int invertedZoomValue = getInvertedZoomValue();
+
+    const auto timeSupported = isTileTimeSupported();
+
+    // Tiles are stored in chunks, each within own transaction, so that readers are not locked out for long
+    bool success = allTilesValid;
+    int storedCount = 0;
+    const auto tilesCount = tiles.size();
+    while (storedCount < tilesCount)
+    {
+        const auto chunkEnd = std::min(storedCount + static_cast<int>(TileSqliteDatabase::TilesPerTransaction), tilesCount);
+        if (!storeTilesDataChunk(tiles, storedCount, chunkEnd, invertedY, invertedZoomValue, timeSupported))
+        {
+            success = false;
+            break;
+        }
+        storedCount = chunkEnd;
+    }
+
+    if (storedCount == 0)
+    {
+        return false;
+    }
+
+    // Cached zoom range and bboxes are updated once for all stored tiles
+    auto minZoom = ZoomLevel::MaxZoomLevel;
+    auto maxZoom = ZoomLevel::MinZoomLevel;
+    std::array<bool, ZoomLevelsCount> zoomsAffected;
+    zoomsAffected.fill(false);
+    for (int tileIdx = 0; tileIdx < storedCount; tileIdx++)
+    {
+        const auto zoom = tiles[tileIdx].zoom;
+        minZoom = std::min(minZoom, zoom);
+        maxZoom = std::max(maxZoom, zoom);
+        zoomsAffected[zoom] = true;
+    }
+    if (minZoom < getMinZoom() || maxZoom > getMaxZoom())
+    {
+        recomputeMinMaxZoom();
+    }
+    for (int zoom = minZoom; zoom <= maxZoom; zoom++)
+    {
+        if (zoomsAffected[zoom])
+        {
+            recomputeBBox31(static_cast<ZoomLevel>(zoom));
+        }
+    }
+
+    return success;
+}
+
+bool OsmAnd::TileSqliteDatabase_P::storeTilesDataChunk(
+    const QList<TileEntry>& tiles,
+    int start,
+    int end,
+    bool invertedY,
+    int invertedZoomValue,
+    bool timeSupported)
+{
+    QWriteLocker scopedLocker(&_lock);
+
+    if (!execStatement(_database, QStringLiteral("BEGIN IMMEDIATE")))
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to begin transaction: %s",
+            sqlite3_errmsg(_database.get()));
+        return false;
+    }
+
+    for (int tileIdx = start; tileIdx < end; tileIdx++)
+    {
+        const auto& tile = tiles[tileIdx];
+        const auto withSpecification = tile.specification != 0;
+
+        QString sql;
+        if (withSpecification)
+        {
+            sql = timeSupported
+                ? QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, s, image, time) VALUES(:x, :y, :z, :s, :data, :time)")
+                : QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, s, image) VALUES(:x, :y, :z, :s, :data)");
+        }
+        else
+        {
+            sql = timeSupported
+                ? QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, image, time) VALUES(:x, :y, :z, :data, :time)")
+                : QStringLiteral("INSERT OR REPLACE INTO tiles(x, y, z, image) VALUES(:x, :y, :z, :data)");
+        }
+
+        bool stored;
+        {
+            const auto statement = obtainStatement(sql);
+            stored = statement
+                && configureStatement(invertedY, invertedZoomValue, statement, tile.tileId, tile.zoom, tile.specification)
+                && bindStatementParameter(statement, QStringLiteral(":data"), tile.data)
+                && (!timeSupported || bindStatementParameter(
+                    statement, QStringLiteral(":time"), QVariant(static_cast<qint64>(tile.time))))
+                && stepStatement(statement) >= 0;
+            if (!stored)
+            {
+                LogPrintf(
+                    LogSeverityLevel::Error,
+                    "Failed to store data for %dx%d@%d,%lld: %s",
+                    tile.tileId.x,
+                    tile.tileId.y,
+                    tile.zoom,
+                    tile.specification,
+                    sqlite3_errmsg(_database.get()));
+            }
+        }
+        if (!stored)
+        {
+            execStatement(_database, QStringLiteral("ROLLBACK"));
+            return false;
+        }
+    }
+
+    if (!execStatement(_database, QStringLiteral("COMMIT")))
+    {
+        LogPrintf(
+            LogSeverityLevel::Error,
+            "Failed to commit transaction: %s",
+            sqlite3_errmsg(_database.get()));
+
+        execStatement(_database, QStringLiteral("ROLLBACK"));
+        return false;
+    }
+
+    return true;
+}
+
 bool OsmAnd::TileSqliteDatabase_P::updateTileDataFrom(
     const QString& dbFilePath,
     const QString* specName /* = nullptr */)
@@ -2373,6 +2498,103 @@ std::shared_ptr<sqlite3_stmt> OsmAnd::TileSqliteDatabase_P::prepareStatement(
     return statement;
 }
 
+std::shared_ptr<sqlite3_stmt> OsmAnd::TileSqliteDatabase_P::obtainCachedStatement(
+    const std::shared_ptr<sqlite3>& db,
+    QHash<QString, std::shared_ptr<sqlite3_stmt>>& statements,
+    const QString& sql)
+{
+    auto& statement = statements[sql];
+    if (!statement)
+    {
+        statement = prepareStatement(db, sql);
+        if (!statement)
+        {
+            statements.remove(sql);
+            return nullptr;
+        }
+    }
+
+    // Returned reference doesn't finalize statement, but resets it for next use
+    const auto cachedStatement = statement;
+    return std::shared_ptr<sqlite3_stmt>(cachedStatement.get(),
+        [cachedStatement]
+        (sqlite3_stmt* const pStatement)
+        {
+            sqlite3_reset(pStatement);
+            sqlite3_clear_bindings(pStatement);
+        });
+}
+
+std::shared_ptr<sqlite3_stmt> OsmAnd::TileSqliteDatabase_P::obtainStatement(const QString& sql)
+{
+    return obtainCachedStatement(_database, _statements, sql);
+}
+
+std::shared_ptr<sqlite3_stmt> OsmAnd::TileSqliteDatabase_P::obtainReadStatement(
+    const QString& sql,
+    std::shared_ptr<sqlite3>& outDatabase) const
+{
+    if (_useReadConnections.loadAcquire() != 0)
+    {
+        if (const auto readConnection = obtainReadConnection())
+        {
+            outDatabase = readConnection->database;
+            return obtainCachedStatement(readConnection->database, readConnection->statements, sql);
+        }
+    }
+
+    // Main connection is shared by concurrent readers, so statements prepared on it can't be reused
+    outDatabase = _database;
+    return prepareStatement(_database, sql);
+}
+
+std::shared_ptr<OsmAnd::TileSqliteDatabase_P::ReadConnection> OsmAnd::TileSqliteDatabase_P::obtainReadConnection() const
+{
+    auto& threadReadConnection = _threadReadConnection.localData();
+    if (threadReadConnection && threadReadConnection->database)
+        return threadReadConnection;
+
+    sqlite3* pDatabase = nullptr;
+    const auto res = sqlite3_open_v2(
+        owner->filename.toUtf8().constData(),
+        &pDatabase,
+        SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+        nullptr);
+    const std::shared_ptr<sqlite3> database(pDatabase, sqlite3_close);
+    if (res != SQLITE_OK)
+    {
+        LogPrintf(
+            LogSeverityLevel::Warning,
+            "Failed to open read connection to '%s', falling back to main connection: %s (%s)",
+            qPrintable(owner->filename),
+            database ? sqlite3_errmsg(database.get()) : "N/A",
+            sqlite3_errstr(res));
+
+        _useReadConnections.storeRelease(0);
+        return nullptr;
+    }
+
+    // Writer may hold lock for a moment, so wait for it instead of failing the read
+    sqlite3_busy_timeout(database.get(), 1000);
+
+    const std::shared_ptr<ReadConnection> readConnection(new ReadConnection());
+    readConnection->database = database;
+    threadReadConnection = readConnection;
+
+    QMutexLocker scopedLocker(&_readConnectionsLock);
+
+    // Connections of finished threads are gone already
+    auto itReadConnection = mutableIteratorOf(_readConnections);
+    while (itReadConnection.hasNext())
+    {
+        if (itReadConnection.next().expired())
+            itReadConnection.remove();
+    }
+    _readConnections.push_back(readConnection);
+
+    return readConnection;
+}
+
 QVariant OsmAnd::TileSqliteDatabase_P::readStatementValue(
     const std::shared_ptr<sqlite3_stmt>& statement,
     int index,
@@ -2405,6 +2627,40 @@ QVariant OsmAnd::TileSqliteDatabase_P::readStatementValue(
     }
 }
 
+void OsmAnd::TileSqliteDatabase_P::readStatementBlob(
+    const std::shared_ptr<sqlite3_stmt>& statement,
+    int index,
+    QByteArray& outData)
+{
+    // Blob is copied straight into output buffer, reusing its storage if possible
+    const auto pBlob = sqlite3_column_blob(statement.get(), index);
+    const auto size = sqlite3_column_bytes(statement.get(), index);
+    outData.resize(size);
+    if (size > 0)
+        memcpy(outData.data(), pBlob, size);
+}
+
+void OsmAnd::TileSqliteDatabase_P::readStatementBlob(
+    const std::shared_ptr<sqlite3_stmt>& statement,
+    int index,
+    void* outData)
+{
+    const auto pBlob = sqlite3_column_blob(statement.get(), index);
+    const auto size = sqlite3_column_bytes(statement.get(), index);
+    if (size > 0)
+        memcpy(outData, pBlob, size);
+}
+
+int64_t OsmAnd::TileSqliteDatabase_P::readStatementTime(
+    const std::shared_ptr<sqlite3_stmt>& statement,
+    int index)
+{
+    if (sqlite3_column_type(statement.get(), index) == SQLITE_NULL)
+        return 0;
+
+    return static_cast<int64_t>(sqlite3_column_int64(statement.get(), index));
+}
+
 bool OsmAnd::TileSqliteDatabase_P::bindStatementParameter(
     const std::shared_ptr<sqlite3_stmt>& statement,
     QString name,
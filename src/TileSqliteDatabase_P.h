@@ -8,6 +8,9 @@
 #include <QAtomicInt>
 #include <QReadWriteLock>
 #include <QMutex>
+#include <QHash>
+#include <QList>
+#include <QThreadStorage>
 #include <QVariant>
 #include "restore_internal_warnings.h"
 
@@ -27,12 +30,32 @@ namespace OsmAnd
     {
     public:
         typedef TileSqliteDatabase::Meta Meta;
+        typedef TileSqliteDatabase::TileEntry TileEntry;
 
     private:
+        // Read-only connection used by a single thread, along with statements prepared on it.
+        // Statements are declared after database, so they're finalized before it's closed.
+        struct ReadConnection
+        {
+            std::shared_ptr<sqlite3> database;
+            QHash<QString, std::shared_ptr<sqlite3_stmt>> statements;
+        };
+
         mutable QReadWriteLock _lock;
         std::shared_ptr<sqlite3> _database;
         QAtomicInt _isOpened;
 
+        // Statements prepared on main connection, used only under exclusive lock
+        QHash<QString, std::shared_ptr<sqlite3_stmt>> _statements;
+
+        // Connection of each thread is released when thread finishes. All of them are also tracked here,
+        // so that they're closed along with database.
+        mutable QAtomicInt _useReadConnections;
+        mutable QThreadStorage<std::shared_ptr<ReadConnection>> _threadReadConnection;
+        mutable QMutex _readConnectionsLock;
+        mutable QList<std::weak_ptr<ReadConnection>> _readConnections;
+        std::shared_ptr<ReadConnection> obtainReadConnection() const;
+
         mutable QMutex _metaLock;
         mutable std::shared_ptr<Meta> _meta;
 
@@ -47,6 +70,8 @@ namespace OsmAnd
         mutable std::array<AreaI, ZoomLevelsCount> _cachedBboxes31;
         void resetCachedInfo();
         bool setMinMaxZoom(OsmAnd::ZoomLevel minZoom, OsmAnd::ZoomLevel maxZoom);
+        bool storeTilesDataChunk(const QList<TileEntry>& tiles, int start, int end,
+            bool invertedY, int invertedZoomValue, bool timeSupported);
 
     protected:
         TileSqliteDatabase_P(TileSqliteDatabase* owner);
@@ -63,9 +88,18 @@ namespace OsmAnd
             int64_t specification) const;
         bool configureStatement(const std::shared_ptr<sqlite3_stmt>& statement, int64_t time) const;
 
+        std::shared_ptr<sqlite3_stmt> obtainStatement(const QString& sql);
+        std::shared_ptr<sqlite3_stmt> obtainReadStatement(const QString& sql,
+            std::shared_ptr<sqlite3>& outDatabase) const;
+
         static std::shared_ptr<sqlite3_stmt> prepareStatement(const std::shared_ptr<sqlite3>& db, QString sql);
+        static std::shared_ptr<sqlite3_stmt> obtainCachedStatement(const std::shared_ptr<sqlite3>& db,
+            QHash<QString, std::shared_ptr<sqlite3_stmt>>& statements, const QString& sql);
         static QVariant readStatementValue(const std::shared_ptr<sqlite3_stmt>& statement,
             int index, void* data = nullptr);
+        static void readStatementBlob(const std::shared_ptr<sqlite3_stmt>& statement, int index, QByteArray& outData);
+        static void readStatementBlob(const std::shared_ptr<sqlite3_stmt>& statement, int index, void* outData);
+        static int64_t readStatementTime(const std::shared_ptr<sqlite3_stmt>& statement, int index);
         static bool bindStatementParameter(const std::shared_ptr<sqlite3_stmt>& statement,
             QString name, QVariant value);
         static bool bindStatementParameter(const std::shared_ptr<sqlite3_stmt>& statement, int index, QVariant value);
@@ -129,6 +163,7 @@ namespace OsmAnd
         bool storeTileData(TileId tileId, ZoomLevel zoom, const QByteArray& data, int64_t time = 0);
         bool storeTileData(TileId tileId, ZoomLevel zoom, int64_t specification,
             const QByteArray& data, int64_t time = 0);
+        bool storeTilesData(const QList<TileEntry>& tiles);
         bool updateTileDataFrom(const QString& dbFilePath, const QString* specName = nullptr);
         bool removeTileData(TileId tileId, ZoomLevel zoom, int64_t specification = 0);
         bool removeTilesData(QList<TileId>& tileIds, ZoomLevel zoom, int64_t specification = 0);
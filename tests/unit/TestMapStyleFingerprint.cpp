@@ -0,0 +1,53 @@
+#include <OsmAndCore.h>
+#include <OsmAndCore/CoreResourcesEmbeddedBundle.h>
+#include <OsmAndCore/Map/MapStylesCollection.h>
+#include <OsmAndCore/Map/ResolvedMapStyle.h>
+
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QHash>
+
+#include <memory>
+
+using namespace OsmAnd;
+
+class TestMapStyleFingerprint : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void sameAcrossSessions();
+};
+
+void TestMapStyleFingerprint::initTestCase()
+{
+    QVERIFY(InitializeCore(CoreResourcesEmbeddedBundle::loadFromSharedResourcesBundle()));
+}
+
+void TestMapStyleFingerprint::cleanupTestCase()
+{
+    ReleaseCore();
+}
+
+void TestMapStyleFingerprint::sameAcrossSessions()
+{
+    // Each collection loads and resolves style independently. Seed of hash tables is changed in between,
+    // so that they are iterated in different order, same as it happens in different sessions.
+    qSetGlobalQHashSeed(0);
+    const auto firstCollection = std::make_shared<MapStylesCollection>();
+    const auto firstStyle = firstCollection->getResolvedStyleByName(QLatin1String("default"));
+
+    qSetGlobalQHashSeed(-1);
+    const auto secondCollection = std::make_shared<MapStylesCollection>();
+    const auto secondStyle = secondCollection->getResolvedStyleByName(QLatin1String("default"));
+
+    QVERIFY(firstStyle);
+    QVERIFY(secondStyle);
+    QVERIFY(firstStyle->getFingerprint() != 0);
+    QCOMPARE(firstStyle->getFingerprint(), secondStyle->getFingerprint());
+}
+
+QTEST_MAIN(TestMapStyleFingerprint)
+#include "TestMapStyleFingerprint.moc"
@@ -0,0 +1,65 @@
+#ifndef _OSMAND_CORE_TOOLS_STRING_MATCHER_BENCHMARK_H_
+#define _OSMAND_CORE_TOOLS_STRING_MATCHER_BENCHMARK_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <iostream>
+#include <sstream>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/ObfsCollection.h>
+
+#include <OsmAndCoreTools.h>
+
+namespace OsmAndTools
+{
+    // Measures matching of query against names from OBF address sections: per-call ICU collator matching versus
+    // CollatorStringMatcher, that prepares query once
+    class OSMAND_CORE_TOOLS_API StringMatcherBenchmark Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(StringMatcherBenchmark);
+
+    public:
+        struct OSMAND_CORE_TOOLS_API Configuration Q_DECL_FINAL
+        {
+            Configuration();
+
+            std::shared_ptr<OsmAnd::ObfsCollection> obfsCollection;
+            QStringList queries;
+            QList<OsmAnd::StringMatcherMode> modes;
+            unsigned int repeats;
+            bool verbose;
+
+            static bool parseFromCommandLineArguments(
+                const QStringList& commandLineArgs,
+                Configuration& outConfiguration,
+                QString& outError);
+        };
+
+    private:
+#if defined(_UNICODE) || defined(UNICODE)
+        bool run(std::wostream& output);
+#else
+        bool run(std::ostream& output);
+#endif
+    protected:
+    public:
+        StringMatcherBenchmark(const Configuration& configuration);
+        ~StringMatcherBenchmark();
+
+        const Configuration configuration;
+
+        bool run(QString* pLog = nullptr);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TOOLS_STRING_MATCHER_BENCHMARK_H_)
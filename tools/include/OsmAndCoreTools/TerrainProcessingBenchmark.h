@@ -0,0 +1,69 @@
+#ifndef _OSMAND_CORE_TOOLS_TERRAIN_PROCESSING_BENCHMARK_H_
+#define _OSMAND_CORE_TOOLS_TERRAIN_PROCESSING_BENCHMARK_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <iostream>
+#include <sstream>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/IGeoTiffCollection.h>
+
+#include <OsmAndCoreTools.h>
+
+namespace OsmAndTools
+{
+    // Compares in-process terrain processing with GDAL DEM processing on same GeoTIFF tiles: speed and
+    // difference of produced rasters
+    class OSMAND_CORE_TOOLS_API TerrainProcessingBenchmark Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(TerrainProcessingBenchmark);
+
+    public:
+        struct OSMAND_CORE_TOOLS_API Configuration Q_DECL_FINAL
+        {
+            Configuration();
+
+            QString geotiffsPath;
+            OsmAnd::IGeoTiffCollection::RasterType rasterType;
+            QString colorsFilename;
+            QString slopeGrayscaleFilename;
+            OsmAnd::ZoomLevel zoom;
+            QList<OsmAnd::TileId> tileIds;
+            unsigned int tileSize;
+            unsigned int repeats;
+            bool verbose;
+
+            static bool parseFromCommandLineArguments(
+                const QStringList& commandLineArgs,
+                Configuration& outConfiguration,
+                QString& outError);
+        };
+
+    private:
+#if defined(_UNICODE) || defined(UNICODE)
+        bool run(std::wostream& output);
+#else
+        bool run(std::ostream& output);
+#endif
+    protected:
+    public:
+        TerrainProcessingBenchmark(const Configuration& configuration);
+        ~TerrainProcessingBenchmark();
+
+        const Configuration configuration;
+
+        bool run(QString* pLog = nullptr);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TOOLS_TERRAIN_PROCESSING_BENCHMARK_H_)
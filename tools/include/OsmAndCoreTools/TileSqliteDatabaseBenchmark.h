@@ -0,0 +1,64 @@
+#ifndef _OSMAND_CORE_TOOLS_TILE_SQLITE_DATABASE_BENCHMARK_H_
+#define _OSMAND_CORE_TOOLS_TILE_SQLITE_DATABASE_BENCHMARK_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <iostream>
+#include <sstream>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QStringList>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+
+#include <OsmAndCoreTools.h>
+
+namespace OsmAndTools
+{
+    // Measures bulk import of tiles into TileSqliteDatabase: tile-by-tile stores versus batched stores
+    class OSMAND_CORE_TOOLS_API TileSqliteDatabaseBenchmark Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(TileSqliteDatabaseBenchmark);
+
+    public:
+        struct OSMAND_CORE_TOOLS_API Configuration Q_DECL_FINAL
+        {
+            Configuration();
+
+            QString outputPath;
+            unsigned int tilesCount;
+            unsigned int tileDataSize;
+            OsmAnd::ZoomLevel zoom;
+            bool withTime;
+            bool withSpecification;
+            bool verbose;
+
+            static bool parseFromCommandLineArguments(
+                const QStringList& commandLineArgs,
+                Configuration& outConfiguration,
+                QString& outError);
+        };
+
+    private:
+#if defined(_UNICODE) || defined(UNICODE)
+        bool run(std::wostream& output);
+#else
+        bool run(std::ostream& output);
+#endif
+    protected:
+    public:
+        TileSqliteDatabaseBenchmark(const Configuration& configuration);
+        ~TileSqliteDatabaseBenchmark();
+
+        const Configuration configuration;
+
+        bool run(QString* pLog = nullptr);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TOOLS_TILE_SQLITE_DATABASE_BENCHMARK_H_)
@@ -0,0 +1,70 @@
+#ifndef _OSMAND_CORE_TOOLS_WEATHER_RASTERIZATION_BENCHMARK_H_
+#define _OSMAND_CORE_TOOLS_WEATHER_RASTERIZATION_BENCHMARK_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <iostream>
+#include <sstream>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/Map/GeoCommonTypes.h>
+
+#include <OsmAndCoreTools.h>
+
+namespace OsmAndTools
+{
+    // Compares native weather raster colorization with GDAL warp and color-relief chain on same GeoTIFF:
+    // tiles per second of each band and difference of produced rasters
+    class OSMAND_CORE_TOOLS_API WeatherRasterizationBenchmark Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(WeatherRasterizationBenchmark);
+
+    public:
+        struct OSMAND_CORE_TOOLS_API Configuration Q_DECL_FINAL
+        {
+            Configuration();
+
+            QString geotiffFilename;
+            QHash<OsmAnd::BandIndex, QString> colorProfiles;
+            QString projSearchPath;
+            OsmAnd::ZoomLevel zoom;
+            QList<OsmAnd::TileId> tileIds;
+            unsigned int tileSize;
+            unsigned int repeats;
+            bool encode;
+            bool verbose;
+
+            static bool parseFromCommandLineArguments(
+                const QStringList& commandLineArgs,
+                Configuration& outConfiguration,
+                QString& outError);
+        };
+
+    private:
+#if defined(_UNICODE) || defined(UNICODE)
+        bool run(std::wostream& output);
+#else
+        bool run(std::ostream& output);
+#endif
+    protected:
+    public:
+        WeatherRasterizationBenchmark(const Configuration& configuration);
+        ~WeatherRasterizationBenchmark();
+
+        const Configuration configuration;
+
+        bool run(QString* pLog = nullptr);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TOOLS_WEATHER_RASTERIZATION_BENCHMARK_H_)
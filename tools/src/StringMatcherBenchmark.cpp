@@ -0,0 +1,337 @@
+#include "StringMatcherBenchmark.h"
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Common.h>
+#include <OsmAndCore/Stopwatch.h>
+#include <OsmAndCore/ICU.h>
+#include <OsmAndCore/CollatorStringMatcher.h>
+#include <OsmAndCore/ObfDataInterface.h>
+#include <OsmAndCore/Data/StreetGroup.h>
+#include <OsmAndCore/Data/Street.h>
+
+#include <OsmAndCoreTools.h>
+#include <OsmAndCoreTools/Utilities.h>
+
+OsmAndTools::StringMatcherBenchmark::StringMatcherBenchmark(const Configuration& configuration_)
+    : configuration(configuration_)
+{
+}
+
+OsmAndTools::StringMatcherBenchmark::~StringMatcherBenchmark()
+{
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::StringMatcherBenchmark::run(std::wostream& output)
+#else
+bool OsmAndTools::StringMatcherBenchmark::run(std::ostream& output)
+#endif
+{
+    // Names of street groups and streets, in all languages
+    QStringList names;
+    const auto appendNames =
+        [&names]
+        (const std::shared_ptr<const OsmAnd::Address>& address)
+        {
+            if (!address->nativeName.isEmpty())
+                names.push_back(address->nativeName);
+            for (const auto& localizedName : OsmAnd::constOf(address->localizedNames))
+            {
+                if (!localizedName.isEmpty())
+                    names.push_back(localizedName);
+            }
+        };
+    const auto obfDataInterface = configuration.obfsCollection->obtainDataInterface();
+    QList< std::shared_ptr<const OsmAnd::StreetGroup> > streetGroups;
+    QHash< std::shared_ptr<const OsmAnd::StreetGroup>, QList< std::shared_ptr<const OsmAnd::Street> > > streets;
+    if (!obfDataInterface->loadStreetGroups(&streetGroups) ||
+        !obfDataInterface->loadStreetsFromGroups(streetGroups, &streets))
+    {
+        output << xT("Failed to load names from OBF files") << std::endl;
+        return false;
+    }
+    for (const auto& streetGroup : OsmAnd::constOf(streetGroups))
+        appendNames(streetGroup);
+    for (const auto& groupStreets : OsmAnd::constOf(streets))
+    {
+        for (const auto& street : OsmAnd::constOf(groupStreets))
+            appendNames(street);
+    }
+    if (names.isEmpty())
+    {
+        output << xT("No names found in OBF files") << std::endl;
+        return false;
+    }
+    output << names.size() << xT(" names loaded") << std::endl;
+
+    const auto modeName =
+        []
+        (const OsmAnd::StringMatcherMode mode) -> QString
+        {
+            switch (mode)
+            {
+                case OsmAnd::StringMatcherMode::CHECK_ONLY_STARTS_WITH:
+                    return QStringLiteral("startsWith");
+                case OsmAnd::StringMatcherMode::CHECK_STARTS_FROM_SPACE:
+                    return QStringLiteral("startsFromSpace");
+                case OsmAnd::StringMatcherMode::CHECK_STARTS_FROM_SPACE_NOT_BEGINNING:
+                    return QStringLiteral("startsFromSpaceNotBeginning");
+                case OsmAnd::StringMatcherMode::CHECK_EQUALS_FROM_SPACE:
+                    return QStringLiteral("equalsFromSpace");
+                case OsmAnd::StringMatcherMode::CHECK_CONTAINS:
+                    return QStringLiteral("contains");
+                case OsmAnd::StringMatcherMode::CHECK_EQUALS:
+                    return QStringLiteral("equals");
+            }
+            return QString();
+        };
+
+    // Legacy matching is done with query and mode as prepared by matcher
+    const auto matchesByICU =
+        []
+        (const OsmAnd::CollatorStringMatcher& matcher, const QString& name) -> bool
+        {
+            return OsmAnd::ICU::cmatches(name, matcher.getPart(), matcher.getMode());
+        };
+
+    // Names with characters of several collation weights, that both approaches have to match same way
+    typedef OsmAnd::StringMatcherMode Mode;
+    struct ParityCase
+    {
+        QString name;
+        QString query;
+        Mode mode;
+    };
+    const QList<ParityCase> parityCases = {
+        { QStringLiteral("Hauptstraße"), QStringLiteral("Hauptstras"), Mode::CHECK_ONLY_STARTS_WITH },
+        { QStringLiteral("Hauptstraße"), QStringLiteral("hauptstrasse"), Mode::CHECK_EQUALS },
+        { QStringLiteral("Hauptstrasse"), QStringLiteral("Hauptstraße"), Mode::CHECK_EQUALS },
+        { QStringLiteral("Alte Hauptstraße"), QStringLiteral("Hauptstr."), Mode::CHECK_EQUALS_FROM_SPACE },
+        { QStringLiteral("Große Straße"), QStringLiteral("grosse"), Mode::CHECK_EQUALS_FROM_SPACE },
+        { QStringLiteral("Große Straße"), QStringLiteral("strass"), Mode::CHECK_STARTS_FROM_SPACE_NOT_BEGINNING },
+        { QStringLiteral("Große Straße"), QStringLiteral("osse"), Mode::CHECK_CONTAINS },
+        { QStringLiteral("Hauptstrasse"), QStringLiteral("Hauptstrase"), Mode::CHECK_ONLY_STARTS_WITH },
+        { QStringLiteral("Ærøvej"), QStringLiteral("ærø"), Mode::CHECK_ONLY_STARTS_WITH },
+        { QStringLiteral("Ærøvej"), QStringLiteral("ærøvej"), Mode::CHECK_EQUALS },
+        { QStringLiteral("Gammel Kongevej Ærø"), QStringLiteral("ærø"), Mode::CHECK_EQUALS_FROM_SPACE },
+        { QStringLiteral("Sankt Hæstvej"), QStringLiteral("hæst"), Mode::CHECK_STARTS_FROM_SPACE },
+        { QStringLiteral("Sankt Hæstvej"), QStringLiteral("æstv"), Mode::CHECK_CONTAINS },
+        { QStringLiteral("Hæstvej"), QStringLiteral("hæstvej."), Mode::CHECK_EQUALS },
+    };
+    int parityMismatchesCount = 0;
+    for (const auto& parityCase : OsmAnd::constOf(parityCases))
+    {
+        const OsmAnd::CollatorStringMatcher matcher(parityCase.query, parityCase.mode);
+        const auto legacyMatch = matchesByICU(matcher, parityCase.name);
+        const auto matcherMatch = matcher.matches(parityCase.name);
+        if (legacyMatch == matcherMatch)
+            continue;
+
+        parityMismatchesCount++;
+        output
+            << xT("\t'") << QStringToStlString(parityCase.name) << xT("' ")
+            << QStringToStlString(modeName(parityCase.mode)) << xT(" '") << QStringToStlString(parityCase.query)
+            << xT("': ") << (legacyMatch ? xT("legacy only") : xT("matcher only")) << std::endl;
+    }
+    output << parityCases.size() << xT(" parity cases, ") << parityMismatchesCount << xT(" mismatches") << std::endl;
+
+    const auto keysCount = static_cast<float>(names.size()) * configuration.repeats;
+    for (const auto& query : OsmAnd::constOf(configuration.queries))
+    {
+        for (const auto mode : OsmAnd::constOf(configuration.modes))
+        {
+            const OsmAnd::CollatorStringMatcher legacyMatcher(query, mode);
+            QVector<bool> legacyMatches(names.size());
+            OsmAnd::Stopwatch legacyStopwatch(true);
+            for (auto repeat = 0u; repeat < configuration.repeats; repeat++)
+            {
+                for (auto nameIndex = 0; nameIndex < names.size(); nameIndex++)
+                    legacyMatches[nameIndex] = matchesByICU(legacyMatcher, names[nameIndex]);
+            }
+            const auto legacyElapsed = legacyStopwatch.elapsed();
+
+            QVector<bool> matcherMatches(names.size());
+            OsmAnd::Stopwatch matcherStopwatch(true);
+            for (auto repeat = 0u; repeat < configuration.repeats; repeat++)
+            {
+                const OsmAnd::CollatorStringMatcher matcher(query, mode);
+                for (auto nameIndex = 0; nameIndex < names.size(); nameIndex++)
+                    matcherMatches[nameIndex] = matcher.matches(names[nameIndex]);
+            }
+            const auto matcherElapsed = matcherStopwatch.elapsed();
+
+            int matchesCount = 0;
+            int mismatchesCount = 0;
+            for (auto nameIndex = 0; nameIndex < names.size(); nameIndex++)
+            {
+                if (matcherMatches[nameIndex])
+                    matchesCount++;
+                if (legacyMatches[nameIndex] == matcherMatches[nameIndex])
+                    continue;
+
+                mismatchesCount++;
+                if (configuration.verbose)
+                {
+                    output
+                        << xT("\t'") << QStringToStlString(names[nameIndex]) << xT("': ")
+                        << (legacyMatches[nameIndex] ? xT("legacy only") : xT("matcher only")) << std::endl;
+                }
+            }
+
+            output
+                << xT("'") << QStringToStlString(query) << xT("' ") << QStringToStlString(modeName(mode))
+                << xT(": ") << matchesCount << xT(" matches, ") << mismatchesCount << xT(" mismatches") << std::endl
+                << xT("\tICU: ") << legacyElapsed << xT("s, ")
+                << (legacyElapsed > 0.0f ? keysCount / legacyElapsed : 0.0f) << xT(" keys/s") << std::endl
+                << xT("\tMatcher: ") << matcherElapsed << xT("s, ")
+                << (matcherElapsed > 0.0f ? keysCount / matcherElapsed : 0.0f) << xT(" keys/s") << std::endl;
+        }
+    }
+
+    return true;
+}
+
+bool OsmAndTools::StringMatcherBenchmark::run(QString* pLog /*= nullptr*/)
+{
+    if (pLog != nullptr)
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        std::wostringstream output;
+        const bool success = run(output);
+        *pLog = QString::fromStdWString(output.str());
+        return success;
+#else
+        std::ostringstream output;
+        const bool success = run(output);
+        *pLog = QString::fromStdString(output.str());
+        return success;
+#endif
+    }
+    else
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        return run(std::wcout);
+#else
+        return run(std::cout);
+#endif
+    }
+}
+
+OsmAndTools::StringMatcherBenchmark::Configuration::Configuration()
+    : repeats(1)
+    , verbose(false)
+{
+}
+
+bool OsmAndTools::StringMatcherBenchmark::Configuration::parseFromCommandLineArguments(
+    const QStringList& commandLineArgs,
+    Configuration& outConfiguration,
+    QString& outError)
+{
+    outConfiguration = Configuration();
+
+    const std::shared_ptr<OsmAnd::ObfsCollection> obfsCollection(new OsmAnd::ObfsCollection());
+    outConfiguration.obfsCollection = obfsCollection;
+
+    for (const auto& arg : commandLineArgs)
+    {
+        if (arg.startsWith(QLatin1String("-obfsPath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-obfsPath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            obfsCollection->addDirectory(value, false);
+        }
+        else if (arg.startsWith(QLatin1String("-obfFile=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-obfFile=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            obfsCollection->addFile(value);
+        }
+        else if (arg.startsWith(QLatin1String("-query=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-query=")));
+            if (value.isEmpty())
+            {
+                outError = QString("Query can not be empty");
+                return false;
+            }
+
+            outConfiguration.queries.push_back(value);
+        }
+        else if (arg.startsWith(QLatin1String("-mode=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-mode=")));
+            if (value == QLatin1String("startsWith"))
+                outConfiguration.modes.push_back(OsmAnd::StringMatcherMode::CHECK_ONLY_STARTS_WITH);
+            else if (value == QLatin1String("startsFromSpace"))
+                outConfiguration.modes.push_back(OsmAnd::StringMatcherMode::CHECK_STARTS_FROM_SPACE);
+            else if (value == QLatin1String("startsFromSpaceNotBeginning"))
+                outConfiguration.modes.push_back(OsmAnd::StringMatcherMode::CHECK_STARTS_FROM_SPACE_NOT_BEGINNING);
+            else if (value == QLatin1String("equalsFromSpace"))
+                outConfiguration.modes.push_back(OsmAnd::StringMatcherMode::CHECK_EQUALS_FROM_SPACE);
+            else if (value == QLatin1String("contains"))
+                outConfiguration.modes.push_back(OsmAnd::StringMatcherMode::CHECK_CONTAINS);
+            else if (value == QLatin1String("equals"))
+                outConfiguration.modes.push_back(OsmAnd::StringMatcherMode::CHECK_EQUALS);
+            else
+            {
+                outError = QString("'%1' is not a matcher mode").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-repeats=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-repeats=")));
+
+            bool ok = false;
+            outConfiguration.repeats = value.toUInt(&ok);
+            if (!ok || outConfiguration.repeats == 0)
+            {
+                outError = QString("'%1' can not be parsed as repeats count").arg(value);
+                return false;
+            }
+        }
+        else if (arg == QLatin1String("-verbose"))
+        {
+            outConfiguration.verbose = true;
+        }
+        else
+        {
+            outError = QString("Unrecognized argument: '%1'").arg(arg);
+            return false;
+        }
+    }
+
+    // Validate
+    if (outConfiguration.queries.isEmpty())
+    {
+        outError = QString("At least one query has to be specified");
+        return false;
+    }
+    if (outConfiguration.modes.isEmpty())
+    {
+        outConfiguration.modes
+            << OsmAnd::StringMatcherMode::CHECK_ONLY_STARTS_WITH
+            << OsmAnd::StringMatcherMode::CHECK_STARTS_FROM_SPACE
+            << OsmAnd::StringMatcherMode::CHECK_CONTAINS;
+    }
+
+    return true;
+}
@@ -0,0 +1,314 @@
+#include "TerrainProcessingBenchmark.h"
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QDir>
+#include <QFile>
+#include <QByteArray>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Common.h>
+#include <OsmAndCore/Stopwatch.h>
+#include <OsmAndCore/GeoTiffCollection.h>
+
+#include <OsmAndCoreTools.h>
+#include <OsmAndCoreTools/Utilities.h>
+
+OsmAndTools::TerrainProcessingBenchmark::TerrainProcessingBenchmark(const Configuration& configuration_)
+    : configuration(configuration_)
+{
+}
+
+OsmAndTools::TerrainProcessingBenchmark::~TerrainProcessingBenchmark()
+{
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::TerrainProcessingBenchmark::run(std::wostream& output)
+#else
+bool OsmAndTools::TerrainProcessingBenchmark::run(std::ostream& output)
+#endif
+{
+    // Same setup as in hillshade and slope layer providers
+    const int bandCount = 4;
+    const int overlap = 4;
+    const auto bufferSize = configuration.tileSize * configuration.tileSize * bandCount;
+
+    const std::shared_ptr<OsmAnd::GeoTiffCollection> geotiffsCollection(new OsmAnd::GeoTiffCollection(false));
+    geotiffsCollection->addDirectory(configuration.geotiffsPath);
+
+    OsmAnd::IGeoTiffCollection::ProcessingParameters procParameters;
+    procParameters.rasterType = configuration.rasterType;
+    procParameters.resultColorsFilename = configuration.colorsFilename;
+    procParameters.intermediateColorsFilename = configuration.slopeGrayscaleFilename;
+
+    const auto produceTiles =
+        [this, geotiffsCollection, bufferSize, &output]
+        (const OsmAnd::IGeoTiffCollection::ProcessingParameters& procParameters,
+            QList<QByteArray>& outTiles,
+            float& outElapsed) -> bool
+        {
+            outTiles.clear();
+            OsmAnd::Stopwatch stopwatch(true);
+            for (auto repeat = 0u; repeat < configuration.repeats; repeat++)
+            {
+                for (const auto& tileId : OsmAnd::constOf(configuration.tileIds))
+                {
+                    QByteArray tile(bufferSize, 0);
+                    const auto result = geotiffsCollection->getGeoTiffData(
+                        tileId,
+                        configuration.zoom,
+                        configuration.tileSize + overlap,
+                        overlap,
+                        bandCount,
+                        true,
+                        tile.data(),
+                        &procParameters);
+                    if (result == OsmAnd::IGeoTiffCollection::CallResult::Failed)
+                    {
+                        output
+                            << xT("Failed to produce tile ")
+                            << tileId.x << xT("x") << tileId.y << xT("@") << configuration.zoom
+                            << std::endl;
+                        return false;
+                    }
+                    if (repeat == 0)
+                        outTiles.push_back(result == OsmAnd::IGeoTiffCollection::CallResult::Completed
+                            ? tile
+                            : QByteArray());
+                }
+            }
+            outElapsed = stopwatch.elapsed();
+            return true;
+        };
+
+    QList<QByteArray> gdalTiles;
+    float gdalElapsed = 0.0f;
+    procParameters.useNativeProcessing = false;
+    if (!produceTiles(procParameters, gdalTiles, gdalElapsed))
+        return false;
+
+    QList<QByteArray> nativeTiles;
+    float nativeElapsed = 0.0f;
+    procParameters.useNativeProcessing = true;
+    if (!produceTiles(procParameters, nativeTiles, nativeElapsed))
+        return false;
+
+    const auto tilesCount = configuration.tileIds.size() * configuration.repeats;
+    output
+        << xT("GDAL: ") << tilesCount << xT(" tiles in ") << gdalElapsed << xT("s") << std::endl
+        << xT("Native: ") << tilesCount << xT(" tiles in ") << nativeElapsed << xT("s") << std::endl;
+
+    // Compare produced rasters channel by channel
+    int emptyTilesCount = 0;
+    int maxDifference = 0;
+    uint64_t differentValuesCount = 0;
+    for (int tileIdx = 0; tileIdx < gdalTiles.size(); tileIdx++)
+    {
+        const auto& gdalTile = gdalTiles[tileIdx];
+        const auto& nativeTile = nativeTiles[tileIdx];
+        if (gdalTile.isEmpty() || nativeTile.isEmpty())
+        {
+            if (gdalTile.isEmpty() != nativeTile.isEmpty())
+            {
+                output << xT("Tile #") << tileIdx << xT(" was produced only by one of implementations") << std::endl;
+                return false;
+            }
+            emptyTilesCount++;
+            continue;
+        }
+
+        for (int idx = 0; idx < gdalTile.size(); idx++)
+        {
+            const auto difference = std::abs(
+                static_cast<int>(static_cast<uint8_t>(gdalTile[idx])) -
+                static_cast<int>(static_cast<uint8_t>(nativeTile[idx])));
+            if (difference > 0)
+                differentValuesCount++;
+            maxDifference = std::max(maxDifference, difference);
+        }
+    }
+    output
+        << xT("Compared ") << gdalTiles.size() - emptyTilesCount << xT(" tiles (")
+        << emptyTilesCount << xT(" empty): ")
+        << differentValuesCount << xT(" values differ, max difference ") << maxDifference
+        << std::endl;
+
+    return true;
+}
+
+bool OsmAndTools::TerrainProcessingBenchmark::run(QString* pLog /*= nullptr*/)
+{
+    if (pLog != nullptr)
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        std::wostringstream output;
+        const bool success = run(output);
+        *pLog = QString::fromStdWString(output.str());
+        return success;
+#else
+        std::ostringstream output;
+        const bool success = run(output);
+        *pLog = QString::fromStdString(output.str());
+        return success;
+#endif
+    }
+    else
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        return run(std::wcout);
+#else
+        return run(std::cout);
+#endif
+    }
+}
+
+OsmAndTools::TerrainProcessingBenchmark::Configuration::Configuration()
+    : rasterType(OsmAnd::IGeoTiffCollection::RasterType::Hillshade)
+    , zoom(OsmAnd::ZoomLevel12)
+    , tileSize(256)
+    , repeats(1)
+    , verbose(false)
+{
+}
+
+bool OsmAndTools::TerrainProcessingBenchmark::Configuration::parseFromCommandLineArguments(
+    const QStringList& commandLineArgs,
+    Configuration& outConfiguration,
+    QString& outError)
+{
+    outConfiguration = Configuration();
+
+    for (const auto& arg : commandLineArgs)
+    {
+        if (arg.startsWith(QLatin1String("-geotiffsPath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-geotiffsPath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.geotiffsPath = value;
+        }
+        else if (arg.startsWith(QLatin1String("-colors=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-colors=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.colorsFilename = value;
+        }
+        else if (arg.startsWith(QLatin1String("-slopeGrayscale=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-slopeGrayscale=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.slopeGrayscaleFilename = value;
+        }
+        else if (arg == QLatin1String("-hillshade"))
+        {
+            outConfiguration.rasterType = OsmAnd::IGeoTiffCollection::RasterType::Hillshade;
+        }
+        else if (arg == QLatin1String("-slope"))
+        {
+            outConfiguration.rasterType = OsmAnd::IGeoTiffCollection::RasterType::Slope;
+        }
+        else if (arg.startsWith(QLatin1String("-zoom=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-zoom=")));
+
+            bool ok = false;
+            outConfiguration.zoom = static_cast<OsmAnd::ZoomLevel>(value.toUInt(&ok));
+            if (!ok || outConfiguration.zoom < OsmAnd::MinZoomLevel || outConfiguration.zoom > OsmAnd::MaxZoomLevel)
+            {
+                outError = QString("'%1' can not be parsed as zoom").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-tile=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-tile=")));
+            const auto components = value.split(QLatin1Char('x'));
+
+            bool okX = false;
+            bool okY = false;
+            const auto x = components.size() == 2 ? components[0].toInt(&okX) : 0;
+            const auto y = components.size() == 2 ? components[1].toInt(&okY) : 0;
+            if (!okX || !okY)
+            {
+                outError = QString("'%1' can not be parsed as tile (XxY)").arg(value);
+                return false;
+            }
+
+            outConfiguration.tileIds.push_back(OsmAnd::TileId::fromXY(x, y));
+        }
+        else if (arg.startsWith(QLatin1String("-tileSize=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-tileSize=")));
+
+            bool ok = false;
+            outConfiguration.tileSize = value.toUInt(&ok);
+            if (!ok || outConfiguration.tileSize == 0)
+            {
+                outError = QString("'%1' can not be parsed as tile size").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-repeats=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-repeats=")));
+
+            bool ok = false;
+            outConfiguration.repeats = value.toUInt(&ok);
+            if (!ok || outConfiguration.repeats == 0)
+            {
+                outError = QString("'%1' can not be parsed as repeats count").arg(value);
+                return false;
+            }
+        }
+        else if (arg == QLatin1String("-verbose"))
+        {
+            outConfiguration.verbose = true;
+        }
+        else
+        {
+            outError = QString("Unrecognized argument: '%1'").arg(arg);
+            return false;
+        }
+    }
+
+    // Validate
+    if (outConfiguration.geotiffsPath.isEmpty())
+    {
+        outError = QLatin1String("'geotiffsPath' can not be empty");
+        return false;
+    }
+    if (outConfiguration.colorsFilename.isEmpty())
+    {
+        outError = QLatin1String("'colors' can not be empty");
+        return false;
+    }
+    if (outConfiguration.rasterType == OsmAnd::IGeoTiffCollection::RasterType::Hillshade &&
+        outConfiguration.slopeGrayscaleFilename.isEmpty())
+    {
+        outError = QLatin1String("'slopeGrayscale' can not be empty for hillshade");
+        return false;
+    }
+    if (outConfiguration.tileIds.isEmpty())
+    {
+        outError = QLatin1String("No tiles specified");
+        return false;
+    }
+
+    return true;
+}
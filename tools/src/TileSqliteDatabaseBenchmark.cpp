@@ -0,0 +1,259 @@
+#include "TileSqliteDatabaseBenchmark.h"
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <random>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QDir>
+#include <QFile>
+#include <QDateTime>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Common.h>
+#include <OsmAndCore/Stopwatch.h>
+#include <OsmAndCore/TileSqliteDatabase.h>
+
+#include <OsmAndCoreTools.h>
+#include <OsmAndCoreTools/Utilities.h>
+
+OsmAndTools::TileSqliteDatabaseBenchmark::TileSqliteDatabaseBenchmark(const Configuration& configuration_)
+    : configuration(configuration_)
+{
+}
+
+OsmAndTools::TileSqliteDatabaseBenchmark::~TileSqliteDatabaseBenchmark()
+{
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::TileSqliteDatabaseBenchmark::run(std::wostream& output)
+#else
+bool OsmAndTools::TileSqliteDatabaseBenchmark::run(std::ostream& output)
+#endif
+{
+    // Prepare same set of tiles for both runs
+    std::mt19937 randomGenerator(42);
+    std::uniform_int_distribution<int> byteDistribution(0, 255);
+    QByteArray tileData(configuration.tileDataSize, Qt::Uninitialized);
+    for (auto& byte : tileData)
+        byte = static_cast<char>(byteDistribution(randomGenerator));
+
+    const auto tilesPerRow = 1u << configuration.zoom;
+    const auto specification = configuration.withSpecification ? 1 : 0;
+    const auto time = configuration.withTime ? QDateTime::currentMSecsSinceEpoch() : 0;
+    QList<OsmAnd::TileSqliteDatabase::TileEntry> tiles;
+    tiles.reserve(configuration.tilesCount);
+    for (auto tileIdx = 0u; tileIdx < configuration.tilesCount; tileIdx++)
+    {
+        const auto tileId = OsmAnd::TileId::fromXY(tileIdx % tilesPerRow, tileIdx / tilesPerRow);
+        tiles.push_back(OsmAnd::TileSqliteDatabase::TileEntry(
+            tileId, configuration.zoom, tileData, time, specification));
+    }
+
+    const auto openDatabase =
+        [this, &output]
+        (const QString& filename) -> std::shared_ptr<OsmAnd::TileSqliteDatabase>
+        {
+            QFile::remove(filename);
+            QFile::remove(filename + QLatin1String("-wal"));
+            QFile::remove(filename + QLatin1String("-shm"));
+
+            const std::shared_ptr<OsmAnd::TileSqliteDatabase> database(new OsmAnd::TileSqliteDatabase(filename));
+            if (!database->open(configuration.withSpecification))
+            {
+                output << xT("Failed to open '") << QStringToStlString(filename) << xT("'") << std::endl;
+                return nullptr;
+            }
+            if (configuration.withTime && !database->enableTileTimeSupport())
+            {
+                output << xT("Failed to enable time support in '") << QStringToStlString(filename) << xT("'") << std::endl;
+                return nullptr;
+            }
+            return database;
+        };
+    const auto printResult =
+        [&output]
+        (const char* const mode, const int tilesCount, const float elapsed)
+        {
+            output
+                << mode << xT(": ")
+                << tilesCount << xT(" tiles in ") << elapsed << xT("s (")
+                << (elapsed > 0.0f ? tilesCount / elapsed : 0.0f) << xT(" tiles/s)")
+                << std::endl;
+        };
+
+    // Store tiles one by one, each in own implicit transaction
+    const auto singleFilename = QDir(configuration.outputPath).absoluteFilePath(QLatin1String("benchmark_single.sqlitedb"));
+    if (const auto database = openDatabase(singleFilename))
+    {
+        OsmAnd::Stopwatch stopwatch(true);
+        for (const auto& tile : OsmAnd::constOf(tiles))
+        {
+            const auto stored = configuration.withSpecification
+                ? database->storeTileData(tile.tileId, tile.zoom, tile.specification, tile.data, tile.time)
+                : database->storeTileData(tile.tileId, tile.zoom, tile.data, tile.time);
+            if (!stored)
+            {
+                output << xT("Failed to store tile") << std::endl;
+                return false;
+            }
+        }
+        printResult("Single", tiles.size(), stopwatch.elapsed());
+        database->close(false);
+    }
+    else
+        return false;
+
+    // Store all tiles as a batch
+    const auto batchFilename = QDir(configuration.outputPath).absoluteFilePath(QLatin1String("benchmark_batch.sqlitedb"));
+    if (const auto database = openDatabase(batchFilename))
+    {
+        OsmAnd::Stopwatch stopwatch(true);
+        if (!database->storeTilesData(tiles))
+        {
+            output << xT("Failed to store tiles") << std::endl;
+            return false;
+        }
+        printResult("Batch", tiles.size(), stopwatch.elapsed());
+        database->close(false);
+    }
+    else
+        return false;
+
+    if (configuration.verbose)
+    {
+        output
+            << xT("Databases left at '") << QStringToStlString(singleFilename)
+            << xT("' and '") << QStringToStlString(batchFilename) << xT("'")
+            << std::endl;
+    }
+
+    return true;
+}
+
+bool OsmAndTools::TileSqliteDatabaseBenchmark::run(QString* pLog /*= nullptr*/)
+{
+    if (pLog != nullptr)
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        std::wostringstream output;
+        const bool success = run(output);
+        *pLog = QString::fromStdWString(output.str());
+        return success;
+#else
+        std::ostringstream output;
+        const bool success = run(output);
+        *pLog = QString::fromStdString(output.str());
+        return success;
+#endif
+    }
+    else
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        return run(std::wcout);
+#else
+        return run(std::cout);
+#endif
+    }
+}
+
+OsmAndTools::TileSqliteDatabaseBenchmark::Configuration::Configuration()
+    : outputPath(QDir::tempPath())
+    , tilesCount(10000)
+    , tileDataSize(16 * 1024)
+    , zoom(OsmAnd::ZoomLevel12)
+    , withTime(true)
+    , withSpecification(false)
+    , verbose(false)
+{
+}
+
+bool OsmAndTools::TileSqliteDatabaseBenchmark::Configuration::parseFromCommandLineArguments(
+    const QStringList& commandLineArgs,
+    Configuration& outConfiguration,
+    QString& outError)
+{
+    outConfiguration = Configuration();
+
+    for (const auto& arg : commandLineArgs)
+    {
+        if (arg.startsWith(QLatin1String("-outputPath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-outputPath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.outputPath = value;
+        }
+        else if (arg.startsWith(QLatin1String("-tilesCount=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-tilesCount=")));
+
+            bool ok = false;
+            outConfiguration.tilesCount = value.toUInt(&ok);
+            if (!ok || outConfiguration.tilesCount == 0)
+            {
+                outError = QString("'%1' can not be parsed as tiles count").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-tileDataSize=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-tileDataSize=")));
+
+            bool ok = false;
+            outConfiguration.tileDataSize = value.toUInt(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' can not be parsed as tile data size").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-zoom=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-zoom=")));
+
+            bool ok = false;
+            outConfiguration.zoom = static_cast<OsmAnd::ZoomLevel>(value.toUInt(&ok));
+            if (!ok || outConfiguration.zoom < OsmAnd::MinZoomLevel || outConfiguration.zoom > OsmAnd::MaxZoomLevel)
+            {
+                outError = QString("'%1' can not be parsed as zoom").arg(value);
+                return false;
+            }
+        }
+        else if (arg == QLatin1String("-noTime"))
+        {
+            outConfiguration.withTime = false;
+        }
+        else if (arg == QLatin1String("-withSpecification"))
+        {
+            outConfiguration.withSpecification = true;
+        }
+        else if (arg == QLatin1String("-verbose"))
+        {
+            outConfiguration.verbose = true;
+        }
+        else
+        {
+            outError = QString("Unrecognized argument: '%1'").arg(arg);
+            return false;
+        }
+    }
+
+    // Validate
+    const auto tilesAtZoom = static_cast<uint64_t>(1u << outConfiguration.zoom) * (1u << outConfiguration.zoom);
+    if (outConfiguration.tilesCount > tilesAtZoom)
+    {
+        outError = QString("Zoom %1 has only %2 tiles").arg(outConfiguration.zoom).arg(tilesAtZoom);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,351 @@
+#include "WeatherRasterizationBenchmark.h"
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QFile>
+#include <QByteArray>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <SkImage.h>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Common.h>
+#include <OsmAndCore/Stopwatch.h>
+#include <OsmAndCore/Map/GeoBandSettings.h>
+#include <OsmAndCore/Map/GeoTileRasterizer.h>
+
+#include <OsmAndCoreTools.h>
+#include <OsmAndCoreTools/Utilities.h>
+
+OsmAndTools::WeatherRasterizationBenchmark::WeatherRasterizationBenchmark(const Configuration& configuration_)
+    : configuration(configuration_)
+{
+}
+
+OsmAndTools::WeatherRasterizationBenchmark::~WeatherRasterizationBenchmark()
+{
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::WeatherRasterizationBenchmark::run(std::wostream& output)
+#else
+bool OsmAndTools::WeatherRasterizationBenchmark::run(std::ostream& output)
+#endif
+{
+    QFile geotiffFile(configuration.geotiffFilename);
+    if (!geotiffFile.open(QIODevice::ReadOnly))
+    {
+        output << xT("Failed to open ") << QStringToStlString(configuration.geotiffFilename) << std::endl;
+        return false;
+    }
+    const auto geoTileData = geotiffFile.readAll();
+    geotiffFile.close();
+
+    QHash<OsmAnd::BandIndex, std::shared_ptr<const OsmAnd::GeoBandSettings>> bandSettings;
+    for (const auto& colorProfileEntry : OsmAnd::rangeOf(OsmAnd::constOf(configuration.colorProfiles)))
+    {
+        bandSettings.insert(colorProfileEntry.key(), std::make_shared<const OsmAnd::GeoBandSettings>(
+            QString(),
+            QString(),
+            QString(),
+            QString(),
+            1.0f,
+            colorProfileEntry.value(),
+            QString(),
+            QHash<OsmAnd::ZoomLevel, QList<double>>()));
+    }
+
+    // Each band is rasterized separately, so that speed of each one is measured
+    const auto rasterizeBand =
+        [this, geoTileData, bandSettings, &output]
+        (const OsmAnd::BandIndex band,
+            const bool useNativeProcessing,
+            QList< sk_sp<const SkImage> >& outImages,
+            float& outElapsed) -> bool
+        {
+            outImages.clear();
+            OsmAnd::Stopwatch stopwatch(true);
+            for (auto repeat = 0u; repeat < configuration.repeats; repeat++)
+            {
+                for (const auto& tileId : OsmAnd::constOf(configuration.tileIds))
+                {
+                    OsmAnd::GeoTileRasterizer rasterizer(
+                        geoTileData,
+                        tileId,
+                        configuration.zoom,
+                        QList<OsmAnd::BandIndex>() << band,
+                        bandSettings,
+                        configuration.tileSize,
+                        1.0f,
+                        configuration.projSearchPath,
+                        useNativeProcessing);
+
+                    QHash<OsmAnd::BandIndex, QByteArray> encImgData;
+                    const auto images = configuration.encode
+                        ? rasterizer.rasterize(encImgData)
+                        : rasterizer.rasterize();
+                    const auto image = images.value(band);
+                    if (!image)
+                    {
+                        output
+                            << xT("Failed to rasterize band ") << static_cast<int>(band) << xT(" of tile ")
+                            << tileId.x << xT("x") << tileId.y << xT("@") << configuration.zoom
+                            << std::endl;
+                        return false;
+                    }
+                    if (repeat == 0)
+                        outImages.push_back(image);
+                }
+            }
+            outElapsed = stopwatch.elapsed();
+            return true;
+        };
+
+    const auto readPixels =
+        []
+        (const sk_sp<const SkImage>& image, QByteArray& outPixels) -> bool
+        {
+            const auto info = SkImageInfo::Make(
+                image->width(),
+                image->height(),
+                SkColorType::kRGBA_8888_SkColorType,
+                SkAlphaType::kUnpremul_SkAlphaType);
+            outPixels.resize(static_cast<int>(info.computeMinByteSize()));
+            return image->readPixels(info, outPixels.data(), info.minRowBytes(), 0, 0);
+        };
+
+    const auto tilesCount = configuration.tileIds.size() * configuration.repeats;
+    for (const auto band : OsmAnd::constOf(configuration.colorProfiles.keys()))
+    {
+        QList< sk_sp<const SkImage> > gdalImages;
+        float gdalElapsed = 0.0f;
+        if (!rasterizeBand(band, false, gdalImages, gdalElapsed))
+            return false;
+
+        QList< sk_sp<const SkImage> > nativeImages;
+        float nativeElapsed = 0.0f;
+        if (!rasterizeBand(band, true, nativeImages, nativeElapsed))
+            return false;
+
+        output
+            << xT("Band ") << static_cast<int>(band) << xT(":") << std::endl
+            << xT("\tGDAL: ") << tilesCount << xT(" tiles in ") << gdalElapsed << xT("s, ")
+            << (gdalElapsed > 0.0f ? tilesCount / gdalElapsed : 0.0f) << xT(" tiles/s") << std::endl
+            << xT("\tNative: ") << tilesCount << xT(" tiles in ") << nativeElapsed << xT("s, ")
+            << (nativeElapsed > 0.0f ? tilesCount / nativeElapsed : 0.0f) << xT(" tiles/s") << std::endl;
+
+        // Compare produced rasters channel by channel
+        int maxDifference = 0;
+        uint64_t differentValuesCount = 0;
+        uint64_t totalDifference = 0;
+        uint64_t valuesCount = 0;
+        for (int tileIdx = 0; tileIdx < gdalImages.size(); tileIdx++)
+        {
+            QByteArray gdalPixels;
+            QByteArray nativePixels;
+            if (!readPixels(gdalImages[tileIdx], gdalPixels) || !readPixels(nativeImages[tileIdx], nativePixels)
+                || gdalPixels.size() != nativePixels.size())
+            {
+                output << xT("\tTile #") << tileIdx << xT(" can not be compared") << std::endl;
+                continue;
+            }
+
+            for (int idx = 0; idx < gdalPixels.size(); idx++)
+            {
+                const auto difference = std::abs(
+                    static_cast<int>(static_cast<uint8_t>(gdalPixels[idx])) -
+                    static_cast<int>(static_cast<uint8_t>(nativePixels[idx])));
+                if (difference > 0)
+                    differentValuesCount++;
+                totalDifference += difference;
+                maxDifference = std::max(maxDifference, difference);
+            }
+            valuesCount += gdalPixels.size();
+
+            if (configuration.verbose)
+            {
+                output
+                    << xT("\tTile ") << configuration.tileIds[tileIdx].x << xT("x")
+                    << configuration.tileIds[tileIdx].y << xT(" compared") << std::endl;
+            }
+        }
+        output
+            << xT("\t") << differentValuesCount << xT(" of ") << valuesCount << xT(" values differ, mean difference ")
+            << (valuesCount > 0 ? static_cast<double>(totalDifference) / valuesCount : 0.0)
+            << xT(", max difference ") << maxDifference
+            << std::endl;
+    }
+
+    return true;
+}
+
+bool OsmAndTools::WeatherRasterizationBenchmark::run(QString* pLog /*= nullptr*/)
+{
+    if (pLog != nullptr)
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        std::wostringstream output;
+        const bool success = run(output);
+        *pLog = QString::fromStdWString(output.str());
+        return success;
+#else
+        std::ostringstream output;
+        const bool success = run(output);
+        *pLog = QString::fromStdString(output.str());
+        return success;
+#endif
+    }
+    else
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        return run(std::wcout);
+#else
+        return run(std::cout);
+#endif
+    }
+}
+
+OsmAndTools::WeatherRasterizationBenchmark::Configuration::Configuration()
+    : zoom(OsmAnd::ZoomLevel6)
+    , tileSize(256)
+    , repeats(1)
+    , encode(false)
+    , verbose(false)
+{
+}
+
+bool OsmAndTools::WeatherRasterizationBenchmark::Configuration::parseFromCommandLineArguments(
+    const QStringList& commandLineArgs,
+    Configuration& outConfiguration,
+    QString& outError)
+{
+    outConfiguration = Configuration();
+
+    for (const auto& arg : commandLineArgs)
+    {
+        if (arg.startsWith(QLatin1String("-geotiff=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-geotiff=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.geotiffFilename = value;
+        }
+        else if (arg.startsWith(QLatin1String("-band=")))
+        {
+            // Band number and its color profile, separated by colon
+            const auto value = arg.mid(strlen("-band="));
+            const auto separatorIndex = value.indexOf(QLatin1Char(':'));
+
+            bool ok = false;
+            const auto band = separatorIndex > 0 ? value.left(separatorIndex).toUInt(&ok) : 0;
+            if (!ok || band == 0 || band > 255)
+            {
+                outError = QString("'%1' can not be parsed as band (N:colorProfile)").arg(value);
+                return false;
+            }
+            const auto colorProfilePath = Utilities::resolvePath(value.mid(separatorIndex + 1));
+            if (!QFile(colorProfilePath).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(colorProfilePath);
+                return false;
+            }
+
+            outConfiguration.colorProfiles.insert(static_cast<OsmAnd::BandIndex>(band), colorProfilePath);
+        }
+        else if (arg.startsWith(QLatin1String("-projSearchPath=")))
+        {
+            outConfiguration.projSearchPath = Utilities::resolvePath(arg.mid(strlen("-projSearchPath=")));
+        }
+        else if (arg.startsWith(QLatin1String("-zoom=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-zoom=")));
+
+            bool ok = false;
+            outConfiguration.zoom = static_cast<OsmAnd::ZoomLevel>(value.toUInt(&ok));
+            if (!ok || outConfiguration.zoom < OsmAnd::MinZoomLevel || outConfiguration.zoom > OsmAnd::MaxZoomLevel)
+            {
+                outError = QString("'%1' can not be parsed as zoom").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-tile=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-tile=")));
+            const auto components = value.split(QLatin1Char('x'));
+
+            bool okX = false;
+            bool okY = false;
+            const auto x = components.size() == 2 ? components[0].toInt(&okX) : 0;
+            const auto y = components.size() == 2 ? components[1].toInt(&okY) : 0;
+            if (!okX || !okY)
+            {
+                outError = QString("'%1' can not be parsed as tile (XxY)").arg(value);
+                return false;
+            }
+
+            outConfiguration.tileIds.push_back(OsmAnd::TileId::fromXY(x, y));
+        }
+        else if (arg.startsWith(QLatin1String("-tileSize=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-tileSize=")));
+
+            bool ok = false;
+            outConfiguration.tileSize = value.toUInt(&ok);
+            if (!ok || outConfiguration.tileSize == 0)
+            {
+                outError = QString("'%1' can not be parsed as tile size").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-repeats=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-repeats=")));
+
+            bool ok = false;
+            outConfiguration.repeats = value.toUInt(&ok);
+            if (!ok || outConfiguration.repeats == 0)
+            {
+                outError = QString("'%1' can not be parsed as repeats count").arg(value);
+                return false;
+            }
+        }
+        else if (arg == QLatin1String("-encode"))
+        {
+            outConfiguration.encode = true;
+        }
+        else if (arg == QLatin1String("-verbose"))
+        {
+            outConfiguration.verbose = true;
+        }
+        else
+        {
+            outError = QString("Unrecognized argument: '%1'").arg(arg);
+            return false;
+        }
+    }
+
+    // Validate
+    if (outConfiguration.geotiffFilename.isEmpty())
+    {
+        outError = QLatin1String("'geotiff' can not be empty");
+        return false;
+    }
+    if (outConfiguration.colorProfiles.isEmpty())
+    {
+        outError = QLatin1String("No bands specified");
+        return false;
+    }
+    if (outConfiguration.tileIds.isEmpty())
+    {
+        outError = QLatin1String("No tiles specified");
+        return false;
+    }
+
+    return true;
+}